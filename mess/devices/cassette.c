@@ -14,6 +14,14 @@
 #define ANIMATION_FPS		4
 #define ANIMATION_FRAMES	4
 
+/* while accelerating, how often we check whether the load has finished */
+#define ACCEL_POLL_TIME		TIME_IN_MSEC(1)
+
+/* how long the tape may go unread before we consider the load over */
+#define ACCEL_IDLE_TIME		TIME_IN_SEC(0.5)
+
+#define NO_LOADER_EXIT_PC	(~(UINT64) 0)
+
 #define VERBOSE				0
 
 
@@ -29,6 +37,13 @@ struct mess_cassetteimg
 	double position;
 	double position_time;
 	INT32 value;
+
+	/* fast loading */
+	mame_timer *accel_timer;
+	double accel_last_read;
+	UINT64 loader_exit_pc;
+	int accelerating;
+	int load_finished;
 };
 
 
@@ -64,6 +79,85 @@ static int cassette_is_motor_on(mess_image *cassette)
 
 
 
+/*********************************************************************
+	fast loading
+
+	When the 'fastcassette' option is on, the first read of a playing
+	tape asks the core to run unthrottled with rendering skipped, since
+	the tape is the only thing that matters to the machine.  We go back
+	to normal speed when the motor stops, the tape runs out, the tape
+	has not been read for a while, or the main CPU is seen at the
+	driver's DEVINFO_INT_CASSETTE_LOADER_EXIT_PC.  The PC is sampled
+	every ACCEL_POLL_TIME, so the exit PC is best placed in the loop
+	that the machine spins in once loading completes.  Programs often
+	keep polling the tape after that, so once the exit PC is seen we
+	do not accelerate again until the motor stops, the tape is moved,
+	or another tape is loaded.
+*********************************************************************/
+
+static void cassette_accel_poll(void *param)
+{
+	mess_image *cassette = (mess_image *) param;
+	struct mess_cassetteimg *tag;
+	int done = FALSE;
+
+	tag = get_cassimg(cassette);
+
+	if (!cassette_is_motor_on(cassette) || !tag->cassette)
+		done = TRUE;
+	else if ((tag->state & CASSETTE_MASK_UISTATE) != CASSETTE_PLAY)
+		done = TRUE;
+	else if (cassette_get_position(cassette) >= cassette_get_length(cassette))
+		done = TRUE;
+	else if (timer_get_time() - tag->accel_last_read > ACCEL_IDLE_TIME)
+		done = TRUE;
+	else if ((tag->loader_exit_pc != NO_LOADER_EXIT_PC) && (cpunum_get_reg(0, REG_PC) == (offs_t) tag->loader_exit_pc))
+		done = tag->load_finished = TRUE;
+
+	if (done)
+		cassette_stop_accelerating(cassette);
+}
+
+
+
+static void cassette_start_accelerating(mess_image *cassette)
+{
+	struct mess_cassetteimg *tag;
+
+	tag = get_cassimg(cassette);
+	if (tag->accelerating || !tag->accel_timer)
+		return;
+
+#if VERBOSE
+	logerror("cassette: accelerating load at time_index=%g\n", tag->position);
+#endif
+
+	tag->accelerating = TRUE;
+	timer_adjust_ptr(tag->accel_timer, ACCEL_POLL_TIME, ACCEL_POLL_TIME);
+	video_set_fastforward(TRUE);
+}
+
+
+
+void cassette_stop_accelerating(mess_image *cassette)
+{
+	struct mess_cassetteimg *tag;
+
+	tag = get_cassimg(cassette);
+	if (!tag->accelerating)
+		return;
+
+#if VERBOSE
+	logerror("cassette: load acceleration ended at time_index=%g\n", tag->position);
+#endif
+
+	tag->accelerating = FALSE;
+	timer_adjust_ptr(tag->accel_timer, TIME_NEVER, 0);
+	video_set_fastforward(FALSE);
+}
+
+
+
 static void cassette_update(mess_image *cassette)
 {
 	struct mess_cassetteimg *tag;
@@ -114,6 +208,10 @@ void cassette_change_state(mess_image *cassette, cassette_state state, cassette_
 	{
 		cassette_update(cassette);
 		tag->state = new_state;
+
+		/* the next load may be a new one */
+		if (!cassette_is_motor_on(cassette))
+			tag->load_finished = FALSE;
 	}
 }
 
@@ -137,6 +235,14 @@ double cassette_input(mess_image *cassette)
 	sample = tag->value;
 	double_value = sample / ((double) 0x7FFFFFFF);
 
+	/* the machine is reading the tape; speed it up if asked to */
+	if (options.fast_tape_load && !tag->load_finished && cassette_is_motor_on(cassette)
+		&& ((tag->state & CASSETTE_MASK_UISTATE) == CASSETTE_PLAY))
+	{
+		tag->accel_last_read = timer_get_time();
+		cassette_start_accelerating(cassette);
+	}
+
 #if VERBOSE
 	logerror("cassette_input(): time_index=%g value=%g\n", tag->position, double_value);
 #endif
@@ -221,6 +327,7 @@ void cassette_seek(mess_image *cassette, double time, int origin)
 	/* clip position into legal bounds */
 	tag = get_cassimg(cassette);
 	tag->position = time;
+	tag->load_finished = FALSE;
 }
 
 
@@ -232,13 +339,21 @@ void cassette_seek(mess_image *cassette, double time, int origin)
 static int device_init_cassette(mess_image *image)
 {
 	const struct IODevice *dev;
+	struct mess_cassetteimg *tag;
 
 	if (!image_alloctag(image, CASSETTE_TAG, sizeof(struct mess_cassetteimg)))
 		return INIT_FAIL;
+	tag = get_cassimg(image);
 
 	/* set to default state */
 	dev = device_find(Machine->devices, IO_CASSETTE);
-	get_cassimg(image)->state = get_default_state(dev);
+	tag->state = get_default_state(dev);
+
+	/* set up fast loading */
+	tag->loader_exit_pc = (UINT64) device_get_info_int(&dev->devclass, DEVINFO_INT_CASSETTE_LOADER_EXIT_PC);
+	tag->accel_timer = timer_alloc_ptr(cassette_accel_poll, image);
+	tag->accelerating = FALSE;
+	tag->load_finished = FALSE;
 
 	return INIT_PASS;
 }
@@ -296,6 +411,7 @@ static int device_load_cassette(mess_image *image)
 	/* reset the position */
 	tag->position = 0.0;
 	tag->position_time = timer_get_time();
+	tag->load_finished = FALSE;
 
 	return INIT_PASS;
 
@@ -311,6 +427,9 @@ static void device_unload_cassette(mess_image *image)
 	
 	tag = get_cassimg(image);
 
+	/* a tape that is gone cannot be loading */
+	cassette_stop_accelerating(image);
+
 	/* if we are recording, write the value to the image */
 	if ((tag->state & CASSETTE_MASK_UISTATE) == CASSETTE_RECORD)
 		cassette_update(image);
@@ -386,6 +505,7 @@ void cassette_device_getinfo(const device_class *devclass, UINT32 state, union d
 		case DEVINFO_INT_WRITEABLE:					info->i = 1; break;
 		case DEVINFO_INT_CREATABLE:					info->i = 1; break;
 		case DEVINFO_INT_CASSETTE_DEFAULT_STATE:	info->i = CASSETTE_PLAY; break;
+		case DEVINFO_INT_CASSETTE_LOADER_EXIT_PC:	info->i = (INT64) NO_LOADER_EXIT_PC; break;
 
 		/* --- the following bits of info are returned as pointers to data or functions --- */
 		case DEVINFO_PTR_INIT:						info->init = device_init_cassette; break;
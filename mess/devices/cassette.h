@@ -15,6 +15,7 @@
 enum
 {
 	DEVINFO_INT_CASSETTE_DEFAULT_STATE = DEVINFO_INT_DEV_SPECIFIC,
+	DEVINFO_INT_CASSETTE_LOADER_EXIT_PC,
 
 	DEVINFO_PTR_CASSETTE_FORMATS = DEVINFO_PTR_DEV_SPECIFIC,
 	DEVINFO_PTR_CASSETTE_OPTIONS
@@ -53,6 +54,9 @@ double cassette_get_position(mess_image *cassette);
 double cassette_get_length(mess_image *cassette);
 void cassette_seek(mess_image *cassette, double time, int origin);
 
+/* fast loading; the cassette accelerates the machine while the tape is read */
+void cassette_stop_accelerating(mess_image *cassette);
+
 /* device specification */
 void cassette_device_getinfo(const device_class *devclass, UINT32 state, union devinfo *info);
 
@@ -11,12 +11,58 @@
 #include "expat/expat.h"
 
 
+/***************************************************************************
+
+	Constants
+
+***************************************************************************/
+
+/* compiled indexes live beside the .hsi, with this extension */
+#define HASH_INDEX_EXTENSION	".hsx"
+
+#define HASH_INDEX_MAGIC		"MESSHSX1"
+#define HASH_INDEX_BYTE_ORDER	0x01020304
+
+
+
 /***************************************************************************
 
 	Type definitions
 
 ***************************************************************************/
 
+/* header of a compiled index; followed by the lookup table, the entries
+ * and the string pool */
+struct hash_index_header
+{
+	char magic[8];
+	UINT32 byte_order;
+	UINT32 source_length;
+	UINT32 source_stamp_hi;
+	UINT32 source_stamp_lo;
+	UINT32 entry_count;
+	UINT32 table_mask;
+	UINT32 pool_length;
+	UINT32 functions[IO_COUNT];
+};
+
+
+
+/* one entry of a compiled index; all strings are offsets into the pool,
+ * with 0 meaning NULL */
+struct hash_index_entry
+{
+	UINT32 key;
+	UINT32 hash;
+	UINT32 longname;
+	UINT32 manufacturer;
+	UINT32 year;
+	UINT32 playable;
+	UINT32 extrainfo;
+};
+
+
+
 struct _hash_file
 {
 	mame_file *file;
@@ -26,6 +72,14 @@ struct _hash_file
 	struct hash_info **preloaded_hashes;
 	int preloaded_hash_count;
 
+	/* compiled index, if we have one */
+	UINT8 *index;
+	const struct hash_index_header *index_header;
+	const UINT32 *index_table;
+	const struct hash_index_entry *index_entries;
+	const char *index_pool;
+	struct hash_info **index_expanded;
+
 	void (*error_proc)(const char *message);
 };
 
@@ -352,13 +406,314 @@ static void preload_use_proc(hash_file *hashfile, void *param, struct hash_info
 
 
 
-hash_file *hashfile_open(const char *sysname, int is_preload,
+/* -----------------------------------------------------------------------
+ * Compiled indexes
+ *
+ * Looking up an image by streaming the whole .hsi through expat is slow
+ * for systems with tens of thousands of entries, so the first time a hash
+ * file is opened we compile it into an open-addressing table keyed on the
+ * CRC (or, failing that, the first four bytes of the SHA1 or MD5) and save
+ * it beside the .hsi.  The index records the length and modification
+ * stamp of the .hsi it was built from, and is rebuilt when they change.
+ * ----------------------------------------------------------------------- */
+
+static const unsigned int index_key_functions[] = { HASH_CRC, HASH_SHA1, HASH_MD5 };
+
+
+
+static int hash_key(const char *hash, unsigned int function, UINT32 *key)
+{
+	UINT8 checksum[20];
+
+	if (!hash_data_extract_binary_checksum(hash, function, checksum))
+		return FALSE;
+	*key = (checksum[0] << 24) | (checksum[1] << 16) | (checksum[2] << 8) | checksum[3];
+	return TRUE;
+}
+
+
+
+static int index_attach(hash_file *hashfile, UINT8 *index, UINT32 length)
+{
+	const struct hash_index_header *header = (const struct hash_index_header *) index;
+	UINT32 table_size;
+	UINT64 stamp;
+
+	if (length < sizeof(*header))
+		return FALSE;
+	if (memcmp(header->magic, HASH_INDEX_MAGIC, sizeof(header->magic)) || header->byte_order != HASH_INDEX_BYTE_ORDER)
+		return FALSE;
+
+	/* is it stale? */
+	stamp = mame_fstamp(hashfile->file);
+	if (header->source_length != mame_fsize(hashfile->file)
+		|| header->source_stamp_hi != (UINT32) (stamp >> 32)
+		|| header->source_stamp_lo != (UINT32) stamp)
+		return FALSE;
+
+	/* is it complete? */
+	table_size = header->table_mask + 1;
+	if (length != sizeof(*header) + table_size * sizeof(UINT32)
+		+ header->entry_count * sizeof(struct hash_index_entry) + header->pool_length)
+		return FALSE;
+
+	hashfile->index = index;
+	hashfile->index_header = header;
+	hashfile->index_table = (const UINT32 *) (header + 1);
+	hashfile->index_entries = (const struct hash_index_entry *) (hashfile->index_table + table_size);
+	hashfile->index_pool = (const char *) (hashfile->index_entries + header->entry_count);
+	memcpy(hashfile->functions, header->functions, sizeof(hashfile->functions));
+	return TRUE;
+}
+
+
+
+static char *index_filename(hash_file *hashfile)
+{
+	const char *source = mame_file_full_name(hashfile->file);
+	const char *ext = strrchr(source, '.');
+	char *fname;
+
+	if (!ext)
+		ext = source + strlen(source);
+	fname = malloc((ext - source) + strlen(HASH_INDEX_EXTENSION) + 1);
+	if (!fname)
+		return NULL;
+	memcpy(fname, source, ext - source);
+	strcpy(fname + (ext - source), HASH_INDEX_EXTENSION);
+	return fname;
+}
+
+
+
+static int index_load(hash_file *hashfile)
+{
+	mame_file_error filerr;
+	mame_file *file;
+	char *fname;
+	UINT8 *index;
+	UINT32 length;
+
+	/* without a stamp we cannot tell if an index is stale */
+	if (mame_fstamp(hashfile->file) == 0)
+		return FALSE;
+
+	fname = index_filename(hashfile);
+	if (!fname)
+		return FALSE;
+	filerr = mame_fopen(NULL, fname, OPEN_FLAG_READ, &file);
+	free(fname);
+	if (filerr != FILERR_NONE)
+		return FALSE;
+
+	/* read it in one go */
+	length = (UINT32) mame_fsize(file);
+	index = malloc(length);
+	if (index && (mame_fread(file, index, length) != length || !index_attach(hashfile, index, length)))
+	{
+		free(index);
+		index = NULL;
+	}
+	mame_fclose(file);
+	return index != NULL;
+}
+
+
+
+static UINT32 index_add_string(char *pool, UINT32 *pool_pos, const char *s)
+{
+	UINT32 offset;
+
+	if (!s)
+		return 0;
+	offset = *pool_pos;
+	if (pool)
+		strcpy(&pool[offset], s);
+	*pool_pos += strlen(s) + 1;
+	return offset;
+}
+
+
+
+static void index_build(hash_file *hashfile)
+{
+	struct hash_index_header *header;
+	struct hash_index_entry *entries;
+	UINT32 *table;
+	UINT32 table_size, pool_length, length, count, i, j, slot;
+	struct hash_info *hi;
+	mame_file_error filerr;
+	mame_file *file;
+	char *pool;
+	char *fname;
+	UINT8 *index;
+	UINT64 stamp;
+	memory_pool pool_save;
+
+	/* parse everything in the file into a scratch pool; once the index is
+	 * built it holds its own copy of everything */
+	pool_save = hashfile->pool;
+	pool_init(&hashfile->pool);
+	hashfile_parse(hashfile, NULL, preload_use_proc, hashfile->error_proc, NULL);
+	count = hashfile->preloaded_hash_count;
+
+	/* size up the table and string pool; pool offset 0 is reserved for NULL */
+	for (table_size = 16; table_size < count * 2; table_size *= 2)
+		;
+	pool_length = 1;
+	for (i = 0; i < count; i++)
+	{
+		hi = hashfile->preloaded_hashes[i];
+		index_add_string(NULL, &pool_length, hi->hash);
+		index_add_string(NULL, &pool_length, hi->longname);
+		index_add_string(NULL, &pool_length, hi->manufacturer);
+		index_add_string(NULL, &pool_length, hi->year);
+		index_add_string(NULL, &pool_length, hi->playable);
+		index_add_string(NULL, &pool_length, hi->extrainfo);
+	}
+
+	length = sizeof(*header) + table_size * sizeof(*table) + count * sizeof(*entries) + pool_length;
+	index = malloc(length);
+	if (!index)
+		goto done;
+	memset(index, 0, length);
+
+	header = (struct hash_index_header *) index;
+	table = (UINT32 *) (header + 1);
+	entries = (struct hash_index_entry *) (table + table_size);
+	pool = (char *) (entries + count);
+
+	stamp = mame_fstamp(hashfile->file);
+	memcpy(header->magic, HASH_INDEX_MAGIC, sizeof(header->magic));
+	header->byte_order = HASH_INDEX_BYTE_ORDER;
+	header->source_length = (UINT32) mame_fsize(hashfile->file);
+	header->source_stamp_hi = (UINT32) (stamp >> 32);
+	header->source_stamp_lo = (UINT32) stamp;
+	header->entry_count = count;
+	header->table_mask = table_size - 1;
+	header->pool_length = pool_length;
+	memcpy(header->functions, hashfile->functions, sizeof(header->functions));
+
+	/* fill in the entries and hash them on their first available checksum */
+	pool_length = 1;
+	for (i = 0; i < count; i++)
+	{
+		hi = hashfile->preloaded_hashes[i];
+		entries[i].hash = index_add_string(pool, &pool_length, hi->hash);
+		entries[i].longname = index_add_string(pool, &pool_length, hi->longname);
+		entries[i].manufacturer = index_add_string(pool, &pool_length, hi->manufacturer);
+		entries[i].year = index_add_string(pool, &pool_length, hi->year);
+		entries[i].playable = index_add_string(pool, &pool_length, hi->playable);
+		entries[i].extrainfo = index_add_string(pool, &pool_length, hi->extrainfo);
+
+		/* entries without any checksum can never match, so leave them out */
+		for (j = 0; j < sizeof(index_key_functions) / sizeof(index_key_functions[0]); j++)
+			if (hash_key(hi->hash, index_key_functions[j], &entries[i].key))
+				break;
+		if (j == sizeof(index_key_functions) / sizeof(index_key_functions[0]))
+			continue;
+
+		for (slot = entries[i].key & header->table_mask; table[slot]; slot = (slot + 1) & header->table_mask)
+			;
+		table[slot] = i + 1;
+	}
+
+	/* save it for next time if we can tell when it goes stale; failure just
+	 * means that we rebuild it again later */
+	if (stamp != 0)
+	{
+		fname = index_filename(hashfile);
+		if (fname)
+		{
+			filerr = mame_fopen(NULL, fname, OPEN_FLAG_WRITE | OPEN_FLAG_CREATE, &file);
+			if (filerr == FILERR_NONE)
+			{
+				mame_fwrite(file, index, length);
+				mame_fclose(file);
+			}
+			free(fname);
+		}
+	}
+
+	if (!index_attach(hashfile, index, length))
+		free(index);
+
+done:
+	pool_exit(&hashfile->pool);
+	hashfile->pool = pool_save;
+	hashfile->preloaded_hashes = NULL;
+	hashfile->preloaded_hash_count = 0;
+}
+
+
+
+static const struct hash_info *index_lookup(hash_file *hashfile, const char *hash)
+{
+	const struct hash_index_entry *entry;
+	struct hash_info *hi;
+	UINT32 best, key, slot, idx, j;
+
+	/* find the earliest entry that matches on any of our keys; that is the
+	 * one that a scan of the .hsi would have found */
+	best = hashfile->index_header->entry_count;
+	for (j = 0; j < sizeof(index_key_functions) / sizeof(index_key_functions[0]); j++)
+	{
+		if (!hash_key(hash, index_key_functions[j], &key))
+			continue;
+
+		for (slot = key & hashfile->index_header->table_mask; hashfile->index_table[slot]; slot = (slot + 1) & hashfile->index_header->table_mask)
+		{
+			idx = hashfile->index_table[slot] - 1;
+			entry = &hashfile->index_entries[idx];
+			if (idx < best && entry->key == key)
+			{
+				const char *entry_hash = hashfile->index_pool + entry->hash;
+				if (hash_data_is_equal(entry_hash, hash, hash_data_used_functions(entry_hash)) == 1)
+					best = idx;
+			}
+		}
+	}
+	if (best == hashfile->index_header->entry_count)
+		return NULL;
+
+	/* callers hold on to what we return, so each entry is expanded once
+	 * and kept until the hash file is closed */
+	if (!hashfile->index_expanded)
+	{
+		hashfile->index_expanded = pool_malloc(&hashfile->pool,
+			hashfile->index_header->entry_count * sizeof(*hashfile->index_expanded));
+		if (!hashfile->index_expanded)
+			return NULL;
+		memset(hashfile->index_expanded, 0, hashfile->index_header->entry_count * sizeof(*hashfile->index_expanded));
+	}
+	if (hashfile->index_expanded[best])
+		return hashfile->index_expanded[best];
+
+	/* expand the entry */
+	entry = &hashfile->index_entries[best];
+	hi = pool_malloc(&hashfile->pool, sizeof(*hi));
+	if (!hi)
+		return NULL;
+	memset(hi, 0, sizeof(*hi));
+	strcpy(hi->hash, hashfile->index_pool + entry->hash);
+	hi->longname = entry->longname ? hashfile->index_pool + entry->longname : NULL;
+	hi->manufacturer = entry->manufacturer ? hashfile->index_pool + entry->manufacturer : NULL;
+	hi->year = entry->year ? hashfile->index_pool + entry->year : NULL;
+	hi->playable = entry->playable ? hashfile->index_pool + entry->playable : NULL;
+	hi->extrainfo = entry->extrainfo ? hashfile->index_pool + entry->extrainfo : NULL;
+	hashfile->index_expanded[best] = hi;
+	return hi;
+}
+
+
+
+static hash_file *hashfile_open_source(const char *sysname,
 	void (*error_proc)(const char *message))
 {
 	mame_file_error filerr;
 	char *fname;
 	hash_file *hashfile;
-	
+
 	hashfile = malloc(sizeof(struct _hash_file));
 	if (!hashfile)
 		goto error;
@@ -374,9 +729,6 @@ hash_file *hashfile_open(const char *sysname, int is_preload,
 	if (filerr != FILERR_NONE)
 		goto error;
 
-	if (is_preload)
-		hashfile_parse(hashfile, NULL, preload_use_proc, hashfile->error_proc, NULL);
-
 	return hashfile;
 
 error:
@@ -387,9 +739,32 @@ error:
 
 
 
+hash_file *hashfile_open(const char *sysname, int is_preload,
+	void (*error_proc)(const char *message))
+{
+	hash_file *hashfile;
+
+	hashfile = hashfile_open_source(sysname, error_proc);
+	if (!hashfile)
+		return NULL;
+
+	/* use the compiled index, building it if need be */
+	if (!index_load(hashfile))
+		index_build(hashfile);
+
+	if (is_preload && !hashfile->index)
+		hashfile_parse(hashfile, NULL, preload_use_proc, hashfile->error_proc, NULL);
+
+	return hashfile;
+}
+
+
+
 void hashfile_close(hash_file *hashfile)
 {
 	pool_exit(&hashfile->pool);
+	if (hashfile->index)
+		free(hashfile->index);
 	if (hashfile->file)
 		mame_fclose(hashfile->file);
 	free(hashfile);
@@ -427,6 +802,9 @@ const struct hash_info *hashfile_lookup(hash_file *hashfile, const char *hash)
 	struct hashlookup_params param;
 	int i;
 
+	if (hashfile->index)
+		return index_lookup(hashfile, hash);
+
 	param.hash = hash;
 	param.hi = NULL;
 
@@ -455,8 +833,9 @@ unsigned int hashfile_functions_used(hash_file *hashfile, iodevice_t devtype)
 int hashfile_verify(const char *sysname, void (*my_error_proc)(const char *message))
 {
 	hash_file *hashfile;
-	
-	hashfile = hashfile_open(sysname, FALSE, my_error_proc);
+
+	/* just check the syntax; neither load nor build the index */
+	hashfile = hashfile_open_source(sysname, my_error_proc);
 	if (!hashfile)
 		return -1;
 
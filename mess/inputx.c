@@ -961,7 +961,8 @@ void inputx_handle_mess_extensions(input_port_entry *ipt)
 
 const char *inputx_key_name(unicode_char ch)
 {
-	static char buf[2];
+	/* one buffer per character, so that concurrent callers do not collide */
+	static char buf[0x80][2];
 	const char_info *ci;
 	const char *result;
 
@@ -976,9 +977,9 @@ const char *inputx_key_name(unicode_char ch)
 	{
 		if ((ch <= 0x7F) && isprint(ch))
 		{
-			buf[0] = (char) ch;
-			buf[1] = '\0';
-			result = buf;
+			buf[ch][0] = (char) ch;
+			buf[ch][1] = '\0';
+			result = buf[ch];
 		}
 		else
 			result = "???";
@@ -45,6 +45,7 @@ static const options_entry mess_opts[] =
 	{ "min_height;mh",				"200",	0,					"specifies the minimum height for the display" },
 	{ "writeconfig;wc",				"0",	OPTION_BOOLEAN,		"writes configuration to (driver).ini on exit" },
 	{ "skip_warnings",				"0",    OPTION_BOOLEAN,		"skip displaying the warnings screen" },
+	{ "fastcassette;fc",			"0",	OPTION_BOOLEAN,		"run unthrottled while loading from cassette" },
 	{ NULL }
 };
 
@@ -359,6 +360,7 @@ void win_mess_extract_options(void)
 	options.ram = specified_ram;
 	options.min_width = options_get_int("min_width");
 	options.min_height = options_get_int("min_height");
+	options.fast_tape_load = options_get_bool("fastcassette");
 
 	win_task_count = options_get_int("threads");
 	win_use_natural_keyboard = options_get_bool("natural");
@@ -14,16 +14,67 @@
 #include "hash.h"
 #include "audit.h"
 #include "harddisk.h"
+#include "unzip.h"
 #include "sound/samples.h"
 
 
 
+/***************************************************************************
+    CONSTANTS
+***************************************************************************/
+
+/* name of the hash cache file, stored in the cfg directory */
+#define AUDIT_CACHE_FILENAME	"audit.cache"
+
+/* number of hash buckets in the cache */
+#define AUDIT_CACHE_BUCKETS		4096
+
+/* maximum number of drivers audited at once by audit_images_batch */
+#define AUDIT_BATCH_WINDOW		64
+
+
+
+/***************************************************************************
+    TYPE DEFINITIONS
+***************************************************************************/
+
+/* a previously computed hash for a file, valid while its length and stamp match */
+typedef struct _audit_cache_entry audit_cache_entry;
+struct _audit_cache_entry
+{
+	audit_cache_entry *	next;					/* next entry in this bucket */
+	UINT64				stamp;					/* modification stamp of the file */
+	UINT32				length;					/* length of the file */
+	char				hash[HASH_BUF_SIZE];	/* hash data */
+	char				name[1];				/* full path to the file */
+};
+
+
+/* one driver's worth of work for audit_images_batch */
+typedef struct _audit_job audit_job;
+struct _audit_job
+{
+	int					game;					/* index of the driver */
+	UINT32				validation;				/* hashes to validate */
+	int					count;					/* number of records produced */
+	audit_record *		records;				/* the records themselves */
+};
+
+
+
 /***************************************************************************
     GLOBAL VARIABLES
 ***************************************************************************/
 
 static const game_driver *chd_gamedrv;
 
+/* non-NULL while a batch audit is running; guards the cache and CHD interface */
+static osd_lock *audit_lock;
+
+/* hash cache, loaded only for batch audits */
+static audit_cache_entry **audit_cache;
+static int audit_cache_dirty;
+
 
 
 /***************************************************************************
@@ -33,6 +84,13 @@ static const game_driver *chd_gamedrv;
 static int audit_one_rom(const rom_entry *rom, const game_driver *gamedrv, UINT32 validation, audit_record *record);
 static int audit_one_disk(const rom_entry *rom, const game_driver *gamedrv, UINT32 validation, audit_record *record);
 static int rom_used_by_parent(const game_driver *gamedrv, const rom_entry *romentry, const game_driver **parent);
+static void *audit_job_callback(void *param);
+
+static void audit_cache_load(void);
+static void audit_cache_save(void);
+static void audit_cache_free(void);
+static int audit_cache_lookup(mame_file *file, UINT32 validation, char *hash);
+static void audit_cache_store(mame_file *file, const char *hash);
 
 static chd_interface_file *audit_chd_open(const char *filename, const char *mode);
 static void audit_chd_close(chd_interface_file *file);
@@ -73,6 +131,56 @@ INLINE void set_status(audit_record *record, UINT8 status, UINT8 substatus)
 }
 
 
+/*-------------------------------------------------
+    audit_lock_acquire/audit_lock_release -
+    serialize access to shared state during a
+    batch audit
+-------------------------------------------------*/
+
+INLINE void audit_lock_acquire(void)
+{
+	if (audit_lock != NULL)
+		osd_lock_acquire(audit_lock);
+}
+
+INLINE void audit_lock_release(void)
+{
+	if (audit_lock != NULL)
+		osd_lock_release(audit_lock);
+}
+
+
+/*-------------------------------------------------
+    audit_get_clone - driver_get_clone under the
+    audit lock, since looking up a driver updates
+    the shared driver LRU
+-------------------------------------------------*/
+
+INLINE const game_driver *audit_get_clone(const game_driver *driver)
+{
+	const game_driver *clone;
+
+	audit_lock_acquire();
+	clone = driver_get_clone(driver);
+	audit_lock_release();
+	return clone;
+}
+
+
+/*-------------------------------------------------
+    cache_bucket - compute the cache bucket for
+    a full path
+-------------------------------------------------*/
+
+INLINE UINT32 cache_bucket(const char *name)
+{
+	UINT32 hash = 0;
+	while (*name != 0)
+		hash = (hash * 31) + (UINT8)*name++;
+	return hash % AUDIT_CACHE_BUCKETS;
+}
+
+
 
 /***************************************************************************
     CORE FUNCTIONS
@@ -143,6 +251,69 @@ int audit_images(int game, UINT32 validation, audit_record **audit)
 }
 
 
+/*-------------------------------------------------
+    audit_images_batch - validate the ROM and disk
+    images for a list of games, spreading the work
+    across worker threads; the callback is invoked
+    for each game in list order on the calling
+    thread, and owns the records passed to it
+-------------------------------------------------*/
+
+void audit_images_batch(const int *games, int numgames, UINT32 validation, audit_batch_callback callback, void *param)
+{
+	osd_work_item *items[AUDIT_BATCH_WINDOW];
+	audit_job jobs[AUDIT_BATCH_WINDOW];
+	osd_work_queue *queue;
+	int submitted = 0;
+	int completed;
+
+	/* start from an empty ZIP cache; this also creates its lock before any workers exist */
+	zip_file_cache_clear();
+
+	/* set up the shared state */
+	audit_lock = osd_lock_alloc();
+	audit_cache_load();
+	queue = osd_work_queue_alloc(WORK_QUEUE_FLAG_IO | WORK_QUEUE_FLAG_MULTI);
+
+	for (completed = 0; completed < numgames; completed++)
+	{
+		int slot = completed % AUDIT_BATCH_WINDOW;
+
+		/* keep the window full */
+		for ( ; submitted < numgames && submitted < completed + AUDIT_BATCH_WINDOW; submitted++)
+		{
+			audit_job *job = &jobs[submitted % AUDIT_BATCH_WINDOW];
+
+			job->game = games[submitted];
+			job->validation = validation;
+			job->count = 0;
+			job->records = NULL;
+
+			/* if we can't queue the item, just do the work here */
+			items[submitted % AUDIT_BATCH_WINDOW] = (queue != NULL) ? osd_work_item_queue(queue, audit_job_callback, job) : NULL;
+			if (items[submitted % AUDIT_BATCH_WINDOW] == NULL)
+				audit_job_callback(job);
+		}
+
+		/* wait for the oldest game and report it */
+		if (items[slot] != NULL)
+		{
+			while (!osd_work_item_wait(items[slot], osd_ticks_per_second())) ;
+			osd_work_item_release(items[slot]);
+		}
+		(*callback)(jobs[slot].game, jobs[slot].count, jobs[slot].records, param);
+	}
+
+	/* tear down and remember what we learned */
+	if (queue != NULL)
+		osd_work_queue_free(queue);
+	audit_cache_save();
+	audit_cache_free();
+	osd_lock_free(audit_lock);
+	audit_lock = NULL;
+}
+
+
 /*-------------------------------------------------
     audit_samples - validate the samples for a
     game
@@ -362,7 +533,7 @@ static int audit_one_rom(const rom_entry *rom, const game_driver *gamedrv, UINT3
 		crc = (crcs[0] << 24) | (crcs[1] << 16) | (crcs[2] << 8) | crcs[3];
 
 	/* find the file and checksum it, getting the file length along the way */
-	for (drv = gamedrv; drv != NULL; drv = driver_get_clone(drv))
+	for (drv = gamedrv; drv != NULL; drv = audit_get_clone(drv))
 	{
 		mame_file_error filerr;
 		mame_file *file;
@@ -376,10 +547,14 @@ static int audit_one_rom(const rom_entry *rom, const game_driver *gamedrv, UINT3
 			filerr = mame_fopen(SEARCHPATH_ROM, fname, OPEN_FLAG_READ, &file);
 		free(fname);
 
-		/* if we got it, extract the hash and length */
+		/* if we got it, extract the hash and length, avoiding a re-read if we can */
 		if (filerr == FILERR_NONE)
 		{
-			hash_data_copy(record->hash, mame_fhash(file, validation));
+			if (!audit_cache_lookup(file, validation, record->hash))
+			{
+				hash_data_copy(record->hash, mame_fhash(file, validation));
+				audit_cache_store(file, record->hash);
+			}
 			record->length = (UINT32)mame_fsize(file);
 			mame_fclose(file);
 			break;
@@ -451,7 +626,8 @@ static int audit_one_disk(const rom_entry *rom, const game_driver *gamedrv, UINT
 	record->name = ROM_GETNAME(rom);
 	record->exphash = ROM_GETHASHDATA(rom);
 
-	/* open the disk */
+	/* open the disk; the CHD interface is global, so only one thread may do this at a time */
+	audit_lock_acquire();
 	chd_gamedrv = gamedrv;
 	chd_set_interface(&audit_chd_interface);
 	err = open_disk_image(gamedrv, rom, &source);
@@ -498,6 +674,7 @@ static int audit_one_disk(const rom_entry *rom, const game_driver *gamedrv, UINT
 
 		chd_close(source);
 	}
+	audit_lock_release();
 
 	/* return TRUE if we found anything at all */
 	return (source != NULL);
@@ -515,7 +692,7 @@ static int rom_used_by_parent(const game_driver *gamedrv, const rom_entry *romen
 	const game_driver *drv;
 
 	/* iterate up the parent chain */
-	for (drv = driver_get_clone(gamedrv); drv != NULL; drv = driver_get_clone(drv))
+	for (drv = audit_get_clone(gamedrv); drv != NULL; drv = audit_get_clone(drv))
 	{
 		const rom_entry *region;
 		const rom_entry *rom;
@@ -536,6 +713,206 @@ static int rom_used_by_parent(const game_driver *gamedrv, const rom_entry *romen
 
 
 
+/*-------------------------------------------------
+    audit_job_callback - audit one game on
+    behalf of audit_images_batch
+-------------------------------------------------*/
+
+static void *audit_job_callback(void *param)
+{
+	audit_job *job = param;
+	job->count = audit_images(job->game, job->validation, &job->records);
+	return NULL;
+}
+
+
+
+/***************************************************************************
+    HASH CACHE
+***************************************************************************/
+
+/*-------------------------------------------------
+    audit_cache_load - read the hash cache from
+    the cfg directory; each line holds the stamp,
+    length, hash data and full path of one file
+-------------------------------------------------*/
+
+static void audit_cache_load(void)
+{
+	mame_file_error filerr;
+	mame_file *file;
+	char line[1024];
+
+	audit_cache = malloc_or_die(sizeof(*audit_cache) * AUDIT_CACHE_BUCKETS);
+	memset(audit_cache, 0, sizeof(*audit_cache) * AUDIT_CACHE_BUCKETS);
+	audit_cache_dirty = FALSE;
+
+	/* a missing cache is not an error */
+	filerr = mame_fopen(SEARCHPATH_CONFIG, AUDIT_CACHE_FILENAME, OPEN_FLAG_READ, &file);
+	if (filerr != FILERR_NONE)
+		return;
+
+	while (mame_fgets(line, ARRAY_LENGTH(line), file) != NULL)
+	{
+		char hash[HASH_BUF_SIZE];
+		audit_cache_entry *entry;
+		UINT32 stamphi, stamplo, length, bucket;
+		int nameoffs = 0;
+		char *eol;
+
+		/* skip anything we can't parse */
+		if (sscanf(line, "%8x%8x %u %255s %n", &stamphi, &stamplo, &length, hash, &nameoffs) != 4 || nameoffs == 0)
+			continue;
+		if (!hash_verify_string(hash))
+			continue;
+
+		/* trim the end of line */
+		for (eol = &line[nameoffs]; *eol != 0 && *eol != '\r' && *eol != '\n'; eol++) ;
+		*eol = 0;
+
+		/* add it to the table */
+		entry = malloc_or_die(sizeof(*entry) + strlen(&line[nameoffs]));
+		entry->stamp = ((UINT64)stamphi << 32) | stamplo;
+		entry->length = length;
+		strcpy(entry->hash, hash);
+		strcpy(entry->name, &line[nameoffs]);
+		bucket = cache_bucket(entry->name);
+		entry->next = audit_cache[bucket];
+		audit_cache[bucket] = entry;
+	}
+	mame_fclose(file);
+}
+
+
+/*-------------------------------------------------
+    audit_cache_save - write the hash cache back
+    out if anything changed
+-------------------------------------------------*/
+
+static void audit_cache_save(void)
+{
+	mame_file_error filerr;
+	mame_file *file;
+	int bucket;
+
+	if (audit_cache == NULL || !audit_cache_dirty)
+		return;
+
+	filerr = mame_fopen(SEARCHPATH_CONFIG, AUDIT_CACHE_FILENAME, OPEN_FLAG_WRITE | OPEN_FLAG_CREATE | OPEN_FLAG_CREATE_PATHS, &file);
+	if (filerr != FILERR_NONE)
+		return;
+
+	for (bucket = 0; bucket < AUDIT_CACHE_BUCKETS; bucket++)
+	{
+		audit_cache_entry *entry;
+
+		for (entry = audit_cache[bucket]; entry != NULL; entry = entry->next)
+			mame_fprintf(file, "%08X%08X %u %s %s\n", (UINT32)(entry->stamp >> 32), (UINT32)entry->stamp, entry->length, entry->hash, entry->name);
+	}
+	mame_fclose(file);
+	audit_cache_dirty = FALSE;
+}
+
+
+/*-------------------------------------------------
+    audit_cache_free - release the hash cache
+-------------------------------------------------*/
+
+static void audit_cache_free(void)
+{
+	int bucket;
+
+	if (audit_cache == NULL)
+		return;
+
+	for (bucket = 0; bucket < AUDIT_CACHE_BUCKETS; bucket++)
+		while (audit_cache[bucket] != NULL)
+		{
+			audit_cache_entry *entry = audit_cache[bucket];
+			audit_cache[bucket] = entry->next;
+			free(entry);
+		}
+	free(audit_cache);
+	audit_cache = NULL;
+}
+
+
+/*-------------------------------------------------
+    audit_cache_lookup - look up the hash for an
+    open file; returns TRUE and fills in the hash
+    if we have one with all the requested
+    functions
+-------------------------------------------------*/
+
+static int audit_cache_lookup(mame_file *file, UINT32 validation, char *hash)
+{
+	const char *name = mame_file_full_name(file);
+	UINT64 stamp = mame_fstamp(file);
+	audit_cache_entry *entry;
+	int found = FALSE;
+
+	/* without a stamp we can't know whether the file changed */
+	if (audit_cache == NULL || stamp == 0)
+		return FALSE;
+
+	audit_lock_acquire();
+	for (entry = audit_cache[cache_bucket(name)]; entry != NULL; entry = entry->next)
+		if (strcmp(entry->name, name) == 0)
+		{
+			if (entry->stamp == stamp && entry->length == mame_fsize(file) &&
+				(hash_data_used_functions(entry->hash) & validation) == validation)
+			{
+				hash_data_copy(hash, entry->hash);
+				found = TRUE;
+			}
+			break;
+		}
+	audit_lock_release();
+	return found;
+}
+
+
+/*-------------------------------------------------
+    audit_cache_store - remember the hash for an
+    open file
+-------------------------------------------------*/
+
+static void audit_cache_store(mame_file *file, const char *hash)
+{
+	const char *name = mame_file_full_name(file);
+	UINT64 stamp = mame_fstamp(file);
+	audit_cache_entry *entry;
+	UINT32 bucket;
+
+	if (audit_cache == NULL || stamp == 0)
+		return;
+	bucket = cache_bucket(name);
+
+	audit_lock_acquire();
+
+	/* find an existing entry, or create a new one */
+	for (entry = audit_cache[bucket]; entry != NULL; entry = entry->next)
+		if (strcmp(entry->name, name) == 0)
+			break;
+	if (entry == NULL)
+	{
+		entry = malloc_or_die(sizeof(*entry) + strlen(name));
+		strcpy(entry->name, name);
+		entry->next = audit_cache[bucket];
+		audit_cache[bucket] = entry;
+	}
+
+	/* update it */
+	entry->stamp = stamp;
+	entry->length = (UINT32)mame_fsize(file);
+	hash_data_copy(entry->hash, hash);
+	audit_cache_dirty = TRUE;
+
+	audit_lock_release();
+}
+
+
+
 /***************************************************************************
     CHD INTERFACES
 ***************************************************************************/
@@ -549,7 +926,7 @@ static chd_interface_file *audit_chd_open(const char *filename, const char *mode
 {
 	const game_driver *drv;
 
-	/* attempt reading up the chain through the parents */
+	/* attempt reading up the chain through the parents; audit_one_disk holds the audit lock */
 	for (drv = chd_gamedrv; drv != NULL; drv = driver_get_clone(drv))
 	{
 		mame_file_error filerr;
@@ -78,11 +78,17 @@ struct _audit_record
 
 
 
+/* callback for audit_images_batch; called in order on the calling thread */
+typedef void (*audit_batch_callback)(int game, int count, audit_record *records, void *param);
+
+
+
 /***************************************************************************
     FUNCTION PROTOTYPES
 ***************************************************************************/
 
 int audit_images(int game, UINT32 validation, audit_record **audit);
+void audit_images_batch(const int *games, int numgames, UINT32 validation, audit_batch_callback callback, void *param);
 int audit_samples(int game, audit_record **audit);
 int audit_summary(int game, int count, const audit_record *records, int output);
 
@@ -32,6 +32,7 @@ COREOBJS = \
 	$(OBJ)/hash.o \
 	$(OBJ)/info.o \
 	$(OBJ)/input.o \
+	$(OBJ)/inplog.o \
 	$(OBJ)/inptport.o \
 	$(OBJ)/jedparse.o \
 	$(OBJ)/mame.o \
@@ -69,6 +70,7 @@ COREOBJS = \
 	$(OBJ)/sound/flt_vol.o \
 	$(OBJ)/sound/flt_rc.o \
 	$(OBJ)/sound/wavwrite.o \
+	$(OBJ)/machine/cryptcache.o \
 	$(OBJ)/machine/eeprom.o \
 	$(OBJ)/machine/generic.o \
 	$(OBJ)/sndhrdw/generic.o \
@@ -139,4 +141,4 @@ endif
 # set of tool targets
 #-------------------------------------------------
 
-TOOLS += romcmp$(EXE) chdman$(EXE) jedutil$(EXE) file2str$(EXE)
+TOOLS += romcmp$(EXE) chdman$(EXE) jedutil$(EXE) file2str$(EXE) voodprof$(EXE)
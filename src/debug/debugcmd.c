@@ -63,6 +63,7 @@ static void execute_logerror(int ref, int params, const char **param);
 static void execute_tracelog(int ref, int params, const char **param);
 static void execute_quit(int ref, int params, const char **param);
 static void execute_do(int ref, int params, const char **param);
+static void execute_exprbench(int ref, int params, const char **param);
 static void execute_step(int ref, int params, const char **param);
 static void execute_over(int ref, int params, const char **param);
 static void execute_out(int ref, int params, const char **param);
@@ -86,12 +87,18 @@ static void execute_wpclear(int ref, int params, const char **param);
 static void execute_wpdisenable(int ref, int params, const char **param);
 static void execute_wplist(int ref, int params, const char **param);
 static void execute_hotspot(int ref, int params, const char **param);
+static void execute_profile(int ref, int params, const char **param);
+#ifdef MEMORY_PROFILE
+static void execute_memprofile(int ref, int params, const char **param);
+#endif
 static void execute_save(int ref, int params, const char **param);
 static void execute_dump(int ref, int params, const char **param);
 static void execute_dasm(int ref, int params, const char **param);
 static void execute_find(int ref, int params, const char **param);
 static void execute_trace(int ref, int params, const char **param);
 static void execute_traceover(int ref, int params, const char **param);
+static void execute_tracebin(int ref, int params, const char **param);
+static void execute_tracedasm(int ref, int params, const char **param);
 static void execute_traceflush(int ref, int params, const char **param);
 static void execute_history(int ref, int params, const char **param);
 static void execute_snap(int ref, int params, const char **param);
@@ -153,6 +160,7 @@ void debug_command_init(running_machine *machine)
 	debug_console_register_command("tracelog",  CMDFLAG_NONE, 0, 1, MAX_COMMAND_PARAMS, execute_tracelog);
 	debug_console_register_command("quit",      CMDFLAG_NONE, 0, 0, 0, execute_quit);
 	debug_console_register_command("do",        CMDFLAG_NONE, 0, 1, 1, execute_do);
+	debug_console_register_command("exprbench", CMDFLAG_NONE, 0, 1, 2, execute_exprbench);
 	debug_console_register_command("step",      CMDFLAG_NONE, 0, 0, 1, execute_step);
 	debug_console_register_command("s",         CMDFLAG_NONE, 0, 0, 1, execute_step);
 	debug_console_register_command("over",      CMDFLAG_NONE, 0, 0, 1, execute_over);
@@ -196,6 +204,10 @@ void debug_command_init(running_machine *machine)
 	debug_console_register_command("wplist",    CMDFLAG_NONE, 0, 0, 0, execute_wplist);
 
 	debug_console_register_command("hotspot",   CMDFLAG_NONE, 0, 0, 3, execute_hotspot);
+	debug_console_register_command("profile",   CMDFLAG_NONE, 0, 1, 4, execute_profile);
+#ifdef MEMORY_PROFILE
+	debug_console_register_command("memprofile", CMDFLAG_NONE, 0, 0, 1, execute_memprofile);
+#endif
 
 	debug_console_register_command("save",      CMDFLAG_NONE, ADDRESS_SPACE_PROGRAM, 3, 4, execute_save);
 	debug_console_register_command("saved",     CMDFLAG_NONE, ADDRESS_SPACE_DATA, 3, 4, execute_save);
@@ -216,6 +228,8 @@ void debug_command_init(running_machine *machine)
 
 	debug_console_register_command("trace",     CMDFLAG_NONE, 0, 1, 3, execute_trace);
 	debug_console_register_command("traceover", CMDFLAG_NONE, 0, 1, 3, execute_traceover);
+	debug_console_register_command("tracebin",  CMDFLAG_NONE, 0, 1, 4, execute_tracebin);
+	debug_console_register_command("tracedasm", CMDFLAG_NONE, 0, 2, 3, execute_tracedasm);
 	debug_console_register_command("traceflush",CMDFLAG_NONE, 0, 0, 0, execute_traceflush);
 
 	debug_console_register_command("history",   CMDFLAG_NONE, 0, 0, 2, execute_history);
@@ -624,6 +638,59 @@ static void execute_do(int ref, int params, const char *param[])
 }
 
 
+/*-------------------------------------------------
+    execute_exprbench - execute the exprbench
+    command
+-------------------------------------------------*/
+
+static void execute_exprbench(int ref, int params, const char *param[])
+{
+	UINT64 count = 1000000, index, interpreted = 0, compiled = 0;
+	osd_ticks_t start, interpreted_ticks, compiled_ticks, tps;
+	EXPRERR interpreted_err = EXPRERR_NONE, compiled_err = EXPRERR_NONE;
+	parsed_expression *expr;
+	double nsec_per_tick;
+
+	/* validate parameters */
+	if (params > 1 && !validate_parameter_number(param[1], &count))
+		return;
+	if (!validate_parameter_expression(param[0], &expr))
+		return;
+	if (count == 0)
+		count = 1;
+
+	/* time the interpreter */
+	start = osd_ticks();
+	for (index = 0; index < count; index++)
+		interpreted_err = expression_execute_interpreted(expr, &interpreted);
+	interpreted_ticks = osd_ticks() - start;
+
+	/* then the compiled code, which is the interpreter again if the expression couldn't be compiled */
+	start = osd_ticks();
+	for (index = 0; index < count; index++)
+		compiled_err = expression_execute(expr, &compiled);
+	compiled_ticks = osd_ticks() - start;
+
+	/* report the results */
+	tps = osd_ticks_per_second();
+	nsec_per_tick = 1000000000.0 / (double)tps / (double)(INT64)count;
+	debug_console_printf("Interpreted: %.1f ns per evaluation\n", (double)interpreted_ticks * nsec_per_tick);
+	if (!expression_is_compiled(expr))
+		debug_console_printf("Compiled: not available; the expression uses operators that are only interpreted\n");
+	else
+	{
+		debug_console_printf("Compiled: %.1f ns per evaluation", (double)compiled_ticks * nsec_per_tick);
+		if (compiled_ticks != 0)
+			debug_console_printf(" (%.1fx)", (double)interpreted_ticks / (double)compiled_ticks);
+		debug_console_printf("\n");
+	}
+	if (interpreted_err != compiled_err || interpreted != compiled)
+		debug_console_printf("Warning: results differ (%X%08X vs %X%08X)\n",
+				(UINT32)(interpreted >> 32), (UINT32)interpreted, (UINT32)(compiled >> 32), (UINT32)compiled);
+	expression_free(expr);
+}
+
+
 /*-------------------------------------------------
     execute_step - execute the step command
 -------------------------------------------------*/
@@ -1361,6 +1428,114 @@ static void execute_hotspot(int ref, int params, const char *param[])
 }
 
 
+/*-------------------------------------------------
+    execute_profile - execute the profile command
+-------------------------------------------------*/
+
+static void execute_profile(int ref, int params, const char *param[])
+{
+	const char *filename = param[0];
+	UINT64 cpunum, interval = 1000, granularity = 4;
+	FILE *f = NULL;
+
+	cpunum = cpu_getactivecpu();
+
+	/* validate parameters */
+	if (params > 1 && !validate_parameter_number(param[1], &cpunum))
+		return;
+	if (params > 2 && !validate_parameter_number(param[2], &interval))
+		return;
+	if (params > 3 && !validate_parameter_number(param[3], &granularity))
+		return;
+
+	/* further validation */
+	if (!mame_stricmp(filename, "off"))
+		filename = NULL;
+	if (cpunum >= cpu_gettotalcpu())
+	{
+		debug_console_printf("Invalid CPU number!\n");
+		return;
+	}
+	if (interval == 0 || interval > 0xffffffff || granularity > 31)
+	{
+		debug_console_printf("Invalid interval or granularity!\n");
+		return;
+	}
+
+	/* open the file */
+	if (filename)
+	{
+		f = fopen(filename, "w");
+		if (!f)
+		{
+			debug_console_printf("Error opening file '%s'\n", param[0]);
+			return;
+		}
+	}
+
+	/* do it */
+	debug_cpu_profile(cpunum, f, interval, granularity);
+	if (f)
+		debug_console_printf("Profiling CPU %d every %d cycles; report goes to %s\n", (int)cpunum, (int)interval, filename);
+	else
+		debug_console_printf("Stopped profiling CPU %d\n", (int)cpunum);
+}
+
+
+#ifdef MEMORY_PROFILE
+/*-------------------------------------------------
+    execute_memprofile - execute the memprofile
+    command
+-------------------------------------------------*/
+
+static void execute_memprofile(int ref, int params, const char *param[])
+{
+	memory_handler_stats *stats;
+	UINT64 maxcount = 20;
+	INT64 total = 0;
+	int count, index, caller;
+
+	/* reset clears the statistics */
+	if (params > 0 && !mame_stricmp(param[0], "reset"))
+	{
+		memory_profile_reset();
+		debug_console_printf("Cleared memory handler statistics\n");
+		return;
+	}
+
+	/* validate parameters */
+	if (params > 0 && !validate_parameter_number(param[0], &maxcount))
+		return;
+
+	stats = malloc_or_die(sizeof(*stats) * MEMORY_PROFILE_MAX_HANDLERS);
+	count = memory_profile_get_stats(stats, MEMORY_PROFILE_MAX_HANDLERS);
+	for (index = 0; index < count; index++)
+		total += stats[index].ticks;
+
+	if (count == 0)
+		debug_console_printf("No memory handlers have been called\n");
+	else
+		debug_console_printf("%-24s rw %12s %6s %10s  top callers\n", "handler", "calls", "time", "ticks/call");
+	for (index = 0; index < count && index < maxcount; index++)
+	{
+		char buffer[256];
+		char *dest = buffer;
+
+		dest += sprintf(dest, "%-24s %s  %12.0f %5.2f%% %10.1f ",
+				stats[index].name, stats[index].iswrite ? "w" : "r",
+				(double)stats[index].calls,
+				total ? (double)stats[index].ticks * 100.0 / (double)total : 0.0,
+				(double)stats[index].ticks / (double)stats[index].calls);
+		for (caller = 0; caller < MEMORY_PROFILE_CALLERS; caller++)
+			if (stats[index].caller[caller].count != 0)
+				dest += sprintf(dest, " %d:%X", stats[index].caller[caller].cpunum, stats[index].caller[caller].pc);
+		debug_console_printf("%s\n", buffer);
+	}
+	free(stats);
+}
+#endif
+
+
 /*-------------------------------------------------
     execute_save - execute the save command
 -------------------------------------------------*/
@@ -1908,6 +2083,102 @@ static void execute_traceover(int ref, int params, const char *param[])
 }
 
 
+/*-------------------------------------------------
+    execute_tracebin - execute the binary trace
+    command
+-------------------------------------------------*/
+
+static void execute_tracebin(int ref, int params, const char *param[])
+{
+	const char *action = NULL, *filename = param[0];
+	UINT64 cpunum, registers = 0;
+	FILE *f = NULL;
+
+	cpunum = cpu_getactivecpu();
+
+	/* validate parameters */
+	if (params > 1 && !validate_parameter_number(param[1], &cpunum))
+		return;
+	if (params > 2 && !validate_parameter_number(param[2], &registers))
+		return;
+	if (params > 3 && !validate_parameter_command(action = param[3]))
+		return;
+
+	/* further validation */
+	if (!mame_stricmp(filename, "off"))
+		filename = NULL;
+	if (cpunum >= cpu_gettotalcpu())
+	{
+		debug_console_printf("Invalid CPU number!\n");
+		return;
+	}
+
+	/* open the file; each binary trace has its own header, so they can't be appended */
+	if (filename)
+	{
+		f = fopen(filename, "wb");
+		if (!f)
+		{
+			debug_console_printf("Error opening file '%s'\n", param[0]);
+			return;
+		}
+	}
+
+	/* do it */
+	debug_cpu_trace_binary(cpunum, f, 0, (registers != 0), action);
+	if (f)
+		debug_console_printf("Tracing CPU %d to binary file %s\n", (int)cpunum, filename);
+	else
+		debug_console_printf("Stopped tracing on CPU %d\n", (int)cpunum);
+}
+
+
+/*-------------------------------------------------
+    execute_tracedasm - execute the trace
+    disassemble command
+-------------------------------------------------*/
+
+static void execute_tracedasm(int ref, int params, const char *param[])
+{
+	UINT64 cpunum;
+	FILE *src, *dst;
+	int count;
+
+	cpunum = cpu_getactivecpu();
+
+	/* validate parameters */
+	if (params > 2 && !validate_parameter_number(param[2], &cpunum))
+		return;
+	if (cpunum >= cpu_gettotalcpu())
+	{
+		debug_console_printf("Invalid CPU number!\n");
+		return;
+	}
+
+	/* open the files */
+	src = fopen(param[0], "rb");
+	if (!src)
+	{
+		debug_console_printf("Error opening file '%s'\n", param[0]);
+		return;
+	}
+	dst = fopen(param[1], "w");
+	if (!dst)
+	{
+		fclose(src);
+		debug_console_printf("Error opening file '%s'\n", param[1]);
+		return;
+	}
+
+	/* do it */
+	count = debug_cpu_trace_disassemble(cpunum, src, dst);
+	fclose(src);
+	fclose(dst);
+	if (count >= 0)
+		debug_console_printf("Disassembled %d instructions to %s\n", count, param[1]);
+}
+
+
 /*-------------------------------------------------
     execute_traceflush - execute the trace flush command
 -------------------------------------------------*/
@@ -256,6 +256,34 @@ const char *debug_comment_get_text(int cpu_num, offs_t addr, UINT32 c_crc)
 }
 
 
+/*-------------------------------------------------------------------------
+    debug_comment_get_preceding_text - returns the closest comment at or
+                        before a given address, whatever its crc, and
+                        the address it is attached to
+-------------------------------------------------------------------------*/
+
+const char *debug_comment_get_preceding_text(int cpu_num, offs_t addr, offs_t *comment_addr)
+{
+	int low = 0, high = debug_comments[cpu_num].comment_count;
+
+	/* the list is sorted by address, so find the last comment not past addr */
+	while (low < high)
+	{
+		int mid = (low + high) / 2;
+		if (debug_comments[cpu_num].comment_info[mid]->address <= addr)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+
+	if (low == 0)
+		return NULL;
+
+	*comment_addr = debug_comments[cpu_num].comment_info[low - 1]->address;
+	return debug_comments[cpu_num].comment_info[low - 1]->text;
+}
+
+
 /*-------------------------------------------------------------------------
     debug_comment_get_count - returns the number of comments
     for a given cpu number
@@ -30,6 +30,7 @@ int debug_comment_add(int cpu_num, offs_t addr, const char *comment, rgb_t color
 int debug_comment_remove(int cpu_num, offs_t addr, UINT32 c_crc);
 
 const char *debug_comment_get_text(int cpu_num, offs_t addr, UINT32 c_crc);
+const char *debug_comment_get_preceding_text(int cpu_num, offs_t addr, offs_t *comment_addr);
 int debug_comment_get_count(int cpu_num);
 UINT32 debug_comment_get_change_count(int cpu_num);
 UINT32 debug_comment_all_change_count(void);
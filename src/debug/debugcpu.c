@@ -27,12 +27,116 @@
 
 #define NUM_TEMP_VARIABLES	10
 
+/* binary traces are collected in a ring of chunks, written out by a worker thread */
+#define TRACE_CHUNKS		16
+#define TRACE_CHUNK_SIZE	(1024 * 1024)
+#define TRACE_MAX_REGS		64
+#define TRACE_MAX_TEXT		1024
+
+/* largest record we ever reserve space for */
+#define TRACE_MAX_RECORD	(16 + 2 * 64 + 1 + TRACE_MAX_REGS * 9)
+
+/*
+    Binary trace files start with a header:
+
+        8 bytes     "MAMETRC" followed by a version byte (TRACE_VERSION)
+        32 bytes    CPU name, NUL padded
+        1 byte      opcode bytes recorded per instruction
+        1 byte      number of registers tracked
+        16 bytes    name of each register, NUL padded
+
+    followed by records, each starting with a TRACE_RECORD_* byte. All values
+    are little-endian.
+
+        INSTRUCTION 1 byte flags (TRACE_FLAG_*), 4 bytes PC, 4 bytes cycles
+                    since the previous instruction, the opcode bytes, the
+                    argument bytes if they differ, then if any registers
+                    changed, a count byte and that many index bytes, each
+                    followed by 8 bytes of new value
+        LOOP        4 bytes count of instructions collapsed into a loop
+        TEXT        2 bytes length, then that many characters of tracelog
+                    output
+*/
+#define TRACE_VERSION		1
+
+enum
+{
+	TRACE_RECORD_INSTRUCTION = 1,
+	TRACE_RECORD_LOOP,
+	TRACE_RECORD_TEXT
+};
+
+#define TRACE_FLAG_SPLIT_ARGS	0x01			/* argument bytes differ from the opcode bytes */
+#define TRACE_FLAG_REGISTERS	0x02			/* register changes follow */
+
+/* PC profiles start with 1 << this many buckets, and double in size when half full */
+#define PROFILE_INITIAL_BITS	12
+
+/* most lines in each section of a profile report */
+#define PROFILE_REPORT_LINES	100
+
 
 
 /***************************************************************************
     TYPE DEFINITIONS
 ***************************************************************************/
 
+typedef struct _trace_chunk trace_chunk;
+struct _trace_chunk
+{
+	FILE *			file;						/* file to write to */
+	UINT8 *			data;						/* chunk data */
+	UINT32			length;						/* bytes used */
+	osd_work_item *	item;						/* pending write */
+};
+
+
+typedef struct _profile_bucket profile_bucket;
+struct _profile_bucket
+{
+	offs_t			base;						/* first address in the bucket */
+	UINT32			count;						/* samples in the bucket (0 = unused) */
+};
+
+
+typedef struct _profile_group profile_group;
+struct _profile_group
+{
+	offs_t			address;					/* address of the comment naming the group */
+	const char *	text;						/* comment text, or NULL if none */
+	UINT32			count;						/* samples in the group */
+};
+
+
+/* typedef struct _debug_profile_info debug_profile_info -- defined in debugcpu.h */
+struct _debug_profile_info
+{
+	FILE *			file;						/* file for the report */
+	UINT32			interval;					/* cycles between samples */
+	int				granularity;				/* log2 of the addresses per bucket */
+	UINT64			nextsample;					/* total cycles at the next sample */
+	offs_t			lastpc;						/* PC of the instruction in flight */
+	UINT32			samples;					/* total samples taken */
+	UINT32			used;						/* buckets in use */
+	int				bits;						/* log2 of the number of buckets */
+	UINT32			mask;						/* number of buckets - 1 */
+	profile_bucket *bucket;						/* hash table of buckets */
+};
+
+
+/* typedef struct _debug_trace_buffer debug_trace_buffer -- defined in debugcpu.h */
+struct _debug_trace_buffer
+{
+	osd_work_queue *queue;						/* queue for the writer thread */
+	trace_chunk		chunk[TRACE_CHUNKS];		/* ring of chunks */
+	int				curchunk;					/* chunk being filled */
+	UINT8			opbytes;					/* opcode bytes recorded per instruction */
+	UINT8			regcount;					/* number of registers tracked */
+	int				regnum[TRACE_MAX_REGS];		/* CPU register number of each */
+	UINT64			regvalue[TRACE_MAX_REGS];	/* last recorded value of each */
+	UINT64			lastcycles;					/* total cycles at the last instruction */
+};
+
 
 
 /***************************************************************************
@@ -78,6 +182,10 @@ static UINT64 tempvar[NUM_TEMP_VARIABLES];
 ***************************************************************************/
 
 static void debug_cpu_exit(running_machine *machine);
+static void debug_profile_exit(running_machine *machine);
+static void profile_sample(debug_profile_info *profile, UINT64 cycles);
+static void trace_binary_free(debug_trace_buffer *trace);
+static void trace_binary_flush(debug_trace_buffer *trace);
 static void perform_trace(debug_cpu_info *info);
 static void prepare_for_step_overout(void);
 static void process_source_file(void);
@@ -99,6 +207,55 @@ static void check_hotspots(int cpunum, int spacenum, offs_t address);
 
 
 
+/***************************************************************************
+    INLINE FUNCTIONS
+***************************************************************************/
+
+/*-------------------------------------------------
+    breakpoint_hash - hash a breakpoint address;
+    the top bits pick the filter bit and the
+    hash bucket
+-------------------------------------------------*/
+
+INLINE UINT32 breakpoint_hash(offs_t address)
+{
+	return address * 0x9e3779b1;
+}
+
+
+/*-------------------------------------------------
+    breakpoint_filter_hit - return TRUE if an
+    enabled breakpoint might be set at the given
+    address
+-------------------------------------------------*/
+
+INLINE int breakpoint_filter_hit(const debug_cpu_info *info, offs_t address)
+{
+	UINT32 bit = breakpoint_hash(address) >> (32 - BREAKPOINT_FILTER_BITS);
+	return (info->bp_filter[bit / 32] >> (bit % 32)) & 1;
+}
+
+
+/*-------------------------------------------------
+    watchpoint_map_hit - return TRUE if an access
+    touches a page with an enabled watchpoint
+-------------------------------------------------*/
+
+INLINE int watchpoint_map_hit(const debug_space_info *space, offs_t address, int size)
+{
+	offs_t first, last;
+
+	if (space->wpmap == NULL)
+		return FALSE;
+
+	/* accesses are small enough to span at most two pages */
+	first = (address & space->logbytemask) >> space->wpmapshift;
+	last = ((address + size - 1) & space->logbytemask) >> space->wpmapshift;
+	return ((space->wpmap[first / 32] >> (first % 32)) & 1) || ((space->wpmap[last / 32] >> (last % 32)) & 1);
+}
+
+
+
 /***************************************************************************
     FRONTENDS FOR OLDER FUNCTIONS
 ***************************************************************************/
@@ -116,6 +273,9 @@ void mame_debug_init(running_machine *machine)
 	debug_view_init(machine);
 	debug_comment_init(machine);
 	atexit(debug_flush_traces);
+
+	/* registered last so that profiles are reported before the comments they use are freed */
+	add_exit_callback(machine, debug_profile_exit);
 	add_logerror_callback(machine, debug_errorlog_write_line);
 }
 
@@ -296,6 +456,9 @@ static void debug_cpu_exit(running_machine *machine)
 	for (cpunum = 0; cpunum < MAX_CPU; cpunum++)
 	{
 		/* close any tracefiles */
+		if (debug_cpuinfo[cpunum].trace.binary)
+			trace_binary_free(debug_cpuinfo[cpunum].trace.binary);
+		debug_cpuinfo[cpunum].trace.binary = NULL;
 		if (debug_cpuinfo[cpunum].trace.file)
 			fclose(debug_cpuinfo[cpunum].trace.file);
 		if (debug_cpuinfo[cpunum].trace.action)
@@ -472,6 +635,10 @@ void debug_cpu_ignore_cpu(int cpunum, int ignore)
 void debug_cpu_trace(int cpunum, FILE *file, int trace_over, const char *action)
 {
 	/* close existing files and delete expressions */
+	if (debug_cpuinfo[cpunum].trace.binary)
+		trace_binary_free(debug_cpuinfo[cpunum].trace.binary);
+	debug_cpuinfo[cpunum].trace.binary = NULL;
+
 	if (debug_cpuinfo[cpunum].trace.file)
 		fclose(debug_cpuinfo[cpunum].trace.file);
 	debug_cpuinfo[cpunum].trace.file = NULL;
@@ -495,6 +662,77 @@ void debug_cpu_trace(int cpunum, FILE *file, int trace_over, const char *action)
 }
 
 
+/*-------------------------------------------------
+    debug_cpu_trace_binary - trace execution of a
+    given CPU to a binary file, optionally
+    recording register changes
+-------------------------------------------------*/
+
+void debug_cpu_trace_binary(int cpunum, FILE *file, int trace_over, int registers, const char *action)
+{
+	debug_trace_buffer *trace;
+	const char *name;
+	UINT8 *dest;
+	int index;
+
+	/* start off like a text trace */
+	debug_cpu_trace(cpunum, file, trace_over, action);
+	if (file == NULL)
+		return;
+
+	/* allocate the buffer; if the writer thread can't be started, chunks are written inline */
+	trace = malloc_or_die(sizeof(*trace));
+	memset(trace, 0, sizeof(*trace));
+	trace->queue = osd_work_queue_alloc(WORK_QUEUE_FLAG_IO);
+	for (index = 0; index < TRACE_CHUNKS; index++)
+	{
+		trace->chunk[index].file = file;
+		trace->chunk[index].data = malloc_or_die(TRACE_CHUNK_SIZE);
+	}
+	trace->opbytes = MIN(cpunum_max_instruction_bytes(cpunum), 64);
+	trace->lastcycles = cpunum_gettotalcycles64(cpunum);
+
+	/* find the registers to track, the same ones the register view shows */
+	if (registers)
+		for (index = 0; index < MAX_REGS && trace->regcount < TRACE_MAX_REGS; index++)
+		{
+			const char *str = cpunum_reg_string(cpunum, index);
+			if (str != NULL && str[0] != '~' && strchr(str, ':') != NULL)
+			{
+				trace->regnum[trace->regcount] = index;
+				trace->regvalue[trace->regcount++] = cpunum_get_reg(cpunum, index);
+			}
+		}
+
+	/* the header goes at the start of the first chunk */
+	dest = trace->chunk[0].data;
+	memcpy(dest, "MAMETRC", 7);
+	dest[7] = TRACE_VERSION;
+	dest += 8;
+	memset(dest, 0, 32);
+	name = cpunum_name(cpunum);
+	strncpy((char *)dest, name, 31);
+	dest += 32;
+	*dest++ = trace->opbytes;
+	*dest++ = trace->regcount;
+	for (index = 0; index < trace->regcount; index++)
+	{
+		const char *str = cpunum_reg_string(cpunum, trace->regnum[index]);
+		int charnum = 0;
+
+		/* keep the name up to the colon, minus spaces */
+		memset(dest, 0, 16);
+		for ( ; *str != ':' && charnum < 15; str++)
+			if (!isspace(*str))
+				dest[charnum++] = *str;
+		dest += 16;
+	}
+	trace->chunk[0].length = dest - trace->chunk[0].data;
+
+	debug_cpuinfo[cpunum].trace.binary = trace;
+}
+
+
 
 /***************************************************************************
     UTILITIES
@@ -715,6 +953,15 @@ void mame_debug_hook(void)
 	/* update the history */
 	info->pc_history[info->pc_history_index++ % DEBUG_HISTORY_SIZE] = curpc;
 
+	/* profile even if we are ignoring; the sample goes to the instruction in flight when it came due */
+	if (info->profile)
+	{
+		UINT64 cycles = activecpu_gettotalcycles64();
+		if (cycles >= info->profile->nextsample)
+			profile_sample(info->profile, cycles);
+		info->profile->lastpc = curpc;
+	}
+
 	/* quick out if we are ignoring */
 	if (info->ignoring)
 		return;
@@ -764,8 +1011,8 @@ void mame_debug_hook(void)
 			info->temp_breakpoint_pc = ~0;
 		}
 
-		/* check for execution breakpoints */
-		if (info->first_bp)
+		/* check for execution breakpoints; the filter is empty if there are none */
+		if (breakpoint_filter_hit(info, curpc))
 			debug_check_breakpoints(cpunum, curpc);
 
 		/* handle single stepping */
@@ -854,8 +1101,8 @@ void mame_debug_hook(void)
 
 
 /*-------------------------------------------------
-    perform_trace - log to the tracefile the
-    data for a given instruction
+    dasm_wrapped - disassemble the instruction at
+    the given PC of the active CPU
 -------------------------------------------------*/
 
 static UINT32 dasm_wrapped(char *buffer, offs_t pc)
@@ -878,6 +1125,236 @@ static UINT32 dasm_wrapped(char *buffer, offs_t pc)
 }
 
 
+/*-------------------------------------------------
+    trace_put_u16/u32/u64 - store little-endian
+    values into a binary trace
+-------------------------------------------------*/
+
+INLINE UINT8 *trace_put_u16(UINT8 *dest, UINT16 value)
+{
+	dest[0] = value;
+	dest[1] = value >> 8;
+	return dest + 2;
+}
+
+INLINE UINT8 *trace_put_u32(UINT8 *dest, UINT32 value)
+{
+	dest[0] = value;
+	dest[1] = value >> 8;
+	dest[2] = value >> 16;
+	dest[3] = value >> 24;
+	return dest + 4;
+}
+
+INLINE UINT8 *trace_put_u64(UINT8 *dest, UINT64 value)
+{
+	dest = trace_put_u32(dest, (UINT32)value);
+	return trace_put_u32(dest, (UINT32)(value >> 32));
+}
+
+
+/*-------------------------------------------------
+    trace_write_chunk - write a chunk of a binary
+    trace; runs on the writer thread
+-------------------------------------------------*/
+
+static void *trace_write_chunk(void *param)
+{
+	trace_chunk *chunk = param;
+	fwrite(chunk->data, 1, chunk->length, chunk->file);
+	return NULL;
+}
+
+
+/*-------------------------------------------------
+    trace_wait_chunk - wait for a chunk's pending
+    write to finish
+-------------------------------------------------*/
+
+static void trace_wait_chunk(trace_chunk *chunk)
+{
+	if (chunk->item != NULL)
+	{
+		while (!osd_work_item_wait(chunk->item, osd_ticks_per_second())) ;
+		osd_work_item_release(chunk->item);
+		chunk->item = NULL;
+	}
+}
+
+
+/*-------------------------------------------------
+    trace_reserve - make room for a record in the
+    current chunk and return where it goes
+-------------------------------------------------*/
+
+static UINT8 *trace_reserve(debug_trace_buffer *trace, UINT32 bytes)
+{
+	trace_chunk *chunk = &trace->chunk[trace->curchunk];
+
+	/* if this chunk is full, hand it to the writer and move to the next one */
+	if (chunk->length + bytes > TRACE_CHUNK_SIZE)
+	{
+		chunk->item = (trace->queue != NULL) ? osd_work_item_queue(trace->queue, trace_write_chunk, chunk) : NULL;
+		if (chunk->item == NULL)
+			trace_write_chunk(chunk);
+
+		/* the next chunk may still be on its way out if the writer has fallen a full ring behind */
+		trace->curchunk = (trace->curchunk + 1) % TRACE_CHUNKS;
+		chunk = &trace->chunk[trace->curchunk];
+		trace_wait_chunk(chunk);
+		chunk->length = 0;
+	}
+	return &chunk->data[chunk->length];
+}
+
+
+/*-------------------------------------------------
+    trace_commit - mark a reserved record as
+    complete
+-------------------------------------------------*/
+
+static void trace_commit(debug_trace_buffer *trace, UINT8 *end)
+{
+	trace_chunk *chunk = &trace->chunk[trace->curchunk];
+	chunk->length = end - chunk->data;
+}
+
+
+/*-------------------------------------------------
+    trace_binary_flush - write out everything
+    buffered for a binary trace
+-------------------------------------------------*/
+
+static void trace_binary_flush(debug_trace_buffer *trace)
+{
+	trace_chunk *chunk;
+	int index;
+
+	/* wait for the writer to finish, oldest chunk first */
+	for (index = 1; index <= TRACE_CHUNKS; index++)
+		trace_wait_chunk(&trace->chunk[(trace->curchunk + index) % TRACE_CHUNKS]);
+
+	/* then write what we have of the current chunk ourselves */
+	chunk = &trace->chunk[trace->curchunk];
+	trace_write_chunk(chunk);
+	chunk->length = 0;
+	fflush(chunk->file);
+}
+
+
+/*-------------------------------------------------
+    trace_binary_free - flush and free a binary
+    trace buffer; the file is left open
+-------------------------------------------------*/
+
+static void trace_binary_free(debug_trace_buffer *trace)
+{
+	int index;
+
+	trace_binary_flush(trace);
+	if (trace->queue != NULL)
+		osd_work_queue_free(trace->queue);
+	for (index = 0; index < TRACE_CHUNKS; index++)
+		free(trace->chunk[index].data);
+	free(trace);
+}
+
+
+/*-------------------------------------------------
+    trace_binary_instruction - record an
+    instruction to a binary trace
+-------------------------------------------------*/
+
+static void trace_binary_instruction(debug_cpu_info *info, offs_t pc)
+{
+	debug_trace_buffer *trace = info->trace.binary;
+	UINT8 *dest = trace_reserve(trace, TRACE_MAX_RECORD);
+	UINT64 cycles = activecpu_gettotalcycles64();
+	UINT8 *flags, *regcount = NULL;
+	offs_t pcbyte;
+	int index;
+
+	*dest++ = TRACE_RECORD_INSTRUCTION;
+	flags = dest++;
+	*flags = 0;
+	dest = trace_put_u32(dest, pc);
+	dest = trace_put_u32(dest, (UINT32)(cycles - trace->lastcycles));
+	trace->lastcycles = cycles;
+
+	/* we don't know the instruction length without disassembling, so take the maximum */
+	pcbyte = ADDR2BYTE_MASKED(pc, info, ADDRESS_SPACE_PROGRAM);
+	for (index = 0; index < trace->opbytes; index++)
+		dest[index] = debug_read_opcode(pcbyte + index, 1, FALSE);
+	for (index = 0; index < trace->opbytes; index++)
+	{
+		dest[trace->opbytes + index] = debug_read_opcode(pcbyte + index, 1, TRUE);
+		if (dest[trace->opbytes + index] != dest[index])
+			*flags |= TRACE_FLAG_SPLIT_ARGS;
+	}
+	dest += (*flags & TRACE_FLAG_SPLIT_ARGS) ? 2 * trace->opbytes : trace->opbytes;
+
+	/* record any registers that changed */
+	for (index = 0; index < trace->regcount; index++)
+	{
+		UINT64 value = activecpu_get_reg(trace->regnum[index]);
+		if (value != trace->regvalue[index])
+		{
+			if (regcount == NULL)
+			{
+				*flags |= TRACE_FLAG_REGISTERS;
+				regcount = dest++;
+				*regcount = 0;
+			}
+			(*regcount)++;
+			*dest++ = index;
+			dest = trace_put_u64(dest, value);
+			trace->regvalue[index] = value;
+		}
+	}
+
+	trace_commit(trace, dest);
+}
+
+
+/*-------------------------------------------------
+    trace_binary_loop - record a collapsed loop to
+    a binary trace
+-------------------------------------------------*/
+
+static void trace_binary_loop(debug_trace_buffer *trace, int loops)
+{
+	UINT8 *dest = trace_reserve(trace, 5);
+	*dest++ = TRACE_RECORD_LOOP;
+	dest = trace_put_u32(dest, loops);
+	trace_commit(trace, dest);
+}
+
+
+/*-------------------------------------------------
+    trace_binary_text - record tracelog output to
+    a binary trace
+-------------------------------------------------*/
+
+static void trace_binary_text(debug_trace_buffer *trace, const char *text)
+{
+	int length = strlen(text);
+	UINT8 *dest;
+
+	if (length > TRACE_MAX_TEXT)
+		length = TRACE_MAX_TEXT;
+	dest = trace_reserve(trace, 3 + length);
+	*dest++ = TRACE_RECORD_TEXT;
+	dest = trace_put_u16(dest, length);
+	memcpy(dest, text, length);
+	trace_commit(trace, dest + length);
+}
+
+
+/*-------------------------------------------------
+    perform_trace - log to the tracefile the data
+    for a given instruction
+-------------------------------------------------*/
+
 static void perform_trace(debug_cpu_info *info)
 {
 	offs_t pc = activecpu_get_pc();
@@ -903,21 +1380,35 @@ static void perform_trace(debug_cpu_info *info)
 	{
 		/* if we just finished looping, indicate as much */
 		if (info->trace.loops)
-			fprintf(info->trace.file, "\n   (loops for %d instructions)\n\n", info->trace.loops);
+		{
+			if (info->trace.binary)
+				trace_binary_loop(info->trace.binary, info->trace.loops);
+			else
+				fprintf(info->trace.file, "\n   (loops for %d instructions)\n\n", info->trace.loops);
+		}
 		info->trace.loops = 0;
 
 		/* execute any trace actions first */
 		if (info->trace.action)
 			debug_console_execute_command(info->trace.action, 0);
 
-		/* print the address */
-		offset = sprintf(buffer, "%0*X: ", info->space[ADDRESS_SPACE_PROGRAM].logchars, pc);
+		/* binary traces are disassembled later, unless we need the flags to trace over */
+		if (info->trace.binary)
+		{
+			trace_binary_instruction(info, pc);
+			dasmresult = info->trace.trace_over_target ? dasm_wrapped(buffer, pc) : 0;
+		}
+		else
+		{
+			/* print the address */
+			offset = sprintf(buffer, "%0*X: ", info->space[ADDRESS_SPACE_PROGRAM].logchars, pc);
 
-		/* print the disassembly */
-		dasmresult = dasm_wrapped(&buffer[offset], pc);
+			/* print the disassembly */
+			dasmresult = dasm_wrapped(&buffer[offset], pc);
 
-		/* output the result */
-		fprintf(info->trace.file, "%s\n", buffer);
+			/* output the result */
+			fprintf(info->trace.file, "%s\n", buffer);
+		}
 
 		/* do we need to step the trace over this instruction? */
 		if (info->trace.trace_over_target && (dasmresult & DASMFLAG_SUPPORTED)
@@ -1066,7 +1557,7 @@ static void standard_debug_hook_read(int spacenum, int size, offs_t address)
 	debug_cpu_info *info = &debug_cpuinfo[memory_hook_cpunum];
 
 	/* check watchpoints */
-	if (info->read_watchpoints)
+	if (info->read_watchpoints && watchpoint_map_hit(&info->space[spacenum], address, size))
 		check_watchpoints(memory_hook_cpunum, spacenum, WATCHPOINT_READ, address, size, 0);
 
 	/* check hotspots */
@@ -1084,7 +1575,7 @@ static void standard_debug_hook_write(int spacenum, int size, offs_t address, UI
 	debug_cpu_info *info = &debug_cpuinfo[memory_hook_cpunum];
 
 	/* check watchpoints */
-	if (info->write_watchpoints)
+	if (info->write_watchpoints && watchpoint_map_hit(&info->space[spacenum], address, size))
 		check_watchpoints(memory_hook_cpunum, spacenum, WATCHPOINT_WRITE, address, size, data);
 }
 
@@ -1115,6 +1606,25 @@ void debug_get_memory_hooks(int cpunum, debug_hook_read_ptr *read, debug_hook_wr
     BREAKPOINTS
 ***************************************************************************/
 
+/*-------------------------------------------------
+    rebuild_breakpoint_filter - recompute the
+    filter from the enabled breakpoints
+-------------------------------------------------*/
+
+static void rebuild_breakpoint_filter(debug_cpu_info *info)
+{
+	debug_cpu_breakpoint *bp;
+
+	memset(info->bp_filter, 0, sizeof(info->bp_filter));
+	for (bp = info->first_bp; bp; bp = bp->next)
+		if (bp->enabled)
+		{
+			UINT32 bit = breakpoint_hash(bp->address) >> (32 - BREAKPOINT_FILTER_BITS);
+			info->bp_filter[bit / 32] |= 1 << (bit % 32);
+		}
+}
+
+
 /*-------------------------------------------------
     debug_check_breakpoints - check the
     breakpoints for a given CPU
@@ -1125,8 +1635,8 @@ void debug_check_breakpoints(int cpunum, offs_t pc)
 	debug_cpu_breakpoint *bp;
 	UINT64 result;
 
-	/* see if we match */
-	for (bp = debug_cpuinfo[cpunum].first_bp; bp; bp = bp->next)
+	/* see if we match; only breakpoints in this bucket can */
+	for (bp = debug_cpuinfo[cpunum].bp_hash[breakpoint_hash(pc) >> (32 - BREAKPOINT_HASH_BITS)]; bp; bp = bp->hashnext)
 		if (bp->enabled && bp->address == pc)
 
 			/* if we do, evaluate the condition */
@@ -1148,11 +1658,11 @@ void debug_check_breakpoints(int cpunum, offs_t pc)
 
 
 /*-------------------------------------------------
-    debug_breakpoint_first - find the first
-    breakpoint for a given CPU
+    find_breakpoint - find a breakpoint and the
+    CPU it belongs to
 -------------------------------------------------*/
 
-static debug_cpu_breakpoint *find_breakpoint(int bpnum)
+static debug_cpu_breakpoint *find_breakpoint(int bpnum, int *cpunumptr)
 {
 	debug_cpu_breakpoint *bp;
 	int cpunum;
@@ -1161,7 +1671,10 @@ static debug_cpu_breakpoint *find_breakpoint(int bpnum)
 	for (cpunum = 0; cpunum < MAX_CPU; cpunum++)
 		for (bp = debug_cpuinfo[cpunum].first_bp; bp; bp = bp->next)
 			if (bp->index == bpnum)
+			{
+				*cpunumptr = cpunum;
 				return bp;
+			}
 
 	return NULL;
 }
@@ -1184,6 +1697,8 @@ debug_cpu_breakpoint *debug_breakpoint_first(int cpunum)
 
 int debug_breakpoint_set(int cpunum, offs_t address, parsed_expression *condition, const char *action)
 {
+	debug_cpu_info *info = &debug_cpuinfo[cpunum];
+	debug_cpu_breakpoint **bucket;
 	debug_cpu_breakpoint *bp;
 
 	assert_always((cpunum >= 0) && (cpunum < cpu_gettotalcpu()), "debug_breakpoint_set() called with invalid cpunum!");
@@ -1208,9 +1723,13 @@ int debug_breakpoint_set(int cpunum, offs_t address, parsed_expression *conditio
 			strcpy(bp->action, action);
 	}
 
-	/* hook us in */
-	bp->next = debug_cpuinfo[cpunum].first_bp;
-	debug_cpuinfo[cpunum].first_bp = bp;
+	/* hook us in, both to the list and to our hash bucket */
+	bp->next = info->first_bp;
+	info->first_bp = bp;
+	bucket = &info->bp_hash[breakpoint_hash(address) >> (32 - BREAKPOINT_HASH_BITS)];
+	bp->hashnext = *bucket;
+	*bucket = bp;
+	rebuild_breakpoint_filter(info);
 	return bp->index;
 }
 
@@ -1221,7 +1740,7 @@ int debug_breakpoint_set(int cpunum, offs_t address, parsed_expression *conditio
 
 int debug_breakpoint_clear(int bpnum)
 {
-	debug_cpu_breakpoint *bp, *pbp;
+	debug_cpu_breakpoint *bp, *pbp, **bucket;
 	int cpunum;
 
 	/* loop over CPUs and find the requested breakpoint */
@@ -1235,6 +1754,11 @@ int debug_breakpoint_clear(int bpnum)
 				else
 					pbp->next = bp->next;
 
+				/* and from our hash bucket */
+				for (bucket = &debug_cpuinfo[cpunum].bp_hash[breakpoint_hash(bp->address) >> (32 - BREAKPOINT_HASH_BITS)]; *bucket != bp; bucket = &(*bucket)->hashnext) ;
+				*bucket = bp->hashnext;
+				rebuild_breakpoint_filter(&debug_cpuinfo[cpunum]);
+
 				/* free the memory */
 				if (bp->condition)
 					expression_free(bp->condition);
@@ -1256,12 +1780,14 @@ int debug_breakpoint_clear(int bpnum)
 
 int debug_breakpoint_enable(int bpnum, int enable)
 {
-	debug_cpu_breakpoint *bp = find_breakpoint(bpnum);
+	int cpunum;
+	debug_cpu_breakpoint *bp = find_breakpoint(bpnum, &cpunum);
 
 	/* if we found it, set it */
 	if (bp != NULL)
 	{
 		bp->enabled = (enable != 0);
+		rebuild_breakpoint_filter(&debug_cpuinfo[cpunum]);
 		return 1;
 	}
 	return 0;
@@ -1273,6 +1799,52 @@ int debug_breakpoint_enable(int bpnum, int enable)
     WATCHPOINTS
 ***************************************************************************/
 
+/*-------------------------------------------------
+    rebuild_watchpoint_map - recompute the map of
+    pages touched by enabled watchpoints
+-------------------------------------------------*/
+
+static void rebuild_watchpoint_map(debug_cpu_info *info, int spacenum)
+{
+	debug_space_info *space = &info->space[spacenum];
+	debug_cpu_watchpoint *wp;
+	offs_t pages;
+
+	/* free the map once the last watchpoint goes away */
+	if (space->first_wp == NULL)
+	{
+		if (space->wpmap != NULL)
+			free(space->wpmap);
+		space->wpmap = NULL;
+		return;
+	}
+
+	/* pick a page size that keeps the map small, and allocate it on first use */
+	if (space->wpmap == NULL)
+	{
+		space->wpmapshift = 8;
+		while ((space->logbytemask >> space->wpmapshift) >= (1 << WATCHPOINT_MAP_MAX_BITS))
+			space->wpmapshift++;
+		space->wpmap = malloc_or_die((((space->logbytemask >> space->wpmapshift) + 32) / 32) * sizeof(UINT32));
+	}
+	pages = (space->logbytemask >> space->wpmapshift) + 1;
+
+	/* mark every page each enabled watchpoint covers */
+	memset(space->wpmap, 0, ((pages + 31) / 32) * sizeof(UINT32));
+	for (wp = space->first_wp; wp; wp = wp->next)
+		if (wp->enabled && wp->length != 0)
+		{
+			offs_t page = wp->address >> space->wpmapshift;
+			UINT64 last = ((UINT64)wp->address + wp->length - 1) >> space->wpmapshift;
+
+			if (last >= pages)
+				last = pages - 1;
+			for ( ; page <= last; page++)
+				space->wpmap[page / 32] |= 1 << (page % 32);
+		}
+}
+
+
 /*-------------------------------------------------
     check_watchpoints - check the
     breakpoints for a given CPU and address space
@@ -1337,11 +1909,11 @@ static void check_watchpoints(int cpunum, int spacenum, int type, offs_t address
 
 
 /*-------------------------------------------------
-    debug_watchpoint_first - find the first
-    watchpoint for a given CPU
+    find_watchpoint - find a watchpoint and the
+    CPU and address space it belongs to
 -------------------------------------------------*/
 
-static debug_cpu_watchpoint *find_watchpoint(int wpnum)
+static debug_cpu_watchpoint *find_watchpoint(int wpnum, int *cpunumptr, int *spacenumptr)
 {
 	debug_cpu_watchpoint *wp;
 	int cpunum, spacenum;
@@ -1351,7 +1923,11 @@ static debug_cpu_watchpoint *find_watchpoint(int wpnum)
 		for (spacenum = 0; spacenum < ADDRESS_SPACES; spacenum++)
 			for (wp = debug_cpuinfo[cpunum].space[spacenum].first_wp; wp; wp = wp->next)
 				if (wp->index == wpnum)
+				{
+					*cpunumptr = cpunum;
+					*spacenumptr = spacenum;
 					return wp;
+				}
 
 	return NULL;
 }
@@ -1402,6 +1978,7 @@ int debug_watchpoint_set(int cpunum, int spacenum, int type, offs_t address, off
 		debug_cpuinfo[cpunum].read_watchpoints++;
 	if (wp->type & WATCHPOINT_WRITE)
 		debug_cpuinfo[cpunum].write_watchpoints++;
+	rebuild_watchpoint_map(&debug_cpuinfo[cpunum], spacenum);
 
 	/* force debug_get_memory_hooks() to be called */
 	cpuintrf_push_context(-1);
@@ -1442,6 +2019,7 @@ int debug_watchpoint_clear(int wpnum)
 					if (wp->type & WATCHPOINT_WRITE)
 						debug_cpuinfo[cpunum].write_watchpoints--;
 					free(wp);
+					rebuild_watchpoint_map(&debug_cpuinfo[cpunum], spacenum);
 
 					/* force debug_get_memory_hooks() to be called */
 					cpuintrf_push_context(-1);
@@ -1462,12 +2040,14 @@ int debug_watchpoint_clear(int wpnum)
 
 int debug_watchpoint_enable(int wpnum, int enable)
 {
-	debug_cpu_watchpoint *wp = find_watchpoint(wpnum);
+	int cpunum, spacenum;
+	debug_cpu_watchpoint *wp = find_watchpoint(wpnum, &cpunum, &spacenum);
 
 	/* if we found it, set it */
 	if (wp != NULL)
 	{
 		wp->enabled = (enable != 0);
+		rebuild_watchpoint_map(&debug_cpuinfo[cpunum], spacenum);
 		return 1;
 	}
 	return 0;
@@ -1561,6 +2141,224 @@ static void check_hotspots(int cpunum, int spacenum, offs_t address)
 }
 
 
+/***************************************************************************
+    PROFILING
+***************************************************************************/
+
+/*-------------------------------------------------
+    profile_find_bucket - find or create the
+    bucket for an address
+-------------------------------------------------*/
+
+static profile_bucket *profile_find_bucket(debug_profile_info *profile, offs_t base)
+{
+	/* the low bits of base are all zero, so only the top bits of the hash are any good */
+	UINT32 index = breakpoint_hash(base >> profile->granularity) >> (32 - profile->bits);
+
+	/* linear probing; the table is never more than half full */
+	while (profile->bucket[index].count != 0 && profile->bucket[index].base != base)
+		index = (index + 1) & profile->mask;
+	profile->bucket[index].base = base;
+	return &profile->bucket[index];
+}
+
+
+/*-------------------------------------------------
+    profile_sample - add the samples that have
+    come due to the instruction in flight
+-------------------------------------------------*/
+
+static void profile_sample(debug_profile_info *profile, UINT64 cycles)
+{
+	offs_t base = profile->lastpc & ~(((offs_t)1 << profile->granularity) - 1);
+	UINT32 count = (UINT32)((cycles - profile->nextsample) / profile->interval) + 1;
+	profile_bucket *bucket = profile_find_bucket(profile, base);
+
+	/* long instructions and halts may be due more than one sample */
+	if (bucket->count == 0)
+		profile->used++;
+	bucket->count += count;
+	profile->samples += count;
+	profile->nextsample += (UINT64)count * profile->interval;
+
+	/* double the table when it gets half full */
+	if (profile->used * 2 > profile->mask)
+	{
+		profile_bucket *oldbucket = profile->bucket;
+		UINT32 oldsize = profile->mask + 1, index;
+
+		profile->bits++;
+		profile->mask = oldsize * 2 - 1;
+		profile->bucket = malloc_or_die(sizeof(*profile->bucket) * oldsize * 2);
+		memset(profile->bucket, 0, sizeof(*profile->bucket) * oldsize * 2);
+		for (index = 0; index < oldsize; index++)
+			if (oldbucket[index].count != 0)
+				profile_find_bucket(profile, oldbucket[index].base)->count = oldbucket[index].count;
+		free(oldbucket);
+	}
+}
+
+
+/*-------------------------------------------------
+    profile_compare_* - qsort callbacks for the
+    profile report
+-------------------------------------------------*/
+
+static int CLIB_DECL profile_compare_count(const void *item1, const void *item2)
+{
+	UINT32 count1 = ((const profile_bucket *)item1)->count;
+	UINT32 count2 = ((const profile_bucket *)item2)->count;
+	return (count1 < count2) ? 1 : (count1 > count2) ? -1 : 0;
+}
+
+static int CLIB_DECL profile_compare_group_count(const void *item1, const void *item2)
+{
+	UINT32 count1 = ((const profile_group *)item1)->count;
+	UINT32 count2 = ((const profile_group *)item2)->count;
+	return (count1 < count2) ? 1 : (count1 > count2) ? -1 : 0;
+}
+
+static int CLIB_DECL profile_compare_address(const void *item1, const void *item2)
+{
+	offs_t base1 = ((const profile_bucket *)item1)->base;
+	offs_t base2 = ((const profile_bucket *)item2)->base;
+	return (base1 > base2) ? 1 : (base1 < base2) ? -1 : 0;
+}
+
+
+/*-------------------------------------------------
+    profile_report - write the report for a
+    CPU's profile
+-------------------------------------------------*/
+
+static void profile_report(int cpunum, debug_profile_info *profile)
+{
+	int logchars = debug_cpuinfo[cpunum].space[ADDRESS_SPACE_PROGRAM].logchars;
+	offs_t span = ((offs_t)1 << profile->granularity) - 1;
+	double scale = (profile->samples != 0) ? 100.0 / (double)profile->samples : 0;
+	profile_bucket *list;
+	profile_group *group;
+	UINT32 index, count = 0, groups = 0;
+
+	fprintf(profile->file, "PC profile of CPU %d (%s): %d samples, one every %d cycles\n\n",
+			cpunum, cpunum_name(cpunum), profile->samples, profile->interval);
+
+	/* gather the buckets in use */
+	list = malloc_or_die(sizeof(*list) * (profile->used + 1));
+	for (index = 0; index <= profile->mask; index++)
+		if (profile->bucket[index].count != 0)
+			list[count++] = profile->bucket[index];
+
+	/* the busiest address ranges first, with the comment of the code they are in */
+	qsort(list, count, sizeof(*list), profile_compare_count);
+	fprintf(profile->file, "Hottest address ranges:\n");
+	for (index = 0; index < count && index < PROFILE_REPORT_LINES; index++)
+	{
+		offs_t commentaddr = 0;
+		const char *text = debug_comment_get_preceding_text(cpunum, list[index].base + span, &commentaddr);
+
+		fprintf(profile->file, "  %0*X-%0*X %10d %6.2f%%", logchars, list[index].base, logchars, list[index].base + span,
+				list[index].count, (double)list[index].count * scale);
+		if (text != NULL)
+			fprintf(profile->file, "  %0*X: %s", logchars, commentaddr, text);
+		fprintf(profile->file, "\n");
+	}
+
+	/* then group them by the closest comment before them, which is usually the routine's name */
+	if (debug_comment_get_count(cpunum) > 0)
+	{
+		group = malloc_or_die(sizeof(*group) * (count + 1));
+		qsort(list, count, sizeof(*list), profile_compare_address);
+		for (index = 0; index < count; index++)
+		{
+			offs_t commentaddr = 0;
+			const char *text = debug_comment_get_preceding_text(cpunum, list[index].base, &commentaddr);
+
+			/* buckets are sorted by address, so each group's buckets are together */
+			if (groups == 0 || group[groups - 1].text != text || group[groups - 1].address != commentaddr)
+			{
+				group[groups].address = commentaddr;
+				group[groups].text = text;
+				group[groups++].count = 0;
+			}
+			group[groups - 1].count += list[index].count;
+		}
+
+		qsort(group, groups, sizeof(*group), profile_compare_group_count);
+		fprintf(profile->file, "\nHottest routines, by the comment preceding them:\n");
+		for (index = 0; index < groups && index < PROFILE_REPORT_LINES; index++)
+		{
+			fprintf(profile->file, "  %10d %6.2f%%  ", group[index].count, (double)group[index].count * scale);
+			if (group[index].text != NULL)
+				fprintf(profile->file, "%0*X: %s\n", logchars, group[index].address, group[index].text);
+			else
+				fprintf(profile->file, "(before the first comment)\n");
+		}
+		free(group);
+	}
+
+	free(list);
+}
+
+
+/*-------------------------------------------------
+    debug_cpu_profile - start or stop profiling a
+    CPU; stopping writes the report to the file
+    given when it started
+-------------------------------------------------*/
+
+int debug_cpu_profile(int cpunum, FILE *file, UINT32 interval, int granularity)
+{
+	debug_cpu_info *info = &debug_cpuinfo[cpunum];
+	debug_profile_info *profile = info->profile;
+
+	/* finish off any existing profile */
+	if (profile)
+	{
+		profile_report(cpunum, profile);
+		fclose(profile->file);
+		free(profile->bucket);
+		free(profile);
+		info->profile = NULL;
+	}
+
+	/* start a new one if we have a file */
+	if (file)
+	{
+		profile = malloc_or_die(sizeof(*profile));
+		memset(profile, 0, sizeof(*profile));
+		profile->file = file;
+		profile->interval = (interval != 0) ? interval : 1;
+		profile->granularity = MIN(granularity, 31);
+		profile->nextsample = cpunum_gettotalcycles64(cpunum) + profile->interval;
+		profile->lastpc = cpunum_get_reg(cpunum, REG_PC);
+		profile->bits = PROFILE_INITIAL_BITS;
+		profile->mask = (1 << PROFILE_INITIAL_BITS) - 1;
+		profile->bucket = malloc_or_die(sizeof(*profile->bucket) << PROFILE_INITIAL_BITS);
+		memset(profile->bucket, 0, sizeof(*profile->bucket) << PROFILE_INITIAL_BITS);
+		info->profile = profile;
+	}
+
+	return 1;
+}
+
+
+/*-------------------------------------------------
+    debug_profile_exit - write the reports of any
+    profiles still running
+-------------------------------------------------*/
+
+static void debug_profile_exit(running_machine *machine)
+{
+	int cpunum;
+
+	for (cpunum = 0; cpunum < MAX_CPU; cpunum++)
+		if (debug_cpuinfo[cpunum].profile)
+			debug_cpu_profile(cpunum, NULL, 0, 0);
+}
+
+
+
 /***************************************************************************
     MEMORY ACCESSORS
 ***************************************************************************/
@@ -2128,7 +2926,19 @@ void debug_trace_printf(int cpunum, const char *fmt, ...)
 
 	debug_cpu_info *info = &debug_cpuinfo[cpunum];
 
-	if (info->trace.file)
+	if (info->trace.binary)
+	{
+		char buffer[TRACE_MAX_TEXT + 1];
+
+		/* text records hold at most TRACE_MAX_TEXT characters; some vsnprintfs */
+		/* don't terminate what they truncate, so do it ourselves */
+		va_start(va, fmt);
+		vsnprintf(buffer, sizeof(buffer), fmt, va);
+		va_end(va);
+		buffer[TRACE_MAX_TEXT] = 0;
+		trace_binary_text(info->trace.binary, buffer);
+	}
+	else if (info->trace.file)
 	{
 		va_start(va, fmt);
 		vfprintf(info->trace.file, fmt, va);
@@ -2175,7 +2985,155 @@ void debug_flush_traces(void)
 
 	for (cpunum = 0; cpunum < cpu_gettotalcpu(); cpunum++)
 	{
+		if (debug_cpuinfo[cpunum].trace.binary)
+			trace_binary_flush(debug_cpuinfo[cpunum].trace.binary);
 		if (debug_cpuinfo[cpunum].trace.file)
 			fflush(debug_cpuinfo[cpunum].trace.file);
 	}
 }
+
+
+/*-------------------------------------------------
+    trace_read - read bytes from a binary trace,
+    returning FALSE if the file ends first
+-------------------------------------------------*/
+
+static int trace_read(FILE *src, UINT8 *dest, int bytes)
+{
+	return (fread(dest, 1, bytes, src) == bytes);
+}
+
+
+/*-------------------------------------------------
+    trace_get_u32 - fetch a little-endian value
+    from a binary trace
+-------------------------------------------------*/
+
+INLINE UINT32 trace_get_u32(const UINT8 *src)
+{
+	return src[0] | (src[1] << 8) | (src[2] << 16) | ((UINT32)src[3] << 24);
+}
+
+
+/*-------------------------------------------------
+    debug_cpu_trace_disassemble - convert a binary
+    trace to the text format, using the given
+    CPU's disassembler
+-------------------------------------------------*/
+
+int debug_cpu_trace_disassemble(int cpunum, FILE *src, FILE *dst)
+{
+	const debug_cpu_info *info = &debug_cpuinfo[cpunum];
+	char regname[TRACE_MAX_REGS][17];
+	UINT8 header[8 + 32 + 2];
+	UINT8 opbuf[64], argbuf[64], data[16];
+	char buffer[TRACE_MAX_TEXT + 1];
+	int opbytes, regcount, index, count = 0;
+	int type;
+
+	/* read and validate the header */
+	if (!trace_read(src, header, sizeof(header)) || memcmp(header, "MAMETRC", 7) != 0 || header[7] != TRACE_VERSION)
+	{
+		debug_console_printf("Not a binary trace file\n");
+		return -1;
+	}
+	header[8 + 31] = 0;
+	if (strcmp((char *)&header[8], cpunum_name(cpunum)) != 0)
+	{
+		debug_console_printf("Trace was recorded from a %s, but CPU %d is a %s\n", (char *)&header[8], cpunum, cpunum_name(cpunum));
+		return -1;
+	}
+	opbytes = header[8 + 32];
+	regcount = header[8 + 33];
+	if (opbytes > sizeof(opbuf) || regcount > TRACE_MAX_REGS)
+	{
+		debug_console_printf("Corrupt binary trace header\n");
+		return -1;
+	}
+	for (index = 0; index < regcount; index++)
+	{
+		if (!trace_read(src, (UINT8 *)regname[index], 16))
+			return -1;
+		regname[index][16] = 0;
+	}
+
+	/* convert each record */
+	memset(opbuf, 0, sizeof(opbuf));
+	memset(argbuf, 0, sizeof(argbuf));
+	while ((type = fgetc(src)) != EOF)
+	{
+		switch (type)
+		{
+			case TRACE_RECORD_INSTRUCTION:
+			{
+				UINT8 flags, regchanges = 0;
+				offs_t pc;
+				UINT32 cycles;
+				int offset;
+
+				if (!trace_read(src, data, 9))
+					goto truncated;
+				flags = data[0];
+				pc = trace_get_u32(&data[1]);
+				cycles = trace_get_u32(&data[5]);
+				if (!trace_read(src, opbuf, opbytes))
+					goto truncated;
+				if (!(flags & TRACE_FLAG_SPLIT_ARGS))
+					memcpy(argbuf, opbuf, opbytes);
+				else if (!trace_read(src, argbuf, opbytes))
+					goto truncated;
+
+				/* same layout as a text trace, with the cycles and register changes after */
+				offset = sprintf(buffer, "%0*X: ", info->space[ADDRESS_SPACE_PROGRAM].logchars, pc);
+				cpunum_dasm(cpunum, &buffer[offset], pc, opbuf, argbuf);
+				fprintf(dst, "%-40s ; +%d", buffer, cycles);
+
+				if ((flags & TRACE_FLAG_REGISTERS) && !trace_read(src, &regchanges, 1))
+					goto truncated;
+				while (regchanges-- > 0)
+				{
+					UINT64 value;
+
+					if (!trace_read(src, data, 9) || data[0] >= regcount)
+						goto truncated;
+					value = trace_get_u32(&data[1]) | ((UINT64)trace_get_u32(&data[5]) << 32);
+					if ((value >> 32) != 0)
+						fprintf(dst, " %s=%X%08X", regname[data[0]], (UINT32)(value >> 32), (UINT32)value);
+					else
+						fprintf(dst, " %s=%X", regname[data[0]], (UINT32)value);
+				}
+				fprintf(dst, "\n");
+				count++;
+				break;
+			}
+
+			case TRACE_RECORD_LOOP:
+				if (!trace_read(src, data, 4))
+					goto truncated;
+				fprintf(dst, "\n   (loops for %d instructions)\n\n", trace_get_u32(data));
+				break;
+
+			case TRACE_RECORD_TEXT:
+			{
+				int length;
+
+				if (!trace_read(src, data, 2))
+					goto truncated;
+				length = data[0] | (data[1] << 8);
+				if (length > TRACE_MAX_TEXT || !trace_read(src, (UINT8 *)buffer, length))
+					goto truncated;
+				buffer[length] = 0;
+				fputs(buffer, dst);
+				break;
+			}
+
+			default:
+				goto truncated;
+		}
+	}
+	return count;
+
+truncated:
+	debug_console_printf("Binary trace is truncated or corrupt after %d instructions\n", count);
+	return count;
+}
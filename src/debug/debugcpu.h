@@ -28,6 +28,14 @@
 #define WATCHPOINT_WRITE		2
 #define WATCHPOINT_READWRITE	(WATCHPOINT_READ | WATCHPOINT_WRITE)
 
+/* breakpoints are hashed by address, and a filter with one bit per hash value
+   lets most instructions skip the hash table entirely */
+#define BREAKPOINT_HASH_BITS	8
+#define BREAKPOINT_FILTER_BITS	12
+
+/* the watchpoint page map never needs more than this many bits */
+#define WATCHPOINT_MAP_MAX_BITS	20
+
 enum
 {
 	EXECUTION_STATE_STOPPED,
@@ -59,8 +67,10 @@ typedef void (*debug_hook_write_ptr)(int spacenum, int size, offs_t address, UIN
 
 
 typedef struct _debug_trace_info debug_trace_info;
+typedef struct _debug_trace_buffer debug_trace_buffer;
 typedef struct _debug_space_info debug_space_info;
 typedef struct _debug_hotspot_entry debug_hotspot_entry;
+typedef struct _debug_profile_info debug_profile_info;
 typedef struct _debug_cpu_info debug_cpu_info;
 typedef struct _debug_cpu_breakpoint debug_cpu_breakpoint;
 typedef struct _debug_cpu_watchpoint debug_cpu_watchpoint;
@@ -76,6 +86,7 @@ struct _debug_trace_info
 	offs_t			trace_over_target;			/* target for tracing over
                                                     (0 = not tracing over,
                                                     ~0 = not currently tracing over) */
+	debug_trace_buffer *binary;					/* buffer for binary traces (NULL for text) */
 };
 
 
@@ -92,6 +103,8 @@ struct _debug_space_info
 	offs_t			physbytemask;				/* physical byte mask */
 	offs_t			logbytemask;				/* logical byte mask */
 	debug_cpu_watchpoint *first_wp;				/* first watchpoint */
+	UINT32 *		wpmap;						/* bitmap of pages touched by enabled watchpoints */
+	UINT8			wpmapshift;					/* log2 of the bytes per page in the map */
 };
 
 
@@ -116,12 +129,15 @@ struct _debug_cpu_info
 	symbol_table *	symtable;					/* symbol table for expression evaluation */
 	debug_trace_info trace;						/* trace info */
 	debug_cpu_breakpoint *first_bp;				/* first breakpoint */
+	debug_cpu_breakpoint *bp_hash[1 << BREAKPOINT_HASH_BITS]; /* breakpoints hashed by address */
+	UINT32			bp_filter[(1 << BREAKPOINT_FILTER_BITS) / 32]; /* hashes of enabled breakpoints */
 	debug_space_info space[ADDRESS_SPACES];		/* per-address space info */
 	debug_hotspot_entry *hotspots;				/* hotspot list */
 	offs_t			pc_history[DEBUG_HISTORY_SIZE]; /* history of recent PCs */
 	UINT32			pc_history_index;			/* current history index */
 	int				hotspot_count;				/* number of hotspots */
 	int				hotspot_threshhold;			/* threshhold for the number of hits to print */
+	debug_profile_info *profile;				/* PC profile (NULL if not profiling) */
 	int				(*translate)(int space, offs_t *address);/* address translation routine */
 	int 			(*read)(int space, UINT32 offset, int size, UINT64 *value); /* memory read routine */
 	int				(*write)(int space, UINT32 offset, int size, UINT64 value); /* memory write routine */
@@ -137,6 +153,7 @@ struct _debug_cpu_breakpoint
 	parsed_expression *condition;		/* condition */
 	char *			action;						/* action */
 	debug_cpu_breakpoint *next;					/* next in the list */
+	debug_cpu_breakpoint *hashnext;				/* next in the hash bucket */
 };
 
 
@@ -198,6 +215,8 @@ void				debug_cpu_ignore_cpu(int cpunum, int ignore);
 
 /* tracing support */
 void				debug_cpu_trace(int cpunum, FILE *file, int trace_over, const char *action);
+void				debug_cpu_trace_binary(int cpunum, FILE *file, int trace_over, int registers, const char *action);
+int					debug_cpu_trace_disassemble(int cpunum, FILE *src, FILE *dst);
 
 /* breakpoints */
 void				debug_check_breakpoints(int cpunum, offs_t pc);
@@ -215,6 +234,9 @@ int					debug_watchpoint_enable(int wpnum, int enable);
 /* hotspots */
 int					debug_hotspot_track(int cpunum, int numspots, int threshhold);
 
+/* profiling */
+int					debug_cpu_profile(int cpunum, FILE *file, UINT32 interval, int granularity);
+
 /* memory accessors */
 UINT8				debug_read_byte(int spacenum, offs_t address);
 UINT16				debug_read_word(int spacenum, offs_t address);
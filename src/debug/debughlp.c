@@ -77,6 +77,7 @@ static help_item static_help_list[] =
 		"\n"
 		"  help [<topic>] -- get help on a particular topic\n"
 		"  do <expression> -- evaluates the given expression\n"
+		"  exprbench <expression>[,<count>] -- times interpreted and compiled evaluation of an expression\n"
 		"  symlist [<cpunum>] -- lists registered symbols\n"
 		"  print <item>[,...] -- prints one or more <item>s to the console\n"
 		"  printf <format>[,<item>[,...]] -- prints one or more <item>s to the console using <format>\n"
@@ -123,6 +124,8 @@ static help_item static_help_list[] =
 		"  ignore [<cpunum>[,<cpunum>[,...]]] -- stops debugging on <cpunum>\n"
 		"  observe [<cpunum>[,<cpunum>[,...]]] -- resumes debugging on <cpunum>\n"
 		"  trace {<filename>|OFF}[,<cpunum>[,<action>]] -- trace the given CPU to a file (defaults to active CPU)\n"
+		"  tracebin {<filename>|OFF}[,<cpunum>[,<registers>[,<action>]]] -- trace the given CPU to a binary file\n"
+		"  tracedasm <binfile>,<filename>[,<cpunum>] -- disassemble a binary trace to a text file\n"
 	},
 	{
 		"breakpoints",
@@ -150,6 +153,10 @@ static help_item static_help_list[] =
 		"  wpenable [<wpnum>] -- enables a given watchpoint or all if no <wpnum> specified\n"
 		"  wplist -- lists all the watchpoints\n"
 		"  hotspot [<cpunum>,[<depth>[,<hits>]]] -- attempt to find hotspots\n"
+		"  profile {<filename>|OFF}[,<cpunum>[,<interval>[,<granularity>]]] -- sample where a CPU spends its time\n"
+#ifdef MEMORY_PROFILE
+		"  memprofile [<count>|RESET] -- list the memory handlers taking the most time\n"
+#endif
 	},
 	{
 		"expressions",
@@ -226,6 +233,25 @@ static help_item static_help_list[] =
 		"symlist 2\n"
 		"  Displays the symbols specific to CPU #2.\n"
 	},
+	{
+		"exprbench",
+		"\n"
+		"  exprbench <expression>[,<count>]\n"
+		"\n"
+		"The exprbench command evaluates <expression> <count> times with the expression interpreter, "
+		"then <count> times more with the compiled form that breakpoint and watchpoint conditions use, "
+		"and reports the average time per evaluation of each. <count> defaults to 1000000. Expressions "
+		"containing assignments, increments or decrements are never compiled. Note that the expression "
+		"really is evaluated each time, so any side effects happen <count> times over.\n"
+		"\n"
+		"Examples:\n"
+		"\n"
+		"exprbench pc==1234 && b@(a0) != 0\n"
+		"  Times a typical breakpoint condition one million times with each evaluator.\n"
+		"\n"
+		"exprbench w@(sp+2),#100000\n"
+		"  Times a memory read 100000 times with each evaluator.\n"
+	},
 	{
 		"print",
 		"\n"
@@ -693,6 +719,46 @@ static help_item static_help_list[] =
 		"  Begin tracing the execution of CPU #0, logging output to asteroid.tr. Before each line, "
 		"output A=<aval> to the tracelog.\n"
 	},
+	{
+		"tracebin",
+		"\n"
+		"  tracebin {<filename>|OFF}[,<cpunum>[,<registers>[,<action>]]]\n"
+		"\n"
+		"Starts or stops a binary trace of the execution of the specified <cpunum>. This works like the "
+		"trace command, but instead of disassembling each instruction as it runs, it records the PC, the "
+		"opcode bytes and the cycles taken since the previous instruction into a large buffer which is "
+		"written out in the background. This is much faster than a text trace and the file is much "
+		"smaller. If <registers> is nonzero, any registers that changed since the previous instruction "
+		"are recorded as well. Loops are collapsed just as they are in a text trace, and any tracelog "
+		"output from <action> is kept. Use the tracedasm command to turn the binary file into text.\n"
+		"\n"
+		"Examples:\n"
+		"\n"
+		"tracebin dribling.trb,0\n"
+		"  Begin a binary trace of CPU #0 to dribling.trb.\n"
+		"\n"
+		"tracebin joust.trb,1,1\n"
+		"  Begin a binary trace of CPU #1 to joust.trb, recording register changes.\n"
+		"\n"
+		"tracebin off,0\n"
+		"  Turn off tracing on CPU #0.\n"
+	},
+	{
+		"tracedasm",
+		"\n"
+		"  tracedasm <binfile>,<filename>[,<cpunum>]\n"
+		"\n"
+		"Converts a binary trace recorded with the tracebin command into the same text format that the "
+		"trace command writes, using the disassembler of <cpunum>. If <cpunum> is omitted, the currently "
+		"active CPU is used; it must be the same type of CPU the trace was recorded from. Each line also "
+		"shows the cycles taken since the previous instruction, and any recorded register changes. The "
+		"conversion can be done at any time, even from a later session of the same game.\n"
+		"\n"
+		"Examples:\n"
+		"\n"
+		"tracedasm dribling.trb,dribling.tr,0\n"
+		"  Disassembles the binary trace dribling.trb into dribling.tr using CPU #0's disassembler.\n"
+	},
 	{
 		"traceflush",
 		"\n"
@@ -925,6 +991,55 @@ static help_item static_help_list[] =
 		"  Looks for hotspots on CPU 1 using a search buffer of 64 entries, reporting any entries which "
 		"end up with 1000 or more hits.\n"
 	},
+	{
+		"profile",
+		"\n"
+		"  profile {<filename>|OFF}[,<cpunum>[,<interval>[,<granularity>]]]\n"
+		"\n"
+		"The profile command samples the PC of <cpunum> once every <interval> emulated cycles, building a "
+		"histogram of where the CPU spends its time. <cpunum> defaults to the currently active CPU and "
+		"<interval> defaults to 1000 cycles. Samples are gathered into address ranges of 2^<granularity> "
+		"addresses each; <granularity> defaults to 4. Profiling continues even on CPUs being ignored by "
+		"the debugger. When profiling is turned off, or when the emulator exits, a report is written to "
+		"<filename>. The report lists the busiest address ranges first. If any comments have been added "
+		"for the CPU, it also totals the samples by the closest comment before each range. Commenting the "
+		"first instruction of each routine turns this into a per-routine profile.\n"
+		"\n"
+		"Examples:\n"
+		"\n"
+		"profile galaga.prf,0\n"
+		"  Profiles CPU #0 every 1000 cycles, writing the report to galaga.prf.\n"
+		"\n"
+		"profile sf2.prf,0,#100,8\n"
+		"  Profiles CPU #0 every 100 cycles, in ranges of 256 addresses.\n"
+		"\n"
+		"profile off,0\n"
+		"  Stops profiling CPU #0 and writes the report.\n"
+	},
+#ifdef MEMORY_PROFILE
+	{
+		"memprofile",
+		"\n"
+		"  memprofile [<count>|RESET]\n"
+		"\n"
+		"The memprofile command lists the <count> memory handlers that have taken the most time so far; "
+		"<count> defaults to 20. Handlers sharing a name are combined across all CPUs and address spaces. "
+		"For each handler it shows the number of calls, its share of the time spent in all handlers, the "
+		"average profiling ticks per call, and the most frequent callers as <cpunum>:<pc>, sampled once "
+		"every 16 calls. Time spent in a handler includes any handlers it calls in turn. Banked memory "
+		"is accessed directly and never shows up. The same table is printed when the emulator exits. "
+		"memprofile RESET clears the statistics. This command is only present in builds made with "
+		"MEMORY_PROFILE defined.\n"
+		"\n"
+		"Examples:\n"
+		"\n"
+		"memprofile\n"
+		"  Lists the 20 most expensive memory handlers.\n"
+		"\n"
+		"memprofile reset\n"
+		"  Clears the statistics, so that only what happens from now on is counted.\n"
+	},
+#endif
 	{
 		"map",
 		"\n"
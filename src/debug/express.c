@@ -33,6 +33,7 @@
 #define MAX_STRING_LENGTH		256
 #define MAX_EXPRESSION_STRINGS	64
 #define MAX_SYMBOL_LENGTH		64
+#define MAX_COMPILED_OPS		(MAX_TOKENS * 2 + 1)
 
 #define SYM_TABLE_HASH_SIZE		97
 
@@ -138,6 +139,28 @@ enum
 };
 
 
+/* compiled_op.opcode values; operators use their TVL_* value directly */
+enum
+{
+	EOP_END = TVL_EXECUTEFUNC + 1,	/* return the value on top of the stack */
+	EOP_CONST,						/* push a constant */
+	EOP_REGISTER,					/* push the result of a register getter */
+	EOP_VALUE,						/* push the current value of a value symbol */
+	EOP_READ,						/* replace an address on the stack with the memory it points to */
+	EOP_CALL						/* replace the parameters on the stack with a function result */
+};
+
+
+/* compile_entry.kind values */
+enum
+{
+	CEK_VALUE,						/* a computed value */
+	CEK_CONST,						/* a constant that is a candidate for folding */
+	CEK_MEMORY,						/* an address whose read is deferred until it is used */
+	CEK_FUNCTION					/* a function symbol; takes no space at runtime */
+};
+
+
 
 /***************************************************************************
     TYPE DEFINITIONS
@@ -178,6 +201,28 @@ struct _symbol_table
 };
 
 
+typedef struct _compiled_op compiled_op;
+struct _compiled_op
+{
+	UINT8			opcode;			/* TVL_* operator or EOP_* opcode */
+	UINT8			param;			/* stack depth or parameter count */
+	UINT16			info;			/* memory info for reads */
+	UINT32			offset;			/* offset within the string, for errors */
+	int_ptr			value;			/* constant or symbol */
+};
+
+
+typedef struct _compile_entry compile_entry;
+struct _compile_entry
+{
+	UINT16			kind;			/* what the entry holds (CEK_*) */
+	UINT16			info;			/* memory info for deferred reads */
+	UINT32			offset;			/* offset within the string, for errors */
+	int				codepos;		/* instruction that pushed a constant */
+	symbol_entry *	symbol;			/* function symbol */
+};
+
+
 /* typedef struct _parsed_expression parsed_expression -- defined in express.h */
 struct _parsed_expression
 {
@@ -187,6 +232,8 @@ struct _parsed_expression
 	parse_token		token[MAX_TOKENS];/* array of tokens */
 	int				token_stack_ptr;/* stack poointer */
 	parse_token		token_stack[MAX_STACK_DEPTH];/* token stack */
+	int				codelength;		/* number of compiled ops, or 0 if not compiled */
+	compiled_op		code[MAX_COMPILED_OPS];/* compiled ops */
 };
 
 
@@ -1543,6 +1590,385 @@ static EXPRERR execute_tokens(parsed_expression *expr, UINT64 *result)
 
 
 
+
+/***************************************************************************
+    EXPRESSION COMPILATION
+***************************************************************************/
+
+/*-------------------------------------------------
+    execute_code - execute a sequence of
+    compiled ops
+-------------------------------------------------*/
+
+static EXPRERR execute_code(const compiled_op *op, UINT64 *result)
+{
+	UINT64 stack[MAX_STACK_DEPTH];
+	UINT64 *sp = stack;
+	symbol_entry *symbol;
+
+	/* the compiler has already checked the stack depth, so no checks are needed here */
+	for ( ; ; op++)
+		switch (op->opcode)
+		{
+			case EOP_END:
+				*result = sp[-1];
+				return EXPRERR_NONE;
+
+			case EOP_CONST:
+				*sp++ = op->value.i;
+				break;
+
+			case EOP_REGISTER:
+				symbol = op->value.p;
+				*sp++ = (*symbol->info.reg.getter)(symbol->ref);
+				break;
+
+			case EOP_VALUE:
+				symbol = op->value.p;
+				*sp++ = symbol->info.gen.value;
+				break;
+
+			case EOP_READ:
+				sp[-1 - op->param] = external_read_memory((op->info & TIN_MEMORY_SPACE_MASK) >> TIN_MEMORY_SPACE_SHIFT,
+						sp[-1 - op->param], 1 << ((op->info & TIN_MEMORY_SIZE_MASK) >> TIN_MEMORY_SIZE_SHIFT));
+				break;
+
+			case EOP_CALL:
+				symbol = op->value.p;
+				sp -= op->param;
+				*sp = (*symbol->info.func.execute)(symbol->ref, op->param, sp);
+				sp++;
+				break;
+
+			case TVL_COMPLEMENT:		sp[-1] = !sp[-1];				break;
+			case TVL_NOT:				sp[-1] = ~sp[-1];				break;
+			case TVL_UMINUS:			sp[-1] = -sp[-1];				break;
+
+			case TVL_MULTIPLY:			sp--; sp[-1] *= sp[0];			break;
+			case TVL_ADD:				sp--; sp[-1] += sp[0];			break;
+			case TVL_SUBTRACT:			sp--; sp[-1] -= sp[0];			break;
+			case TVL_LSHIFT:			sp--; sp[-1] <<= sp[0];			break;
+			case TVL_RSHIFT:			sp--; sp[-1] >>= sp[0];			break;
+			case TVL_LESS:				sp--; sp[-1] = sp[-1] < sp[0];	break;
+			case TVL_LESSOREQUAL:		sp--; sp[-1] = sp[-1] <= sp[0];	break;
+			case TVL_GREATER:			sp--; sp[-1] = sp[-1] > sp[0];	break;
+			case TVL_GREATEROREQUAL:	sp--; sp[-1] = sp[-1] >= sp[0];	break;
+			case TVL_EQUAL:				sp--; sp[-1] = sp[-1] == sp[0];	break;
+			case TVL_NOTEQUAL:			sp--; sp[-1] = sp[-1] != sp[0];	break;
+			case TVL_BAND:				sp--; sp[-1] &= sp[0];			break;
+			case TVL_BXOR:				sp--; sp[-1] ^= sp[0];			break;
+			case TVL_BOR:				sp--; sp[-1] |= sp[0];			break;
+			case TVL_LAND:				sp--; sp[-1] = sp[-1] && sp[0];	break;
+			case TVL_LOR:				sp--; sp[-1] = sp[-1] || sp[0];	break;
+			case TVL_COMMA:				sp--; sp[-1] = sp[0];			break;
+
+			case TVL_DIVIDE:
+				if (sp[-1] == 0) return MAKE_EXPRERR_DIVIDE_BY_ZERO(op->offset);
+				sp--; sp[-1] /= sp[0];
+				break;
+
+			case TVL_MODULO:
+				if (sp[-1] == 0) return MAKE_EXPRERR_DIVIDE_BY_ZERO(op->offset);
+				sp--; sp[-1] %= sp[0];
+				break;
+
+			default:
+				return MAKE_EXPRERR_INVALID_TOKEN(op->offset);
+		}
+}
+
+
+/*-------------------------------------------------
+    emit_op - append an op to the compiled code
+-------------------------------------------------*/
+
+INLINE compiled_op *emit_op(parsed_expression *expr, int opcode, int param, UINT32 offset)
+{
+	compiled_op *op;
+
+	if (expr->codelength >= MAX_COMPILED_OPS)
+		return NULL;
+	op = &expr->code[expr->codelength++];
+	op->opcode = opcode;
+	op->param = param;
+	op->info = 0;
+	op->offset = offset;
+	op->value.i = 0;
+	return op;
+}
+
+
+/*-------------------------------------------------
+    compile_rval - make sure a compile-time stack
+    entry will be a plain value at runtime; depth
+    is its distance from the top of the stack
+-------------------------------------------------*/
+
+static int compile_rval(parsed_expression *expr, compile_entry *entry, int depth)
+{
+	compiled_op *op;
+
+	/* functions are only valid as the target of a call */
+	if (entry->kind == CEK_FUNCTION)
+		return FALSE;
+
+	/* memory is read at the point it is consumed, just as the interpreter does */
+	if (entry->kind == CEK_MEMORY)
+	{
+		op = emit_op(expr, EOP_READ, depth, entry->offset);
+		if (op == NULL)
+			return FALSE;
+		op->info = entry->info;
+		entry->kind = CEK_VALUE;
+	}
+	return TRUE;
+}
+
+
+/*-------------------------------------------------
+    fold_constants - if all the operands of the
+    op just emitted were constants pushed right
+    before it, replace the lot with the result
+-------------------------------------------------*/
+
+static int fold_constants(parsed_expression *expr, const compile_entry *operand, int count)
+{
+	int start = expr->codelength - count - 1;
+	compiled_op *op;
+	UINT64 value;
+	int index;
+
+	for (index = 0; index < count; index++)
+		if (operand[index].kind != CEK_CONST || operand[index].codepos != start + index)
+			return FALSE;
+
+	/* run the ops through the executor; anything that fails (divide by zero) is left for runtime */
+	if (emit_op(expr, EOP_END, 0, 0) == NULL)
+		return FALSE;
+	if (execute_code(&expr->code[start], &value) != EXPRERR_NONE)
+	{
+		expr->codelength--;
+		return FALSE;
+	}
+
+	expr->codelength = start;
+	op = emit_op(expr, EOP_CONST, 0, operand[0].offset);
+	op->value.i = value;
+	return TRUE;
+}
+
+
+/*-------------------------------------------------
+    compile_operator - compile a single operator
+    token
+-------------------------------------------------*/
+
+static int compile_operator(parsed_expression *expr, parse_token *token, compile_entry *stack, int *sp)
+{
+	compile_entry *t1, *t2;
+	symbol_entry *symbol;
+	compiled_op *op;
+	int count, index;
+
+	switch (token->value.i)
+	{
+		case TVL_COMPLEMENT:
+		case TVL_NOT:
+		case TVL_UPLUS:
+		case TVL_UMINUS:
+			if (*sp < 1)
+				return FALSE;
+			t1 = &stack[*sp - 1];
+			if (!compile_rval(expr, t1, 0))
+				return FALSE;
+
+			/* unary plus changes nothing, so a constant stays foldable */
+			if (token->value.i == TVL_UPLUS)
+				break;
+			if (emit_op(expr, token->value.i, 0, t1->offset) == NULL)
+				return FALSE;
+			if (fold_constants(expr, t1, 1))
+				t1->codepos = expr->codelength - 1;
+			else
+				t1->kind = CEK_VALUE;
+			break;
+
+		case TVL_COMMA:
+			/* commas between function parameters just leave the parameters on the stack */
+			if (token->info & TIN_FUNCTION)
+				break;
+			/* fall through */
+
+		case TVL_MULTIPLY:
+		case TVL_DIVIDE:
+		case TVL_MODULO:
+		case TVL_ADD:
+		case TVL_SUBTRACT:
+		case TVL_LSHIFT:
+		case TVL_RSHIFT:
+		case TVL_LESS:
+		case TVL_LESSOREQUAL:
+		case TVL_GREATER:
+		case TVL_GREATEROREQUAL:
+		case TVL_EQUAL:
+		case TVL_NOTEQUAL:
+		case TVL_BAND:
+		case TVL_BXOR:
+		case TVL_BOR:
+		case TVL_LAND:
+		case TVL_LOR:
+			if (*sp < 2)
+				return FALSE;
+			t1 = &stack[*sp - 2];
+			t2 = &stack[*sp - 1];
+			if (!compile_rval(expr, t2, 0) || !compile_rval(expr, t1, 1))
+				return FALSE;
+
+			/* the divide op carries the offset of the divisor for error reporting */
+			if (emit_op(expr, token->value.i, 0, t2->offset) == NULL)
+				return FALSE;
+			if (token->value.i == TVL_COMMA)
+				t1->offset = t2->offset;
+			else if (t2->offset < t1->offset)
+				t1->offset = t2->offset;
+			if (fold_constants(expr, t1, 2))
+				t1->codepos = expr->codelength - 1;
+			else
+				t1->kind = CEK_VALUE;
+			(*sp)--;
+			break;
+
+		case TVL_MEMORYAT:
+			if (*sp < 1)
+				return FALSE;
+			t1 = &stack[*sp - 1];
+			if (!compile_rval(expr, t1, 0))
+				return FALSE;
+			t1->kind = CEK_MEMORY;
+			t1->info = token->info;
+			t1->offset = 0;
+			break;
+
+		case TVL_EXECUTEFUNC:
+			/* find the function symbol beneath the parameters */
+			for (count = 0; count < MAX_FUNCTION_PARAMS; count++)
+			{
+				if (count >= *sp)
+					return FALSE;
+				if (stack[*sp - 1 - count].kind == CEK_FUNCTION)
+					break;
+			}
+			if (count == MAX_FUNCTION_PARAMS)
+				return FALSE;
+			symbol = stack[*sp - 1 - count].symbol;
+			if (count < symbol->info.func.minparams || count > symbol->info.func.maxparams)
+				return FALSE;
+
+			/* resolve the parameters top down, the same order the interpreter pops them */
+			for (index = 0; index < count; index++)
+				if (!compile_rval(expr, &stack[*sp - 1 - index], index))
+					return FALSE;
+			op = emit_op(expr, EOP_CALL, count, token->offset);
+			if (op == NULL)
+				return FALSE;
+			op->value.p = symbol;
+
+			*sp -= count;
+			t1 = &stack[*sp - 1];
+			t1->kind = CEK_VALUE;
+			t1->offset = token->offset;
+			break;
+
+		/* assignments and increments are left to the interpreter */
+		default:
+			return FALSE;
+	}
+	return TRUE;
+}
+
+
+/*-------------------------------------------------
+    compile_tokens - compile a postfix sequence of
+    tokens into ops; returns FALSE if the
+    expression must be left to the interpreter
+-------------------------------------------------*/
+
+static int compile_tokens(parsed_expression *expr)
+{
+	compile_entry stack[MAX_STACK_DEPTH];
+	int tokindex, sp = 0;
+
+	expr->codelength = 0;
+
+	/* loop over the entire sequence */
+	for (tokindex = 0; expr->token[tokindex].type != TOK_END; tokindex++)
+	{
+		parse_token *token = &expr->token[tokindex];
+		compile_entry *entry;
+		symbol_entry *symbol;
+		compiled_op *op;
+
+		if (token->type == TOK_OPERATOR)
+		{
+			if (!compile_operator(expr, token, stack, &sp))
+				return FALSE;
+			continue;
+		}
+
+		/* everything else pushes a new entry */
+		if (sp >= MAX_STACK_DEPTH)
+			return FALSE;
+		entry = &stack[sp++];
+		entry->offset = token->offset;
+		entry->codepos = expr->codelength;
+
+		switch (token->type)
+		{
+			case TOK_NUMBER:
+				op = emit_op(expr, EOP_CONST, 0, token->offset);
+				if (op == NULL)
+					return FALSE;
+				op->value.i = token->value.i;
+				entry->kind = CEK_CONST;
+				break;
+
+			/* registers and values are fetched when pushed rather than when popped; getters
+               have no side effects, so the result is the same */
+			case TOK_SYMBOL:
+				symbol = token->value.p;
+				if (symbol == NULL)
+					return FALSE;
+				entry->symbol = symbol;
+				entry->kind = CEK_VALUE;
+				if (symbol->type == SMT_FUNCTION)
+				{
+					entry->kind = CEK_FUNCTION;
+					break;
+				}
+				else if (symbol->type == SMT_REGISTER)
+					op = emit_op(expr, EOP_REGISTER, 0, token->offset);
+				else if (symbol->type == SMT_VALUE)
+					op = emit_op(expr, EOP_VALUE, 0, token->offset);
+				else
+					return FALSE;
+				if (op == NULL)
+					return FALSE;
+				op->value.p = symbol;
+				break;
+
+			/* strings are only meaningful to assignments, which we don't compile */
+			default:
+				return FALSE;
+		}
+	}
+
+	/* anything but a single final value is an error the interpreter must report */
+	if (sp != 1 || !compile_rval(expr, &stack[0], 0))
+		return FALSE;
+	return (emit_op(expr, EOP_END, 0, 0) != NULL);
+}
+
+
 /***************************************************************************
     MISC HELPERS
 ***************************************************************************/
@@ -1631,6 +2057,10 @@ EXPRERR expression_parse(const char *expression, const symbol_table *table, pars
 	if (exprerr != EXPRERR_NONE)
 		goto cleanup;
 
+	/* compile what we can; the rest runs through the interpreter */
+	if (!compile_tokens(&temp_expression))
+		temp_expression.codelength = 0;
+
 	/* allocate memory for the result */
 	*result = malloc(sizeof(temp_expression));
 	if (!*result)
@@ -1656,11 +2086,38 @@ cleanup:
 
 EXPRERR expression_execute(parsed_expression *expr, UINT64 *result)
 {
+	/* use the compiled code if we have it */
+	if (expr->codelength != 0)
+		return execute_code(expr->code, result);
+
 	/* execute the expression to get the result */
 	return execute_tokens(expr, result);
 }
 
 
+/*-------------------------------------------------
+    expression_execute_interpreted - execute a
+    previously-parsed expression without using
+    the compiled code
+-------------------------------------------------*/
+
+EXPRERR expression_execute_interpreted(parsed_expression *expr, UINT64 *result)
+{
+	return execute_tokens(expr, result);
+}
+
+
+/*-------------------------------------------------
+    expression_is_compiled - return TRUE if the
+    expression was compiled
+-------------------------------------------------*/
+
+int expression_is_compiled(parsed_expression *expr)
+{
+	return (expr->codelength != 0);
+}
+
+
 /*-------------------------------------------------
     expression_free - free a previously
     allocated parsed expression
@@ -143,6 +143,8 @@ void	external_write_memory(int space, UINT32 offset, int size, UINT64 value);
 EXPRERR 					expression_evaluate(const char *expression, const symbol_table *table, UINT64 *result);
 EXPRERR 					expression_parse(const char *expression, const symbol_table *table, parsed_expression **result);
 EXPRERR 					expression_execute(parsed_expression *expr, UINT64 *result);
+EXPRERR 					expression_execute_interpreted(parsed_expression *expr, UINT64 *result);
+int							expression_is_compiled(parsed_expression *expr);
 void 						expression_free(parsed_expression *expr);
 const char *				expression_original_string(parsed_expression *expr);
 const char *				exprerr_to_string(EXPRERR error);
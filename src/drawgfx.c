@@ -3402,6 +3402,119 @@ void mdrawgfxzoom( mame_bitmap *dest_bmp,const gfx_element *gfx,
 	profiler_mark(PROFILER_END);
 }
 
+
+/***************************************************************************
+
+  Draw a list of sprites, in list order, with the same results as calling
+  drawgfxzoom() (or pdrawgfxzoom()) once for each of them.
+
+  Sprites entirely outside the clip rectangle are rejected up front; the
+  rest are drawn one horizontal band at a time, so that the destination
+  and priority bitmap rows being written stay in the cache while every
+  sprite crossing them is drawn.
+
+***************************************************************************/
+
+#define SPRITE_BAND_HEIGHT	32	/* scanlines drawn per pass over the list */
+#define SPRITE_BATCH		256	/* sprites binned at a time */
+
+INLINE void common_drawgfx_list(mame_bitmap *dest,const gfx_sprite *list,int count,
+		const rectangle *clip,mame_bitmap *pri_buffer,UINT32 pri_or)
+{
+	const gfx_sprite *visible[SPRITE_BATCH];
+	INT32 top[SPRITE_BATCH], bottom[SPRITE_BATCH];
+	rectangle bounds, band;
+
+	/* the drawing functions clip to the bitmap themselves, so only reject against the overlap */
+	bounds.min_x = 0;
+	bounds.max_x = dest->width - 1;
+	bounds.min_y = 0;
+	bounds.max_y = dest->height - 1;
+	if (clip)
+	{
+		if (bounds.min_x < clip->min_x) bounds.min_x = clip->min_x;
+		if (bounds.max_x > clip->max_x) bounds.max_x = clip->max_x;
+		if (bounds.min_y < clip->min_y) bounds.min_y = clip->min_y;
+		if (bounds.max_y > clip->max_y) bounds.max_y = clip->max_y;
+	}
+	if (bounds.min_x > bounds.max_x || bounds.min_y > bounds.max_y)
+		return;
+	band.min_x = bounds.min_x;
+	band.max_x = bounds.max_x;
+
+	while (count > 0)
+	{
+		int batch = MIN(count, SPRITE_BATCH);
+		int visible_count = 0;
+		INT32 miny = bounds.max_y, maxy = bounds.min_y;
+		int i;
+
+		/* bin the sprites that land inside the clip */
+		for (i = 0; i < batch; i++)
+		{
+			const gfx_sprite *sprite = &list[i];
+			int width, height;
+
+			if (sprite->scalex == 0x10000 && sprite->scaley == 0x10000)
+			{
+				width = sprite->gfx->width;
+				height = sprite->gfx->height;
+			}
+			else
+			{
+				width = (sprite->scalex * sprite->gfx->width + 0x8000) >> 16;
+				height = (sprite->scaley * sprite->gfx->height + 0x8000) >> 16;
+			}
+
+			if (width <= 0 || height <= 0 ||
+				sprite->sx > bounds.max_x || sprite->sx + width - 1 < bounds.min_x ||
+				sprite->sy > bounds.max_y || sprite->sy + height - 1 < bounds.min_y)
+				continue;
+
+			visible[visible_count] = sprite;
+			top[visible_count] = MAX(sprite->sy, bounds.min_y);
+			bottom[visible_count] = MIN(sprite->sy + height - 1, bounds.max_y);
+			if (top[visible_count] < miny) miny = top[visible_count];
+			if (bottom[visible_count] > maxy) maxy = bottom[visible_count];
+			visible_count++;
+		}
+
+		/* draw them a band at a time; clipping never changes which source pixel lands where */
+		if (visible_count != 0)
+			for (band.min_y = miny; band.min_y <= maxy; band.min_y += SPRITE_BAND_HEIGHT)
+			{
+				band.max_y = MIN(band.min_y + SPRITE_BAND_HEIGHT - 1, maxy);
+
+				for (i = 0; i < visible_count; i++)
+					if (top[i] <= band.max_y && bottom[i] >= band.min_y)
+					{
+						const gfx_sprite *sprite = visible[i];
+
+						common_drawgfxzoom(dest,sprite->gfx,sprite->code,sprite->color,sprite->flipx,sprite->flipy,
+								sprite->sx,sprite->sy,&band,sprite->transparency,sprite->transparent_color,
+								sprite->scalex,sprite->scaley,pri_buffer,pri_buffer ? (sprite->priority_mask | pri_or) : 0);
+					}
+			}
+
+		list += batch;
+		count -= batch;
+	}
+}
+
+void drawgfx_list(mame_bitmap *dest,const gfx_sprite *list,int count,const rectangle *clip)
+{
+	profiler_mark(PROFILER_DRAWGFX);
+	common_drawgfx_list(dest,list,count,clip,NULL,0);
+	profiler_mark(PROFILER_END);
+}
+
+void pdrawgfx_list(mame_bitmap *dest,const gfx_sprite *list,int count,const rectangle *clip)
+{
+	profiler_mark(PROFILER_DRAWGFX);
+	common_drawgfx_list(dest,list,count,clip,priority_bitmap,1<<31);
+	profiler_mark(PROFILER_END);
+}
+
 INLINE void plotclip(mame_bitmap *bitmap,int x,int y,int pen,const rectangle *clip)
 {
 	if (x >= clip->min_x && x <= clip->max_x && y >= clip->min_y && y <= clip->max_y)
@@ -112,6 +112,22 @@ struct _alpha_cache
 
 extern struct _alpha_cache drawgfx_alpha_cache;
 
+
+/* one entry of a sprite list for drawgfx_list() and pdrawgfx_list() */
+typedef struct _gfx_sprite gfx_sprite;
+struct _gfx_sprite
+{
+	const gfx_element *gfx;		/* graphics to draw from */
+	UINT32 code;				/* character/sprite number */
+	UINT32 color;				/* color code */
+	UINT8 flipx, flipy;			/* flip flags */
+	INT32 sx, sy;				/* destination position */
+	INT32 scalex, scaley;		/* 16.16 zoom factors, 0x10000 for no zoom */
+	int transparency;			/* TRANSPARENCY_xxx mode */
+	int transparent_color;		/* transparent pen, pens or color */
+	UINT32 priority_mask;		/* as passed to pdrawgfx(); ignored by drawgfx_list() */
+};
+
 enum
 {
 	TRANSPARENCY_NONE,			/* opaque with remapping */
@@ -228,6 +244,10 @@ void mdrawgfxzoom( mame_bitmap *dest_bmp,const gfx_element *gfx,
 		const rectangle *clip,int transparency,int transparent_color,int scalex,int scaley,
 		UINT32 priority_mask);
 
+/* draw a list of sprites in order, same as calling drawgfxzoom()/pdrawgfxzoom() for each */
+void drawgfx_list(mame_bitmap *dest,const gfx_sprite *list,int count,const rectangle *clip);
+void pdrawgfx_list(mame_bitmap *dest,const gfx_sprite *list,int count,const rectangle *clip);
+
 
 
 INLINE void plot_pixel(mame_bitmap *bitmap, int x, int y, pen_t pen)
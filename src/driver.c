@@ -324,19 +324,22 @@ int driver_get_index(const char *name)
 {
 	int lurnum, drvnum;
 
-	/* scan the LRU list first */
+	/* scan the LRU list first; the LRU is not thread-safe, so the auditor */
+	/* serializes its calls with its own lock */
 	for (lurnum = 0; lurnum < DRIVER_LRU_SIZE; lurnum++)
-		if (mame_stricmp(drivers[driver_lru[lurnum]]->name, name) == 0)
+	{
+		drvnum = driver_lru[lurnum];
+		if (mame_stricmp(drivers[drvnum]->name, name) == 0)
 		{
 			/* if not first, swap with the head */
 			if (lurnum != 0)
 			{
-				int temp = driver_lru[0];
-				driver_lru[0] = driver_lru[lurnum];
-				driver_lru[lurnum] = temp;
+				driver_lru[lurnum] = driver_lru[0];
+				driver_lru[0] = drvnum;
 			}
-			return driver_lru[0];
+			return drvnum;
 		}
+	}
 
 	/* scan for a match in the drivers -- slow! */
 	for (drvnum = 0; drivers[drvnum] != NULL; drvnum++)
@@ -75,6 +75,8 @@ struct _mame_file
 	UINT64			length;
 	UINT8			eof;
 	UINT8			type;
+	char *			filename;
+	UINT64			stamp;
 	char			hash[HASH_BUF_SIZE];
 	text_file_type	text_type;
 	char			back_chars[UTF8_CHAR_MAX];
@@ -154,6 +156,7 @@ static chd_interface mame_chd_interface =
 void fileio_init(running_machine *machine)
 {
 	chd_set_interface(&mame_chd_interface);
+	zip_file_cache_set_size(options_get_int(OPTION_ZIP_CACHE_SIZE));
 	add_exit_callback(machine, fileio_exit);
 }
 
@@ -249,7 +252,10 @@ static mame_file_error fopen_internal(const char *searchpath, const char *filena
 		/* attempt to open the file directly */
 		filerr = fopen_attempt_plain(fullname, openflags, *file);
 		if (filerr == FILERR_NONE)
+		{
+			(*file)->filename = mame_strdup(fullname);
 			break;
+		}
 
 		/* if we're opening for read-only we have other options */
 		if ((openflags & (OPEN_FLAG_READ | OPEN_FLAG_WRITE)) == OPEN_FLAG_READ)
@@ -295,6 +301,37 @@ static mame_file_error fopen_attempt_plain(char *fullname, UINT32 openflags, mam
 }
 
 
+/*-------------------------------------------------
+    zip_member_stamp - build a stamp for a ZIP
+    member from the archive's modification time
+    and length plus the member's CRC and length;
+    the CRC alone can't tell a bad dump from a
+    good one
+-------------------------------------------------*/
+
+static UINT64 zip_member_stamp(const zip_file *zip, const zip_file_header *header)
+{
+	UINT64 values[4];
+	UINT64 stamp = U64(0xcbf29ce484222325);
+	int i;
+
+	/* without the archive's time we can't tell if it was replaced */
+	if (zip->modified == 0)
+		return 0;
+
+	/* FNV-1 style mix of all four values */
+	values[0] = zip->modified;
+	values[1] = zip->length;
+	values[2] = header->crc;
+	values[3] = header->uncompressed_length;
+	for (i = 0; i < 4; i++)
+		stamp = (stamp * U64(0x100000001b3)) ^ values[i];
+
+	/* 0 means "no stamp" */
+	return (stamp != 0) ? stamp : 1;
+}
+
+
 /*-------------------------------------------------
     fopen_attempt_zipped - attempt to open a
     ZIPped file
@@ -313,7 +350,6 @@ static mame_file_error fopen_attempt_zipped(char *fullname, const char *filename
 	while (1)
 	{
 		const zip_file_header *header;
-		int filenamelen;
 
 		/* find the previous path separator */
 		for (dirsep--; dirsep >= filename && *dirsep != PATH_SEPARATOR[0]; dirsep--) ;
@@ -343,23 +379,8 @@ static mame_file_error fopen_attempt_zipped(char *fullname, const char *filename
 		if (ziperr != ZIPERR_NONE)
 			continue;
 
-		/* precompute the filename length */
-		filenamelen = (UINT32)strlen(dirsep + 1);
-
-		/* see if we can find the file */
-		for (header = zip_file_first_file(zip); header != NULL; header = zip_file_next_file(zip))
-		{
-			const char *zipfile = header->filename + header->filename_length - filenamelen;
-
-			/* filename match first */
-			if (zipfile >= header->filename && mame_stricmp(zipfile, dirsep + 1) == 0 &&
-				(zipfile == header->filename || zipfile[-1] == '/'))
-				break;
-
-			/* CRC match second */
-			if ((openflags & OPEN_FLAG_HAS_CRC) && header->crc == crc)
-				break;
-		}
+		/* see if we can find the file by name or CRC */
+		header = zip_file_find_file(zip, dirsep + 1, crc, (openflags & OPEN_FLAG_HAS_CRC) != 0);
 
 		/* if we got it, read the data */
 		if (header != NULL)
@@ -369,6 +390,8 @@ static mame_file_error fopen_attempt_zipped(char *fullname, const char *filename
 			file->zipfile = zip;
 			file->type = ZIPPED_FILE;
 			file->length = header->uncompressed_length;
+			file->filename = assemble_3_strings(zip->filename, PATH_SEPARATOR, header->filename);
+			file->stamp = zip_member_stamp(zip, header);
 
 			/* build a hash with just the CRC */
 			hash_data_clear(file->hash);
@@ -404,6 +427,8 @@ void mame_fclose(mame_file *file)
 		osd_close(file->file);
 	if (file->data != NULL)
 		free(file->data);
+	if (file->filename != NULL)
+		free(file->filename);
 	free(file);
 }
 
@@ -481,6 +506,37 @@ UINT64 mame_fsize(mame_file *file)
 }
 
 
+/*-------------------------------------------------
+    mame_file_full_name - returns the full path
+    of an open file; for ZIPped files this is the
+    archive path followed by the member name
+-------------------------------------------------*/
+
+const char *mame_file_full_name(mame_file *file)
+{
+	return (file->filename != NULL) ? file->filename : "";
+}
+
+
+/*-------------------------------------------------
+    mame_fstamp - returns a value that changes
+    whenever the contents of the file do, or 0
+    if none is available; this is the modification
+    time for plain files, and a mix of the archive's
+    time and length with the member's CRC and length
+    for ZIPped files
+-------------------------------------------------*/
+
+UINT64 mame_fstamp(mame_file *file)
+{
+	/* plain files ask the OSD, but only while we still have the handle */
+	if (file->stamp == 0 && file->type == PLAIN_FILE && file->file != NULL)
+		if (osd_get_modified_time(file->file, &file->stamp) != FILERR_NONE)
+			file->stamp = 0;
+	return file->stamp;
+}
+
+
 
 /***************************************************************************
     FILE READ
@@ -54,6 +54,7 @@
 #define SEARCHPATH_SCREENSHOT	OPTION_SNAPSHOT_DIRECTORY
 #define SEARCHPATH_MOVIE		OPTION_SNAPSHOT_DIRECTORY
 #define SEARCHPATH_COMMENT		OPTION_COMMENT_DIRECTORY
+#define SEARCHPATH_CACHE		OPTION_CACHE_DIRECTORY
 
 
 
@@ -96,6 +97,12 @@ int mame_feof(mame_file *file);
 /* return the total size of the file */
 UINT64 mame_fsize(mame_file *file);
 
+/* return the full path of the file that was opened */
+const char *mame_file_full_name(mame_file *file);
+
+/* return a value that changes whenever the file contents do, or 0 if unknown */
+UINT64 mame_fstamp(mame_file *file);
+
 
 
 /* ----- file read ----- */
@@ -0,0 +1,583 @@
+/***************************************************************************
+
+    inplog.c
+
+    Input recording and playback, with optional state checkpoints.
+
+    Copyright (c) 1996-2007, Nicola Salmoria and the MAME Team.
+    Visit http://mamedev.org for licensing and usage restrictions.
+
+****************************************************************************
+
+    Old-style input files are an inp_header followed by nothing but
+    big-endian 32-bit port values, one for each port read.
+
+    Checkpointed files have INP_CHECKPOINT_MAGIC in the header's
+    reserved field and are followed by a series of blocks. Each block
+    starts with a 4-character type and a big-endian 32-bit length,
+    followed by that many bytes:
+
+        'INPT' - port values, exactly as an old-style file has them
+
+        'CHKP' - a checkpoint: the emulated time since recording began,
+                 counting across hard resets (32-bit seconds and
+                 64-bit subseconds), the playback value of each of
+                 the MAX_INPUT_PORTS ports, then a complete save state
+
+        'INDX' - the index: the time and file offset of each CHKP
+                 block, 20 bytes per entry
+
+        'IEND' - the 64-bit file offset of the INDX block; always the
+                 last 16 bytes of a completed recording
+
+    Checkpoints are written between port reads, so playback can start
+    from one by loading its state and carrying on with the port values
+    that follow it. A recording that was cut short has no index; the
+    blocks are then scanned to find the checkpoints instead.
+
+    All values are big-endian.
+
+***************************************************************************/
+
+#include "driver.h"
+#include "inplog.h"
+
+
+
+/***************************************************************************
+    CONSTANTS
+***************************************************************************/
+
+#define BLOCK_TYPE(a,b,c,d)		(((a) << 24) | ((b) << 16) | ((c) << 8) | (d))
+
+#define BLOCK_INPUT				BLOCK_TYPE('I','N','P','T')
+#define BLOCK_CHECKPOINT		BLOCK_TYPE('C','H','K','P')
+#define BLOCK_INDEX				BLOCK_TYPE('I','N','D','X')
+#define BLOCK_INDEX_END			BLOCK_TYPE('I','E','N','D')
+
+#define BLOCK_HEADER_SIZE		8
+#define INDEX_END_SIZE			(BLOCK_HEADER_SIZE + 8)
+#define INDEX_ENTRY_SIZE		20
+
+/* time and port values at the start of a checkpoint block */
+#define CHECKPOINT_HEADER_SIZE	(12 + 4 * MAX_INPUT_PORTS)
+
+/* port values are buffered and written as one block this size */
+#define RECORD_BUFFER_VALUES	1024
+
+
+
+/***************************************************************************
+    TYPE DEFINITIONS
+***************************************************************************/
+
+typedef struct _inplog_checkpoint inplog_checkpoint;
+struct _inplog_checkpoint
+{
+	mame_time			time;				/* emulated time of the checkpoint */
+	UINT64				offset;				/* file offset of the CHKP block */
+};
+
+
+
+/***************************************************************************
+    GLOBAL VARIABLES
+***************************************************************************/
+
+/* recording; this survives hard resets, which carry on in the same file */
+static mame_file *record_file;
+static int record_blocks;
+static int record_checkpoints;
+static mame_time record_interval;
+static mame_time record_next;
+static mame_time record_base;
+static UINT32 record_buffer[RECORD_BUFFER_VALUES];
+static int record_buffered;
+static inplog_checkpoint *record_index;
+static int record_index_count;
+static int record_index_alloc;
+
+/* playback; this also survives hard resets */
+static mame_file *playback_file;
+static int playback_checkpoints;
+static UINT32 playback_remaining;
+static int playback_seek_pending;
+static mame_time playback_seek_time;
+
+
+
+/***************************************************************************
+    FUNCTION PROTOTYPES
+***************************************************************************/
+
+static void inplog_exit(running_machine *machine);
+
+
+
+/***************************************************************************
+    INLINE FUNCTIONS
+***************************************************************************/
+
+INLINE void put_be32(UINT8 *dest, UINT32 value)
+{
+	dest[0] = value >> 24;
+	dest[1] = value >> 16;
+	dest[2] = value >> 8;
+	dest[3] = value;
+}
+
+
+INLINE void put_be64(UINT8 *dest, UINT64 value)
+{
+	put_be32(&dest[0], value >> 32);
+	put_be32(&dest[4], value);
+}
+
+
+INLINE UINT32 get_be32(const UINT8 *src)
+{
+	return (src[0] << 24) | (src[1] << 16) | (src[2] << 8) | src[3];
+}
+
+
+INLINE UINT64 get_be64(const UINT8 *src)
+{
+	return ((UINT64)get_be32(&src[0]) << 32) | get_be32(&src[4]);
+}
+
+
+INLINE int write_block_header(mame_file *file, UINT32 type, UINT32 length)
+{
+	UINT8 header[BLOCK_HEADER_SIZE];
+
+	put_be32(&header[0], type);
+	put_be32(&header[4], length);
+	return (mame_fwrite(file, header, sizeof(header)) == sizeof(header));
+}
+
+
+INLINE int read_block_header(mame_file *file, UINT32 *type, UINT32 *length)
+{
+	UINT8 header[BLOCK_HEADER_SIZE];
+
+	if (mame_fread(file, header, sizeof(header)) != sizeof(header))
+		return FALSE;
+	*type = get_be32(&header[0]);
+	*length = get_be32(&header[4]);
+	return TRUE;
+}
+
+
+
+/***************************************************************************
+    INITIALIZATION
+***************************************************************************/
+
+/*-------------------------------------------------
+    inplog_init - set up checkpointing and
+    seeking for the record and playback files
+-------------------------------------------------*/
+
+void inplog_init(running_machine *machine)
+{
+	/* emulated time starts over after a hard reset, so take a checkpoint straight away */
+	record_next = time_zero;
+
+	add_exit_callback(machine, inplog_exit);
+
+	/* after a hard reset, carry on where we were in the same files */
+	if (machine->record_file == NULL || machine->record_file != record_file)
+	{
+		record_file = machine->record_file;
+		record_blocks = record_checkpoints = (record_file != NULL && options.record_checkpoint > 0);
+		record_interval = make_mame_time(options.record_checkpoint, 0);
+		record_base = time_zero;
+		record_buffered = 0;
+		record_index = NULL;
+		record_index_count = record_index_alloc = 0;
+	}
+
+	if (machine->playback_file == NULL || machine->playback_file != playback_file)
+	{
+		playback_file = machine->playback_file;
+		playback_checkpoints = (playback_file != NULL && options.playback_checkpoints);
+		playback_remaining = 0;
+		playback_seek_pending = FALSE;
+
+		/* seeking needs checkpoints to seek to */
+		if (playback_file != NULL && options.playback_seek > 0)
+		{
+			if (playback_checkpoints)
+			{
+				playback_seek_pending = TRUE;
+				playback_seek_time = make_mame_time(options.playback_seek, 0);
+			}
+			else
+				mame_printf_warning("Input file has no checkpoints; playing back from the start\n");
+		}
+	}
+}
+
+
+/*-------------------------------------------------
+    flush_record_buffer - write any buffered port
+    values as an input block
+-------------------------------------------------*/
+
+static int flush_record_buffer(mame_file *file)
+{
+	int index;
+
+	if (record_buffered == 0)
+		return TRUE;
+
+	if (!write_block_header(file, BLOCK_INPUT, record_buffered * 4))
+		return FALSE;
+	for (index = 0; index < record_buffered; index++)
+		record_buffer[index] = BIG_ENDIANIZE_INT32(record_buffer[index]);
+	if (mame_fwrite(file, record_buffer, record_buffered * 4) != record_buffered * 4)
+		return FALSE;
+
+	record_buffered = 0;
+	return TRUE;
+}
+
+
+/*-------------------------------------------------
+    inplog_exit - write out the buffered port
+    values; the machine may be hard resetting,
+    so the index waits for inplog_close_record
+-------------------------------------------------*/
+
+static void inplog_exit(running_machine *machine)
+{
+	if (record_blocks && machine->record_file != NULL)
+	{
+		/* checkpoint times carry on from here if we are resetting */
+		record_base = add_mame_times(record_base, mame_timer_get_time());
+
+		/* a file we couldn't write to gets no index either */
+		if (!flush_record_buffer(machine->record_file))
+			record_file = NULL;
+	}
+}
+
+
+/*-------------------------------------------------
+    inplog_close_record - finish off the record
+    file with the checkpoint index; called just
+    before the file is closed
+-------------------------------------------------*/
+
+void inplog_close_record(mame_file *file)
+{
+	if (record_blocks && file != NULL && file == record_file && flush_record_buffer(file))
+	{
+		UINT64 indexoffs = mame_ftell(file);
+		UINT8 entry[INDEX_END_SIZE];
+		int index;
+
+		/* write the index, then the pointer to it */
+		if (write_block_header(file, BLOCK_INDEX, record_index_count * INDEX_ENTRY_SIZE))
+		{
+			for (index = 0; index < record_index_count; index++)
+			{
+				put_be32(&entry[0], record_index[index].time.seconds);
+				put_be64(&entry[4], record_index[index].time.subseconds);
+				put_be64(&entry[12], record_index[index].offset);
+				mame_fwrite(file, entry, INDEX_ENTRY_SIZE);
+			}
+
+			put_be32(&entry[0], BLOCK_INDEX_END);
+			put_be32(&entry[4], 8);
+			put_be64(&entry[8], indexoffs);
+			mame_fwrite(file, entry, INDEX_END_SIZE);
+		}
+	}
+
+	if (record_index != NULL)
+		free(record_index);
+	record_index = NULL;
+	record_index_count = record_index_alloc = 0;
+	record_blocks = record_checkpoints = FALSE;
+	record_file = NULL;
+}
+
+
+/*-------------------------------------------------
+    inplog_close_playback - forget about the
+    playback file; called just before it is
+    closed
+-------------------------------------------------*/
+
+void inplog_close_playback(mame_file *file)
+{
+	if (file == playback_file)
+		playback_file = NULL;
+}
+
+
+
+/***************************************************************************
+    PORT VALUES
+***************************************************************************/
+
+/*-------------------------------------------------
+    inplog_read - read the next recorded port
+    value
+-------------------------------------------------*/
+
+int inplog_read(running_machine *machine, UINT32 *value)
+{
+	mame_file *file = machine->playback_file;
+	UINT32 result;
+
+	/* in checkpointed files, find the next block of port values, skipping checkpoints */
+	if (playback_checkpoints)
+	{
+		while (playback_remaining == 0)
+		{
+			UINT32 type, length;
+
+			/* the index marks the end of the input */
+			if (!read_block_header(file, &type, &length))
+				return FALSE;
+			if (type == BLOCK_INPUT && length % 4 == 0)
+				playback_remaining = length / 4;
+			else if (type == BLOCK_CHECKPOINT)
+				mame_fseek(file, length, SEEK_CUR);
+			else
+				return FALSE;
+		}
+		playback_remaining--;
+	}
+
+	if (mame_fread(file, &result, sizeof(result)) != sizeof(result))
+		return FALSE;
+	*value = BIG_ENDIANIZE_INT32(result);
+	return TRUE;
+}
+
+
+/*-------------------------------------------------
+    inplog_write - record the next port value
+-------------------------------------------------*/
+
+int inplog_write(running_machine *machine, UINT32 value)
+{
+	mame_file *file = machine->record_file;
+
+	/* old-style files get each value as it comes */
+	if (!record_blocks)
+	{
+		UINT32 result = BIG_ENDIANIZE_INT32(value);
+		return (mame_fwrite(file, &result, sizeof(result)) == sizeof(result));
+	}
+
+	/* otherwise, buffer them up into blocks; on failure the caller closes the file */
+	record_buffer[record_buffered++] = value;
+	if (record_buffered == RECORD_BUFFER_VALUES && !flush_record_buffer(file))
+	{
+		record_file = NULL;
+		return FALSE;
+	}
+	return TRUE;
+}
+
+
+
+/***************************************************************************
+    CHECKPOINTS
+***************************************************************************/
+
+/*-------------------------------------------------
+    write_checkpoint - write the current machine
+    state to the record file
+-------------------------------------------------*/
+
+static void write_checkpoint(running_machine *machine)
+{
+	mame_file *file = machine->record_file;
+	UINT8 header[CHECKPOINT_HEADER_SIZE];
+	UINT32 ports[MAX_INPUT_PORTS];
+	mame_time now = mame_timer_get_time();
+	mame_time when = add_mame_times(record_base, now);
+	UINT64 start, end;
+	int portnum;
+
+	/* if the state can't be saved, give up on checkpoints before writing anything, */
+	/* since there is no way to take bytes back out of the file */
+	if (state_save_get_illegal_count() > 0)
+	{
+		mame_printf_warning("Unable to save state; no more checkpoints will be recorded\n");
+		record_checkpoints = FALSE;
+		return;
+	}
+
+	/* the values recorded so far come before the checkpoint */
+	if (!flush_record_buffer(file))
+		return;
+	start = mame_ftell(file);
+
+	/* write the block with a dummy length, then the time, ports and state */
+	put_be32(&header[0], when.seconds);
+	put_be64(&header[4], when.subseconds);
+	input_port_get_playback_values(ports);
+	for (portnum = 0; portnum < MAX_INPUT_PORTS; portnum++)
+		put_be32(&header[12 + 4 * portnum], ports[portnum]);
+	if (!write_block_header(file, BLOCK_CHECKPOINT, 0) || mame_fwrite(file, header, sizeof(header)) != sizeof(header))
+		return;
+
+	/* we checked the only reason this can fail above */
+	if (mame_save_state(machine, file) != 0)
+		fatalerror("Unable to save a checkpoint to the input file");
+
+	/* go back and fill in the length */
+	end = mame_ftell(file);
+	mame_fseek(file, start, SEEK_SET);
+	write_block_header(file, BLOCK_CHECKPOINT, end - start - BLOCK_HEADER_SIZE);
+	mame_fseek(file, end, SEEK_SET);
+
+	/* add it to the index */
+	if (record_index_count == record_index_alloc)
+	{
+		record_index_alloc += 64;
+		record_index = realloc(record_index, record_index_alloc * sizeof(record_index[0]));
+		if (record_index == NULL)
+			fatalerror("Out of memory for the checkpoint index");
+	}
+	record_index[record_index_count].time = when;
+	record_index[record_index_count].offset = start;
+	record_index_count++;
+
+	record_next = add_mame_times(now, record_interval);
+}
+
+
+/*-------------------------------------------------
+    find_checkpoint - find the offset of the last
+    checkpoint at or before the given time;
+    returns FALSE if there is none
+-------------------------------------------------*/
+
+static int find_checkpoint(mame_file *file, mame_time target, UINT64 *offset)
+{
+	UINT8 entry[INDEX_END_SIZE];
+	UINT32 type, length;
+	int found = FALSE;
+
+	/* use the index if the recording was finished properly */
+	if (mame_fsize(file) >= INDEX_END_SIZE)
+	{
+		mame_fseek(file, -INDEX_END_SIZE, SEEK_END);
+		if (mame_fread(file, entry, INDEX_END_SIZE) == INDEX_END_SIZE &&
+			get_be32(&entry[0]) == BLOCK_INDEX_END && get_be32(&entry[4]) == 8)
+		{
+			mame_fseek(file, get_be64(&entry[8]), SEEK_SET);
+			if (read_block_header(file, &type, &length) && type == BLOCK_INDEX)
+			{
+				for ( ; length >= INDEX_ENTRY_SIZE; length -= INDEX_ENTRY_SIZE)
+				{
+					if (mame_fread(file, entry, INDEX_ENTRY_SIZE) != INDEX_ENTRY_SIZE)
+						break;
+					if (compare_mame_times(make_mame_time(get_be32(&entry[0]), get_be64(&entry[4])), target) > 0)
+						break;
+					*offset = get_be64(&entry[12]);
+					found = TRUE;
+				}
+				return found;
+			}
+		}
+	}
+
+	/* otherwise, walk the blocks */
+	mame_fseek(file, sizeof(inp_header), SEEK_SET);
+	while (read_block_header(file, &type, &length))
+	{
+		UINT64 start = mame_ftell(file) - BLOCK_HEADER_SIZE;
+
+		if (type == BLOCK_CHECKPOINT)
+		{
+			if (mame_fread(file, entry, 12) != 12)
+				break;
+			if (compare_mame_times(make_mame_time(get_be32(&entry[0]), get_be64(&entry[4])), target) > 0)
+				break;
+			*offset = start;
+			found = TRUE;
+		}
+		else if (type != BLOCK_INPUT)
+			break;
+		mame_fseek(file, start + BLOCK_HEADER_SIZE + length, SEEK_SET);
+	}
+	return found;
+}
+
+
+/*-------------------------------------------------
+    seek_playback - start playing back from the
+    checkpoint closest to the requested time
+-------------------------------------------------*/
+
+static void seek_playback(running_machine *machine)
+{
+	mame_file *file = machine->playback_file;
+	UINT8 header[CHECKPOINT_HEADER_SIZE];
+	UINT32 ports[MAX_INPUT_PORTS];
+	UINT32 type, length;
+	UINT64 resume, offset;
+	int portnum;
+
+	/* the state can't be loaded with anonymous timers pending; see handle_load in mame.c */
+	if (timer_count_anonymous() > 0)
+	{
+		if (mame_timer_get_time().seconds > 0)
+		{
+			popmessage("Unable to seek due to pending anonymous timers. See error.log for details.");
+			playback_seek_pending = FALSE;
+		}
+		return;
+	}
+	playback_seek_pending = FALSE;
+
+	/* if the only checkpoints are later than requested, just play from the start */
+	resume = mame_ftell(file);
+	if (!find_checkpoint(file, playback_seek_time, &offset))
+	{
+		mame_fseek(file, resume, SEEK_SET);
+		return;
+	}
+
+	/* read the checkpoint; once the state is loaded there is no going back */
+	mame_fseek(file, offset, SEEK_SET);
+	if (!read_block_header(file, &type, &length) || type != BLOCK_CHECKPOINT || length < CHECKPOINT_HEADER_SIZE ||
+		mame_fread(file, header, sizeof(header)) != sizeof(header) ||
+		mame_load_state(machine, file, length - CHECKPOINT_HEADER_SIZE) != 0)
+		fatalerror("Unable to load the checkpoint in the input file");
+
+	for (portnum = 0; portnum < MAX_INPUT_PORTS; portnum++)
+		ports[portnum] = get_be32(&header[12 + 4 * portnum]);
+	input_port_set_playback_values(ports);
+
+	/* carry on with the port values recorded after the checkpoint */
+	mame_fseek(file, offset + BLOCK_HEADER_SIZE + length, SEEK_SET);
+	playback_remaining = 0;
+
+	popmessage("Playing back from %d:%02d", get_be32(&header[0]) / 60, get_be32(&header[0]) % 60);
+}
+
+
+/*-------------------------------------------------
+    inplog_update - write checkpoints and handle
+    a pending seek
+-------------------------------------------------*/
+
+void inplog_update(running_machine *machine)
+{
+	if (playback_seek_pending && machine->playback_file != NULL)
+		seek_playback(machine);
+
+	/* checkpoints also need a moment with no anonymous timers */
+	if (record_checkpoints && machine->record_file != NULL &&
+		compare_mame_times(mame_timer_get_time(), record_next) >= 0 && timer_count_anonymous() == 0)
+		write_checkpoint(machine);
+}
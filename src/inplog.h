@@ -0,0 +1,45 @@
+/***************************************************************************
+
+    inplog.h
+
+    Input recording and playback, with optional state checkpoints.
+
+    Copyright (c) 1996-2007, Nicola Salmoria and the MAME Team.
+    Visit http://mamedev.org for licensing and usage restrictions.
+
+***************************************************************************/
+
+#pragma once
+
+#ifndef __INPLOG_H__
+#define __INPLOG_H__
+
+#include "mamecore.h"
+
+
+
+/***************************************************************************
+    FUNCTION PROTOTYPES
+***************************************************************************/
+
+/* set up checkpointing and seeking for the record and playback files */
+void inplog_init(running_machine *machine);
+
+/* write checkpoints and handle a pending seek; called between timeslices */
+void inplog_update(running_machine *machine);
+
+/* read the next recorded port value; returns FALSE at the end of the input */
+int inplog_read(running_machine *machine, UINT32 *value);
+
+/* record the next port value; returns FALSE if it could not be written */
+int inplog_write(running_machine *machine, UINT32 value);
+
+/* finish off the record file with the checkpoint index; call this once, */
+/* just before closing the file, since hard resets keep recording to it */
+void inplog_close_record(mame_file *file);
+
+/* likewise for the playback file, which has nothing to write */
+void inplog_close_playback(mame_file *file);
+
+
+#endif	/* __INPLOG_H__ */
@@ -95,6 +95,7 @@
 #include "driver.h"
 #include "config.h"
 #include "xmlfile.h"
+#include "inplog.h"
 #include "profiler.h"
 #include "ui.h"
 #include <math.h>
@@ -2401,8 +2402,8 @@ static void update_playback_record(int portnum, UINT32 portvalue)
 		UINT32 result;
 
 		/* a successful read goes into the playback field which overrides everything else */
-		if (mame_fread(Machine->playback_file, &result, sizeof(result)) == sizeof(result))
-			portvalue = port_info[portnum].playback = BIG_ENDIANIZE_INT32(result);
+		if (inplog_read(Machine, &result))
+			portvalue = port_info[portnum].playback = result;
 
 		/* a failure causes us to close the playback file and stop playback */
 		else
@@ -2415,10 +2416,8 @@ static void update_playback_record(int portnum, UINT32 portvalue)
 	/* handle recording */
 	if (Machine->record_file != NULL)
 	{
-		UINT32 result = BIG_ENDIANIZE_INT32(portvalue);
-
 		/* a successful write just works */
-		if (mame_fwrite(Machine->record_file, &result, sizeof(result)) == sizeof(result))
+		if (inplog_write(Machine, portvalue))
 			;
 
 		/* a failure causes us to close the record file and stop recording */
@@ -2432,6 +2431,31 @@ static void update_playback_record(int portnum, UINT32 portvalue)
 
 
 
+/*************************************
+ *
+ *  Playback state for checkpoints
+ *
+ *************************************/
+
+void input_port_get_playback_values(UINT32 *values)
+{
+	int portnum;
+
+	for (portnum = 0; portnum < MAX_INPUT_PORTS; portnum++)
+		values[portnum] = port_info[portnum].playback;
+}
+
+
+void input_port_set_playback_values(const UINT32 *values)
+{
+	int portnum;
+
+	for (portnum = 0; portnum < MAX_INPUT_PORTS; portnum++)
+		port_info[portnum].playback = values[portnum];
+}
+
+
+
 /*************************************
  *
  *  Update default ports
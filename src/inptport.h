@@ -581,6 +581,9 @@ struct _inp_header
 	char reserved[20]; /* for future use, possible store game options? */
 };
 
+/* stored in inp_header.reserved for files with state checkpoints (see inplog.c) */
+#define INP_CHECKPOINT_MAGIC	"CHKPT1"
+
 
 
 /***************************************************************************
@@ -830,6 +833,10 @@ void input_port_vblank_end(void);	/* called by cpuintrf.c - not for external use
 
 void input_port_set_digital_value(int port, UINT32 value, UINT32 mask);
 
+/* the MAX_INPUT_PORTS values being played back, saved with input file checkpoints */
+void input_port_get_playback_values(UINT32 *values);
+void input_port_set_playback_values(const UINT32 *values);
+
 UINT32 readinputport(int port);
 UINT32 readinputportbytag(const char *tag);
 UINT32 readinputportbytag_safe(const char *tag, UINT32 defvalue);
@@ -114,6 +114,7 @@ the decryption keys.
 #include "cpu/m68000/m68kmame.h"
 #include "ui.h"
 #include "includes/cps1.h"
+#include "machine/cryptcache.h"
 
 
 /******************************************************************************/
@@ -609,42 +610,37 @@ static UINT16 feistel(UINT16 val, const int *bitsA, const int *bitsB,
 
 
 
-static void cps2_decrypt(const UINT32 *master_key, unsigned int upper_limit)
+struct cps2_decrypt_info
 {
-	UINT16 *rom = (UINT16 *)memory_region(REGION_CPU1);
-	int length = memory_region_length(REGION_CPU1);
-	UINT16 *dec = auto_malloc(length);
-	int i;
+	const UINT32 *master_key;
 	UINT32 key1[4];
+	const UINT16 *rom;
+	UINT16 *dec;
+	int length;
+	unsigned int upper_limit;
+};
 
 
-	// expand master key to 1st FN 96-bit key
-	expand_1st_key(key1, master_key);
-
-	// add extra bits for s-boxes with less than 6 inputs
-	key1[0] ^= BIT(key1[0], 1) <<  4;
-	key1[0] ^= BIT(key1[0], 2) <<  5;
-	key1[0] ^= BIT(key1[0], 8) << 11;
-	key1[1] ^= BIT(key1[1], 0) <<  5;
-	key1[1] ^= BIT(key1[1], 8) << 11;
-	key1[2] ^= BIT(key1[2], 1) <<  5;
-	key1[2] ^= BIT(key1[2], 8) << 11;
+// decrypts the words whose address modulo 0x10000 is in [start, end);
+// each such group shares one 2nd FN key, so groups can be done in parallel
+static void cps2_decrypt_range(void *param, UINT32 start, UINT32 end)
+{
+	struct cps2_decrypt_info *info = param;
+	const UINT32 *master_key = info->master_key;
+	const UINT32 *key1 = info->key1;
+	const UINT16 *rom = info->rom;
+	UINT16 *dec = info->dec;
+	int length = info->length;
+	unsigned int upper_limit = info->upper_limit;
+	int i;
 
-	for (i = 0; i < 0x10000; ++i)
+	for (i = start; i < end; ++i)
 	{
 		int a;
 		UINT16 seed;
 		UINT32 subkey[2];
 		UINT32 key2[4];
 
-		if ((i & 0xff) == 0)
-		{
-			char loadingMessage[256]; // for displaying with UI
-			sprintf(loadingMessage, "Decrypting %d%%", i*100/0x10000);
-			ui_set_startup_text(loadingMessage,FALSE);
-		}
-
-
 		// pass the address through FN1
 		seed = feistel(i, fn1_groupA, fn1_groupB,
 				fn1_r1_boxes, fn1_r2_boxes, fn1_r3_boxes, fn1_r4_boxes,
@@ -686,6 +682,48 @@ static void cps2_decrypt(const UINT32 *master_key, unsigned int upper_limit)
 			a += 0x10000;
 		}
 	}
+}
+
+
+
+static void cps2_decrypt(const UINT32 *master_key, unsigned int upper_limit)
+{
+	struct cps2_decrypt_info info;
+	decrypt_cache_key cachekey;
+	UINT32 keydata[3];
+	UINT16 *rom = (UINT16 *)memory_region(REGION_CPU1);
+	int length = memory_region_length(REGION_CPU1);
+	UINT16 *dec = auto_malloc(length);
+	UINT32 *key1 = info.key1;
+
+
+	// expand master key to 1st FN 96-bit key
+	expand_1st_key(key1, master_key);
+
+	// add extra bits for s-boxes with less than 6 inputs
+	key1[0] ^= BIT(key1[0], 1) <<  4;
+	key1[0] ^= BIT(key1[0], 2) <<  5;
+	key1[0] ^= BIT(key1[0], 8) << 11;
+	key1[1] ^= BIT(key1[1], 0) <<  5;
+	key1[1] ^= BIT(key1[1], 8) << 11;
+	key1[2] ^= BIT(key1[2], 1) <<  5;
+	key1[2] ^= BIT(key1[2], 8) << 11;
+
+	// reuse an earlier run's output if the ROM and key are the same
+	keydata[0] = master_key[0];
+	keydata[1] = master_key[1];
+	keydata[2] = upper_limit;
+	decrypt_cache_compute_key(&cachekey, "cps2-1", keydata, sizeof(keydata), rom, length);
+	if (!decrypt_cache_load(&cachekey, dec, length))
+	{
+		info.master_key = master_key;
+		info.rom = rom;
+		info.dec = dec;
+		info.length = length;
+		info.upper_limit = upper_limit;
+		decrypt_parallel(cps2_decrypt_range, &info, 0x10000, 0x1000, "Decrypting");
+		decrypt_cache_save(&cachekey, dec, length);
+	}
 
 	memory_set_decrypted_region(0, 0x000000, length - 1, dec);
 	m68k_set_encrypted_opcode_range(0,0,length);
@@ -0,0 +1,296 @@
+/*********************************************************************
+
+    cryptcache.c
+
+    Helpers for decrypting ROMs at startup: splitting the work across
+    threads and caching the decrypted data on disk.
+
+    Copyright (c) 1996-2007, Nicola Salmoria and the MAME Team.
+    Visit http://mamedev.org for licensing and usage restrictions.
+
+*********************************************************************/
+
+#include "driver.h"
+#include "ui.h"
+#include "sha1.h"
+#include "cryptcache.h"
+
+
+
+/***************************************************************************
+    CONSTANTS
+***************************************************************************/
+
+/* input data is hashed in pieces of this many bytes, in parallel */
+#define HASH_CHUNK_SIZE			(1 << 20)
+
+/* cache files start with this, followed by the big-endian data length */
+#define CACHE_MAGIC				"MAMEDEC1"
+#define CACHE_HEADER_SIZE		12
+
+
+
+/***************************************************************************
+    TYPE DEFINITIONS
+***************************************************************************/
+
+typedef struct _decrypt_work decrypt_work;
+struct _decrypt_work
+{
+	decrypt_range_func	callback;			/* function doing the work */
+	void *				param;				/* parameter for the function */
+	UINT32				start, end;			/* range of items to do */
+	osd_work_item *		item;				/* work item, or NULL if done inline */
+};
+
+
+typedef struct _hash_work hash_work;
+struct _hash_work
+{
+	const UINT8 *		data;				/* data being hashed */
+	UINT32				length;				/* length of the data */
+	UINT8 *				digests;			/* SHA1 of each HASH_CHUNK_SIZE piece */
+};
+
+
+
+/***************************************************************************
+    PARALLEL DECRYPTION
+***************************************************************************/
+
+/*-------------------------------------------------
+    decrypt_work_callback - run one range of a
+    decrypt_parallel() call
+-------------------------------------------------*/
+
+static void *decrypt_work_callback(void *param)
+{
+	decrypt_work *work = param;
+
+	(*work->callback)(work->param, work->start, work->end);
+	return NULL;
+}
+
+
+/*-------------------------------------------------
+    decrypt_parallel - run a decryption callback
+    over a range of items on the worker threads
+-------------------------------------------------*/
+
+void decrypt_parallel(decrypt_range_func callback, void *param, UINT32 count, UINT32 chunk, const char *message)
+{
+	UINT32 chunks = (count + chunk - 1) / chunk;
+	osd_work_queue *queue;
+	decrypt_work *work;
+	UINT32 index;
+	int lastpercent = -1;
+
+	if (chunks == 0)
+		return;
+
+	/* queue up all the ranges; if the queue can't take them, do them here */
+	work = malloc_or_die(chunks * sizeof(*work));
+	queue = osd_work_queue_alloc(WORK_QUEUE_FLAG_MULTI);
+	for (index = 0; index < chunks; index++)
+	{
+		work[index].callback = callback;
+		work[index].param = param;
+		work[index].start = index * chunk;
+		work[index].end = (count - work[index].start < chunk) ? count : work[index].start + chunk;
+		work[index].item = (queue != NULL) ? osd_work_item_queue(queue, decrypt_work_callback, &work[index]) : NULL;
+		if (work[index].item == NULL)
+			decrypt_work_callback(&work[index]);
+	}
+
+	/* wait for them in order, reporting progress as we go */
+	for (index = 0; index < chunks; index++)
+	{
+		int percent = (index + 1) * 100 / chunks;
+
+		if (work[index].item != NULL)
+		{
+			while (!osd_work_item_wait(work[index].item, osd_ticks_per_second()))
+				;
+			osd_work_item_release(work[index].item);
+		}
+
+		if (message != NULL && percent != lastpercent)
+		{
+			char buffer[256];
+
+			sprintf(buffer, "%s %d%%", message, percent);
+			ui_set_startup_text(buffer, FALSE);
+			lastpercent = percent;
+		}
+	}
+
+	if (queue != NULL)
+		osd_work_queue_free(queue);
+	free(work);
+}
+
+
+
+/***************************************************************************
+    DECRYPTED DATA CACHE
+***************************************************************************/
+
+/*-------------------------------------------------
+    decrypt_cache_enabled - return TRUE if a
+    cache directory is set
+-------------------------------------------------*/
+
+static int decrypt_cache_enabled(void)
+{
+	const char *directory = options_get_string(OPTION_CACHE_DIRECTORY);
+	return (directory != NULL && directory[0] != 0);
+}
+
+
+/*-------------------------------------------------
+    hash_range - hash a range of HASH_CHUNK_SIZE
+    pieces of the input data
+-------------------------------------------------*/
+
+static void hash_range(void *param, UINT32 start, UINT32 end)
+{
+	hash_work *work = param;
+	UINT32 piece;
+
+	for (piece = start; piece < end; piece++)
+	{
+		UINT32 offset = piece * HASH_CHUNK_SIZE;
+		UINT32 length = (work->length - offset < HASH_CHUNK_SIZE) ? work->length - offset : HASH_CHUNK_SIZE;
+		struct sha1_ctx sha1;
+
+		sha1_init(&sha1);
+		sha1_update(&sha1, length, work->data + offset);
+		sha1_final(&sha1);
+		sha1_digest(&sha1, SHA1_DIGEST_SIZE, &work->digests[piece * SHA1_DIGEST_SIZE]);
+	}
+}
+
+
+/*-------------------------------------------------
+    decrypt_cache_compute_key - compute the name
+    of the cached output for a given decryption
+-------------------------------------------------*/
+
+void decrypt_cache_compute_key(decrypt_cache_key *key, const char *algorithm, const void *keydata, UINT32 keylength, const void *data, UINT32 length)
+{
+	UINT32 pieces = (length + HASH_CHUNK_SIZE - 1) / HASH_CHUNK_SIZE;
+	UINT8 digest[SHA1_DIGEST_SIZE];
+	UINT8 lengthbytes[4];
+	struct sha1_ctx sha1;
+	hash_work work;
+	int i;
+
+	/* don't spend time hashing if the cache is off; an empty name is never opened */
+	key->name[0] = 0;
+	if (!decrypt_cache_enabled())
+		return;
+
+	/* hash the data in pieces on the worker threads */
+	work.data = data;
+	work.length = length;
+	work.digests = malloc_or_die(pieces * SHA1_DIGEST_SIZE + 1);
+	decrypt_parallel(hash_range, &work, pieces, 1, NULL);
+
+	/* the key is the hash of the algorithm name, the key data, the length and the piece hashes */
+	lengthbytes[0] = length >> 24;
+	lengthbytes[1] = length >> 16;
+	lengthbytes[2] = length >> 8;
+	lengthbytes[3] = length;
+	sha1_init(&sha1);
+	sha1_update(&sha1, strlen(algorithm) + 1, (const UINT8 *)algorithm);
+	sha1_update(&sha1, keylength, keydata);
+	sha1_update(&sha1, sizeof(lengthbytes), lengthbytes);
+	sha1_update(&sha1, pieces * SHA1_DIGEST_SIZE, work.digests);
+	sha1_final(&sha1);
+	sha1_digest(&sha1, SHA1_DIGEST_SIZE, digest);
+	free(work.digests);
+
+	for (i = 0; i < SHA1_DIGEST_SIZE; i++)
+		sprintf(&key->name[i * 2], "%02x", digest[i]);
+}
+
+
+/*-------------------------------------------------
+    decrypt_cache_open - open the cache file for
+    a key, if the cache is enabled
+-------------------------------------------------*/
+
+static mame_file *decrypt_cache_open(const decrypt_cache_key *key, UINT32 openflags)
+{
+	mame_file_error filerr;
+	mame_file *file;
+	char *fname;
+
+	/* an empty directory turns the cache off */
+	if (key->name[0] == 0 || !decrypt_cache_enabled())
+		return NULL;
+
+	fname = assemble_2_strings(key->name, ".dec");
+	filerr = mame_fopen(SEARCHPATH_CACHE, fname, openflags, &file);
+	free(fname);
+
+	return (filerr == FILERR_NONE) ? file : NULL;
+}
+
+
+/*-------------------------------------------------
+    decrypt_cache_load - fill a buffer with cached
+    decrypted data
+-------------------------------------------------*/
+
+int decrypt_cache_load(const decrypt_cache_key *key, void *dest, UINT32 length)
+{
+	UINT8 header[CACHE_HEADER_SIZE];
+	mame_file *file;
+	int result = FALSE;
+
+	file = decrypt_cache_open(key, OPEN_FLAG_READ);
+	if (file == NULL)
+		return FALSE;
+
+	/* the length is only filled in once all the data has been written */
+	if (mame_fread(file, header, sizeof(header)) == sizeof(header) &&
+		memcmp(header, CACHE_MAGIC, 8) == 0 &&
+		((header[8] << 24) | (header[9] << 16) | (header[10] << 8) | header[11]) == length &&
+		mame_fsize(file) == sizeof(header) + (UINT64)length)
+		result = (mame_fread(file, dest, length) == length);
+
+	mame_fclose(file);
+	return result;
+}
+
+
+/*-------------------------------------------------
+    decrypt_cache_save - save decrypted data to
+    the cache
+-------------------------------------------------*/
+
+void decrypt_cache_save(const decrypt_cache_key *key, const void *src, UINT32 length)
+{
+	UINT8 header[CACHE_HEADER_SIZE];
+	mame_file *file;
+
+	file = decrypt_cache_open(key, OPEN_FLAG_WRITE | OPEN_FLAG_CREATE | OPEN_FLAG_CREATE_PATHS);
+	if (file == NULL)
+		return;
+
+	/* write a zero length until the data is all there, so a partial file is never used */
+	memcpy(header, CACHE_MAGIC, 8);
+	memset(&header[8], 0, 4);
+	if (mame_fwrite(file, header, sizeof(header)) == sizeof(header) &&
+		mame_fwrite(file, src, length) == length)
+	{
+		header[8] = length >> 24;
+		header[9] = length >> 16;
+		header[10] = length >> 8;
+		header[11] = length;
+		mame_fseek(file, 0, SEEK_SET);
+		mame_fwrite(file, header, sizeof(header));
+	}
+	mame_fclose(file);
+}
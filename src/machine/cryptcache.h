@@ -0,0 +1,63 @@
+/*********************************************************************
+
+    cryptcache.h
+
+    Helpers for decrypting ROMs at startup: splitting the work across
+    threads and caching the decrypted data on disk.
+
+    Copyright (c) 1996-2007, Nicola Salmoria and the MAME Team.
+    Visit http://mamedev.org for licensing and usage restrictions.
+
+*********************************************************************/
+
+#pragma once
+
+#ifndef __MACHINE_CRYPTCACHE_H__
+#define __MACHINE_CRYPTCACHE_H__
+
+#include "mamecore.h"
+
+
+
+/***************************************************************************
+    TYPE DEFINITIONS
+***************************************************************************/
+
+/* decrypts items [start, end) of whatever the caller is decrypting */
+typedef void (*decrypt_range_func)(void *param, UINT32 start, UINT32 end);
+
+
+/* names the decrypted form of a given input, key and algorithm */
+typedef struct _decrypt_cache_key decrypt_cache_key;
+struct _decrypt_cache_key
+{
+	char		name[2 * 20 + 1];		/* hex SHA1 of everything that affects the output */
+};
+
+
+
+/***************************************************************************
+    FUNCTION PROTOTYPES
+***************************************************************************/
+
+/* ----- parallel decryption ----- */
+
+/* run callback over [0, count) in pieces of chunk items on worker threads;
+   if message is not NULL, it is shown as startup text with a percentage */
+void decrypt_parallel(decrypt_range_func callback, void *param, UINT32 count, UINT32 chunk, const char *message);
+
+
+/* ----- decrypted data cache ----- */
+
+/* compute the cache key for decrypting length bytes of data with the given
+   key data; algorithm must change whenever the decryption code does */
+void decrypt_cache_compute_key(decrypt_cache_key *key, const char *algorithm, const void *keydata, UINT32 keylength, const void *data, UINT32 length);
+
+/* load cached decrypted data; returns TRUE if dest was filled */
+int decrypt_cache_load(const decrypt_cache_key *key, void *dest, UINT32 length);
+
+/* save decrypted data to the cache */
+void decrypt_cache_save(const decrypt_cache_key *key, const void *src, UINT32 length);
+
+
+#endif	/* __MACHINE_CRYPTCACHE_H__ */
@@ -273,7 +273,36 @@ static int masked_opcodes[] =
 	0xde3a,0xde7a,0xdeba,0xdefa,	0xdffa
 };
 
-static int final_decrypt(int i,int moreffff)
+/* all the masked opcodes are even, so a bitmap of them has one bit per pair of values */
+#define MASKED_OPCODE_MAP_SIZE	(0x10000 / 2 / 8)
+
+
+/* key bits controlling the decryption of a word; they depend only on the state
+   and on the 8-bit main key for the word's address */
+typedef struct _decode_keys decode_keys;
+struct _decode_keys
+{
+	UINT8 key_6a,key_7a,key_6b;
+	UINT8 key_0a,key_0b,key_0c;
+	UINT8 key_1a,key_1b,key_2a,key_2b,key_3a,key_3b,key_4a,key_4b,key_5a,key_5b;
+	UINT8 global_xor0,global_xor1;
+	UINT8 global_swap0a,global_swap1,global_swap2,global_swap3,global_swap4;
+	UINT8 global_swap0b;
+};
+
+
+static void build_masked_opcode_map(UINT8 *map)
+{
+	int j;
+
+	memset(map, 0, MASKED_OPCODE_MAP_SIZE);
+	for (j = 0;j < sizeof(masked_opcodes)/sizeof(masked_opcodes[0]);j++)
+		map[masked_opcodes[j] >> 4] |= 1 << ((masked_opcodes[j] >> 1) & 7);
+}
+
+
+/* masked_map is a bitmap from build_masked_opcode_map(), or NULL to search masked_opcodes[] */
+INLINE int final_decrypt(int i,int moreffff,const UINT8 *masked_map)
 {
 	int j;
 
@@ -285,12 +314,20 @@ static int final_decrypt(int i,int moreffff)
 	if ((i & 0xb100) == 0x0000) dec ^= 0x4000;
 
 	/* mask out opcodes doing PC-relative addressing, replace them with FFFF */
-	for (j = 0;j < sizeof(masked_opcodes)/sizeof(masked_opcodes[0]);j++)
+	if (masked_map)
 	{
-		if ((dec & 0xfffe) == masked_opcodes[j])
-		{
+		if (masked_map[dec >> 4] & (1 << ((dec >> 1) & 7)))
 			dec = 0xffff;
-			break;
+	}
+	else
+	{
+		for (j = 0;j < sizeof(masked_opcodes)/sizeof(masked_opcodes[0]);j++)
+		{
+			if ((dec & 0xfffe) == masked_opcodes[j])
+			{
+				dec = 0xffff;
+				break;
+			}
 		}
 	}
 
@@ -309,70 +346,56 @@ static int final_decrypt(int i,int moreffff)
 }
 
 
-/* note: address is the word offset (physical address / 2) */
-static int decode(int address,int val,unsigned char *main_key,int gkey1,int gkey2,int gkey3,int vector_fetch)
+static void compute_keys(decode_keys *keys,int mainkey,int gkey1,int gkey2,int gkey3)
 {
-	int mainkey,key_F,key_6a,key_7a,key_6b;
-	int key_0a,key_0b,key_0c;
-	int key_1a,key_1b,key_2a,key_2b,key_3a,key_3b,key_4a,key_4b,key_5a,key_5b;
-	int global_xor0,global_xor1;
-	int global_swap0a,global_swap1,global_swap2,global_swap3,global_swap4;
-	int global_swap0b;
+	keys->global_xor0   = 1^BIT(gkey1,5);	// could be bit 7
+	keys->global_xor1   = 1^BIT(gkey1,2);
+	keys->global_swap2  = 1^BIT(gkey1,0);
 
+	keys->global_swap0a = 1^BIT(gkey2,5);
+	keys->global_swap0b = 1^BIT(gkey2,2);
 
-	/* for address xx0000-xx0006 (but only if >= 000008), use key xx2000-xx2006 */
-	if ((address & 0x0ffc) == 0 && address >= 4)
-		mainkey = main_key[(address & 0x1fff) | 0x1000];
-	else
-		mainkey = main_key[address & 0x1fff];
-
-	if (address & 0x1000)	key_F = BIT(mainkey,7);
-	else					key_F = BIT(mainkey,6);
-
-	/* the CPU has been verified to produce different results when fetching opcodes
-       from 0000-0006 than when fetching the inital SP and PC on reset. */
-	if (vector_fetch)
-	{
-		if (address <= 3) gkey3 = 0x00;	// supposed to always be the case
-		if (address <= 2) gkey2 = 0x00;
-		if (address <= 1) gkey1 = 0x00;
-		if (address <= 1) key_F = 0;
-	}
-
-	global_xor0         = 1^BIT(gkey1,5);	// could be bit 7
-	global_xor1         = 1^BIT(gkey1,2);
-	global_swap2        = 1^BIT(gkey1,0);
+	keys->global_swap3  = 1^BIT(gkey3,6);
+	keys->global_swap1  = 1^BIT(gkey3,4);
+	keys->global_swap4  = 1^BIT(gkey3,2);
 
-	global_swap0a       = 1^BIT(gkey2,5);
-	global_swap0b       = 1^BIT(gkey2,2);
+	keys->key_0a = BIT(mainkey,0) ^ BIT(gkey3,1);
+	keys->key_0b = BIT(mainkey,0) ^ BIT(gkey1,7);	// could be bit 5
+	keys->key_0c = BIT(mainkey,0) ^ BIT(gkey1,1);
 
-	global_swap3        = 1^BIT(gkey3,6);
-	global_swap1        = 1^BIT(gkey3,4);
-	global_swap4        = 1^BIT(gkey3,2);
+	keys->key_1a = BIT(mainkey,1) ^ BIT(gkey2,7);
+	keys->key_1b = BIT(mainkey,1) ^ BIT(gkey1,3);
 
-	key_0a = BIT(mainkey,0) ^ BIT(gkey3,1);
-	key_0b = BIT(mainkey,0) ^ BIT(gkey1,7);	// could be bit 5
-	key_0c = BIT(mainkey,0) ^ BIT(gkey1,1);
+	keys->key_2a = BIT(mainkey,2) ^ BIT(gkey3,7);
+	keys->key_2b = BIT(mainkey,2) ^ BIT(gkey1,4);
 
-	key_1a = BIT(mainkey,1) ^ BIT(gkey2,7);
-	key_1b = BIT(mainkey,1) ^ BIT(gkey1,3);
+	keys->key_3a = BIT(mainkey,3) ^ BIT(gkey2,0);
+	keys->key_3b = BIT(mainkey,3) ^ BIT(gkey3,3);
 
-	key_2a = BIT(mainkey,2) ^ BIT(gkey3,7);
-	key_2b = BIT(mainkey,2) ^ BIT(gkey1,4);
+	keys->key_4a = BIT(mainkey,4) ^ BIT(gkey2,3);
+	keys->key_4b = BIT(mainkey,4) ^ BIT(gkey3,0);
 
-	key_3a = BIT(mainkey,3) ^ BIT(gkey2,0);
-	key_3b = BIT(mainkey,3) ^ BIT(gkey3,3);
+	keys->key_5a = BIT(mainkey,5) ^ BIT(gkey3,5);
+	keys->key_5b = BIT(mainkey,5) ^ BIT(gkey1,6);
 
-	key_4a = BIT(mainkey,4) ^ BIT(gkey2,3);
-	key_4b = BIT(mainkey,4) ^ BIT(gkey3,0);
+	keys->key_6a = BIT(mainkey,6) ^ BIT(gkey2,1);
+	keys->key_6b = BIT(mainkey,6) ^ BIT(gkey2,6);
 
-	key_5a = BIT(mainkey,5) ^ BIT(gkey3,5);
-	key_5b = BIT(mainkey,5) ^ BIT(gkey1,6);
+	keys->key_7a = BIT(mainkey,7) ^ BIT(gkey2,4);
+}
 
-	key_6a = BIT(mainkey,6) ^ BIT(gkey2,1);
-	key_6b = BIT(mainkey,6) ^ BIT(gkey2,6);
 
-	key_7a = BIT(mainkey,7) ^ BIT(gkey2,4);
+INLINE int decode_value(int val,const decode_keys *keys,int key_F,const UINT8 *masked_map)
+{
+	int key_6a = keys->key_6a,key_7a = keys->key_7a,key_6b = keys->key_6b;
+	int key_0a = keys->key_0a,key_0b = keys->key_0b,key_0c = keys->key_0c;
+	int key_1a = keys->key_1a,key_1b = keys->key_1b,key_2a = keys->key_2a,key_2b = keys->key_2b;
+	int key_3a = keys->key_3a,key_3b = keys->key_3b,key_4a = keys->key_4a,key_4b = keys->key_4b;
+	int key_5a = keys->key_5a,key_5b = keys->key_5b;
+	int global_xor0 = keys->global_xor0,global_xor1 = keys->global_xor1;
+	int global_swap0a = keys->global_swap0a,global_swap1 = keys->global_swap1,global_swap2 = keys->global_swap2;
+	int global_swap3 = keys->global_swap3,global_swap4 = keys->global_swap4;
+	int global_swap0b = keys->global_swap0b;
 
 
 	if ((val & 0xe000) == 0x0000)
@@ -424,49 +447,45 @@ static int decode(int address,int val,unsigned char *main_key,int gkey1,int gkey
 		if (!global_swap0a)	val = BITSWAP16(val, 15,14,13,12,11,10, 9, 8, 7, 6, 5, 4, 0, 3, 2, 1);	// 3...0
 	}
 
-	return final_decrypt(val,key_F);
+	return final_decrypt(val,key_F,masked_map);
 }
 
 
-static int global_key1,global_key2,global_key3;
+/* for address xx0000-xx0006 (but only if >= 000008), use key xx2000-xx2006 */
+#define MAIN_KEY_FOR_ADDRESS(main_key,address) \
+	((((address) & 0x0ffc) == 0 && (address) >= 4) ? main_key[((address) & 0x1fff) | 0x1000] : main_key[(address) & 0x1fff])
 
-int fd1094_decode(int address,int val,unsigned char *key,int vector_fetch)
-{
-	if (!key) return 0;
 
-	return decode(address,val,key,global_key1,global_key2,global_key3,vector_fetch);
-}
-
-int fd1094_set_state(unsigned char *key,int state)
+/* note: address is the word offset (physical address / 2) */
+static int decode(int address,int val,unsigned char *main_key,int gkey1,int gkey2,int gkey3,int vector_fetch)
 {
-	static int selected_state,irq_mode;
+	decode_keys keys;
+	int mainkey,key_F;
 
-	if (!key) return 0;
+	mainkey = MAIN_KEY_FOR_ADDRESS(main_key,address);
 
-	switch (state & 0x300)
-	{
-		case 0x0000:				// 0x00xx: select state xx
-			selected_state = state & 0xff;
-			break;
+	if (address & 0x1000)	key_F = BIT(mainkey,7);
+	else					key_F = BIT(mainkey,6);
 
-		case FD1094_STATE_RESET:	// 0x01xx: select state xx and exit irq mode
-			selected_state = state & 0xff;
-			irq_mode = 0;
-			break;
+	/* the CPU has been verified to produce different results when fetching opcodes
+       from 0000-0006 than when fetching the inital SP and PC on reset. */
+	if (vector_fetch)
+	{
+		if (address <= 3) gkey3 = 0x00;	// supposed to always be the case
+		if (address <= 2) gkey2 = 0x00;
+		if (address <= 1) gkey1 = 0x00;
+		if (address <= 1) key_F = 0;
+	}
 
-		case FD1094_STATE_IRQ:		// 0x02xx: enter irq mode
-			irq_mode = 1;
-			break;
+	compute_keys(&keys,mainkey,gkey1,gkey2,gkey3);
+	return decode_value(val,&keys,key_F,NULL);
+}
 
-		case FD1094_STATE_RTE:		// 0x03xx: exit irq mode
-			irq_mode = 0;
-			break;
-	}
 
-	if (irq_mode)
-		state = key[0];
-	else
-		state = selected_state;
+/* the global key is bytes 1-3 of the key, modified by the state */
+static void compute_global_keys(const unsigned char *key,int state,int *gkey1,int *gkey2,int *gkey3)
+{
+	int global_key1,global_key2,global_key3;
 
 	global_key1 = key[1];
 	global_key2 = key[2];
@@ -521,5 +540,80 @@ int fd1094_set_state(unsigned char *key,int state)
 		global_key3 ^= 0x40;	// global_swap3
 	}
 
+	*gkey1 = global_key1;
+	*gkey2 = global_key2;
+	*gkey3 = global_key3;
+}
+
+
+static int global_key1,global_key2,global_key3;
+
+int fd1094_decode(int address,int val,unsigned char *key,int vector_fetch)
+{
+	if (!key) return 0;
+
+	return decode(address,val,key,global_key1,global_key2,global_key3,vector_fetch);
+}
+
+int fd1094_set_state(unsigned char *key,int state)
+{
+	static int selected_state,irq_mode;
+
+	if (!key) return 0;
+
+	switch (state & 0x300)
+	{
+		case 0x0000:				// 0x00xx: select state xx
+			selected_state = state & 0xff;
+			break;
+
+		case FD1094_STATE_RESET:	// 0x01xx: select state xx and exit irq mode
+			selected_state = state & 0xff;
+			irq_mode = 0;
+			break;
+
+		case FD1094_STATE_IRQ:		// 0x02xx: enter irq mode
+			irq_mode = 1;
+			break;
+
+		case FD1094_STATE_RTE:		// 0x03xx: exit irq mode
+			irq_mode = 0;
+			break;
+	}
+
+	if (irq_mode)
+		state = key[0];
+	else
+		state = selected_state;
+
+	compute_global_keys(key,state,&global_key1,&global_key2,&global_key3);
+
 	return state & 0xff;
 }
+
+/* decrypt a block of words starting at word offset 0 for a state as returned
+   by fd1094_set_state(), without touching the current state. The key bits are
+   worked out once for each of the 256 main key values rather than for every
+   word, and nothing global is modified, so several blocks can be decrypted
+   at once on different threads. */
+void fd1094_decode_block(UINT16 *dest,const UINT16 *src,UINT32 words,unsigned char *key,int state)
+{
+	UINT8 masked_map[MASKED_OPCODE_MAP_SIZE];
+	decode_keys keys[256];
+	int gkey1,gkey2,gkey3;
+	UINT32 address;
+	int mainkey;
+
+	if (!key) return;
+
+	build_masked_opcode_map(masked_map);
+	compute_global_keys(key,state,&gkey1,&gkey2,&gkey3);
+	for (mainkey = 0;mainkey < 256;mainkey++)
+		compute_keys(&keys[mainkey],mainkey,gkey1,gkey2,gkey3);
+
+	for (address = 0;address < words;address++)
+	{
+		mainkey = MAIN_KEY_FOR_ADDRESS(key,address);
+		dest[address] = decode_value(src[address],&keys[mainkey],BIT(mainkey,(address & 0x1000) ? 7 : 6),masked_map);
+	}
+}
@@ -4,3 +4,4 @@
 
 int fd1094_set_state(unsigned char *key,int state);
 int fd1094_decode(int address,int val,unsigned char *key,int vector_fetch);
+void fd1094_decode_block(UINT16 *dest,const UINT16 *src,UINT32 words,unsigned char *key,int state);
@@ -35,6 +35,7 @@
 
 #include "driver.h"
 #include "neogeo.h"
+#include "machine/cryptcache.h"
 
 
 /***************************************************************************
@@ -508,28 +509,44 @@ static void decrypt(unsigned char *r0, unsigned char *r1,
 	}
 }
 
-static void neogeo_gfx_decrypt(int extra_xor)
+struct gfx_decrypt_info
 {
-	int rom_size;
-	UINT8 *buf;
 	UINT8 *rom;
-	int rpos;
-
-	rom_size = memory_region_length(REGION_GFX3);
+	UINT8 *buf;
+	int rom_size;
+	int extra_xor;
+};
 
-	buf = malloc_or_die(rom_size);
+/* both passes work on 32-bit words, and every word is independent of the others
+   within a pass, so each pass is split into ranges of words done in parallel */
+#define GFX_DECRYPT_CHUNK	0x10000
 
-	rom = memory_region(REGION_GFX3);
+static void neogeo_gfx_decrypt_data(void *param, UINT32 start, UINT32 end)
+{
+	struct gfx_decrypt_info *info = param;
+	UINT8 *rom = info->rom;
+	UINT8 *buf = info->buf;
+	int rpos;
 
 	// Data xor
-	for (rpos = 0;rpos < rom_size/4;rpos++)
+	for (rpos = start;rpos < end;rpos++)
 	{
 		decrypt(buf+4*rpos+0, buf+4*rpos+3, rom[4*rpos+0], rom[4*rpos+3], type0_t03, type0_t12, type1_t03, rpos, (rpos>>8) & 1);
 		decrypt(buf+4*rpos+1, buf+4*rpos+2, rom[4*rpos+1], rom[4*rpos+2], type0_t12, type0_t03, type1_t12, rpos, ((rpos>>16) ^ address_16_23_xor2[(rpos>>8) & 0xff]) & 1);
 	}
+}
+
+static void neogeo_gfx_decrypt_address(void *param, UINT32 start, UINT32 end)
+{
+	struct gfx_decrypt_info *info = param;
+	UINT8 *rom = info->rom;
+	UINT8 *buf = info->buf;
+	int rom_size = info->rom_size;
+	int extra_xor = info->extra_xor;
+	int rpos;
 
 	// Address xor
-	for (rpos = 0;rpos < rom_size/4;rpos++)
+	for (rpos = start;rpos < end;rpos++)
 	{
 		int baser;
 
@@ -566,8 +583,47 @@ static void neogeo_gfx_decrypt(int extra_xor)
 		rom[4*rpos+2] = buf[4*baser+2];
 		rom[4*rpos+3] = buf[4*baser+3];
 	}
+}
 
-	free(buf);
+static void neogeo_gfx_decrypt(int extra_xor)
+{
+	const unsigned char *tables[9];
+	struct gfx_decrypt_info info;
+	decrypt_cache_key cachekey;
+	UINT8 keydata[4 + 9 * 256];
+	int i;
+
+	info.rom_size = memory_region_length(REGION_GFX3);
+	info.rom = memory_region(REGION_GFX3);
+	info.extra_xor = extra_xor;
+
+	// the output depends on the ROM, the extra xor and the tables for this chip
+	tables[0] = type0_t03;
+	tables[1] = type0_t12;
+	tables[2] = type1_t03;
+	tables[3] = type1_t12;
+	tables[4] = address_8_15_xor1;
+	tables[5] = address_8_15_xor2;
+	tables[6] = address_16_23_xor1;
+	tables[7] = address_16_23_xor2;
+	tables[8] = address_0_7_xor;
+	keydata[0] = extra_xor >> 24;
+	keydata[1] = extra_xor >> 16;
+	keydata[2] = extra_xor >> 8;
+	keydata[3] = extra_xor;
+	for (i = 0;i < 9;i++)
+		memcpy(&keydata[4 + i * 256], tables[i], 256);
+
+	decrypt_cache_compute_key(&cachekey, "neogeo-cmc-1", keydata, sizeof(keydata), info.rom, info.rom_size);
+	if (decrypt_cache_load(&cachekey, info.rom, info.rom_size))
+		return;
+
+	info.buf = malloc_or_die(info.rom_size);
+	decrypt_parallel(neogeo_gfx_decrypt_data, &info, info.rom_size/4, GFX_DECRYPT_CHUNK, NULL);
+	decrypt_parallel(neogeo_gfx_decrypt_address, &info, info.rom_size/4, GFX_DECRYPT_CHUNK, NULL);
+	free(info.buf);
+
+	decrypt_cache_save(&cachekey, info.rom, info.rom_size);
 }
 
 /* the S data comes from the end of the C data */
@@ -1,10 +1,15 @@
 /* System 16 and friends FD1094 handling */
 
 /*
+the states a game switches to are counted and saved to <game>.fdc in the
+nvram directory on exit. On the next run the most used ones are decrypted
+on a worker thread while the game starts, so switching to them later
+doesn't stall emulation. The number of states kept decrypted is set with
+the fd1094_cache_size option.
+
 todo:
 
 support multiple FD1094s (does anything /use/ multiple FD1094s?)
-make more configurable (select caches per game?)
 
 */
 
@@ -13,16 +18,26 @@ make more configurable (select caches per game?)
 #include "machine/fd1094.h"
 
 
-#define S16_NUMCACHE 8
+typedef struct _fd1094_cache_entry fd1094_cache_entry;
+struct _fd1094_cache_entry
+{
+	UINT16 *data; // decrypted copy of the CPU region
+	int state; // state it was decrypted for, or -1 if unused
+	UINT32 lastuse; // value of fd1094_usecount when last selected
+	osd_work_item *pending; // background decryption still filling in data
+};
 
 static unsigned char *fd1094_key; // the memory region containing key
 static UINT16 *fd1094_cpuregion; // the CPU region with encrypted code
 static UINT32  fd1094_cpuregionsize; // the size of this region in bytes
 
 static UINT16* fd1094_userregion; // a user region where the current decrypted state is put and executed from
-static UINT16* fd1094_cacheregion[S16_NUMCACHE]; // a cache region where S16_NUMCACHE states are stored to improve performance
-static int fd1094_cached_states[S16_NUMCACHE]; // array of cached state numbers
-static int fd1094_current_cacheposition; // current position in cache array
+static fd1094_cache_entry *fd1094_cache; // fd1094_cachesize decrypted states, replaced least recently used first
+static int fd1094_cachesize; // number of entries in fd1094_cache
+static UINT32 fd1094_usecount; // number of state selections so far
+
+static UINT32 fd1094_state_uses[256]; // how often each state was selected, this run and earlier ones
+static osd_work_queue *fd1094_queue; // queue for decrypting states in the background
 
 void *fd1094_get_decrypted_base(void)
 {
@@ -31,58 +46,76 @@ void *fd1094_get_decrypted_base(void)
 	return fd1094_userregion;
 }
 
+/* decrypts a whole state into its cache entry; runs on the work queue */
+static void *fd1094_decrypt_callback(void *param)
+{
+	fd1094_cache_entry *entry = param;
+
+	fd1094_decode_block(entry->data, fd1094_cpuregion, fd1094_cpuregionsize / 2, fd1094_key, entry->state);
+	return NULL;
+}
+
+/* waits for a background decryption of a cache entry to finish, if there is one */
+static void fd1094_wait_entry(fd1094_cache_entry *entry)
+{
+	if (entry->pending != NULL)
+	{
+		while (!osd_work_item_wait(entry->pending, osd_ticks_per_second()))
+			;
+		osd_work_item_release(entry->pending);
+		entry->pending = NULL;
+	}
+}
+
 /* this function checks the cache to see if the current state is cached,
-   if it is then it copies the cached data to the user region where code is
-   executed from, if its not cached then it gets decrypted to the current
-   cache position using the functions in fd1094.c */
+   if it is then the cached copy becomes the region code is executed from,
+   if its not cached then it gets decrypted over the least recently used
+   cache entry using the functions in fd1094.c */
 void fd1094_setstate_and_decrypt(int state)
 {
+	fd1094_cache_entry *entry = NULL;
 	int i;
-	UINT32 addr;
 
 	cpunum_set_info_int(0, CPUINFO_INT_REGISTER + M68K_PREF_ADDR, 0x0010);	// force a flush of the prefetch cache
 
 	/* set the FD1094 state ready to decrypt.. */
 	state = fd1094_set_state(fd1094_key,state);
+	fd1094_state_uses[state]++;
 
-	/* first check the cache, if its cached we don't need to decrypt it, just copy */
-	for (i=0;i<S16_NUMCACHE;i++)
+	/* first check the cache, if its cached we don't need to decrypt it */
+	for (i=0;i<fd1094_cachesize;i++)
 	{
-		if (fd1094_cached_states[i] == state)
+		if (fd1094_cache[i].state == state)
 		{
-			/* copy cached state */
-			fd1094_userregion=fd1094_cacheregion[i];
-			memory_set_decrypted_region(0, 0, fd1094_cpuregionsize - 1, fd1094_userregion);
-			m68k_set_encrypted_opcode_range(0,0,fd1094_cpuregionsize);
+			entry = &fd1094_cache[i];
 
-			return;
+			/* it may still be being decrypted in the background */
+			fd1094_wait_entry(entry);
+			break;
 		}
 	}
 
-// mame_printf_debug("new state %04x\n",state);
-
-	/* mark it as cached (because it will be once we decrypt it) */
-	fd1094_cached_states[fd1094_current_cacheposition]=state;
-
-	for (addr=0;addr<fd1094_cpuregionsize/2;addr++)
+	if (entry == NULL)
 	{
-		UINT16 dat;
-		dat = fd1094_decode(addr,fd1094_cpuregion[addr],fd1094_key,0);
-		fd1094_cacheregion[fd1094_current_cacheposition][addr]=dat;
+		/* reuse the entry that has gone unused the longest */
+		entry = &fd1094_cache[0];
+		for (i=1;i<fd1094_cachesize;i++)
+			if (fd1094_cache[i].lastuse < entry->lastuse)
+				entry = &fd1094_cache[i];
+		fd1094_wait_entry(entry);
+
+		if (entry->state != -1)
+			mame_printf_debug("FD1094 state %02x replaces %02x in the cache, increase fd1094_cache_size if this happens often\n", state, entry->state);
+
+		entry->state = state;
+		fd1094_decrypt_callback(entry);
 	}
+	entry->lastuse = ++fd1094_usecount;
 
-	/* copy newly decrypted data to user region */
-	fd1094_userregion=fd1094_cacheregion[fd1094_current_cacheposition];
+	/* make the decrypted data the user region */
+	fd1094_userregion=entry->data;
 	memory_set_decrypted_region(0, 0, fd1094_cpuregionsize - 1, fd1094_userregion);
 	m68k_set_encrypted_opcode_range(0,0,fd1094_cpuregionsize);
-
-	fd1094_current_cacheposition++;
-
-	if (fd1094_current_cacheposition>=S16_NUMCACHE)
-	{
-		mame_printf_debug("out of cache, performance may suffer, incrase S16_NUMCACHE!\n");
-		fd1094_current_cacheposition=0;
-	}
 }
 
 /* Callback for CMP.L instructions (state change) */
@@ -132,6 +165,97 @@ void fd1094_machine_init(void)
 	cpunum_set_irq_callback(0, fd1094_int_callback);
 }
 
+/* opens the file listing the states used by the current game */
+static mame_file *fd1094_fopen(UINT32 openflags)
+{
+	mame_file_error filerr;
+	mame_file *file;
+	char *fname;
+
+	fname = assemble_2_strings(Machine->basename, ".fdc");
+	filerr = mame_fopen(SEARCHPATH_NVRAM, fname, openflags, &file);
+	free(fname);
+
+	return (filerr == FILERR_NONE) ? file : NULL;
+}
+
+/* reads the state use counts saved by earlier runs */
+static void fd1094_load_state_uses(void)
+{
+	mame_file *file = fd1094_fopen(OPEN_FLAG_READ);
+	char line[256];
+
+	if (file == NULL)
+		return;
+
+	/* each line is a state and the number of times it was selected, both in hex */
+	while (mame_fgets(line, sizeof(line), file) != NULL)
+	{
+		unsigned int state, uses;
+
+		if (sscanf(line, "%x %x", &state, &uses) == 2 && state < 256)
+			fd1094_state_uses[state] = uses;
+	}
+	mame_fclose(file);
+}
+
+/* starts decrypting the most used states in the background */
+static void fd1094_precompute_states(void)
+{
+	int i, j;
+
+	fd1094_queue = osd_work_queue_alloc(WORK_QUEUE_FLAG_MULTI);
+	if (fd1094_queue == NULL)
+		return;
+
+	for (i=0;i<fd1094_cachesize;i++)
+	{
+		fd1094_cache_entry *entry = &fd1094_cache[i];
+		int best = -1;
+
+		/* find the most used state that isn't queued yet */
+		for (j=0;j<256;j++)
+			if (fd1094_state_uses[j] != 0 && (best == -1 || fd1094_state_uses[j] > fd1094_state_uses[best]))
+			{
+				int k;
+
+				for (k=0;k<i;k++)
+					if (fd1094_cache[k].state == j)
+						break;
+				if (k == i)
+					best = j;
+			}
+		if (best == -1)
+			break;
+
+		entry->state = best;
+		entry->pending = osd_work_item_queue(fd1094_queue, fd1094_decrypt_callback, entry);
+		if (entry->pending == NULL)
+			fd1094_decrypt_callback(entry);
+	}
+}
+
+/* waits for background work and saves the state use counts */
+static void fd1094_exit(running_machine *machine)
+{
+	mame_file *file;
+	int i;
+
+	for (i=0;i<fd1094_cachesize;i++)
+		fd1094_wait_entry(&fd1094_cache[i]);
+	if (fd1094_queue != NULL)
+		osd_work_queue_free(fd1094_queue);
+	fd1094_queue = NULL;
+
+	file = fd1094_fopen(OPEN_FLAG_WRITE | OPEN_FLAG_CREATE | OPEN_FLAG_CREATE_PATHS);
+	if (file == NULL)
+		return;
+	for (i=0;i<256;i++)
+		if (fd1094_state_uses[i] != 0)
+			mame_fprintf(file, "%02x %x\n", i, fd1094_state_uses[i]);
+	mame_fclose(file);
+}
+
 /* startup function, to be called from DRIVER_INIT (once on startup) */
 void fd1094_driver_init(void)
 {
@@ -145,14 +269,22 @@ void fd1094_driver_init(void)
 	if (!fd1094_key)
 		return;
 
-	for (i=0;i<S16_NUMCACHE;i++)
+	/* allocate and flush the cache */
+	fd1094_cachesize = options_get_int_range(OPTION_FD1094_CACHE_SIZE, 1, 256);
+	fd1094_cache = auto_malloc(fd1094_cachesize * sizeof(*fd1094_cache));
+	for (i=0;i<fd1094_cachesize;i++)
 	{
-		fd1094_cacheregion[i]=auto_malloc(fd1094_cpuregionsize);
+		fd1094_cache[i].data = auto_malloc(fd1094_cpuregionsize);
+		fd1094_cache[i].state = -1;
+		fd1094_cache[i].lastuse = 0;
+		fd1094_cache[i].pending = NULL;
 	}
+	fd1094_usecount = 0;
 
-	/* flush the cached state array */
-	for (i=0;i<S16_NUMCACHE;i++)
-		fd1094_cached_states[i] = -1;
+	/* start on the states earlier runs needed */
+	memset(fd1094_state_uses, 0, sizeof(fd1094_state_uses));
+	fd1094_load_state_uses();
+	fd1094_precompute_states();
 
-	fd1094_current_cacheposition = 0;
+	add_exit_callback(Machine, fd1094_exit);
 }
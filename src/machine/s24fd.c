@@ -29,7 +29,6 @@ static int fd1094_current_cacheposition; // current position in cache array
 void s24_fd1094_setstate_and_decrypt(int state)
 {
 	int i;
-	UINT32 addr;
 
 	cpunum_set_info_int(1, CPUINFO_INT_REGISTER + M68K_PREF_ADDR, 0x0010);	// force a flush of the prefetch cache
 
@@ -55,12 +54,7 @@ void s24_fd1094_setstate_and_decrypt(int state)
 	/* mark it as cached (because it will be once we decrypt it) */
 	fd1094_cached_states[fd1094_current_cacheposition]=state;
 
-	for (addr=0;addr<s24_fd1094_cpuregionsize/2;addr++)
-	{
-		UINT16 dat;
-		dat = fd1094_decode(addr,s24_fd1094_cpuregion[addr],s24_fd1094_key,0);
-		s24_fd1094_cacheregion[fd1094_current_cacheposition][addr]=dat;
-	}
+	fd1094_decode_block(s24_fd1094_cacheregion[fd1094_current_cacheposition],s24_fd1094_cpuregion,s24_fd1094_cpuregionsize/2,s24_fd1094_key,state);
 
 	/* copy newly decrypted data to user region */
 	s24_fd1094_userregion=s24_fd1094_cacheregion[fd1094_current_cacheposition];
@@ -40,6 +40,7 @@
                 - calls osd_init() [osdepend.h] to do platform-specific initialization
                 - calls code_init() [input.c] to initialize the input system
                 - calls input_port_init() [inptport.c] to set up the input ports
+                - calls inplog_init() [inplog.c] to set up input file checkpoints
                 - calls rom_init() [romload.c] to load the game's ROMs
                 - calls timer_init() [timer.c] to reset the timer system
                 - calls memory_init() [memory.c] to process the game's memory maps
@@ -78,6 +79,7 @@
 #include "config.h"
 #include "cheat.h"
 #include "debugger.h"
+#include "inplog.h"
 #include "profiler.h"
 #include "render.h"
 #include "ui.h"
@@ -346,6 +348,9 @@ int run_game(int game)
 				if (mame->saveload_schedule_callback)
 					(*mame->saveload_schedule_callback)(machine);
 
+				/* handle input file checkpoints */
+				inplog_update(machine);
+
 				profiler_mark(PROFILER_END);
 			}
 
@@ -1162,6 +1167,8 @@ static void destroy_machine(running_machine *machine)
 		free((machine_config *)machine->drv);
 	if (machine->mame_data != NULL)
 		free(machine->mame_data);
+	if (machine->timer_data != NULL)
+		free(machine->timer_data);
 	if (machine->basename != NULL)
 		free((void *)machine->basename);
 	free(machine);
@@ -1214,6 +1221,7 @@ static void init_machine(running_machine *machine)
 	/* callbacks based on input port tags */
 	if (input_port_init(machine, machine->gamedrv->ipt) != 0)
 		fatalerror("input_port_init failed");
+	inplog_init(machine);
 
 	/* load the ROMs if we have some */
 	/* this must be done before memory_init in order to allocate memory regions */
@@ -1382,6 +1390,89 @@ static void saveload_init(running_machine *machine)
 }
 
 
+/*-------------------------------------------------
+    mame_save_state - write the full machine state
+    at the current position of an open file
+-------------------------------------------------*/
+
+int mame_save_state(running_machine *machine, mame_file *file)
+{
+	int cpunum;
+
+	/* write the save state */
+	if (state_save_save_begin(file) != 0)
+		return 1;
+
+	/* write the default tag */
+	state_save_push_tag(0);
+	state_save_save_continue();
+	state_save_pop_tag();
+
+	/* loop over CPUs */
+	for (cpunum = 0; cpunum < cpu_gettotalcpu(); cpunum++)
+	{
+		cpuintrf_push_context(cpunum);
+
+		/* make sure banking is set */
+		activecpu_reset_banking();
+
+		/* save the CPU data */
+		state_save_push_tag(cpunum + 1);
+		state_save_save_continue();
+		state_save_pop_tag();
+
+		cpuintrf_pop_context();
+	}
+
+	/* finish */
+	state_save_save_finish();
+	return 0;
+}
+
+
+/*-------------------------------------------------
+    mame_load_state - read the full machine state
+    from the current position of an open file
+-------------------------------------------------*/
+
+int mame_load_state(running_machine *machine, mame_file *file, UINT32 length)
+{
+	int cpunum;
+
+	/* start loading */
+	if (state_save_load_begin_length(file, length) != 0)
+		return 1;
+
+	/* read tag 0 */
+	state_save_push_tag(0);
+	state_save_load_continue();
+	state_save_pop_tag();
+
+	/* loop over CPUs */
+	for (cpunum = 0; cpunum < cpu_gettotalcpu(); cpunum++)
+	{
+		cpuintrf_push_context(cpunum);
+
+		/* make sure banking is set */
+		activecpu_reset_banking();
+
+		/* load the CPU data */
+		state_save_push_tag(cpunum + 1);
+		state_save_load_continue();
+		state_save_pop_tag();
+
+		/* make sure banking is set */
+		activecpu_reset_banking();
+
+		cpuintrf_pop_context();
+	}
+
+	/* finish */
+	state_save_load_finish();
+	return 0;
+}
+
+
 /*-------------------------------------------------
     handle_save - attempt to perform a save
 -------------------------------------------------*/
@@ -1415,39 +1506,13 @@ static void handle_save(running_machine *machine)
 	filerr = mame_fopen(SEARCHPATH_STATE, mame->saveload_pending_file, OPEN_FLAG_WRITE | OPEN_FLAG_CREATE | OPEN_FLAG_CREATE_PATHS, &file);
 	if (filerr == FILERR_NONE)
 	{
-		int cpunum;
-
 		/* write the save state */
-		if (state_save_save_begin(file) != 0)
+		if (mame_save_state(machine, file) != 0)
 		{
 			popmessage("Error: Unable to save state due to illegal registrations. See error.log for details.");
 			mame_fclose(file);
 			goto cancel;
 		}
-
-		/* write the default tag */
-		state_save_push_tag(0);
-		state_save_save_continue();
-		state_save_pop_tag();
-
-		/* loop over CPUs */
-		for (cpunum = 0; cpunum < cpu_gettotalcpu(); cpunum++)
-		{
-			cpuintrf_push_context(cpunum);
-
-			/* make sure banking is set */
-			activecpu_reset_banking();
-
-			/* save the CPU data */
-			state_save_push_tag(cpunum + 1);
-			state_save_save_continue();
-			state_save_pop_tag();
-
-			cpuintrf_pop_context();
-		}
-
-		/* finish and close */
-		state_save_save_finish();
 		mame_fclose(file);
 
 		/* pop a warning if the game doesn't support saves */
@@ -1501,39 +1566,9 @@ static void handle_load(running_machine *machine)
 	filerr = mame_fopen(SEARCHPATH_STATE, mame->saveload_pending_file, OPEN_FLAG_READ, &file);
 	if (filerr == FILERR_NONE)
 	{
-		/* start loading */
-		if (state_save_load_begin(file) == 0)
-		{
-			int cpunum;
-
-			/* read tag 0 */
-			state_save_push_tag(0);
-			state_save_load_continue();
-			state_save_pop_tag();
-
-			/* loop over CPUs */
-			for (cpunum = 0; cpunum < cpu_gettotalcpu(); cpunum++)
-			{
-				cpuintrf_push_context(cpunum);
-
-				/* make sure banking is set */
-				activecpu_reset_banking();
-
-				/* load the CPU data */
-				state_save_push_tag(cpunum + 1);
-				state_save_load_continue();
-				state_save_pop_tag();
-
-				/* make sure banking is set */
-				activecpu_reset_banking();
-
-				cpuintrf_pop_context();
-			}
-
-			/* finish and close */
-			state_save_load_finish();
+		/* load the whole file */
+		if (mame_load_state(machine, file, mame_fsize(file)) == 0)
 			popmessage("State successfully loaded.");
-		}
 		else
 			popmessage("Error: Failed to load state");
 		mame_fclose(file);
@@ -139,6 +139,7 @@ typedef void (*output_callback)(void *param, const char *format, va_list argptr)
 
 /* forward type declarations */
 typedef struct _palette_private palette_private;
+typedef struct _timer_private timer_private;
 typedef struct _mame_private mame_private;
 
 
@@ -180,6 +181,7 @@ struct _running_machine
 	/* internal core information */
 	mame_private *			mame_data;			/* internal data from mame.c */
 	palette_private *		palette_data;		/* internal data from palette.c */
+	timer_private *			timer_data;			/* internal data from timer.c */
 
 	/* driver-specific information */
 	void *					driver_data;		/* drivers can hang data off of here instead of using globals */
@@ -239,6 +241,9 @@ struct _global_options
 {
 	mame_file *	record;			/* handle to file to record input to */
 	mame_file *	playback;		/* handle to file to playback input from */
+	int			record_checkpoint;	/* seconds between state checkpoints when recording, or 0 */
+	UINT8		playback_checkpoints;	/* 1 if the playback file has state checkpoints */
+	int			playback_seek;	/* seconds into the playback file to start from */
 	mame_file *	language_file;	/* handle to file for localization */
 	mame_file *	logfile;		/* handle to file for debug logging */
 
@@ -266,6 +271,8 @@ struct _global_options
 
 	const char *controller;	/* controller-specific cfg to load */
 
+	UINT8		snap_uncompressed;	/* 1 to write snapshots without compression */
+
 #ifdef MESS
 	UINT32	ram;
 	struct ImageFile image_files[32];
@@ -273,6 +280,7 @@ struct _global_options
 	int		disable_normal_ui;
 	int		min_width;		/* minimum width for the display */
 	int		min_height;		/* minimum height for the display */
+	UINT8	fast_tape_load;	/* 1 to run unthrottled while a tape is being loaded */
 #endif /* MESS */
 };
 
@@ -332,6 +340,12 @@ void mame_schedule_save(running_machine *machine, const char *filename);
 /* schedule a load */
 void mame_schedule_load(running_machine *machine, const char *filename);
 
+/* write the full machine state at the current file position; returns non-zero on failure */
+int mame_save_state(running_machine *machine, mame_file *file);
+
+/* read length bytes of machine state from the current file position; returns non-zero on failure */
+int mame_load_state(running_machine *machine, mame_file *file, UINT32 length);
+
 /* is a scheduled event pending? */
 int mame_is_scheduled_event_pending(running_machine *machine);
 
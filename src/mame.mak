@@ -1653,3 +1653,21 @@ $(OBJ)/drivers/warpwarp.o:	$(OBJ)/layout/geebee.lh \
 
 $(OBJ)/drivers/zac2650.o:	$(OBJ)/layout/tinv2650.lh
 
+
+
+
+#-------------------------------------------------
+# Voodoo rasterizers generated from game profiles
+#-------------------------------------------------
+
+ifdef VOODOO_PROFILE
+CFLAGS += -I$(OBJ)/vidhrdw
+
+VOODOO_PROFILES = $(wildcard src/vidhrdw/voodprof/*.vrp)
+
+$(OBJ)/vidhrdw/voodoo.o:	$(OBJ)/vidhrdw/voodprof.h
+
+$(OBJ)/vidhrdw/voodprof.h: src/vidhrdw/voodoo.c $(VOODOO_PROFILES) voodprof$(EXE)
+	@echo Generating $@...
+	@voodprof$(EXE) $@ src/vidhrdw/voodoo.c $(VOODOO_PROFILES)
+endif
@@ -140,6 +140,18 @@
 #define MEMWRITESTART()			do { profiler_mark(PROFILER_MEMWRITE); } while (0)
 #define MEMWRITEEND(ret)		do { (ret); profiler_mark(PROFILER_END); return; } while (0)
 
+/* macros for calling a handler; with MEMORY_PROFILE each call is timed and counted */
+#ifdef MEMORY_PROFILE
+#define MEMREADHANDLER(hdata, call)	do { handler_data *_h = &(hdata); osd_ticks_t _start = osd_profiling_ticks(); UINT64 _result = (call); handler_profile_end(_h, _start); MEMREADEND(_result); } while (0)
+#define MEMWRITEHANDLER(hdata, call) do { handler_data *_h = &(hdata); osd_ticks_t _start = osd_profiling_ticks(); (call); handler_profile_end(_h, _start); MEMWRITEEND((void)0); } while (0)
+#else
+#define MEMREADHANDLER(hdata, call)	MEMREADEND(call)
+#define MEMWRITEHANDLER(hdata, call) MEMWRITEEND(call)
+#endif
+
+/* every this many calls to a handler, the caller's PC is sampled */
+#define MEMORY_PROFILE_SAMPLE_RATE	16
+
 /* helper macros */
 #define HANDLER_IS_RAM(h)		((FPTR)(h) == STATIC_RAM)
 #define HANDLER_IS_ROM(h)		((FPTR)(h) == STATIC_ROM)
@@ -210,6 +222,12 @@ struct _handler_data
 	offs_t					top;					/* maximum offset for handler */
 	offs_t					mask;					/* mask against the final address */
 	const char *			name;					/* name of the handler */
+#ifdef MEMORY_PROFILE
+	UINT64					calls;					/* number of calls to the handler */
+	osd_ticks_t				ticks;					/* total profiling ticks spent in the handler */
+	offs_t					callerpc[MEMORY_PROFILE_CALLERS]; /* most frequent sampled caller PCs */
+	UINT32					callercount[MEMORY_PROFILE_CALLERS]; /* samples seen for each caller PC */
+#endif
 };
 /* In memory.h: typedef struct _handler_data handler_data */
 
@@ -392,6 +410,9 @@ static address_map *assign_intersecting_blocks(addrspace_data *space, offs_t sta
 static int find_memory(void);
 static void *memory_find_base(int cpunum, int spacenum, int readwrite, offs_t offset);
 static genf *get_static_handler(int databits, int readorwrite, int spacenum, int which);
+#ifdef MEMORY_PROFILE
+static void memory_profile_dump(void);
+#endif
 
 static void mem_dump(void)
 {
@@ -468,6 +489,11 @@ void memory_exit(running_machine *machine)
 {
 	int cpunum, spacenum;
 
+#ifdef MEMORY_PROFILE
+	/* report the handler statistics before the tables go away */
+	memory_profile_dump();
+#endif
+
 	/* free all the tables */
 	for (cpunum = 0; cpunum < MAX_CPU; cpunum++)
 		for (spacenum = 0; spacenum < ADDRESS_SPACES; spacenum++)
@@ -2373,6 +2399,39 @@ static void *memory_find_base(int cpunum, int spacenum, int readwrite, offs_t of
 }
 
 
+#ifdef MEMORY_PROFILE
+/*-------------------------------------------------
+    handler_profile_end - account for a single
+    handler call, sampling the caller's PC
+-------------------------------------------------*/
+
+INLINE void handler_profile_end(handler_data *handler, osd_ticks_t start)
+{
+	int index, victim = 0;
+	offs_t pc;
+
+	handler->ticks += osd_profiling_ticks() - start;
+	if ((handler->calls++ % MEMORY_PROFILE_SAMPLE_RATE) != 0 || cpu_getactivecpu() < 0)
+		return;
+
+	/* count the PC if we already track it; otherwise it replaces the least frequent one */
+	pc = activecpu_get_pc();
+	for (index = 0; index < MEMORY_PROFILE_CALLERS; index++)
+	{
+		if (handler->callercount[index] != 0 && handler->callerpc[index] == pc)
+		{
+			handler->callercount[index]++;
+			return;
+		}
+		if (handler->callercount[index] < handler->callercount[victim])
+			victim = index;
+	}
+	handler->callerpc[victim] = pc;
+	handler->callercount[victim]++;
+}
+#endif
+
+
 /*-------------------------------------------------
     PERFORM_LOOKUP - common lookup procedure
 -------------------------------------------------*/
@@ -2404,7 +2463,7 @@ UINT8 name(offs_t address)																\
 																						\
 	/* fall back to the handler */														\
 	else																				\
-		MEMREADEND((*active_address_space[spacenum].readhandlers[entry].handler.read.handler8)(address));\
+		MEMREADHANDLER(active_address_space[spacenum].readhandlers[entry], (*active_address_space[spacenum].readhandlers[entry].handler.read.handler8)(address));\
 	return 0;																			\
 }																						\
 
@@ -2425,7 +2484,7 @@ UINT8 name(offs_t address)																\
 	else																				\
 	{																					\
 		int shift = 8 * (shiftbytes);													\
-		MEMREADEND((*active_address_space[spacenum].readhandlers[entry].handler.read.handlertype)(address >> (ignorebits), ~((masktype)0xff << shift)) >> shift);\
+		MEMREADHANDLER(active_address_space[spacenum].readhandlers[entry], (*active_address_space[spacenum].readhandlers[entry].handler.read.handlertype)(address >> (ignorebits), ~((masktype)0xff << shift)) >> shift);\
 	}																					\
 	return 0;																			\
 }																						\
@@ -2458,7 +2517,7 @@ UINT16 name(offs_t address)																\
 																						\
 	/* fall back to the handler */														\
 	else																				\
-		MEMREADEND((*active_address_space[spacenum].readhandlers[entry].handler.read.handler16)(address >> 1,0));\
+		MEMREADHANDLER(active_address_space[spacenum].readhandlers[entry], (*active_address_space[spacenum].readhandlers[entry].handler.read.handler16)(address >> 1,0));\
 	return 0;																			\
 }																						\
 
@@ -2479,7 +2538,7 @@ UINT16 name(offs_t address)																\
 	else																				\
 	{																					\
 		int shift = 8 * (shiftbytes);													\
-		MEMREADEND((*active_address_space[spacenum].readhandlers[entry].handler.read.handlertype)(address >> (ignorebits), ~((masktype)0xffff << shift)) >> shift);\
+		MEMREADHANDLER(active_address_space[spacenum].readhandlers[entry], (*active_address_space[spacenum].readhandlers[entry].handler.read.handlertype)(address >> (ignorebits), ~((masktype)0xffff << shift)) >> shift);\
 	}																					\
 	return 0;																			\
 }																						\
@@ -2510,7 +2569,7 @@ UINT32 name(offs_t address)																\
 																						\
 	/* fall back to the handler */														\
 	else																				\
-		MEMREADEND((*active_address_space[spacenum].readhandlers[entry].handler.read.handler32)(address >> 2,0));\
+		MEMREADHANDLER(active_address_space[spacenum].readhandlers[entry], (*active_address_space[spacenum].readhandlers[entry].handler.read.handler32)(address >> 2,0));\
 	return 0;																			\
 }																						\
 
@@ -2531,7 +2590,7 @@ UINT32 name(offs_t address)																\
 	else																				\
 	{																					\
 		int shift = 8 * (shiftbytes);													\
-		MEMREADEND((*active_address_space[spacenum].readhandlers[entry].handler.read.handlertype)(address >> (ignorebits), ~((masktype)0xffffffff << shift)) >> shift);\
+		MEMREADHANDLER(active_address_space[spacenum].readhandlers[entry], (*active_address_space[spacenum].readhandlers[entry].handler.read.handlertype)(address >> (ignorebits), ~((masktype)0xffffffff << shift)) >> shift);\
 	}																					\
 	return 0;																			\
 }																						\
@@ -2560,7 +2619,7 @@ UINT64 name(offs_t address)																\
 																						\
 	/* fall back to the handler */														\
 	else																				\
-		MEMREADEND((*active_address_space[spacenum].readhandlers[entry].handler.read.handler64)(address >> 3,0));\
+		MEMREADHANDLER(active_address_space[spacenum].readhandlers[entry], (*active_address_space[spacenum].readhandlers[entry].handler.read.handler64)(address >> 3,0));\
 	return 0;																			\
 }																						\
 
@@ -2584,7 +2643,7 @@ void name(offs_t address, UINT8 data)													\
 																						\
 	/* fall back to the handler */														\
 	else																				\
-		MEMWRITEEND((*active_address_space[spacenum].writehandlers[entry].handler.write.handler8)(address, data));\
+		MEMWRITEHANDLER(active_address_space[spacenum].writehandlers[entry], (*active_address_space[spacenum].writehandlers[entry].handler.write.handler8)(address, data));\
 }																						\
 
 #define WRITEBYTE(name,spacenum,xormacro,handlertype,ignorebits,shiftbytes,masktype)	\
@@ -2604,7 +2663,7 @@ void name(offs_t address, UINT8 data)													\
 	else																				\
 	{																					\
 		int shift = 8 * (shiftbytes);													\
-		MEMWRITEEND((*active_address_space[spacenum].writehandlers[entry].handler.write.handlertype)(address >> (ignorebits), (masktype)data << shift, ~((masktype)0xff << shift)));\
+		MEMWRITEHANDLER(active_address_space[spacenum].writehandlers[entry], (*active_address_space[spacenum].writehandlers[entry].handler.write.handlertype)(address >> (ignorebits), (masktype)data << shift, ~((masktype)0xff << shift)));\
 	}																					\
 }																						\
 
@@ -2636,7 +2695,7 @@ void name(offs_t address, UINT16 data)													\
 																						\
 	/* fall back to the handler */														\
 	else																				\
-		MEMWRITEEND((*active_address_space[spacenum].writehandlers[entry].handler.write.handler16)(address >> 1, data, 0));\
+		MEMWRITEHANDLER(active_address_space[spacenum].writehandlers[entry], (*active_address_space[spacenum].writehandlers[entry].handler.write.handler16)(address >> 1, data, 0));\
 }																						\
 
 #define WRITEWORD(name,spacenum,xormacro,handlertype,ignorebits,shiftbytes,masktype)	\
@@ -2656,7 +2715,7 @@ void name(offs_t address, UINT16 data)													\
 	else																				\
 	{																					\
 		int shift = 8 * (shiftbytes);													\
-		MEMWRITEEND((*active_address_space[spacenum].writehandlers[entry].handler.write.handlertype)(address >> (ignorebits), (masktype)data << shift, ~((masktype)0xffff << shift)));\
+		MEMWRITEHANDLER(active_address_space[spacenum].writehandlers[entry], (*active_address_space[spacenum].writehandlers[entry].handler.write.handlertype)(address >> (ignorebits), (masktype)data << shift, ~((masktype)0xffff << shift)));\
 	}																					\
 }																						\
 
@@ -2686,7 +2745,7 @@ void name(offs_t address, UINT32 data)													\
 																						\
 	/* fall back to the handler */														\
 	else																				\
-		MEMWRITEEND((*active_address_space[spacenum].writehandlers[entry].handler.write.handler32)(address >> 2, data, 0));\
+		MEMWRITEHANDLER(active_address_space[spacenum].writehandlers[entry], (*active_address_space[spacenum].writehandlers[entry].handler.write.handler32)(address >> 2, data, 0));\
 }																						\
 
 #define WRITEDWORD(name,spacenum,xormacro,handlertype,ignorebits,shiftbytes,masktype)	\
@@ -2706,7 +2765,7 @@ void name(offs_t address, UINT32 data)													\
 	else																				\
 	{																					\
 		int shift = 8 * (shiftbytes);													\
-		MEMWRITEEND((*active_address_space[spacenum].writehandlers[entry].handler.write.handlertype)(address >> (ignorebits), (masktype)data << shift, ~((masktype)0xffffffff << shift)));\
+		MEMWRITEHANDLER(active_address_space[spacenum].writehandlers[entry], (*active_address_space[spacenum].writehandlers[entry].handler.write.handlertype)(address >> (ignorebits), (masktype)data << shift, ~((masktype)0xffffffff << shift)));\
 	}																					\
 }																						\
 
@@ -2734,7 +2793,7 @@ void name(offs_t address, UINT64 data)													\
 																						\
 	/* fall back to the handler */														\
 	else																				\
-		MEMWRITEEND((*active_address_space[spacenum].writehandlers[entry].handler.write.handler64)(address >> 3, data, 0));\
+		MEMWRITEHANDLER(active_address_space[spacenum].writehandlers[entry], (*active_address_space[spacenum].writehandlers[entry].handler.write.handler64)(address >> 3, data, 0));\
 }																						\
 
 
@@ -3318,3 +3377,171 @@ const char *memory_get_handler_string(int read0_or_write1, int cpunum, int space
 	/* 8-bit case: RAM/ROM */
 	return handler_to_string(table, entry);
 }
+
+
+
+#ifdef MEMORY_PROFILE
+/*-------------------------------------------------
+    profile_compare_ticks - qsort callback to
+    sort handler statistics by time spent
+-------------------------------------------------*/
+
+static int profile_compare_ticks(const void *item1, const void *item2)
+{
+	const memory_handler_stats *stats1 = item1;
+	const memory_handler_stats *stats2 = item2;
+
+	if (stats1->ticks != stats2->ticks)
+		return (stats1->ticks > stats2->ticks) ? -1 : 1;
+	if (stats1->calls != stats2->calls)
+		return (stats1->calls > stats2->calls) ? -1 : 1;
+	return strcmp(stats1->name, stats2->name);
+}
+
+
+/*-------------------------------------------------
+    profile_add_caller - merge a caller PC into
+    a set of handler statistics
+-------------------------------------------------*/
+
+static void profile_add_caller(memory_handler_stats *stats, int cpunum, offs_t pc, UINT32 count)
+{
+	int index, victim = 0;
+
+	for (index = 0; index < MEMORY_PROFILE_CALLERS; index++)
+	{
+		memory_handler_caller *caller = &stats->caller[index];
+		if (caller->count != 0 && caller->cpunum == cpunum && caller->pc == pc)
+		{
+			caller->count += count;
+			return;
+		}
+		if (caller->count < stats->caller[victim].count)
+			victim = index;
+	}
+
+	/* keep only the most frequent callers */
+	if (count > stats->caller[victim].count)
+	{
+		stats->caller[victim].cpunum = cpunum;
+		stats->caller[victim].pc = pc;
+		stats->caller[victim].count = count;
+	}
+}
+
+
+/*-------------------------------------------------
+    memory_profile_get_stats - gather the handler
+    statistics, merged by handler name and sorted
+    by time spent; returns the number of entries
+-------------------------------------------------*/
+
+int memory_profile_get_stats(memory_handler_stats *stats, int maxstats)
+{
+	int cpunum, spacenum, iswrite, count = 0;
+
+	for (cpunum = 0; cpunum < MAX_CPU && Machine->drv->cpu[cpunum].cpu_type != CPU_DUMMY; cpunum++)
+		for (spacenum = 0; spacenum < ADDRESS_SPACES; spacenum++)
+			if (cpudata[cpunum].space[spacenum].abits)
+				for (iswrite = 0; iswrite < 2; iswrite++)
+				{
+					const table_data *table = iswrite ? &cpudata[cpunum].space[spacenum].write : &cpudata[cpunum].space[spacenum].read;
+					int entry;
+
+					/* banks are handled inline and never reach a handler */
+					for (entry = STATIC_RAM; entry < ENTRY_COUNT; entry++)
+					{
+						const handler_data *handler = &table->handlers[entry];
+						const char *name;
+						int index, caller;
+
+						if (handler->calls == 0)
+							continue;
+
+						/* find or create an entry for this name */
+						name = handler_to_string(table, entry);
+						for (index = 0; index < count; index++)
+							if (stats[index].iswrite == iswrite && strcmp(stats[index].name, name) == 0)
+								break;
+						if (index == count)
+						{
+							if (count == maxstats)
+								continue;
+							memset(&stats[count], 0, sizeof(stats[count]));
+							stats[count].name = name;
+							stats[count].iswrite = iswrite;
+							count++;
+						}
+
+						stats[index].calls += handler->calls;
+						stats[index].ticks += handler->ticks;
+						for (caller = 0; caller < MEMORY_PROFILE_CALLERS; caller++)
+							if (handler->callercount[caller] != 0)
+								profile_add_caller(&stats[index], cpunum, handler->callerpc[caller], handler->callercount[caller]);
+					}
+				}
+
+	qsort(stats, count, sizeof(stats[0]), profile_compare_ticks);
+	return count;
+}
+
+
+/*-------------------------------------------------
+    memory_profile_reset - clear the handler
+    statistics
+-------------------------------------------------*/
+
+void memory_profile_reset(void)
+{
+	int cpunum, spacenum, entry;
+
+	for (cpunum = 0; cpunum < MAX_CPU; cpunum++)
+		for (spacenum = 0; spacenum < ADDRESS_SPACES; spacenum++)
+			for (entry = 0; entry < ENTRY_COUNT; entry++)
+			{
+				handler_data *rhandler = &cpudata[cpunum].space[spacenum].read.handlers[entry];
+				handler_data *whandler = &cpudata[cpunum].space[spacenum].write.handlers[entry];
+
+				rhandler->calls = whandler->calls = 0;
+				rhandler->ticks = whandler->ticks = 0;
+				memset(rhandler->callercount, 0, sizeof(rhandler->callercount));
+				memset(whandler->callercount, 0, sizeof(whandler->callercount));
+			}
+}
+
+
+/*-------------------------------------------------
+    memory_profile_dump - print the handler
+    statistics at exit
+-------------------------------------------------*/
+
+static void memory_profile_dump(void)
+{
+	memory_handler_stats *stats = malloc_or_die(sizeof(*stats) * MEMORY_PROFILE_MAX_HANDLERS);
+	osd_ticks_t total = 0;
+	int count, index, caller;
+
+	count = memory_profile_get_stats(stats, MEMORY_PROFILE_MAX_HANDLERS);
+	for (index = 0; index < count; index++)
+		total += stats[index].ticks;
+
+	if (count != 0)
+	{
+		mame_printf_info("\nMemory handler profile (time includes any nested handler calls):\n");
+		mame_printf_info("%-32s %-2s %12s %6s %10s  %s\n", "handler", "rw", "calls", "time", "ticks/call", "top callers");
+		for (index = 0; index < count; index++)
+		{
+			mame_printf_info("%-32s %-2s %12.0f %5.2f%% %10.1f ",
+					stats[index].name, stats[index].iswrite ? "w" : "r",
+					(double)stats[index].calls,
+					total ? (double)stats[index].ticks * 100.0 / (double)total : 0.0,
+					(double)stats[index].ticks / (double)stats[index].calls);
+			for (caller = 0; caller < MEMORY_PROFILE_CALLERS; caller++)
+				if (stats[index].caller[caller].count != 0)
+					mame_printf_info(" %d:%X", stats[index].caller[caller].cpunum, stats[index].caller[caller].pc);
+			mame_printf_info("\n");
+		}
+	}
+	free(stats);
+}
+#endif
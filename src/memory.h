@@ -36,6 +36,11 @@
 #define CPUREADOP_SAFETY_FULL		0
 #endif
 
+#ifdef MEMORY_PROFILE
+#define MEMORY_PROFILE_CALLERS		4			/* caller PCs kept for each handler */
+#define MEMORY_PROFILE_MAX_HANDLERS	1024		/* most handlers reported at exit */
+#endif
+
 
 
 /***************************************************************************
@@ -591,6 +596,28 @@ struct _address_space
 };
 typedef struct _address_space address_space;
 
+#ifdef MEMORY_PROFILE
+/* ----- a sampled caller of a memory handler ----- */
+struct _memory_handler_caller
+{
+	UINT8				cpunum;				/* CPU making the call */
+	offs_t				pc;					/* PC of the caller */
+	UINT32				count;				/* number of samples at this PC */
+};
+typedef struct _memory_handler_caller memory_handler_caller;
+
+/* ----- statistics for all the handlers sharing a name ----- */
+struct _memory_handler_stats
+{
+	const char *		name;				/* name of the handler */
+	UINT8				iswrite;			/* read (0) or write (1) handler */
+	UINT64				calls;				/* number of calls */
+	INT64				ticks;				/* total osd_profiling_ticks spent in the handler */
+	memory_handler_caller caller[MEMORY_PROFILE_CALLERS]; /* most frequent sampled callers */
+};
+typedef struct _memory_handler_stats memory_handler_stats;
+#endif
+
 
 
 /***************************************************************************
@@ -950,6 +977,12 @@ UINT64 *	_memory_install_write64_matchmask_handler(int cpunum, int spacenum, off
 void 		memory_dump(FILE *file);
 const char *memory_get_handler_string(int read0_or_write1, int cpunum, int spacenum, offs_t offset);
 
+#ifdef MEMORY_PROFILE
+/* ----- memory handler profiling ----- */
+int			memory_profile_get_stats(memory_handler_stats *stats, int maxstats);
+void		memory_profile_reset(void);
+#endif
+
 
 
 /***************************************************************************
@@ -102,10 +102,15 @@ static const options_entry core_options[] =
 	{ "snapshot_directory",          "snap",      0,                 "directory to save screenshots" },
 	{ "diff_directory",              "diff",      0,                 "directory to save hard drive image difference files" },
 	{ "comment_directory",           "comments",  0,                 "directory to save debugger comments" },
+	{ "cache_directory",             "cache",     0,                 "directory to save decrypted ROM data; empty to disable" },
 
 	{ NULL,                          NULL,        OPTION_HEADER,     "CORE FILENAME OPTIONS" },
 	{ "cheat_file",                  "cheat.dat", 0,                 "cheat filename" },
 
+	{ NULL,                          NULL,        OPTION_HEADER,     "CORE CACHE OPTIONS" },
+	{ "zip_cache_size",              "64",        0,                 "number of ZIP file directories to keep cached" },
+	{ "fd1094_cache_size",           "8",         0,                 "number of FD1094 decryption states to keep decrypted" },
+
 	{ NULL }
 };
 
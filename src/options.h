@@ -56,10 +56,15 @@
 #define OPTION_SNAPSHOT_DIRECTORY	"snapshot_directory"
 #define OPTION_DIFF_DIRECTORY		"diff_directory"
 #define OPTION_COMMENT_DIRECTORY	"comment_directory"
+#define OPTION_CACHE_DIRECTORY		"cache_directory"
 
 /* core filename options */
 #define OPTION_CHEAT_FILE			"cheat_file"
 
+/* core cache options */
+#define OPTION_ZIP_CACHE_SIZE		"zip_cache_size"
+#define OPTION_FD1094_CACHE_SIZE	"fd1094_cache_size"
+
 
 
 /***************************************************************************
@@ -160,6 +160,25 @@ mame_file_error osd_read(osd_file *file, void *buffer, UINT64 offset, UINT32 len
 mame_file_error osd_write(osd_file *file, const void *buffer, UINT64 offset, UINT32 length, UINT32 *actual);
 
 
+/*-----------------------------------------------------------------------------
+    osd_get_modified_time: return the last modification time of an open file
+
+    Parameters:
+
+        file - handle to a file previously opened via osd_open
+
+        modtime - pointer to a UINT64 to receive the modification time, in
+            whatever units are natural to the OSD; the only requirement is
+            that the value changes whenever the file is written
+
+    Return value:
+
+        a mame_file_error describing any error that occurred while querying
+        the file, or FILERR_NONE if no error occurred
+-----------------------------------------------------------------------------*/
+mame_file_error osd_get_modified_time(osd_file *file, UINT64 *modtime);
+
+
 /*-----------------------------------------------------------------------------
     osd_rmfile: deletes a file
 
@@ -101,6 +101,18 @@ mame_file_error osd_close(osd_file *file)
 }
 
 
+//============================================================
+//  osd_get_modified_time
+//============================================================
+
+mame_file_error osd_get_modified_time(osd_file *file, UINT64 *modtime)
+{
+	// there is no standard way of doing this, so we report a failure
+	*modtime = 0;
+	return FILERR_FAILURE;
+}
+
+
 //============================================================
 //  osd_get_physical_drive_geometry
 //============================================================
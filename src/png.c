@@ -15,6 +15,21 @@
 #include "driver.h"
 #include "png.h"
 
+/***************************************************************************
+    CONSTANTS
+***************************************************************************/
+
+/* images smaller than this are deflated in one piece */
+#define PARALLEL_DEFLATE_MIN	(128 * 1024)
+
+/* most blocks an image is split into for parallel deflate */
+#define MAX_DEFLATE_BLOCKS		8
+
+/* size of deflate's window; each block is primed with this much of the data before it */
+#define DEFLATE_WINDOW			32768
+
+
+
 /***************************************************************************
     TYPE DEFINITIONS
 ***************************************************************************/
@@ -39,6 +54,22 @@ struct _png_private
 };
 
 
+typedef struct _deflate_block deflate_block;
+struct _deflate_block
+{
+	const UINT8 *		dictionary;		/* data preceding the block, or NULL */
+	UINT32				dictlength;
+	const UINT8 *		data;			/* data to compress */
+	UINT32				length;
+	int					level;			/* zlib compression level */
+	int					last;			/* TRUE if this block ends the stream */
+	UINT8 *				output;			/* raw deflate data */
+	UINT32				outlength;
+	UINT32				adler;			/* Adler-32 of the block's data */
+	png_error			error;
+};
+
+
 
 /***************************************************************************
     GLOBAL VARIABLES
@@ -46,6 +77,9 @@ struct _png_private
 
 static const int samples[] = { 1, 0, 3, 1, 2, 0, 4 };
 
+/* workers for parallel deflate; without them, everything is deflated on the calling thread */
+static osd_work_queue *deflate_queue;
+
 
 
 /***************************************************************************
@@ -698,87 +732,270 @@ static png_error write_chunk(mame_file *fp, const UINT8 *data, UINT32 type, UINT
 
 
 /*-------------------------------------------------
-    write_deflated_chunk - write an in-memory
-    chunk to the given file by deflating it
+    deflate_block_callback - compress one block
+    of data to raw deflate data that ends on a
+    byte boundary, so blocks can be joined
 -------------------------------------------------*/
 
-static png_error write_deflated_chunk(mame_file *fp, UINT8 *data, UINT32 type, UINT32 length)
+static void *deflate_block_callback(void *param)
 {
-	UINT64 lengthpos = mame_ftell(fp);
-	UINT8 tempbuff[8192];
-    UINT32 zlength = 0;
-    z_stream stream;
-	UINT32 crc;
+	deflate_block *block = param;
+	z_stream stream;
+	UINT32 bound;
 	int zerr;
 
-	/* stuff the length/type into the buffer */
-	put_32bit(tempbuff + 0, length);
-	put_32bit(tempbuff + 4, type);
-	crc = crc32(0, tempbuff + 4, 4);
-
-	/* write that data */
-	if (mame_fwrite(fp, tempbuff, 8) != 8)
-		return PNGERR_FILE_ERROR;
+	block->output = NULL;
+	block->outlength = 0;
+	block->adler = adler32(adler32(0, NULL, 0), block->data, block->length);
 
-	/* initialize the stream */
+	/* initialize a raw stream, primed with the data before this block */
 	memset(&stream, 0, sizeof(stream));
-	stream.next_in = data;
-	stream.avail_in = length;
-    zerr = deflateInit(&stream, Z_DEFAULT_COMPRESSION);
-    if (zerr != Z_OK)
-    	return PNGERR_COMPRESS_ERROR;
+	if (deflateInit2(&stream, block->level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+	{
+		block->error = PNGERR_COMPRESS_ERROR;
+		return NULL;
+	}
+	if (block->dictionary != NULL)
+		deflateSetDictionary(&stream, block->dictionary, block->dictlength);
 
-	/* now loop until we run out of data */
-	for ( ; ; )
+	/* a sync flush appends an empty stored block, so leave room beyond the bound */
+	bound = deflateBound(&stream, block->length) + 16;
+	block->output = malloc(bound);
+	if (block->output == NULL)
 	{
-		/* compress this chunk */
-		stream.next_out = tempbuff;
-		stream.avail_out = sizeof(tempbuff);
-		zerr = deflate(&stream, Z_FINISH);
+		deflateEnd(&stream);
+		block->error = PNGERR_OUT_OF_MEMORY;
+		return NULL;
+	}
+
+	/* compress in one go; only the last block finishes the stream */
+	stream.next_in = (Bytef *)block->data;
+	stream.avail_in = block->length;
+	stream.next_out = block->output;
+	stream.avail_out = bound;
+	zerr = deflate(&stream, block->last ? Z_FINISH : Z_SYNC_FLUSH);
+	if (zerr != (block->last ? Z_STREAM_END : Z_OK) || stream.avail_in != 0 || stream.avail_out == 0)
+		block->error = PNGERR_COMPRESS_ERROR;
+	block->outlength = bound - stream.avail_out;
+
+	/* unfinished streams report an error here, which we don't care about */
+	deflateEnd(&stream);
+	return NULL;
+}
+
+
+/*-------------------------------------------------
+    png_exit - free the parallel deflate workers
+-------------------------------------------------*/
+
+static void png_exit(running_machine *machine)
+{
+	if (deflate_queue != NULL)
+		osd_work_queue_free(deflate_queue);
+	deflate_queue = NULL;
+}
 
-		/* if there's data to write, do it */
-		if (stream.avail_out < sizeof(tempbuff))
+
+/*-------------------------------------------------
+    png_init - create the workers that deflate
+    large images in parallel
+-------------------------------------------------*/
+
+void png_init(running_machine *machine)
+{
+	deflate_queue = osd_work_queue_alloc(WORK_QUEUE_FLAG_MULTI);
+	add_exit_callback(machine, png_exit);
+}
+
+
+/*-------------------------------------------------
+    deflate_data - compress data to a zlib
+    stream, splitting large data into blocks
+    that are compressed in parallel
+-------------------------------------------------*/
+
+static png_error deflate_data(const UINT8 *data, UINT32 length, int level, int maxblocks, UINT8 **output, UINT32 *outlength)
+{
+	deflate_block block[MAX_DEFLATE_BLOCKS];
+	osd_work_item *item[MAX_DEFLATE_BLOCKS];
+	png_error error = PNGERR_NONE;
+	int blocks, blocknum;
+	UINT32 total, adler;
+	UINT8 *dest;
+
+	/* stored data gains nothing from splitting, and small data not enough */
+	blocks = 1;
+	if (level != Z_NO_COMPRESSION && length >= PARALLEL_DEFLATE_MIN)
+		blocks = MIN(maxblocks, length / (PARALLEL_DEFLATE_MIN / 2));
+	blocks = MAX(1, MIN(blocks, MAX_DEFLATE_BLOCKS));
+
+	/* divide the data; each block sees the window before it, so the ratio barely suffers */
+	memset(block, 0, sizeof(block));
+	for (blocknum = 0; blocknum < blocks; blocknum++)
+	{
+		UINT32 start = (UINT64)length * blocknum / blocks;
+		UINT32 end = (UINT64)length * (blocknum + 1) / blocks;
+
+		block[blocknum].data = data + start;
+		block[blocknum].length = end - start;
+		if (start > 0)
 		{
-			int bytes = sizeof(tempbuff) - stream.avail_out;
-			if (mame_fwrite(fp, tempbuff, bytes) != bytes)
-			{
-				deflateEnd(&stream);
-				return PNGERR_FILE_ERROR;
-			}
-			crc = crc32(crc, tempbuff, bytes);
-			zlength += bytes;
+			block[blocknum].dictlength = MIN(start, DEFLATE_WINDOW);
+			block[blocknum].dictionary = data + start - block[blocknum].dictlength;
 		}
+		block[blocknum].level = level;
+		block[blocknum].last = (blocknum == blocks - 1);
+	}
 
-		/* stop at the end of the stream */
-		if (zerr == Z_STREAM_END)
-			break;
+	/* queue all but the first block, which we compress ourselves */
+	for (blocknum = 1; blocknum < blocks; blocknum++)
+	{
+		item[blocknum] = (deflate_queue != NULL) ? osd_work_item_queue(deflate_queue, deflate_block_callback, &block[blocknum]) : NULL;
+		if (item[blocknum] == NULL)
+			deflate_block_callback(&block[blocknum]);
+	}
+	deflate_block_callback(&block[0]);
+	for (blocknum = 1; blocknum < blocks; blocknum++)
+		if (item[blocknum] != NULL)
+		{
+			while (!osd_work_item_wait(item[blocknum], osd_ticks_per_second())) ;
+			osd_work_item_release(item[blocknum]);
+		}
 
-		/* other errors are fatal */
-		if (zerr != Z_OK)
+	/* total up the output, with room for the zlib header and trailer */
+	total = 2 + 4;
+	for (blocknum = 0; blocknum < blocks; blocknum++)
+	{
+		if (block[blocknum].error != PNGERR_NONE)
+			error = block[blocknum].error;
+		total += block[blocknum].outlength;
+	}
+
+	/* join the blocks into a single zlib stream */
+	dest = NULL;
+	if (error == PNGERR_NONE)
+	{
+		dest = malloc(total);
+		if (dest == NULL)
+			error = PNGERR_OUT_OF_MEMORY;
+	}
+	if (error == PNGERR_NONE)
+	{
+		UINT32 offset = 2;
+
+		dest[0] = 0x78;
+		dest[1] = (level == Z_NO_COMPRESSION) ? 0x01 : 0x9c;
+		adler = adler32(0, NULL, 0);
+		for (blocknum = 0; blocknum < blocks; blocknum++)
 		{
-			deflateEnd(&stream);
-			return PNGERR_COMPRESS_ERROR;
+			memcpy(dest + offset, block[blocknum].output, block[blocknum].outlength);
+			offset += block[blocknum].outlength;
+			adler = adler32_combine(adler, block[blocknum].adler, block[blocknum].length);
 		}
+		put_32bit(dest + offset, adler);
 	}
 
-	/* clean up deflater(maus) */
-	zerr = deflateEnd(&stream);
-	if (zerr != Z_OK)
-		return PNGERR_COMPRESS_ERROR;
+	/* free the pieces */
+	for (blocknum = 0; blocknum < blocks; blocknum++)
+		if (block[blocknum].output != NULL)
+			free(block[blocknum].output);
 
-	/* write the CRC */
-	put_32bit(tempbuff, crc);
-	if (mame_fwrite(fp, tempbuff, 4) != 4)
-		return PNGERR_FILE_ERROR;
+	*output = dest;
+	*outlength = (error == PNGERR_NONE) ? total : 0;
+	return error;
+}
 
-	/* seek back and update the length */
-	mame_fseek(fp, lengthpos, SEEK_SET);
-	put_32bit(tempbuff + 0, zlength);
-	if (mame_fwrite(fp, tempbuff, 4) != 4)
-		return PNGERR_FILE_ERROR;
 
-	/* return to the end */
-	mame_fseek(fp, lengthpos + 8 + zlength + 4, SEEK_SET);
+/*-------------------------------------------------
+    write_deflated_chunk - write an in-memory
+    chunk to the given file by deflating it
+-------------------------------------------------*/
+
+static png_error write_deflated_chunk(mame_file *fp, UINT8 *data, UINT32 type, UINT32 length, int level)
+{
+	UINT32 zlength;
+	png_error error;
+	UINT8 *zdata;
+
+	error = deflate_data(data, length, level, MAX_DEFLATE_BLOCKS, &zdata, &zlength);
+	if (error != PNGERR_NONE)
+		return error;
+	error = write_chunk(fp, zdata, type, zlength);
+	free(zdata);
+	return error;
+}
+
+
+/*-------------------------------------------------
+    filter_image - pick a filter for each row of
+    an unfiltered image, using the smallest sum
+    of absolute differences as the PNG spec
+    suggests
+-------------------------------------------------*/
+
+static png_error filter_image(png_info *pnginfo)
+{
+	int bpp = compute_bpp(pnginfo);
+	int rowbytes = compute_rowbytes(pnginfo);
+	int pitch = rowbytes + 1;
+	UINT8 *candidate[PNG_PF_Paeth + 1];
+	UINT8 *scratch;
+	int x, y, type;
+
+	/* allocate a scratch row for each real filter */
+	scratch = malloc(4 * rowbytes);
+	if (scratch == NULL)
+		return PNGERR_OUT_OF_MEMORY;
+	candidate[PNG_PF_None] = NULL;
+	for (type = PNG_PF_Sub; type <= PNG_PF_Paeth; type++)
+		candidate[type] = scratch + (type - PNG_PF_Sub) * rowbytes;
+
+	/* work from the bottom up, so the row above is still unfiltered */
+	for (y = pnginfo->height - 1; y >= 0; y--)
+	{
+		UINT8 *row = pnginfo->image + y * pitch + 1;
+		const UINT8 *prev = (y > 0) ? row - pitch : NULL;
+		UINT32 sum[PNG_PF_Paeth + 1];
+		int best;
+
+		/* compute every filter in a single pass over the row */
+		memset(sum, 0, sizeof(sum));
+		for (x = 0; x < rowbytes; x++)
+		{
+			INT32 cur = row[x];
+			INT32 a = (x < bpp) ? 0 : row[x - bpp];
+			INT32 b = (prev == NULL) ? 0 : prev[x];
+			INT32 c = (x < bpp || prev == NULL) ? 0 : prev[x - bpp];
+			INT32 prediction = a + b - c;
+			INT32 da = abs(prediction - a);
+			INT32 db = abs(prediction - b);
+			INT32 dc = abs(prediction - c);
+			INT32 paeth = (da <= db && da <= dc) ? a : (db <= dc) ? b : c;
+
+			candidate[PNG_PF_Sub][x] = cur - a;
+			candidate[PNG_PF_Up][x] = cur - b;
+			candidate[PNG_PF_Average][x] = cur - (a + b) / 2;
+			candidate[PNG_PF_Paeth][x] = cur - paeth;
+
+			/* deflate does best on bytes near zero */
+			sum[PNG_PF_None] += abs((INT8)cur);
+			sum[PNG_PF_Sub] += abs((INT8)candidate[PNG_PF_Sub][x]);
+			sum[PNG_PF_Up] += abs((INT8)candidate[PNG_PF_Up][x]);
+			sum[PNG_PF_Average] += abs((INT8)candidate[PNG_PF_Average][x]);
+			sum[PNG_PF_Paeth] += abs((INT8)candidate[PNG_PF_Paeth][x]);
+		}
+
+		/* keep the winner */
+		best = PNG_PF_None;
+		for (type = PNG_PF_Sub; type <= PNG_PF_Paeth; type++)
+			if (sum[type] < sum[best])
+				best = type;
+		row[-1] = best;
+		if (best != PNG_PF_None)
+			memcpy(row, candidate[best], rowbytes);
+	}
+
+	free(scratch);
 	return PNGERR_NONE;
 }
 
@@ -922,7 +1139,7 @@ static png_error convert_bitmap_to_image_rgb(png_info *pnginfo, const mame_bitma
     chunks to the given file
 -------------------------------------------------*/
 
-static png_error write_png_stream(void *fp, png_info *pnginfo, const mame_bitmap *bitmap, int palette_length, const rgb_t *palette)
+static png_error write_png_stream(void *fp, png_info *pnginfo, const mame_bitmap *bitmap, int palette_length, const rgb_t *palette, int level)
 {
 	UINT8 tempbuff[16];
 	png_text *text;
@@ -938,7 +1155,13 @@ static png_error write_png_stream(void *fp, png_info *pnginfo, const mame_bitmap
 	if (error != PNGERR_NONE)
 		goto handle_error;
 
-	/* if we wanted to get clever and do filtering, we would do it here */
+	/* filter truecolor images, unless we're only storing them */
+	if (pnginfo->color_type == 2 && level != Z_NO_COMPRESSION)
+	{
+		error = filter_image(pnginfo);
+		if (error != PNGERR_NONE)
+			goto handle_error;
+	}
 
 	/* write the IHDR chunk */
 	put_32bit(tempbuff + 0, pnginfo->width);
@@ -959,7 +1182,7 @@ static png_error write_png_stream(void *fp, png_info *pnginfo, const mame_bitmap
 		goto handle_error;
 
 	/* write a single IDAT chunk */
-	error = write_deflated_chunk(fp, pnginfo->image, PNG_CN_IDAT, pnginfo->height * (compute_rowbytes(pnginfo) + 1));
+	error = write_deflated_chunk(fp, pnginfo->image, PNG_CN_IDAT, pnginfo->height * (compute_rowbytes(pnginfo) + 1), level);
 	if (error != PNGERR_NONE)
 		goto handle_error;
 
@@ -980,7 +1203,12 @@ handle_error:
 
 
 
-png_error png_write_bitmap(mame_file *fp, mame_bitmap *bitmap)
+/*-------------------------------------------------
+    write_bitmap - write a bitmap to a PNG file
+    at the given compression level
+-------------------------------------------------*/
+
+static png_error write_bitmap(mame_file *fp, mame_bitmap *bitmap, int level)
 {
 	png_info pnginfo;
 	char text[1024];
@@ -1003,11 +1231,34 @@ png_error png_write_bitmap(mame_file *fp, mame_bitmap *bitmap)
 	}
 
 	/* write the rest of the PNG data */
-	error = write_png_stream(fp, &pnginfo, bitmap, Machine->drv->total_colors, palette_get_adjusted_colors(Machine));
+	error = write_png_stream(fp, &pnginfo, bitmap, Machine->drv->total_colors, palette_get_adjusted_colors(Machine), level);
 	png_free(&pnginfo);
 	return error;
 }
 
+
+/*-------------------------------------------------
+    png_write_bitmap - write a bitmap to a
+    compressed PNG file
+-------------------------------------------------*/
+
+png_error png_write_bitmap(mame_file *fp, mame_bitmap *bitmap)
+{
+	return write_bitmap(fp, bitmap, Z_DEFAULT_COMPRESSION);
+}
+
+
+/*-------------------------------------------------
+    png_write_bitmap_uncompressed - write a bitmap
+    to a PNG file without compressing it, which is
+    much faster for images that won't be kept
+-------------------------------------------------*/
+
+png_error png_write_bitmap_uncompressed(mame_file *fp, mame_bitmap *bitmap)
+{
+	return write_bitmap(fp, bitmap, Z_NO_COMPRESSION);
+}
+
 /********************************************************************************
 
   MNG write functions
@@ -1040,7 +1291,7 @@ png_error mng_capture_start(mame_file *fp, mame_bitmap *bitmap)
 	put_32bit(mhdr + 0, bitmap->width);
 	put_32bit(mhdr + 4, bitmap->height);
 	put_32bit(mhdr + 8, Machine->screen[0].refresh);
-	put_32bit(mhdr + 24, 0x0041); /* Simplicity profile */
+	put_32bit(mhdr + 24, 0x0043); /* Simplicity profile; DEFI may be used for delta frames */
 	/* frame count and play time unspecified because
        we don't know at this stage */
 	error = write_chunk(fp, mhdr, MNG_CN_MHDR, 28);
@@ -1053,7 +1304,7 @@ png_error mng_capture_start(mame_file *fp, mame_bitmap *bitmap)
 png_error mng_capture_frame(mame_file *fp, mame_bitmap *bitmap)
 {
         int retcode;
-        retcode=write_png_stream(fp, &mnginfo, bitmap, Machine->drv->total_colors, palette_get_adjusted_colors(Machine));
+        retcode=write_png_stream(fp, &mnginfo, bitmap, Machine->drv->total_colors, palette_get_adjusted_colors(Machine), Z_DEFAULT_COMPRESSION);
         png_free(&mnginfo);
         return retcode;
 }
@@ -1063,3 +1314,177 @@ png_error mng_capture_stop(mame_file *fp)
 	return write_chunk(fp, NULL, MNG_CN_MEND, 0);
 }
 
+
+
+/*-------------------------------------------------
+    append_to_frame - append data to an
+    in-memory MNG frame, growing it as needed;
+    a NULL data pointer just reserves the space
+-------------------------------------------------*/
+
+static png_error append_to_frame(mng_frame *frame, const void *data, UINT32 length)
+{
+	/* expand the buffer if we need to */
+	if (frame->length + length > frame->allocated)
+	{
+		UINT32 newsize = (frame->length + length) * 2;
+		UINT8 *newdata = realloc(frame->data, newsize);
+		if (newdata == NULL)
+			return PNGERR_OUT_OF_MEMORY;
+		frame->data = newdata;
+		frame->allocated = newsize;
+	}
+
+	/* append the data */
+	if (data != NULL)
+		memcpy(frame->data + frame->length, data, length);
+	frame->length += length;
+	return PNGERR_NONE;
+}
+
+
+/*-------------------------------------------------
+    append_chunk - append a chunk to an
+    in-memory MNG frame
+-------------------------------------------------*/
+
+static png_error append_chunk(mng_frame *frame, const UINT8 *data, UINT32 type, UINT32 length)
+{
+	UINT32 chunkpos = frame->length;
+	UINT8 *chunk;
+	png_error error;
+
+	/* make room for the length, type, data and CRC */
+	error = append_to_frame(frame, NULL, 8 + length + 4);
+	if (error != PNGERR_NONE)
+		return error;
+	chunk = frame->data + chunkpos;
+
+	/* fill them in */
+	put_32bit(chunk + 0, length);
+	put_32bit(chunk + 4, type);
+	if (length > 0)
+		memcpy(chunk + 8, data, length);
+	put_32bit(chunk + 8 + length, crc32(0, chunk + 4, 4 + length));
+	return PNGERR_NONE;
+}
+
+
+/*-------------------------------------------------
+    mng_compress_frame - compress rows y through
+    y + height - 1 of a bitmap into a complete
+    MNG frame in memory; delta frames are placed
+    over the previous frame with a DEFI chunk, so
+    that only the changed rows need be stored
+-------------------------------------------------*/
+
+png_error mng_compress_frame(mng_frame *frame, mame_bitmap *bitmap, int y, int height, int delta)
+{
+	UINT8 tempbuff[16];
+	mame_bitmap rows;
+	png_info pnginfo;
+	png_text *text;
+	png_error error;
+	UINT32 zlength;
+	UINT8 *zdata;
+
+	/* only direct RGB bitmaps can be compressed away from the palette */
+	if (bitmap->format != BITMAP_FORMAT_RGB15 && bitmap->format != BITMAP_FORMAT_RGB32)
+		fatalerror("mng_compress_frame: Unsupported bitmap format");
+
+	/* reset the frame and the PNG info */
+	frame->length = 0;
+	memset(&pnginfo, 0, sizeof(pnginfo));
+
+	/* position delta frames; the first frame carries the text instead */
+	if (delta)
+	{
+		memset(tempbuff, 0, 12);
+		put_32bit(tempbuff + 8, y);
+		error = append_chunk(frame, tempbuff, MNG_CN_DEFI, 12);
+		if (error != PNGERR_NONE)
+			return error;
+	}
+	else
+	{
+		char textbuf[1024];
+
+		sprintf(textbuf, APPNAME " %s", build_version);
+		add_text(&pnginfo, "Software", textbuf);
+		sprintf(textbuf, "%s %s", Machine->gamedrv->manufacturer, Machine->gamedrv->description);
+		add_text(&pnginfo, "System", textbuf);
+	}
+
+	/* create an unfiltered image of just the requested rows */
+	rows = *bitmap;
+	rows.base = (UINT8 *)bitmap->base + y * bitmap->rowpixels * (bitmap->bpp / 8);
+	rows.height = height;
+	error = convert_bitmap_to_image_rgb(&pnginfo, &rows, 0, NULL);
+	if (error != PNGERR_NONE)
+		goto handle_error;
+	error = filter_image(&pnginfo);
+	if (error != PNGERR_NONE)
+		goto handle_error;
+
+	/* append the IHDR chunk */
+	put_32bit(tempbuff + 0, pnginfo.width);
+	put_32bit(tempbuff + 4, pnginfo.height);
+	put_8bit(tempbuff + 8, pnginfo.bit_depth);
+	put_8bit(tempbuff + 9, pnginfo.color_type);
+	put_8bit(tempbuff + 10, pnginfo.compression_method);
+	put_8bit(tempbuff + 11, pnginfo.filter_method);
+	put_8bit(tempbuff + 12, pnginfo.interlace_method);
+	error = append_chunk(frame, tempbuff, PNG_CN_IHDR, 13);
+	if (error != PNGERR_NONE)
+		goto handle_error;
+
+	/* append a single IDAT chunk; frames are already compressed in parallel with each other */
+	error = deflate_data(pnginfo.image, pnginfo.height * (compute_rowbytes(&pnginfo) + 1), Z_DEFAULT_COMPRESSION, 1, &zdata, &zlength);
+	if (error != PNGERR_NONE)
+		goto handle_error;
+	error = append_chunk(frame, zdata, PNG_CN_IDAT, zlength);
+	free(zdata);
+	if (error != PNGERR_NONE)
+		goto handle_error;
+
+	/* append TEXT chunks */
+	for (text = pnginfo.textlist; text != NULL; text = text->next)
+	{
+		error = append_chunk(frame, (UINT8 *)text->keyword, PNG_CN_tEXt, (UINT32)strlen(text->keyword) + 1 + (UINT32)strlen(text->text));
+		if (error != PNGERR_NONE)
+			goto handle_error;
+	}
+
+	/* append an IEND chunk */
+	error = append_chunk(frame, NULL, PNG_CN_IEND, 0);
+
+handle_error:
+	png_free(&pnginfo);
+	return error;
+}
+
+
+/*-------------------------------------------------
+    mng_write_frame - write a frame compressed by
+    mng_compress_frame to the given file
+-------------------------------------------------*/
+
+png_error mng_write_frame(mame_file *fp, const mng_frame *frame)
+{
+	if (mame_fwrite(fp, frame->data, frame->length) != frame->length)
+		return PNGERR_FILE_ERROR;
+	return PNGERR_NONE;
+}
+
+
+/*-------------------------------------------------
+    mng_free_frame - free the memory held by an
+    in-memory MNG frame
+-------------------------------------------------*/
+
+void mng_free_frame(mng_frame *frame)
+{
+	if (frame->data != NULL)
+		free(frame->data);
+	memset(frame, 0, sizeof(*frame));
+}
@@ -48,6 +48,7 @@
 #define MNG_CN_MEND			0x4D454E44L
 #define MNG_CN_TERM			0x5445524DL
 #define MNG_CN_BACK			0x4241434BL
+#define MNG_CN_DEFI			0x44454649L
 
 /* Prediction filters */
 #define PNG_PF_None			0
@@ -113,11 +114,22 @@ struct _png_info
 };
 
 
+/* an MNG frame compressed into memory, ready to be written */
+typedef struct _mng_frame mng_frame;
+struct _mng_frame
+{
+	UINT8 *			data;			/* complete chunks for the frame */
+	UINT32			length;			/* number of bytes used */
+	UINT32			allocated;		/* number of bytes allocated */
+};
+
+
 
 /***************************************************************************
     FUNCTION PROTOTYPES
 ***************************************************************************/
 
+void png_init(running_machine *machine);
 void png_free(png_info *pnginfo);
 
 png_error png_read_file(mame_file *fp, png_info *pnginfo);
@@ -125,9 +137,14 @@ png_error png_expand_buffer_8bit(png_info *p);
 
 png_error png_add_text(const char *keyword, const char *text);
 png_error png_write_bitmap(mame_file *fp, mame_bitmap *bitmap);
+png_error png_write_bitmap_uncompressed(mame_file *fp, mame_bitmap *bitmap);
 
 png_error mng_capture_start(mame_file *fp, mame_bitmap *bitmap);
 png_error mng_capture_frame(mame_file *fp, mame_bitmap *bitmap);
 png_error mng_capture_stop(mame_file *fp);
 
+png_error mng_compress_frame(mng_frame *frame, mame_bitmap *bitmap, int y, int height, int delta);
+png_error mng_write_frame(mame_file *fp, const mng_frame *frame);
+void mng_free_frame(mng_frame *frame);
+
 #endif	/* __PNG_H__ */
@@ -36,6 +36,7 @@ struct _profile_data
 {
 	UINT64 count[MEMORY][PROFILER_TOTAL];
 	unsigned int cpu_context_switches[MEMORY];
+	unsigned int partial_updates[MEMORY];
 };
 typedef struct _profile_data profile_data;
 
@@ -109,6 +110,12 @@ logerror("Profiler error: FILO buffer underflow\n");
 	}
 }
 
+void profiler_partial_update(void)
+{
+	if (use_profiler)
+		profile.partial_updates[memory]++;
+}
+
 const char *profiler_get_text(void)
 {
 	int i,j;
@@ -203,9 +210,15 @@ const char *profiler_get_text(void)
 		i += profile.cpu_context_switches[j];
 	bufptr += sprintf(bufptr,"CPU switches%4d\n",i / MEMORY);
 
+	i = 0;
+	for (j = 0;j < MEMORY;j++)
+		i += profile.partial_updates[j];
+	bufptr += sprintf(bufptr,"Partial upd %4d\n",i / MEMORY);
+
 	/* reset the counters */
 	memory = (memory + 1) % MEMORY;
 	profile.cpu_context_switches[memory] = 0;
+	profile.partial_updates[memory] = 0;
 	for (i = 0;i < PROFILER_TOTAL;i++)
 		profile.count[memory][i] = 0;
 
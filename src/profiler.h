@@ -74,8 +74,12 @@ void profiler_mark(int type);
 void profiler_start(void);
 void profiler_stop(void);
 const char *profiler_get_text(void);
+
+/* called by video.c for each partial update drawn */
+void profiler_partial_update(void);
 #else
 #define profiler_mark(type)
+#define profiler_partial_update()
 
 #define profiler_start()
 #define profiler_stop()
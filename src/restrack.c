@@ -10,6 +10,7 @@
 ***************************************************************************/
 
 #include "restrack.h"
+#include "osdcore.h"
 
 
 
@@ -41,6 +42,7 @@ struct _malloc_entry
 static malloc_entry *malloc_list = NULL;
 static int malloc_list_index = 0;
 static int malloc_list_size = 0;
+static osd_lock *malloc_list_lock = NULL;
 
 /* resource tracking */
 int resource_tracking_tag = 0;
@@ -127,6 +129,10 @@ static void free_callback_list(callback_item **cb)
 
 INLINE void auto_malloc_add(void *result, size_t size)
 {
+	/* the validity checks allocate from several threads at once */
+	if (malloc_list_lock != NULL)
+		osd_lock_acquire(malloc_list_lock);
+
 	/* make sure we have tracking space */
 	if (malloc_list_index == malloc_list_size)
 	{
@@ -147,6 +153,9 @@ INLINE void auto_malloc_add(void *result, size_t size)
 	malloc_list[malloc_list_index].memory = result;
 	malloc_list[malloc_list_index].size = size;
 	malloc_list_index++;
+
+	if (malloc_list_lock != NULL)
+		osd_lock_release(malloc_list_lock);
 }
 
 
@@ -179,6 +188,8 @@ void init_resource_tracking(void)
 {
 	resource_tracking_tag = 0;
 	add_free_resources_callback(auto_malloc_free);
+	if (malloc_list_lock == NULL)
+		malloc_list_lock = osd_lock_alloc();
 }
 
 
@@ -193,6 +204,9 @@ void exit_resource_tracking(void)
 	while (resource_tracking_tag != 0)
 		end_resource_tracking();
 	free_callback_list(&free_resources_callback_list);
+	if (malloc_list_lock != NULL)
+		osd_lock_free(malloc_list_lock);
+	malloc_list_lock = NULL;
 }
 
 
@@ -720,6 +720,10 @@ void sound_frame_update(void)
 	if (wavfile && !mame_is_paused(Machine))
 		wav_add_data_16(wavfile, finalmix, samples_this_frame * 2);
 
+	/* raw movies carry the sound alongside the video */
+	if (!mame_is_paused(Machine))
+		video_movie_add_sound(finalmix, samples_this_frame);
+
 	/* play the result */
 	samples_this_frame = osd_update_audio_stream(finalmix);
 
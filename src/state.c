@@ -80,6 +80,19 @@ struct _ss_entry
 };
 
 
+/* a run of registered data copied with a single memcpy; entries of the same */
+/* type that are adjacent both in memory and in the file are merged together */
+typedef struct _ss_run ss_run;
+struct _ss_run
+{
+	UINT8 *			data;				/* pointer to the memory to save/restore */
+	UINT32			offset;				/* offset within the final structure */
+	UINT32			size;				/* size in bytes */
+	UINT8			typesize;			/* size of the raw data type */
+	int				tag;				/* saving tag */
+};
+
+
 typedef struct _ss_func ss_func;
 struct _ss_func
 {
@@ -120,6 +133,18 @@ static UINT8 *ss_dump_array;
 static mame_file *ss_dump_file;
 static UINT32 ss_dump_size;
 
+/* the dump buffer is kept between saves and loads */
+static UINT8 *ss_dump_buffer;
+static UINT32 ss_dump_buffer_size;
+
+/* the layout is computed once after the registrations change */
+static ss_run *ss_layout;
+static int ss_layout_count;
+static int ss_layout_alloc;
+static UINT32 ss_layout_size;
+static UINT32 ss_layout_signature;
+static UINT8 ss_layout_valid;
+
 #ifdef MESS
 static const char ss_magic_num[8] = { 'M', 'E', 'S', 'S', 'S', 'A', 'V', 'E' };
 #else
@@ -136,6 +161,8 @@ static void ss_c2(UINT8 *, UINT32);
 static void ss_c4(UINT8 *, UINT32);
 static void ss_c8(UINT8 *, UINT32);
 
+static UINT32 get_signature(void);
+
 static void (*ss_conv[])(UINT8 *, UINT32) = { 0, 0, ss_c2, 0, ss_c4, 0, 0, 0, ss_c8 };
 
 
@@ -155,6 +182,7 @@ void state_init(running_machine *machine)
 	ss_current_tag = 0;
 	ss_tag_stack_index = 0;
 	ss_registration_allowed = FALSE;
+	ss_layout_valid = FALSE;
 }
 
 
@@ -214,6 +242,18 @@ int state_save_get_reg_count(void)
     REGISTRATION HANDLING
 ***************************************************************************/
 
+/*-------------------------------------------------
+    state_save_get_illegal_count - return the
+    number of registrations made too late, which
+    make saving impossible
+-------------------------------------------------*/
+
+int state_save_get_illegal_count(void)
+{
+	return ss_illegal_regs;
+}
+
+
 /*-------------------------------------------------
     state_save_allow_registration - allow/disallow
     registrations to happen
@@ -290,6 +330,7 @@ void state_save_register_memory(const char *module, UINT32 instance, const char
 	(*entry)->typecount = valcount;
 	(*entry)->tag       = ss_current_tag;
 	(*entry)->restag    = get_resource_tag();
+	ss_layout_valid = FALSE;
 }
 
 
@@ -509,10 +550,21 @@ void state_save_free(void)
 	/* now do the same with the function lists */
 	func_free(&ss_prefunc_reg);
 	func_free(&ss_postfunc_reg);
+	ss_layout_valid = FALSE;
 
-	/* if we're clear of all registrations, reset the invalid counter */
+	/* if we're clear of all registrations, reset the invalid counter and free the buffers */
 	if (ss_registry == NULL && ss_prefunc_reg == NULL && ss_postfunc_reg == NULL)
+	{
 		ss_illegal_regs = 0;
+		if (ss_layout != NULL)
+			free(ss_layout);
+		ss_layout = NULL;
+		ss_layout_count = ss_layout_alloc = 0;
+		if (ss_dump_buffer != NULL)
+			free(ss_dump_buffer);
+		ss_dump_buffer = NULL;
+		ss_dump_buffer_size = 0;
+	}
 }
 
 
@@ -569,28 +621,80 @@ static void ss_c8(UINT8 *data, UINT32 size)
 ***************************************************************************/
 
 /*-------------------------------------------------
-    compute_size_and_offsets - compute the total
-    size and offsets of each individual item
+    compute_layout - compute the offsets of each
+    individual item, the total size, the runs
+    to copy and the signature, if the
+    registrations have changed since last time
 -------------------------------------------------*/
 
-static int compute_size_and_offsets(void)
+static void compute_layout(void)
 {
 	ss_entry *entry;
-	int total_size;
+	UINT32 total_size;
+
+	if (ss_layout_valid)
+		return;
 
 	/* start with the header size */
 	total_size = 0x18;
+	ss_layout_count = 0;
 
 	/* iterate over entries */
 	for (entry = ss_registry; entry; entry = entry->next)
 	{
+		UINT32 size = entry->typesize * entry->typecount;
+		ss_run *run = (ss_layout_count > 0) ? &ss_layout[ss_layout_count - 1] : NULL;
+
 		/* note the offset and accumulate a total size */
 		entry->offset = total_size;
-		total_size += entry->typesize * entry->typecount;
+		total_size += size;
+
+		/* extend the previous run if this entry follows straight on from it */
+		if (run != NULL && run->tag == entry->tag && run->typesize == entry->typesize &&
+			run->data + run->size == (UINT8 *)entry->data && run->offset + run->size == entry->offset)
+		{
+			run->size += size;
+			continue;
+		}
+
+		/* otherwise, start a new one */
+		if (ss_layout_count == ss_layout_alloc)
+		{
+			ss_layout_alloc += 256;
+			ss_layout = realloc(ss_layout, ss_layout_alloc * sizeof(ss_layout[0]));
+			if (ss_layout == NULL)
+				fatalerror("Out of memory allocating the save state layout");
+		}
+		run = &ss_layout[ss_layout_count++];
+		run->data = entry->data;
+		run->offset = entry->offset;
+		run->size = size;
+		run->typesize = entry->typesize;
+		run->tag = entry->tag;
 	}
 
-	/* return the total size */
-	return total_size;
+	ss_layout_size = total_size;
+	ss_layout_signature = get_signature();
+	ss_layout_valid = TRUE;
+	TRACE(logerror("State layout: %d runs, %u bytes\n", ss_layout_count, ss_layout_size));
+}
+
+
+/*-------------------------------------------------
+    get_dump_buffer - return a buffer of at least
+    the given size for saving or loading
+-------------------------------------------------*/
+
+static UINT8 *get_dump_buffer(UINT32 size)
+{
+	if (size > ss_dump_buffer_size)
+	{
+		if (ss_dump_buffer != NULL)
+			free(ss_dump_buffer);
+		ss_dump_buffer = malloc(size);
+		ss_dump_buffer_size = (ss_dump_buffer != NULL) ? size : 0;
+	}
+	return ss_dump_buffer;
 }
 
 
@@ -752,13 +856,14 @@ int state_save_save_begin(mame_file *file)
 	ss_dump_file = file;
 
 	/* compute the total dump size and the offsets of each element */
-	ss_dump_size = compute_size_and_offsets();
+	compute_layout();
+	ss_dump_size = ss_layout_size;
 	TRACE(logerror("   total size %u\n", ss_dump_size));
 
-	/* allocate memory for the array */
-	ss_dump_array = malloc(ss_dump_size);
+	/* get memory for the array */
+	ss_dump_array = get_dump_buffer(ss_dump_size);
 	if (!ss_dump_array)
-		logerror("malloc failed in state_save_save_begin\n");
+		fatalerror("Out of memory saving state");
 	return 0;
 }
 
@@ -770,7 +875,7 @@ int state_save_save_begin(mame_file *file)
 
 void state_save_save_continue(void)
 {
-	ss_entry *entry;
+	int runnum;
 	int count;
 
 	TRACE(logerror("Saving tag %d\n", ss_current_tag));
@@ -783,13 +888,13 @@ void state_save_save_continue(void)
 	/* then copy in all the data */
 	TRACE(logerror("  copying data\n"));
 
-	/* iterate over entries with matching tags */
-	for (entry = ss_registry; entry; entry = entry->next)
-		if (entry->tag == ss_current_tag)
-		{
-			memcpy(ss_dump_array + entry->offset, entry->data, entry->typesize * entry->typecount);
-			TRACE(logerror("    %s: %x..%x\n", entry->name, entry->offset, entry->offset + entry->typesize * entry->typecount - 1));
-		}
+	/* gather the runs with matching tags */
+	for (runnum = 0; runnum < ss_layout_count; runnum++)
+	{
+		const ss_run *run = &ss_layout[runnum];
+		if (run->tag == ss_current_tag)
+			memcpy(ss_dump_array + run->offset, run->data, run->size);
+	}
 }
 
 
@@ -818,14 +923,13 @@ void state_save_save_finish(void)
 	strcpy((char *)ss_dump_array+0xa, Machine->gamedrv->name);
 
 	/* copy in the signature */
-	signature = get_signature();
+	signature = ss_layout_signature;
 	*(UINT32 *)&ss_dump_array[0x14] = LITTLE_ENDIANIZE_INT32(signature);
 
 	/* write the file */
 	mame_fwrite(ss_dump_file, ss_dump_array, ss_dump_size);
 
-	/* free memory and reset the global states */
-	free(ss_dump_array);
+	/* reset the global states; the buffer is kept for next time */
 	ss_dump_array = NULL;
 	ss_dump_size = 0;
 	ss_dump_file = NULL;
@@ -843,25 +947,51 @@ void state_save_save_finish(void)
 -------------------------------------------------*/
 
 int state_save_load_begin(mame_file *file)
+{
+	return state_save_load_begin_length(file, mame_fsize(file) - mame_ftell(file));
+}
+
+
+/*-------------------------------------------------
+    state_save_load_begin_length - begin loading
+    a state of the given length from the current
+    position of a file that may hold other data
+-------------------------------------------------*/
+
+int state_save_load_begin_length(mame_file *file, UINT32 length)
 {
 	TRACE(logerror("Beginning load\n"));
 
-	/* read the file into memory */
-	ss_dump_size = mame_fsize(file);
-	ss_dump_array = malloc(ss_dump_size);
+	/* compute the total size and offset of all the entries */
+	compute_layout();
+
+	/* read the state into memory */
+	ss_dump_size = length;
+	ss_dump_array = get_dump_buffer(ss_dump_size);
 	ss_dump_file = file;
-	mame_fread(ss_dump_file, ss_dump_array, ss_dump_size);
+	if (ss_dump_array == NULL || ss_dump_size < 0x18 || mame_fread(ss_dump_file, ss_dump_array, ss_dump_size) != ss_dump_size)
+	{
+		popmessage("Error: Could not read saved state");
+		goto error;
+	}
 
 	/* verify the header and report an error if it doesn't match */
-	if (validate_header(ss_dump_array, NULL, get_signature(), popmessage, "Error: "))
+	if (validate_header(ss_dump_array, NULL, ss_layout_signature, popmessage, "Error: "))
+		goto error;
+
+	/* a short state would read past the end */
+	if (ss_layout_size > ss_dump_size)
 	{
-		free(ss_dump_array);
-		return 1;
+		popmessage("Error: Saved state is truncated");
+		goto error;
 	}
-
-	/* compute the total size and offset of all the entries */
-	compute_size_and_offsets();
 	return 0;
+
+error:
+	ss_dump_array = NULL;
+	ss_dump_size = 0;
+	ss_dump_file = NULL;
+	return 1;
 }
 
 
@@ -872,8 +1002,8 @@ int state_save_load_begin(mame_file *file)
 
 void state_save_load_continue(void)
 {
-	ss_entry *entry;
 	int need_convert;
+	int runnum;
 	int count;
 
 	/* first determine whether or not we need to convert the endianness of the data */
@@ -886,15 +1016,17 @@ void state_save_load_continue(void)
 	TRACE(logerror("Loading tag %d\n", ss_current_tag));
 	TRACE(logerror("  copying data\n"));
 
-	/* iterate over entries with matching tags */
-	for (entry = ss_registry; entry; entry = entry->next)
-		if (entry->tag == ss_current_tag)
+	/* scatter the runs with matching tags; only a file from the other endianness needs conversion */
+	for (runnum = 0; runnum < ss_layout_count; runnum++)
+	{
+		const ss_run *run = &ss_layout[runnum];
+		if (run->tag == ss_current_tag)
 		{
-			memcpy(entry->data, ss_dump_array + entry->offset, entry->typesize * entry->typecount);
-			if (need_convert && ss_conv[entry->typesize])
-				(*ss_conv[entry->typesize])(entry->data, entry->typecount);
-			TRACE(logerror("    %s: %x..%x\n", entry->name, entry->offset, entry->offset + entry->typesize * entry->typecount - 1));
+			memcpy(run->data, ss_dump_array + run->offset, run->size);
+			if (need_convert && ss_conv[run->typesize])
+				(*ss_conv[run->typesize])(run->data, run->size / run->typesize);
 		}
+	}
 
 	/* call the post-load functions */
 	TRACE(logerror("  calling post-load functions\n"));
@@ -912,8 +1044,7 @@ void state_save_load_finish(void)
 {
 	TRACE(logerror("Finishing load\n"));
 
-	/* free memory and reset the global states */
-	free(ss_dump_array);
+	/* reset the global states; the buffer is kept for next time */
 	ss_dump_array = NULL;
 	ss_dump_size = 0;
 	ss_dump_file = NULL;
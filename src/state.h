@@ -96,8 +96,10 @@ void state_save_register_func_postload_ptr(void (*func)(void *), void *param);
 
 /* Save and load functions */
 /* The tags are a hack around the current cpu structures */
+int  state_save_get_illegal_count(void);
 int  state_save_save_begin(mame_file *file);
 int  state_save_load_begin(mame_file *file);
+int  state_save_load_begin_length(mame_file *file, UINT32 length);
 
 void state_save_push_tag(int tag);
 void state_save_pop_tag(void);
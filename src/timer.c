@@ -63,6 +63,23 @@ struct _mame_timer
 };
 
 
+/* in mame.h: typedef struct _timer_private timer_private; */
+struct _timer_private
+{
+	/* list of active timers */
+	mame_timer		timers[MAX_TIMERS];
+	mame_timer *	timer_head;
+	mame_timer *	timer_free_head;
+	mame_timer *	timer_free_tail;
+
+	/* other internal states */
+	mame_time		basetime;
+	mame_timer *	callback_timer;
+	int				callback_timer_modified;
+	mame_time		callback_timer_expire_time;
+};
+
+
 
 /***************************************************************************
     GLOBAL VARIABLES
@@ -74,17 +91,6 @@ UINT32 cycles_per_second[MAX_CPU];
 double cycles_to_sec[MAX_CPU];
 double sec_to_cycles[MAX_CPU];
 
-/* list of active timers */
-static mame_timer timers[MAX_TIMERS];
-static mame_timer *timer_head;
-static mame_timer *timer_free_head;
-static mame_timer *timer_free_tail;
-
-/* other internal states */
-static mame_time global_basetime;
-static mame_timer *callback_timer;
-static int callback_timer_modified;
-static mame_time callback_timer_expire_time;
 
 /* other constant times */
 mame_time time_zero;
@@ -112,11 +118,12 @@ static void mame_timer_remove(mame_timer *which);
 
 INLINE mame_time get_current_time(void)
 {
+	timer_private *global = Machine->timer_data;
 	int activecpu;
 
 	/* if we're currently in a callback, use the timer's expiration time as a base */
-	if (callback_timer != NULL)
-		return callback_timer_expire_time;
+	if (global->callback_timer != NULL)
+		return global->callback_timer_expire_time;
 
 	/* if we're executing as a particular CPU, use its local time as a base */
 	activecpu = cpu_getactivecpu();
@@ -124,7 +131,7 @@ INLINE mame_time get_current_time(void)
 		return cpunum_get_localtime(activecpu);
 
 	/* otherwise, return the current global base time */
-	return global_basetime;
+	return global->basetime;
 }
 
 
@@ -134,19 +141,20 @@ INLINE mame_time get_current_time(void)
 
 INLINE mame_timer *timer_new(void)
 {
+	timer_private *global = Machine->timer_data;
 	mame_timer *timer;
 
 	/* remove an empty entry */
-	if (!timer_free_head)
+	if (!global->timer_free_head)
 	{
 		timer_logtimers();
 		fatalerror("Out of timers!");
 		return NULL;
 	}
-	timer = timer_free_head;
-	timer_free_head = timer->next;
-	if (!timer_free_head)
-		timer_free_tail = NULL;
+	timer = global->timer_free_head;
+	global->timer_free_head = timer->next;
+	if (!global->timer_free_head)
+		global->timer_free_tail = NULL;
 
 	return timer;
 }
@@ -159,6 +167,7 @@ INLINE mame_timer *timer_new(void)
 
 INLINE void timer_list_insert(mame_timer *timer)
 {
+	timer_private *global = Machine->timer_data;
 	mame_time expire = timer->enabled ? timer->expire : time_never;
 	mame_timer *t, *lt = NULL;
 
@@ -168,7 +177,7 @@ INLINE void timer_list_insert(mame_timer *timer)
 		int tnum = 0;
 
 		/* loop over the timer list */
-		for (t = timer_head; t; t = t->next, tnum++)
+		for (t = global->timer_head; t; t = t->next, tnum++)
 		{
 			if (t == timer)
 				fatalerror("This timer is already inserted in the list!");
@@ -179,7 +188,7 @@ INLINE void timer_list_insert(mame_timer *timer)
 	#endif
 
 	/* loop over the timer list */
-	for (t = timer_head; t; lt = t, t = t->next)
+	for (t = global->timer_head; t; lt = t, t = t->next)
 	{
 		/* if the current list entry expires after us, we should be inserted before it */
 		if (compare_mame_times(t->expire, expire) > 0)
@@ -191,7 +200,7 @@ INLINE void timer_list_insert(mame_timer *timer)
 			if (t->prev)
 				t->prev->next = timer;
 			else
-				timer_head = timer;
+				global->timer_head = timer;
 			t->prev = timer;
 			return;
 		}
@@ -201,7 +210,7 @@ INLINE void timer_list_insert(mame_timer *timer)
 	if (lt)
 		lt->next = timer;
 	else
-		timer_head = timer;
+		global->timer_head = timer;
 	timer->prev = lt;
 	timer->next = NULL;
 }
@@ -214,13 +223,14 @@ INLINE void timer_list_insert(mame_timer *timer)
 
 INLINE void timer_list_remove(mame_timer *timer)
 {
+	timer_private *global = Machine->timer_data;
 	/* sanity checks for the debug build */
 	#ifdef MAME_DEBUG
 	{
 		mame_timer *t;
 
 		/* loop over the timer list */
-		for (t = timer_head; t && t != timer; t = t->next) ;
+		for (t = global->timer_head; t && t != timer; t = t->next) ;
 		if (t == NULL)
 			fatalerror("timer (%s from %s:%d) not found in list", timer->func, timer->file, timer->line);
 	}
@@ -230,7 +240,7 @@ INLINE void timer_list_remove(mame_timer *timer)
 	if (timer->prev)
 		timer->prev->next = timer->next;
 	else
-		timer_head = timer->next;
+		global->timer_head = timer->next;
 	if (timer->next)
 		timer->next->prev = timer->prev;
 }
@@ -247,38 +257,48 @@ INLINE void timer_list_remove(mame_timer *timer)
 
 void timer_init(running_machine *machine)
 {
+	timer_private *global;
 	int i;
 
+	/* allocate our state; this lives as long as the machine, and is freed by destroy_machine */
+	if (machine->timer_data == NULL)
+	{
+		machine->timer_data = malloc(sizeof(*global));
+		if (machine->timer_data == NULL)
+			fatalerror("Out of memory allocating the timer state");
+	}
+	global = machine->timer_data;
+
 	/* init the constant times */
 	time_zero.seconds = time_zero.subseconds = 0;
 	time_never.seconds = MAX_SECONDS;
 	time_never.subseconds = MAX_SUBSECONDS - 1;
 
 	/* we need to wait until the first call to timer_cyclestorun before using real CPU times */
-	global_basetime = time_zero;
-	callback_timer = NULL;
-	callback_timer_modified = FALSE;
+	global->basetime = time_zero;
+	global->callback_timer = NULL;
+	global->callback_timer_modified = FALSE;
 
-	/* register with the save state system */
+	/* register with the save state system; the names are those of the old globals, to keep states compatible */
 	state_save_push_tag(0);
-	state_save_register_item("timer", 0, global_basetime.seconds);
-	state_save_register_item("timer", 0, global_basetime.subseconds);
+	state_save_register_generic("timer", 0, "global_basetime.seconds", &global->basetime.seconds, global->basetime.seconds, 1);
+	state_save_register_generic("timer", 0, "global_basetime.subseconds", &global->basetime.subseconds, global->basetime.subseconds, 1);
 	state_save_register_func_postload(timer_postload);
 	state_save_pop_tag();
 
 	/* reset the timers */
-	memset(timers, 0, sizeof(timers));
+	memset(global->timers, 0, sizeof(global->timers));
 
 	/* initialize the lists */
-	timer_head = NULL;
-	timer_free_head = &timers[0];
+	global->timer_head = NULL;
+	global->timer_free_head = &global->timers[0];
 	for (i = 0; i < MAX_TIMERS-1; i++)
 	{
-		timers[i].tag = -1;
-		timers[i].next = &timers[i+1];
+		global->timers[i].tag = -1;
+		global->timers[i].next = &global->timers[i+1];
 	}
-	timers[MAX_TIMERS-1].next = NULL;
-	timer_free_tail = &timers[MAX_TIMERS-1];
+	global->timers[MAX_TIMERS-1].next = NULL;
+	global->timer_free_tail = &global->timers[MAX_TIMERS-1];
 }
 
 
@@ -289,11 +309,16 @@ void timer_init(running_machine *machine)
 
 void timer_free(void)
 {
+	timer_private *global = Machine->timer_data;
 	int tag = get_resource_tag();
 	mame_timer *timer, *next;
 
+	/* nothing to do if we failed before timer_init */
+	if (global == NULL)
+		return;
+
 	/* scan the list */
-	for (timer = timer_head; timer != NULL; timer = next)
+	for (timer = global->timer_head; timer != NULL; timer = next)
 	{
 		/* prefetch the next timer in case we remove this one */
 		next = timer->next;
@@ -317,7 +342,8 @@ void timer_free(void)
 
 mame_time mame_timer_next_fire_time(void)
 {
-	return timer_head->expire;
+	timer_private *global = Machine->timer_data;
+	return global->timer_head->expire;
 }
 
 
@@ -328,27 +354,28 @@ mame_time mame_timer_next_fire_time(void)
 
 void mame_timer_set_global_time(mame_time newbase)
 {
+	timer_private *global = Machine->timer_data;
 	mame_timer *timer;
 
 	/* set the new global offset */
-	global_basetime = newbase;
+	global->basetime = newbase;
 
-	LOG(("mame_timer_set_global_time: new=%.9f head->expire=%.9f\n", mame_time_to_double(newbase), mame_time_to_double(timer_head->expire)));
+	LOG(("mame_timer_set_global_time: new=%.9f head->expire=%.9f\n", mame_time_to_double(newbase), mame_time_to_double(global->timer_head->expire)));
 
 	/* now process any timers that are overdue */
-	while (compare_mame_times(timer_head->expire, global_basetime) <= 0)
+	while (compare_mame_times(global->timer_head->expire, global->basetime) <= 0)
 	{
-		int was_enabled = timer_head->enabled;
+		int was_enabled = global->timer_head->enabled;
 
 		/* if this is a one-shot timer, disable it now */
-		timer = timer_head;
+		timer = global->timer_head;
 		if (compare_mame_times(timer->period, time_zero) == 0 || compare_mame_times(timer->period, time_never) == 0)
 			timer->enabled = FALSE;
 
 		/* set the global state of which callback we're in */
-		callback_timer_modified = FALSE;
-		callback_timer = timer;
-		callback_timer_expire_time = timer->expire;
+		global->callback_timer_modified = FALSE;
+		global->callback_timer = timer;
+		global->callback_timer_expire_time = timer->expire;
 
 		/* call the callback */
 		if (was_enabled)
@@ -370,10 +397,10 @@ void mame_timer_set_global_time(mame_time newbase)
 		}
 
 		/* clear the callback timer global */
-		callback_timer = NULL;
+		global->callback_timer = NULL;
 
 		/* reset or remove the timer, but only if it wasn't modified during the callback */
-		if (!callback_timer_modified)
+		if (!global->callback_timer_modified)
 		{
 			/* if the timer is temporary, remove it now */
 			if (timer->temporary)
@@ -405,12 +432,13 @@ void mame_timer_set_global_time(mame_time newbase)
 
 static void timer_register_save(mame_timer *timer)
 {
+	timer_private *global = Machine->timer_data;
 	char buf[256];
 	int count = 0;
 	mame_timer *t;
 
 	/* find other timers that match our func name */
-	for (t = timer_head; t; t = t->next)
+	for (t = global->timer_head; t; t = t->next)
 		if (!strcmp(t->func, timer->func))
 			count++;
 
@@ -437,13 +465,14 @@ static void timer_register_save(mame_timer *timer)
 
 static void timer_postload(void)
 {
+	timer_private *global = Machine->timer_data;
 	mame_timer *privlist = NULL;
 	mame_timer *t;
 
 	/* remove all timers and make a private list */
-	while (timer_head)
+	while (global->timer_head)
 	{
-		t = timer_head;
+		t = global->timer_head;
 
 		/* temporary timers go away entirely */
 		if (t->temporary)
@@ -475,12 +504,13 @@ static void timer_postload(void)
 
 int timer_count_anonymous(void)
 {
+	timer_private *global = Machine->timer_data;
 	mame_timer *t;
 	int count = 0;
 
 	logerror("timer_count_anonymous:\n");
-	for (t = timer_head; t; t = t->next)
-		if (t->temporary && t != callback_timer)
+	for (t = global->timer_head; t; t = t->next)
+		if (t->temporary && t != global->callback_timer)
 		{
 			count++;
 			logerror("  Temp. timer %p, file %s:%d[%s]\n", (void *) t, t->file, t->line, t->func);
@@ -555,13 +585,14 @@ mame_timer *_mame_timer_alloc_ptr(void (*callback_ptr)(void *), void *param, con
 
 static void mame_timer_remove(mame_timer *which)
 {
+	timer_private *global = Machine->timer_data;
 	/* error if this is an inactive timer */
 	if (which->tag == -1)
 		fatalerror("timer_remove: removing an inactive timer! (%s from %s:%d)\n", which->func, which->file, which->line);
 
 	/* if this is a callback timer, note that */
-	if (which == callback_timer)
-		callback_timer_modified = TRUE;
+	if (which == global->callback_timer)
+		global->callback_timer_modified = TRUE;
 
 	/* remove it from the list */
 	timer_list_remove(which);
@@ -570,12 +601,12 @@ static void mame_timer_remove(mame_timer *which)
 	which->tag = -1;
 
 	/* free it up by adding it back to the free list */
-	if (timer_free_tail)
-		timer_free_tail->next = which;
+	if (global->timer_free_tail)
+		global->timer_free_tail->next = which;
 	else
-		timer_free_head = which;
+		global->timer_free_head = which;
 	which->next = NULL;
-	timer_free_tail = which;
+	global->timer_free_tail = which;
 }
 
 
@@ -592,6 +623,7 @@ static void mame_timer_remove(mame_timer *which)
 
 INLINE void mame_timer_adjust_common(mame_timer *which, mame_time duration, INT32 param, mame_time period)
 {
+	timer_private *global = Machine->timer_data;
 	mame_time time = get_current_time();
 
 	/* error if this is an inactive timer */
@@ -599,8 +631,8 @@ INLINE void mame_timer_adjust_common(mame_timer *which, mame_time duration, INT3
 		fatalerror("mame_timer_adjust: adjusting an inactive timer!\n");
 
 	/* if this is the callback timer, mark it modified */
-	if (which == callback_timer)
-		callback_timer_modified = TRUE;
+	if (which == global->callback_timer)
+		global->callback_timer_modified = TRUE;
 
 	/* compute the time of the next firing and insert into the list */
 	which->callback_param = param;
@@ -621,7 +653,7 @@ INLINE void mame_timer_adjust_common(mame_timer *which, mame_time duration, INT3
 
 	/* if this was inserted as the head, abort the current timeslice and resync */
 	LOG(("timer_adjust %s.%s:%d to expire @ %.9f\n", which->file, which->func, which->line, mame_time_to_double(which->expire)));
-	if (which == timer_head && cpu_getexecutingcpu() >= 0)
+	if (which == global->timer_head && cpu_getexecutingcpu() >= 0)
 		activecpu_abort_timeslice();
 }
 
@@ -782,6 +814,9 @@ mame_time mame_timer_timeleft(mame_timer *which)
 
 mame_time mame_timer_get_time(void)
 {
+	/* the video system asks for the time while the ROMs load, before timer_init */
+	if (Machine->timer_data == NULL)
+		return time_zero;
 	return get_current_time();
 }
 
@@ -819,6 +854,7 @@ mame_time mame_timer_firetime(mame_timer *which)
 
 static void timer_logtimers(void)
 {
+	timer_private *global = Machine->timer_data;
 	mame_timer *t;
 
 	logerror("===============\n");
@@ -826,12 +862,12 @@ static void timer_logtimers(void)
 	logerror("===============\n");
 
 	logerror("Enqueued timers:\n");
-	for (t = timer_head; t; t = t->next)
+	for (t = global->timer_head; t; t = t->next)
 		logerror("  Start=%15.6f Exp=%15.6f Per=%15.6f Ena=%d Tmp=%d (%s:%d[%s])\n",
 			mame_time_to_double(t->start), mame_time_to_double(t->expire), mame_time_to_double(t->period), t->enabled, t->temporary, t->file, t->line, t->func);
 
 	logerror("Free timers:\n");
-	for (t = timer_free_head; t; t = t->next)
+	for (t = global->timer_free_head; t; t = t->next)
 		logerror("  Start=%15.6f Exp=%15.6f Per=%15.6f Ena=%d Tmp=%d (%s:%d[%s])\n",
 			mame_time_to_double(t->start), mame_time_to_double(t->expire), mame_time_to_double(t->period), t->enabled, t->temporary, t->file, t->line, t->func);
 
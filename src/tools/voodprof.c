@@ -0,0 +1,225 @@
+/***************************************************************************
+
+    voodprof.c
+
+    Builds a table of specialized Voodoo rasterizers from the rasterizer
+    profiles recorded by the emulator.
+
+    Copyright (c) 1996-2007, Nicola Salmoria and the MAME Team.
+    Visit http://mamedev.org for licensing and usage restrictions.
+
+***************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mamecore.h"
+
+
+
+/***************************************************************************
+    CONSTANTS
+***************************************************************************/
+
+/* most modes taken from any one profile */
+#define MAX_MODES_PER_GAME		32
+
+/* modes drawing less than 1/this of a game's pixels aren't worth a specialization */
+#define MIN_FRACTION			100
+
+/* most modes read from any one file */
+#define MAX_MODES				1024
+
+/* most modes in the generated table; voodoo.c holds MAX_RASTERIZERS in total */
+#define MAX_GENERATED			512
+
+
+
+/***************************************************************************
+    TYPE DEFINITIONS
+***************************************************************************/
+
+typedef struct _raster_mode raster_mode;
+struct _raster_mode
+{
+	INT64		polys;
+	INT64		hits;
+	UINT32		value[6];
+	const char *source;
+};
+
+
+
+/***************************************************************************
+    GLOBAL VARIABLES
+***************************************************************************/
+
+static raster_mode existing[MAX_MODES];
+static int existing_count;
+
+static raster_mode generated[MAX_GENERATED];
+static int generated_count;
+
+
+
+/*-------------------------------------------------
+    parse_entry - parse a single RASTERIZER_ENTRY
+    line, with or without recorded counts
+-------------------------------------------------*/
+
+static int parse_entry(const char *line, raster_mode *mode)
+{
+	double polys = 0, hits = 0;
+	int count;
+
+	/* the counts go through doubles since not every C library knows %lld */
+	memset(mode, 0, sizeof(*mode));
+	count = sscanf(line, " RASTERIZER_ENTRY ( 0x%X , 0x%X , 0x%X , 0x%X , 0x%X , 0x%X ) /* %lf polys %lf pixels */",
+			&mode->value[0], &mode->value[1], &mode->value[2], &mode->value[3], &mode->value[4], &mode->value[5],
+			&polys, &hits);
+	mode->polys = (INT64)polys;
+	mode->hits = (INT64)hits;
+	return (count >= 6);
+}
+
+
+/*-------------------------------------------------
+    find_mode - find a mode in a list
+-------------------------------------------------*/
+
+static int find_mode(const raster_mode *list, int count, const raster_mode *mode)
+{
+	int index;
+
+	for (index = 0; index < count; index++)
+		if (memcmp(list[index].value, mode->value, sizeof(mode->value)) == 0)
+			return index;
+	return -1;
+}
+
+
+/*-------------------------------------------------
+    read_modes - read all the entries from a file
+-------------------------------------------------*/
+
+static int read_modes(const char *filename, raster_mode *list, int maxcount)
+{
+	char line[1024];
+	int count = 0;
+	FILE *file;
+
+	file = fopen(filename, "r");
+	if (file == NULL)
+	{
+		fprintf(stderr, "Unable to open file '%s'\n", filename);
+		return -1;
+	}
+
+	while (count < maxcount && fgets(line, sizeof(line), file) != NULL)
+		if (parse_entry(line, &list[count]))
+			list[count++].source = filename;
+
+	fclose(file);
+	return count;
+}
+
+
+/*-------------------------------------------------
+    add_profile - add the busiest modes from a
+    single game's profile
+-------------------------------------------------*/
+
+static int add_profile(const char *filename)
+{
+	static raster_mode profile[MAX_MODES];
+	INT64 total = 0;
+	int count, index, taken = 0;
+
+	count = read_modes(filename, profile, MAX_MODES);
+	if (count < 0)
+		return 1;
+
+	/* profiles are written busiest first */
+	for (index = 0; index < count; index++)
+		total += profile[index].hits;
+
+	for (index = 0; index < count && taken < MAX_MODES_PER_GAME; index++)
+	{
+		raster_mode *mode = &profile[index];
+		int match;
+
+		if (mode->hits == 0 || mode->hits < total / MIN_FRACTION)
+			break;
+		taken++;
+
+		/* skip anything voodoo.c already specializes */
+		if (find_mode(existing, existing_count, mode) != -1)
+			continue;
+
+		/* merge with other games using the same mode */
+		match = find_mode(generated, generated_count, mode);
+		if (match != -1)
+		{
+			generated[match].polys += mode->polys;
+			generated[match].hits += mode->hits;
+		}
+		else if (generated_count < MAX_GENERATED)
+			generated[generated_count++] = *mode;
+	}
+	return 0;
+}
+
+
+/*-------------------------------------------------
+    main - primary entry point
+-------------------------------------------------*/
+
+int main(int argc, char *argv[])
+{
+	const char *dstfile, *srcfile;
+	FILE *dst;
+	int argnum, index;
+
+	/* needs at least two arguments */
+	if (argc < 3)
+	{
+		fprintf(stderr,
+			"Usage:\n"
+			"  voodprof <output.h> <voodoo.c> [<profile.vrp> ...]\n"
+		);
+		return 0;
+	}
+
+	/* extract arguments */
+	dstfile = argv[1];
+	srcfile = argv[2];
+
+	/* gather the hand-picked rasterizers so we don't generate duplicates */
+	existing_count = read_modes(srcfile, existing, MAX_MODES);
+	if (existing_count < 0)
+		return 1;
+
+	/* add each profile */
+	for (argnum = 3; argnum < argc; argnum++)
+		if (add_profile(argv[argnum]) != 0)
+			return 1;
+
+	/* open dest file */
+	dst = fopen(dstfile, "w");
+	if (dst == NULL)
+	{
+		fprintf(stderr, "Unable to open output file '%s'\n", dstfile);
+		return 1;
+	}
+
+	/* this file is included twice by voodoo.c, so it must not have an include guard */
+	fprintf(dst, "/* generated by voodprof from %d profile(s); do not edit */\n", argc - 3);
+	for (index = 0; index < generated_count; index++)
+		fprintf(dst, "RASTERIZER_ENTRY( 0x%08X,  0x%08X, 0x%08X, 0x%08X, 0x%08X, 0x%08X )\t/* %s */\n",
+				generated[index].value[0], generated[index].value[1], generated[index].value[2],
+				generated[index].value[3], generated[index].value[4], generated[index].value[5],
+				generated[index].source);
+
+	fclose(dst);
+	return 0;
+}
@@ -21,9 +21,6 @@
     CONSTANTS
 ***************************************************************************/
 
-/* number of open files to cache */
-#define ZIP_CACHE_SIZE	8
-
 /* offsets in end of central directory structure */
 #define ZIPESIG			0x00
 #define ZIPEDSK			0x04
@@ -87,13 +84,31 @@ INLINE UINT32 read_dword(UINT8 *buf)
 	return (buf[3] << 24) | (buf[2] << 16) | (buf[1] << 8) | buf[0];
 }
 
+/* case-insensitive hash of the part of a name following the last '/' */
+INLINE UINT32 hash_name(const char *name, UINT32 length)
+{
+	UINT32 hash = 0;
+	UINT32 start;
+
+	for (start = length; start > 0 && name[start - 1] != '/'; start--) ;
+	for ( ; start < length; start++)
+		hash = (hash * 31) + tolower((UINT8)name[start]);
+	return hash;
+}
+
 
 
 /***************************************************************************
     GLOBAL VARIABLES
 ***************************************************************************/
 
-static zip_file *zip_cache[ZIP_CACHE_SIZE];
+static zip_file *default_zip_cache[ZIP_CACHE_SIZE];
+static zip_file **zip_cache = default_zip_cache;
+static int zip_cache_size = ZIP_CACHE_SIZE;
+
+/* protects the cache when files are opened from several threads; it is
+   allocated on first use, which must come from a single thread */
+static osd_lock *zip_cache_lock;
 
 
 
@@ -106,6 +121,8 @@ static void free_zip_file(zip_file *zip);
 
 /* ZIP file parsing */
 static zip_error read_ecd(zip_file *zip);
+static zip_error build_index(zip_file *zip);
+static const zip_file_header *read_header(zip_file *zip, UINT32 offset);
 static zip_error get_compressed_data_offset(zip_file *zip, UINT64 *offset);
 
 /* decompression interfaces */
@@ -114,6 +131,34 @@ static zip_error decompress_data_type_8(zip_file *zip, UINT64 offset, void *buff
 
 
 
+/***************************************************************************
+    CACHE LOCKING
+***************************************************************************/
+
+/*-------------------------------------------------
+    cache_lock - acquire the ZIP cache lock,
+    allocating it if necessary
+-------------------------------------------------*/
+
+static void cache_lock(void)
+{
+	if (zip_cache_lock == NULL)
+		zip_cache_lock = osd_lock_alloc();
+	osd_lock_acquire(zip_cache_lock);
+}
+
+
+/*-------------------------------------------------
+    cache_unlock - release the ZIP cache lock
+-------------------------------------------------*/
+
+static void cache_unlock(void)
+{
+	osd_lock_release(zip_cache_lock);
+}
+
+
+
 /***************************************************************************
     ZIP FILE ACCESS
 ***************************************************************************/
@@ -135,7 +180,8 @@ zip_error zip_file_open(const char *filename, zip_file **zip)
 	*zip = NULL;
 
 	/* see if we are in the cache, and reopen if so */
-	for (cachenum = 0; cachenum < ARRAY_LENGTH(zip_cache); cachenum++)
+	cache_lock();
+	for (cachenum = 0; cachenum < zip_cache_size; cachenum++)
 	{
 		zip_file *cached = zip_cache[cachenum];
 
@@ -144,9 +190,11 @@ zip_error zip_file_open(const char *filename, zip_file **zip)
 		{
 			*zip = cached;
 			zip_cache[cachenum] = NULL;
+			cache_unlock();
 			return ZIPERR_NONE;
 		}
 	}
+	cache_unlock();
 
 	/* allocate memory for the zip_file structure */
 	newzip = malloc(sizeof(*newzip));
@@ -161,6 +209,8 @@ zip_error zip_file_open(const char *filename, zip_file **zip)
 		ziperr = ZIPERR_FILE_ERROR;
 		goto error;
 	}
+	if (osd_get_modified_time(newzip->file, &newzip->modified) != FILERR_NONE)
+		newzip->modified = 0;
 
 	/* read ecd data */
 	ziperr = read_ecd(newzip);
@@ -190,6 +240,11 @@ zip_error zip_file_open(const char *filename, zip_file **zip)
 		goto error;
 	}
 
+	/* index it so that lookups don't need to scan */
+	ziperr = build_index(newzip);
+	if (ziperr != ZIPERR_NONE)
+		goto error;
+
 	/* make a copy of the filename for caching purposes */
 	string = malloc(strlen(filename) + 1);
 	if (string == NULL)
@@ -223,18 +278,20 @@ void zip_file_close(zip_file *zip)
 	zip->file = NULL;
 
 	/* find the first NULL entry in the cache */
-	for (cachenum = 0; cachenum < ARRAY_LENGTH(zip_cache); cachenum++)
+	cache_lock();
+	for (cachenum = 0; cachenum < zip_cache_size; cachenum++)
 		if (zip_cache[cachenum] == NULL)
 			break;
 
 	/* if no room left in the cache, free the bottommost entry */
-	if (cachenum == ARRAY_LENGTH(zip_cache))
+	if (cachenum == zip_cache_size)
 		free_zip_file(zip_cache[--cachenum]);
 
 	/* move everyone else down and place us at the top */
 	if (cachenum != 0)
 		memmove(&zip_cache[1], &zip_cache[0], cachenum * sizeof(zip_cache[0]));
 	zip_cache[0] = zip;
+	cache_unlock();
 }
 
 
@@ -248,12 +305,55 @@ void zip_file_cache_clear(void)
 	int cachenum;
 
 	/* clear call cache entries */
-	for (cachenum = 0; cachenum < ARRAY_LENGTH(zip_cache); cachenum++)
+	cache_lock();
+	for (cachenum = 0; cachenum < zip_cache_size; cachenum++)
 		if (zip_cache[cachenum] != NULL)
 		{
 			free_zip_file(zip_cache[cachenum]);
 			zip_cache[cachenum] = NULL;
 		}
+	cache_unlock();
+}
+
+
+/*-------------------------------------------------
+    zip_file_cache_set_size - set the number of
+    ZIP files kept in the cache
+-------------------------------------------------*/
+
+void zip_file_cache_set_size(int size)
+{
+	zip_file **newcache;
+	int cachenum;
+
+	if (size < 1)
+		size = 1;
+
+	cache_lock();
+	if (size != zip_cache_size)
+	{
+		/* allocate the new cache; on failure, keep the old one */
+		newcache = malloc(size * sizeof(*newcache));
+		if (newcache != NULL)
+		{
+			memset(newcache, 0, size * sizeof(*newcache));
+
+			/* keep the most recent entries and free the rest */
+			for (cachenum = 0; cachenum < zip_cache_size; cachenum++)
+			{
+				if (cachenum < size)
+					newcache[cachenum] = zip_cache[cachenum];
+				else
+					free_zip_file(zip_cache[cachenum]);
+			}
+
+			if (zip_cache != default_zip_cache)
+				free(zip_cache);
+			zip_cache = newcache;
+			zip_cache_size = size;
+		}
+	}
+	cache_unlock();
 }
 
 
@@ -282,53 +382,75 @@ const zip_file_header *zip_file_first_file(zip_file *zip)
 
 const zip_file_header *zip_file_next_file(zip_file *zip)
 {
-	/* fix up any modified data */
-	if (zip->header.raw != NULL)
-	{
-		zip->header.raw[ZIPCFN + zip->header.filename_length] = zip->header.saved;
-		zip->header.raw = NULL;
-	}
+	const zip_file_header *header;
 
 	/* if we're at or past the end, we're done */
 	if (zip->cd_pos >= zip->ecd.cd_size)
+	{
+		read_header(zip, zip->ecd.cd_size);
 		return NULL;
+	}
 
-	/* extract file header info */
-	zip->header.raw                 = zip->cd + zip->cd_pos;
-	zip->header.rawlength           = ZIPCFN;
-	zip->header.signature           = read_dword(zip->header.raw + ZIPCENSIG);
-	zip->header.version_created     = read_word (zip->header.raw + ZIPCVER);
-	zip->header.version_needed      = read_word (zip->header.raw + ZIPCVXT);
-	zip->header.bit_flag            = read_word (zip->header.raw + ZIPCFLG);
-	zip->header.compression         = read_word (zip->header.raw + ZIPCMTHD);
-	zip->header.file_time           = read_word (zip->header.raw + ZIPCTIM);
-	zip->header.file_date           = read_word (zip->header.raw + ZIPCDAT);
-	zip->header.crc                 = read_dword(zip->header.raw + ZIPCCRC);
-	zip->header.compressed_length   = read_dword(zip->header.raw + ZIPCSIZ);
-	zip->header.uncompressed_length = read_dword(zip->header.raw + ZIPCUNC);
-	zip->header.filename_length     = read_word (zip->header.raw + ZIPCFNL);
-	zip->header.extra_field_length  = read_word (zip->header.raw + ZIPCXTL);
-	zip->header.file_comment_length = read_word (zip->header.raw + ZIPCCML);
-	zip->header.start_disk_number   = read_word (zip->header.raw + ZIPDSK);
-	zip->header.internal_attributes = read_word (zip->header.raw + ZIPINT);
-	zip->header.external_attributes = read_dword(zip->header.raw + ZIPEXT);
-	zip->header.local_header_offset = read_dword(zip->header.raw + ZIPOFST);
-	zip->header.filename            = (char *)zip->header.raw + ZIPCFN;
+	/* read the header and advance the position */
+	header = read_header(zip, zip->cd_pos);
+	if (header != NULL)
+		zip->cd_pos += header->rawlength;
+	return header;
+}
 
-	/* make sure we have enough data */
-	zip->header.rawlength += zip->header.filename_length;
-	zip->header.rawlength += zip->header.extra_field_length;
-	zip->header.rawlength += zip->header.file_comment_length;
-	if (zip->cd_pos + zip->header.rawlength > zip->ecd.cd_size)
-		return NULL;
 
-	/* NULL terminate the filename */
-	zip->header.saved = zip->header.raw[ZIPCFN + zip->header.filename_length];
-	zip->header.raw[ZIPCFN + zip->header.filename_length] = 0;
+/*-------------------------------------------------
+    zip_file_find_file - return the first entry
+    in the ZIP whose name ends with the given
+    filename at a path boundary or, if match_crc
+    is set, whose CRC matches; this is the same
+    entry a scan with zip_file_first_file and
+    zip_file_next_file would stop at, but found
+    via the lookup tables
+-------------------------------------------------*/
 
-	/* advance the position */
-	zip->cd_pos += zip->header.rawlength;
-	return &zip->header;
+const zip_file_header *zip_file_find_file(zip_file *zip, const char *filename, UINT32 crc, int match_crc)
+{
+	UINT32 filenamelen = (UINT32)strlen(filename);
+	UINT32 best = zip->entries;
+	UINT32 slot, index;
+
+	/* look for a name match */
+	for (slot = hash_name(filename, filenamelen) & zip->table_mask; zip->name_table[slot] != 0; slot = (slot + 1) & zip->table_mask)
+	{
+		const UINT8 *raw;
+		const char *name;
+		UINT32 namelen;
+
+		index = zip->name_table[slot] - 1;
+		if (index >= best)
+			continue;
+
+		/* same rule as the linear scan: the name must end with filename, at a '/' */
+		raw = zip->cd + zip->entry_offset[index];
+		name = (const char *)raw + ZIPCFN;
+		namelen = read_word((UINT8 *)raw + ZIPCFNL);
+		if (namelen >= filenamelen && mame_strnicmp(name + namelen - filenamelen, filename, filenamelen) == 0 &&
+			(namelen == filenamelen || name[namelen - filenamelen - 1] == '/'))
+			best = index;
+	}
+
+	/* look for an earlier CRC match */
+	if (match_crc)
+		for (slot = crc & zip->table_mask; zip->crc_table[slot] != 0; slot = (slot + 1) & zip->table_mask)
+		{
+			index = zip->crc_table[slot] - 1;
+			if (index < best && read_dword(zip->cd + zip->entry_offset[index] + ZIPCCRC) == crc)
+				best = index;
+		}
+
+	/* if we found nothing, we're done */
+	if (best == zip->entries)
+		return NULL;
+
+	/* load up that header and leave the scan position just past it */
+	zip->cd_pos = zip->entry_offset[best];
+	return zip_file_next_file(zip);
 }
 
 
@@ -396,6 +518,12 @@ static void free_zip_file(zip_file *zip)
 			free(zip->ecd.raw);
 		if (zip->cd != NULL)
 			free(zip->cd);
+		if (zip->entry_offset != NULL)
+			free(zip->entry_offset);
+		if (zip->name_table != NULL)
+			free(zip->name_table);
+		if (zip->crc_table != NULL)
+			free(zip->crc_table);
 		free(zip);
 	}
 }
@@ -406,6 +534,120 @@ static void free_zip_file(zip_file *zip)
     ZIP FILE PARSING
 ***************************************************************************/
 
+/*-------------------------------------------------
+    read_header - extract the header of the
+    central directory entry at the given offset
+    into zip->header; an offset at or past the
+    end just restores the previous header
+-------------------------------------------------*/
+
+static const zip_file_header *read_header(zip_file *zip, UINT32 offset)
+{
+	/* fix up any modified data */
+	if (zip->header.raw != NULL)
+	{
+		zip->header.raw[ZIPCFN + zip->header.filename_length] = zip->header.saved;
+		zip->header.raw = NULL;
+	}
+
+	/* if we're at or past the end, we're done */
+	if (offset >= zip->ecd.cd_size)
+		return NULL;
+
+	/* extract file header info */
+	zip->header.raw                 = zip->cd + offset;
+	zip->header.rawlength           = ZIPCFN;
+	zip->header.signature           = read_dword(zip->header.raw + ZIPCENSIG);
+	zip->header.version_created     = read_word (zip->header.raw + ZIPCVER);
+	zip->header.version_needed      = read_word (zip->header.raw + ZIPCVXT);
+	zip->header.bit_flag            = read_word (zip->header.raw + ZIPCFLG);
+	zip->header.compression         = read_word (zip->header.raw + ZIPCMTHD);
+	zip->header.file_time           = read_word (zip->header.raw + ZIPCTIM);
+	zip->header.file_date           = read_word (zip->header.raw + ZIPCDAT);
+	zip->header.crc                 = read_dword(zip->header.raw + ZIPCCRC);
+	zip->header.compressed_length   = read_dword(zip->header.raw + ZIPCSIZ);
+	zip->header.uncompressed_length = read_dword(zip->header.raw + ZIPCUNC);
+	zip->header.filename_length     = read_word (zip->header.raw + ZIPCFNL);
+	zip->header.extra_field_length  = read_word (zip->header.raw + ZIPCXTL);
+	zip->header.file_comment_length = read_word (zip->header.raw + ZIPCCML);
+	zip->header.start_disk_number   = read_word (zip->header.raw + ZIPDSK);
+	zip->header.internal_attributes = read_word (zip->header.raw + ZIPINT);
+	zip->header.external_attributes = read_dword(zip->header.raw + ZIPEXT);
+	zip->header.local_header_offset = read_dword(zip->header.raw + ZIPOFST);
+	zip->header.filename            = (char *)zip->header.raw + ZIPCFN;
+
+	/* make sure we have enough data */
+	zip->header.rawlength += zip->header.filename_length;
+	zip->header.rawlength += zip->header.extra_field_length;
+	zip->header.rawlength += zip->header.file_comment_length;
+	if (offset + zip->header.rawlength > zip->ecd.cd_size)
+	{
+		zip->header.raw = NULL;
+		return NULL;
+	}
+
+	/* NULL terminate the filename */
+	zip->header.saved = zip->header.raw[ZIPCFN + zip->header.filename_length];
+	zip->header.raw[ZIPCFN + zip->header.filename_length] = 0;
+	return &zip->header;
+}
+
+
+/*-------------------------------------------------
+    build_index - record the offset of every
+    entry in the central directory and hash them
+    by name and CRC
+-------------------------------------------------*/
+
+static zip_error build_index(zip_file *zip)
+{
+	UINT32 offset, index, tablesize;
+
+	/* count the entries, stopping at the first truncated one as a scan would */
+	zip->entries = 0;
+	for (offset = 0; offset + ZIPCFN <= zip->ecd.cd_size; zip->entries++)
+	{
+		UINT8 *raw = zip->cd + offset;
+		UINT32 length = ZIPCFN + read_word(raw + ZIPCFNL) + read_word(raw + ZIPCXTL) + read_word(raw + ZIPCCML);
+		if (offset + length > zip->ecd.cd_size)
+			break;
+		offset += length;
+	}
+
+	/* size the tables to be no more than half full */
+	for (tablesize = 16; tablesize < zip->entries * 2; tablesize *= 2) ;
+	zip->table_mask = tablesize - 1;
+
+	/* allocate everything */
+	zip->entry_offset = malloc((zip->entries + 1) * sizeof(zip->entry_offset[0]));
+	zip->name_table = malloc(tablesize * sizeof(zip->name_table[0]));
+	zip->crc_table = malloc(tablesize * sizeof(zip->crc_table[0]));
+	if (zip->entry_offset == NULL || zip->name_table == NULL || zip->crc_table == NULL)
+		return ZIPERR_OUT_OF_MEMORY;
+	memset(zip->name_table, 0, tablesize * sizeof(zip->name_table[0]));
+	memset(zip->crc_table, 0, tablesize * sizeof(zip->crc_table[0]));
+
+	/* fill them in */
+	for (index = 0, offset = 0; index < zip->entries; index++)
+	{
+		UINT8 *raw = zip->cd + offset;
+		UINT32 namelen = read_word(raw + ZIPCFNL);
+		UINT32 slot;
+
+		zip->entry_offset[index] = offset;
+
+		for (slot = hash_name((const char *)raw + ZIPCFN, namelen) & zip->table_mask; zip->name_table[slot] != 0; slot = (slot + 1) & zip->table_mask) ;
+		zip->name_table[slot] = index + 1;
+
+		for (slot = read_dword(raw + ZIPCCRC) & zip->table_mask; zip->crc_table[slot] != 0; slot = (slot + 1) & zip->table_mask) ;
+		zip->crc_table[slot] = index + 1;
+
+		offset += ZIPCFN + namelen + read_word(raw + ZIPCXTL) + read_word(raw + ZIPCCML);
+	}
+	return ZIPERR_NONE;
+}
+
+
 /*-------------------------------------------------
     read_ecd - read the ECD data
 -------------------------------------------------*/
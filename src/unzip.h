@@ -24,6 +24,9 @@
 
 #define ZIP_DECOMPRESS_BUFSIZE	16384
 
+/* default number of ZIP files whose directories are kept in the cache */
+#define ZIP_CACHE_SIZE			64
+
 /* Error types */
 enum _zip_error
 {
@@ -100,11 +103,17 @@ struct _zip_file
 	const char *	filename;				/* copy of ZIP filename (for caching) */
 	osd_file *		file;					/* OSD file handle */
 	UINT64			length;					/* length of zip file */
+	UINT64			modified;				/* modification time of zip file, or 0 if unknown */
 
 	zip_ecd			ecd;					/* end of central directory */
 
 	UINT8 *			cd;						/* central directory raw data */
 	UINT32			cd_pos;					/* position in central directory */
+	UINT32			entries;				/* number of entries in the central directory */
+	UINT32 *		entry_offset;			/* offset of each entry within the central directory */
+	UINT32			table_mask;				/* size - 1 of the lookup tables below */
+	UINT32 *		name_table;				/* entry index + 1, hashed on the last part of the filename */
+	UINT32 *		crc_table;				/* entry index + 1, hashed on the CRC */
 	zip_file_header	header;					/* current file header */
 
 	UINT8			buffer[ZIP_DECOMPRESS_BUFSIZE];	/* buffer for decompression */
@@ -128,6 +137,9 @@ void zip_file_close(zip_file *zip);
 /* clear out all open ZIP files from the cache */
 void zip_file_cache_clear(void);
 
+/* set the number of ZIP files kept in the cache */
+void zip_file_cache_set_size(int size);
+
 
 /* ----- contained file access ----- */
 
@@ -137,6 +149,9 @@ const zip_file_header *zip_file_first_file(zip_file *zip);
 /* find the next file in the ZIP */
 const zip_file_header *zip_file_next_file(zip_file *zip);
 
+/* find the first file in the ZIP matching a name (or, optionally, a CRC) */
+const zip_file_header *zip_file_find_file(zip_file *zip, const char *filename, UINT32 crc, int match_crc);
+
 /* decompress the most recently found file in the ZIP */
 zip_error zip_file_decompress(zip_file *zip, void *buffer, UINT32 length);
 
@@ -19,16 +19,6 @@
 #include <zlib.h>
 
 
-/*************************************
- *
- *  Debugging
- *
- *************************************/
-
-#define REPORT_TIMES		(0)
-
-
-
 /*************************************
  *
  *  Constants
@@ -37,6 +27,23 @@
 
 #define QUARK_HASH_SIZE		389
 
+/* number of drivers validated by each work item */
+#define DRIVERS_PER_CHUNK	16
+
+/* phases we keep timings for */
+enum
+{
+	PHASE_EXPANSION,
+	PHASE_DRIVER,
+	PHASE_ROM,
+	PHASE_CPU,
+	PHASE_DISPLAY,
+	PHASE_GFX,
+	PHASE_INPUT,
+	PHASE_SOUND,
+	PHASE_COUNT
+};
+
 
 
 /*************************************
@@ -63,6 +70,37 @@ struct _quark_table
 };
 
 
+/* messages are gathered per work item and printed in driver order */
+typedef struct _validity_output validity_output;
+struct _validity_output
+{
+	char *buffer;				/* messages, each a channel byte followed by a NUL-terminated string */
+	int length;
+	int allocated;
+};
+
+
+typedef struct _validity_chunk validity_chunk;
+struct _validity_chunk
+{
+	const int *drivlist;		/* drivers to validate */
+	int count;
+	int error;					/* did any of them fail? */
+	validity_output output;
+	osd_ticks_t phase_time[PHASE_COUNT];
+};
+
+
+/* each driver's parent and grandparent, looked up before the workers start */
+/* since the driver LRU behind driver_get_clone is not thread-safe */
+typedef struct _validity_clone validity_clone;
+struct _validity_clone
+{
+	const game_driver *parent;
+	const game_driver *grandparent;
+};
+
+
 
 /*************************************
  *
@@ -77,6 +115,95 @@ static quark_table *roms_table;
 static quark_table *inputs_table;
 static quark_table *defstr_table;
 static int total_drivers;
+static validity_clone *driver_clones;
+
+static const char *const phase_name[PHASE_COUNT] =
+{
+	"Expansion:",
+	"Driver:",
+	"ROM:",
+	"CPU:",
+	"Display:",
+	"Graphics:",
+	"Input:",
+	"Sound:"
+};
+
+
+
+/*************************************
+ *
+ *  Buffer a message for later output
+ *
+ *************************************/
+
+static void validity_vprintf(validity_output *out, char channel, const char *format, va_list arg)
+{
+	char message[1024];
+	int length;
+
+	vsnprintf(message, sizeof(message), format, arg);
+	message[sizeof(message) - 1] = 0;
+	length = strlen(message) + 2;
+
+	/* make room for the channel, the text and the terminator */
+	if (out->length + length > out->allocated)
+	{
+		out->allocated = (out->allocated == 0) ? 1024 : out->allocated * 2;
+		while (out->length + length > out->allocated)
+			out->allocated *= 2;
+		out->buffer = realloc(out->buffer, out->allocated);
+		if (out->buffer == NULL)
+			fatalerror("Out of memory buffering validity messages");
+	}
+
+	out->buffer[out->length] = channel;
+	strcpy(&out->buffer[out->length + 1], message);
+	out->length += length;
+}
+
+
+static void validity_error(validity_output *out, const char *format, ...)
+{
+	va_list arg;
+	va_start(arg, format);
+	validity_vprintf(out, 'E', format, arg);
+	va_end(arg);
+}
+
+
+static void validity_warning(validity_output *out, const char *format, ...)
+{
+	va_list arg;
+	va_start(arg, format);
+	validity_vprintf(out, 'W', format, arg);
+	va_end(arg);
+}
+
+
+
+/*************************************
+ *
+ *  Print and free buffered messages
+ *
+ *************************************/
+
+static void validity_flush(validity_output *out)
+{
+	int offset;
+
+	for (offset = 0; offset < out->length; offset += strlen(&out->buffer[offset + 1]) + 2)
+	{
+		if (out->buffer[offset] == 'W')
+			mame_printf_warning("%s", &out->buffer[offset + 1]);
+		else
+			mame_printf_error("%s", &out->buffer[offset + 1]);
+	}
+
+	if (out->buffer != NULL)
+		free(out->buffer);
+	memset(out, 0, sizeof(*out));
+}
 
 
 
@@ -207,13 +334,45 @@ static void build_quarks(void)
 
 
 
+/*************************************
+ *
+ *  Pick the one driver that
+ *  validates each set of input ports
+ *
+ *************************************/
+
+static void assign_input_owners(const int *drivlist, int count)
+{
+	int index;
+
+	/* the first driver in the list to use a set of ports owns it */
+	for (index = 0; index < count; index++)
+	{
+		const game_driver *driver = drivers[drivlist[index]];
+		quark_entry *entry;
+		UINT32 crc;
+
+		if (!driver->ipt)
+			continue;
+
+		crc = (UINT32)driver->ipt;
+		for (entry = first_hash_entry(inputs_table, crc); entry; entry = entry->next)
+			if (entry->crc == crc && driver->ipt == drivers[entry - inputs_table->entry]->ipt)
+				break;
+		if (entry == NULL)
+			add_quark(inputs_table, drivlist[index], crc);
+	}
+}
+
+
+
 /*************************************
  *
  *  Validate basic driver info
  *
  *************************************/
 
-static int validate_driver(int drivnum, const machine_config *drv)
+static int validate_driver(validity_output *out, int drivnum, const machine_config *drv)
 {
 	const game_driver *driver = drivers[drivnum];
 	const game_driver *clone_of;
@@ -223,34 +382,34 @@ static int validate_driver(int drivnum, const machine_config *drv)
 	UINT32 crc;
 
 	/* determine the clone */
-	clone_of = driver_get_clone(driver);
+	clone_of = driver_clones[drivnum].parent;
 
 	/* if we have at least 100 drivers, validate the clone */
 	/* (100 is arbitrary, but tries to avoid tiny.mak dependencies) */
 	if (total_drivers > 100 && !clone_of && strcmp(driver->parent, "0"))
 	{
-		mame_printf_error("%s: %s is a non-existant clone\n", driver->source_file, driver->parent);
+		validity_error(out, "%s: %s is a non-existant clone\n", driver->source_file, driver->parent);
 		error = TRUE;
 	}
 
 	/* look for recursive cloning */
 	if (clone_of == driver)
 	{
-		mame_printf_error("%s: %s is set as a clone of itself\n", driver->source_file, driver->name);
+		validity_error(out, "%s: %s is set as a clone of itself\n", driver->source_file, driver->name);
 		error = TRUE;
 	}
 
 	/* look for clones that are too deep */
-	if (clone_of != NULL && (clone_of = driver_get_clone(clone_of)) != NULL && (clone_of->flags & NOT_A_DRIVER) == 0)
+	if (clone_of != NULL && (clone_of = driver_clones[drivnum].grandparent) != NULL && (clone_of->flags & NOT_A_DRIVER) == 0)
 	{
-		mame_printf_error("%s: %s is a clone of a clone\n", driver->source_file, driver->name);
+		validity_error(out, "%s: %s is a clone of a clone\n", driver->source_file, driver->name);
 		error = TRUE;
 	}
 
 	/* make sure the driver name is 8 chars or less */
 	if (strlen(driver->name) > 8)
 	{
-		mame_printf_error("%s: %s driver name must be 8 characters or less\n", driver->source_file, driver->name);
+		validity_error(out, "%s: %s driver name must be 8 characters or less\n", driver->source_file, driver->name);
 		error = TRUE;
 	}
 
@@ -258,7 +417,7 @@ static int validate_driver(int drivnum, const machine_config *drv)
 	for (s = driver->year; *s; s++)
 		if (!isdigit(*s) && *s != '?' && *s != '+')
 		{
-			mame_printf_error("%s: %s has an invalid year '%s'\n", driver->source_file, driver->name, driver->year);
+			validity_error(out, "%s: %s has an invalid year '%s'\n", driver->source_file, driver->name, driver->year);
 			error = TRUE;
 			break;
 		}
@@ -267,7 +426,7 @@ static int validate_driver(int drivnum, const machine_config *drv)
 	/* make sure sound-less drivers are flagged */
 	if ((driver->flags & NOT_A_DRIVER) == 0 && drv->sound[0].sound_type == 0 && (driver->flags & GAME_NO_SOUND) == 0 && strcmp(driver->name, "minivadr"))
 	{
-		mame_printf_error("%s: %s missing GAME_NO_SOUND flag\n", driver->source_file, driver->name);
+		validity_error(out, "%s: %s missing GAME_NO_SOUND flag\n", driver->source_file, driver->name);
 		error = TRUE;
 	}
 #endif
@@ -280,7 +439,7 @@ static int validate_driver(int drivnum, const machine_config *drv)
 			const game_driver *match = drivers[entry - name_table->entry];
 			if (!strcmp(match->name, driver->name))
 			{
-				mame_printf_error("%s: %s is a duplicate name (%s, %s)\n", driver->source_file, driver->name, match->source_file, match->name);
+				validity_error(out, "%s: %s is a duplicate name (%s, %s)\n", driver->source_file, driver->name, match->source_file, match->name);
 				error = TRUE;
 			}
 		}
@@ -293,7 +452,7 @@ static int validate_driver(int drivnum, const machine_config *drv)
 			const game_driver *match = drivers[entry - description_table->entry];
 			if (!strcmp(match->description, driver->description))
 			{
-				mame_printf_error("%s: %s is a duplicate description (%s, %s)\n", driver->source_file, driver->description, match->source_file, match->name);
+				validity_error(out, "%s: %s is a duplicate description (%s, %s)\n", driver->source_file, driver->description, match->source_file, match->name);
 				error = TRUE;
 			}
 		}
@@ -309,7 +468,7 @@ static int validate_driver(int drivnum, const machine_config *drv)
 				const game_driver *match = drivers[entry - roms_table->entry];
 				if (match->rom == driver->rom)
 				{
-					mame_printf_error("%s: %s uses the same ROM set as (%s, %s)\n", driver->source_file, driver->description, match->source_file, match->name);
+					validity_error(out, "%s: %s uses the same ROM set as (%s, %s)\n", driver->source_file, driver->description, match->source_file, match->name);
 					error = TRUE;
 				}
 			}
@@ -327,7 +486,7 @@ static int validate_driver(int drivnum, const machine_config *drv)
  *
  *************************************/
 
-static int validate_roms(int drivnum, const machine_config *drv, UINT32 *region_length)
+static int validate_roms(validity_output *out, int drivnum, const machine_config *drv, UINT32 *region_length)
 {
 	const game_driver *driver = drivers[drivnum];
 	const rom_entry *romp;
@@ -349,13 +508,13 @@ static int validate_roms(int drivnum, const machine_config *drv, UINT32 *region_
 
 			/* if we haven't seen any items since the last region, print a warning */
 			if (items_since_region == 0)
-				mame_printf_warning("%s: %s has empty ROM region (warning)\n", driver->source_file, driver->name);
+				validity_warning(out, "%s: %s has empty ROM region (warning)\n", driver->source_file, driver->name);
 			items_since_region = (ROMREGION_ISERASE(romp) || ROMREGION_ISDISPOSE(romp)) ? 1 : 0;
 
 			/* check for an invalid region */
 			if (type >= REGION_MAX || type <= REGION_INVALID)
 			{
-				mame_printf_error("%s: %s has invalid ROM_REGION type %x\n", driver->source_file, driver->name, type);
+				validity_error(out, "%s: %s has invalid ROM_REGION type %x\n", driver->source_file, driver->name, type);
 				error = TRUE;
 				cur_region = -1;
 			}
@@ -363,7 +522,7 @@ static int validate_roms(int drivnum, const machine_config *drv, UINT32 *region_
 			/* check for a duplicate */
 			else if (region_length[type] != 0)
 			{
-				mame_printf_error("%s: %s has duplicate ROM_REGION type %x\n", driver->source_file, driver->name, type);
+				validity_error(out, "%s: %s has duplicate ROM_REGION type %x\n", driver->source_file, driver->name, type);
 				error = TRUE;
 				cur_region = -1;
 			}
@@ -391,7 +550,7 @@ static int validate_roms(int drivnum, const machine_config *drv, UINT32 *region_
 			for (s = last_name; *s; s++)
 				if (tolower(*s) != *s)
 				{
-					mame_printf_error("%s: %s has upper case ROM name %s\n", driver->source_file, driver->name, last_name);
+					validity_error(out, "%s: %s has upper case ROM name %s\n", driver->source_file, driver->name, last_name);
 					error = TRUE;
 					break;
 				}
@@ -400,7 +559,7 @@ static int validate_roms(int drivnum, const machine_config *drv, UINT32 *region_
 			hash = ROM_GETHASHDATA(romp);
 			if (!hash_verify_string(hash))
 			{
-				mame_printf_error("%s: rom '%s' has an invalid hash string '%s'\n", driver->name, last_name, hash);
+				validity_error(out, "%s: rom '%s' has an invalid hash string '%s'\n", driver->name, last_name, hash);
 				error = TRUE;
 			}
 		}
@@ -412,7 +571,7 @@ static int validate_roms(int drivnum, const machine_config *drv, UINT32 *region_
 
 			if (ROM_GETOFFSET(romp) + ROM_GETLENGTH(romp) > region_length[cur_region])
 			{
-				mame_printf_error("%s: %s has ROM %s extending past the defined memory region\n", driver->source_file, driver->name, last_name);
+				validity_error(out, "%s: %s has ROM %s extending past the defined memory region\n", driver->source_file, driver->name, last_name);
 				error = TRUE;
 			}
 		}
@@ -420,7 +579,7 @@ static int validate_roms(int drivnum, const machine_config *drv, UINT32 *region_
 
 	/* final check for empty regions */
 	if (items_since_region == 0)
-		mame_printf_warning("%s: %s has empty ROM region (warning)\n", driver->source_file, driver->name);
+		validity_warning(out, "%s: %s has empty ROM region (warning)\n", driver->source_file, driver->name);
 
 	return error;
 }
@@ -433,7 +592,7 @@ static int validate_roms(int drivnum, const machine_config *drv, UINT32 *region_
  *
  *************************************/
 
-static int validate_cpu(int drivnum, const machine_config *drv, const UINT32 *region_length)
+static int validate_cpu(validity_output *out, int drivnum, const machine_config *drv, const UINT32 *region_length)
 {
 	const game_driver *driver = drivers[drivnum];
 	int error = FALSE;
@@ -453,7 +612,7 @@ static int validate_cpu(int drivnum, const machine_config *drv, const UINT32 *re
 		/* checks to see if this driver is using a dummy CPU */
 		if (cputype_get_interface(cpu->cpu_type)->get_info == dummy_get_info)
 		{
-			mame_printf_error("%s: %s uses non-present CPU\n", driver->source_file, driver->name);
+			validity_error(out, "%s: %s uses non-present CPU\n", driver->source_file, driver->name);
 			error = TRUE;
 			continue;
 		}
@@ -464,7 +623,7 @@ static int validate_cpu(int drivnum, const machine_config *drv, const UINT32 *re
 			|| !cputype_get_info_fct(cpu->cpu_type, CPUINFO_PTR_RESET)
 			|| !cputype_get_info_fct(cpu->cpu_type, CPUINFO_PTR_EXECUTE))
 		{
-			mame_printf_error("%s: %s uses an incomplete CPU\n", driver->source_file, driver->name);
+			validity_error(out, "%s: %s uses an incomplete CPU\n", driver->source_file, driver->name);
 			error = TRUE;
 			continue;
 		}
@@ -489,7 +648,7 @@ static int validate_cpu(int drivnum, const machine_config *drv, const UINT32 *re
 			/* check to see that the same map is not used twice */
 			if (cpu->construct_map[spacenum][0] && cpu->construct_map[spacenum][0] != construct_map_0 && cpu->construct_map[spacenum][0] == cpu->construct_map[spacenum][1])
 			{
-				mame_printf_error("%s: %s uses identical memory maps for CPU #%d spacenum %d\n", driver->source_file, driver->name, cpunum, spacenum);
+				validity_error(out, "%s: %s uses identical memory maps for CPU #%d spacenum %d\n", driver->source_file, driver->name, cpunum, spacenum);
 				error = TRUE;
 			}
 
@@ -513,7 +672,7 @@ static int validate_cpu(int drivnum, const machine_config *drv, const UINT32 *re
 			/* make sure we start with a proper entry */
 			if (!IS_AMENTRY_EXTENDED(map))
 			{
-				mame_printf_error("%s: %s wrong MEMORY_READ_START for %s space\n", driver->source_file, driver->name, spacename[spacenum]);
+				validity_error(out, "%s: %s wrong MEMORY_READ_START for %s space\n", driver->source_file, driver->name, spacename[spacenum]);
 				error = TRUE;
 			}
 
@@ -525,7 +684,7 @@ static int validate_cpu(int drivnum, const machine_config *drv, const UINT32 *re
 				val = (val + 1) * 8;
 				if (val != databus_width)
 				{
-					mame_printf_error("%s: %s cpu #%d uses wrong memory handlers for %s space! (width = %d, memory = %08x)\n", driver->source_file, driver->name, cpunum, spacename[spacenum], databus_width, AM_EXTENDED_FLAGS(map));
+					validity_error(out, "%s: %s cpu #%d uses wrong memory handlers for %s space! (width = %d, memory = %08x)\n", driver->source_file, driver->name, cpunum, spacename[spacenum], databus_width, AM_EXTENDED_FLAGS(map));
 					error = TRUE;
 				}
 			}
@@ -540,14 +699,14 @@ static int validate_cpu(int drivnum, const machine_config *drv, const UINT32 *re
 						/* look for inverted start/end pairs */
 						if (map->end < map->start)
 						{
-							mame_printf_error("%s: %s wrong %s memory read handler start = %08x > end = %08x\n", driver->source_file, driver->name, spacename[spacenum], map->start, map->end);
+							validity_error(out, "%s: %s wrong %s memory read handler start = %08x > end = %08x\n", driver->source_file, driver->name, spacename[spacenum], map->start, map->end);
 							error = TRUE;
 						}
 
 						/* look for misaligned entries */
 						if ((SPACE_SHIFT(map->start) & (alignunit-1)) != 0 || (SPACE_SHIFT_END(map->end) & (alignunit-1)) != (alignunit-1))
 						{
-							mame_printf_error("%s: %s wrong %s memory read handler start = %08x, end = %08x ALIGN = %d\n", driver->source_file, driver->name, spacename[spacenum], map->start, map->end, alignunit);
+							validity_error(out, "%s: %s wrong %s memory read handler start = %08x, end = %08x ALIGN = %d\n", driver->source_file, driver->name, spacename[spacenum], map->start, map->end, alignunit);
 							error = TRUE;
 						}
 
@@ -563,9 +722,9 @@ static int validate_cpu(int drivnum, const machine_config *drv, const UINT32 *re
 							if (region_length[map->region] && map->region_offs + (SPACE_SHIFT_END(map->end) - SPACE_SHIFT(map->start) + 1) > region_length[map->region] && map->share == 0 && !map->base)
 							{
 								if (region_length[map->region] == 0)
-									mame_printf_error("%s: %s CPU %d space %d memory map entry %X-%X references non-existant region %d\n", driver->source_file, driver->name, cpunum, spacenum, map->start, map->end, map->region);
+									validity_error(out, "%s: %s CPU %d space %d memory map entry %X-%X references non-existant region %d\n", driver->source_file, driver->name, cpunum, spacenum, map->start, map->end, map->region);
 								else
-									mame_printf_error("%s: %s CPU %d space %d memory map entry %X-%X extends beyond region %d size (%X)\n", driver->source_file, driver->name, cpunum, spacenum, map->start, map->end, map->region, region_length[map->region]);
+									validity_error(out, "%s: %s CPU %d space %d memory map entry %X-%X extends beyond region %d size (%X)\n", driver->source_file, driver->name, cpunum, spacenum, map->start, map->end, map->region, region_length[map->region]);
 								error = TRUE;
 							}
 					}
@@ -584,7 +743,7 @@ static int validate_cpu(int drivnum, const machine_config *drv, const UINT32 *re
  *
  *************************************/
 
-static int validate_display(int drivnum, const machine_config *drv)
+static int validate_display(validity_output *out, int drivnum, const machine_config *drv)
 {
 	const game_driver *driver = drivers[drivnum];
 	int palette_modes = FALSE;
@@ -598,7 +757,7 @@ static int validate_display(int drivnum, const machine_config *drv)
 			/* sanity check dimensions */
 			if ((drv->screen[scrnum].defstate.width <= 0) || (drv->screen[scrnum].defstate.height <= 0))
 			{
-				mame_printf_error("%s: %s screen %d has invalid display dimensions\n", driver->source_file, driver->name, scrnum);
+				validity_error(out, "%s: %s screen %d has invalid display dimensions\n", driver->source_file, driver->name, scrnum);
 				error = TRUE;
 			}
 
@@ -607,7 +766,7 @@ static int validate_display(int drivnum, const machine_config *drv)
 				drv->screen[scrnum].defstate.format != BITMAP_FORMAT_RGB15 &&
 				drv->screen[scrnum].defstate.format != BITMAP_FORMAT_RGB32)
 			{
-				mame_printf_error("%s: %s screen %d has unsupported format\n", driver->source_file, driver->name, scrnum);
+				validity_error(out, "%s: %s screen %d has unsupported format\n", driver->source_file, driver->name, scrnum);
 				error = TRUE;
 			}
 			if (drv->screen[scrnum].defstate.format == BITMAP_FORMAT_INDEXED16)
@@ -621,7 +780,7 @@ static int validate_display(int drivnum, const machine_config *drv)
 					|| (drv->screen[scrnum].defstate.visarea.max_x >= drv->screen[scrnum].defstate.width)
 					|| (drv->screen[scrnum].defstate.visarea.max_y >= drv->screen[scrnum].defstate.height))
 				{
-					mame_printf_error("%s: %s screen %d has an invalid display area\n", driver->source_file, driver->name, scrnum);
+					validity_error(out, "%s: %s screen %d has an invalid display area\n", driver->source_file, driver->name, scrnum);
 					error = TRUE;
 				}
 			}
@@ -629,7 +788,7 @@ static int validate_display(int drivnum, const machine_config *drv)
 			/* check for zero frame rate */
 			if (drv->screen[scrnum].defstate.refresh == 0)
 			{
-				mame_printf_error("%s: %s screen %d has a zero refresh rate\n", driver->source_file, driver->name, scrnum);
+				validity_error(out, "%s: %s screen %d has a zero refresh rate\n", driver->source_file, driver->name, scrnum);
 				error = TRUE;
 			}
 		}
@@ -637,7 +796,7 @@ static int validate_display(int drivnum, const machine_config *drv)
 	/* check for empty palette */
 	if (palette_modes && drv->total_colors == 0)
 	{
-		mame_printf_error("%s: %s has zero palette entries\n", driver->source_file, driver->name);
+		validity_error(out, "%s: %s has zero palette entries\n", driver->source_file, driver->name);
 		error = TRUE;
 	}
 
@@ -652,7 +811,7 @@ static int validate_display(int drivnum, const machine_config *drv)
  *
  *************************************/
 
-static int validate_gfx(int drivnum, const machine_config *drv, const UINT32 *region_length)
+static int validate_gfx(validity_output *out, int drivnum, const machine_config *drv, const UINT32 *region_length)
 {
 	const game_driver *driver = drivers[drivnum];
 	int error = FALSE;
@@ -689,7 +848,7 @@ static int validate_gfx(int drivnum, const machine_config *drv, const UINT32 *re
 			/* if not, this is an error */
 			if ((start + len) / 8 > avail)
 			{
-				mame_printf_error("%s: %s has gfx[%d] extending past allocated memory\n", driver->source_file, driver->name, gfxnum);
+				validity_error(out, "%s: %s has gfx[%d] extending past allocated memory\n", driver->source_file, driver->name, gfxnum);
 				error = TRUE;
 			}
 		}
@@ -705,7 +864,7 @@ static int validate_gfx(int drivnum, const machine_config *drv, const UINT32 *re
  *
  *************************************/
 
-static void display_valid_coin_order(int drivnum, const input_port_entry *memory)
+static void display_valid_coin_order(validity_output *out, int drivnum, const input_port_entry *memory)
 {
 	const game_driver *driver = drivers[drivnum];
 	const input_port_entry *inp;
@@ -751,7 +910,7 @@ static void display_valid_coin_order(int drivnum, const input_port_entry *memory
 	}
 
 	/* now display the proper coin entry list */
-	mame_printf_error( "%s: %s proper coin sort order should be:\n", driver->source_file, driver->name );
+	validity_error(out, "%s: %s proper coin sort order should be:\n", driver->source_file, driver->name );
 	for( i = INPUT_STRING_9C_1C; i <= INPUT_STRING_1C_9C; i++ )
 	{
 		for( j = 0; j < coin_len; j++ )
@@ -759,7 +918,7 @@ static void display_valid_coin_order(int drivnum, const input_port_entry *memory
 			/* if it's on our list, display it */
 			if ( coin_list[j] == i )
 			{
-				mame_printf_error( "%s\n", input_port_string_from_token(INPUT_PORT_UINT32(i)) );
+				validity_error(out, "%s\n", input_port_string_from_token(INPUT_PORT_UINT32(i)) );
 			}
 		}
 	}
@@ -772,7 +931,7 @@ static void display_valid_coin_order(int drivnum, const input_port_entry *memory
  *
  *************************************/
 
-static int validate_inputs(int drivnum, const machine_config *drv, input_port_entry **memory)
+static int validate_inputs(validity_output *out, int drivnum, const machine_config *drv, input_port_entry **memory)
 {
 	const char *cabinet = input_port_string_from_token(INPUT_PORT_UINT32(INPUT_STRING_Cabinet));
 	const char *demo_sounds = input_port_string_from_token(INPUT_PORT_UINT32(INPUT_STRING_Demo_Sounds));
@@ -790,14 +949,13 @@ static int validate_inputs(int drivnum, const machine_config *drv, input_port_en
 	if (!driver->ipt)
 		return FALSE;
 
-	/* skip if we already validated these ports */
+	/* skip unless we are the driver chosen to validate these ports */
 	crc = (UINT32)driver->ipt;
 	for (entry = first_hash_entry(inputs_table, crc); entry; entry = entry->next)
 		if (entry->crc == crc && driver->ipt == drivers[entry - inputs_table->entry]->ipt)
-			return FALSE;
-
-	/* otherwise, add ourself to the list */
-	add_quark(inputs_table, drivnum, crc);
+			break;
+	if (entry != &inputs_table->entry[drivnum])
+		return FALSE;
 
 	/* allocate the input ports */
 	*memory = input_port_allocate(driver->ipt, *memory);
@@ -816,7 +974,7 @@ static int validate_inputs(int drivnum, const machine_config *drv, input_port_en
 		/* look for invalid (0) types which should be mapped to IPT_OTHER */
 		if (inp->type == IPT_INVALID)
 		{
-			mame_printf_error("%s: %s has an input port with an invalid type (0); use IPT_OTHER instead\n", driver->source_file, driver->name);
+			validity_error(out, "%s: %s has an input port with an invalid type (0); use IPT_OTHER instead\n", driver->source_file, driver->name);
 			error = TRUE;
 		}
 
@@ -826,7 +984,7 @@ static int validate_inputs(int drivnum, const machine_config *drv, input_port_en
 			/* not allowed for dipswitches */
 			if (inp->type == IPT_DIPSWITCH_NAME || inp->type == IPT_DIPSWITCH_SETTING)
 			{
-				mame_printf_error("%s: %s has a DIP switch name or setting with no name\n", driver->source_file, driver->name);
+				validity_error(out, "%s: %s has a DIP switch name or setting with no name\n", driver->source_file, driver->name);
 				error = TRUE;
 			}
 			last_strindex = 0;
@@ -836,7 +994,7 @@ static int validate_inputs(int drivnum, const machine_config *drv, input_port_en
 		/* check for empty string */
 		if (!inp->name[0] && !empty_string_found)
 		{
-			mame_printf_error("%s: %s has an input with an empty string\n", driver->source_file, driver->name);
+			validity_error(out, "%s: %s has an input with an empty string\n", driver->source_file, driver->name);
 			error = TRUE;
 			empty_string_found = TRUE;
 		}
@@ -844,14 +1002,14 @@ static int validate_inputs(int drivnum, const machine_config *drv, input_port_en
 		/* check for trailing spaces */
 		if (inp->name[0] && inp->name[strlen(inp->name) - 1] == ' ')
 		{
-			mame_printf_error("%s: %s input '%s' has trailing spaces\n", driver->source_file, driver->name, inp->name);
+			validity_error(out, "%s: %s input '%s' has trailing spaces\n", driver->source_file, driver->name, inp->name);
 			error = TRUE;
 		}
 
 		/* check for invalid UTF-8 */
 		if (!utf8_is_valid_string(inp->name))
 		{
-			mame_printf_error("%s: %s input '%s' has invalid characters\n", driver->source_file, driver->name, inp->name);
+			validity_error(out, "%s: %s input '%s' has invalid characters\n", driver->source_file, driver->name, inp->name);
 			error = TRUE;
 		}
 
@@ -867,7 +1025,7 @@ static int validate_inputs(int drivnum, const machine_config *drv, input_port_en
 		/* check for strings that should be DEF_STR */
 		if (strindex != 0 && inp->name != input_port_string_from_token(INPUT_PORT_UINT32(strindex)))
 		{
-			mame_printf_error("%s: %s must use DEF_STR( %s )\n", driver->source_file, driver->name, inp->name);
+			validity_error(out, "%s: %s must use DEF_STR( %s )\n", driver->source_file, driver->name, inp->name);
 			error = TRUE;
 		}
 
@@ -881,21 +1039,21 @@ static int validate_inputs(int drivnum, const machine_config *drv, input_port_en
 			/* check for inverted off/on dispswitch order */
 			if (last_strindex == INPUT_STRING_On && strindex == INPUT_STRING_Off)
 			{
-				mame_printf_error("%s: %s has inverted Off/On dipswitch order\n", driver->source_file, driver->name);
+				validity_error(out, "%s: %s has inverted Off/On dipswitch order\n", driver->source_file, driver->name);
 				error = TRUE;
 			}
 
 			/* check for inverted yes/no dispswitch order */
 			else if (last_strindex == INPUT_STRING_Yes && strindex == INPUT_STRING_No)
 			{
-				mame_printf_error("%s: %s has inverted No/Yes dipswitch order\n", driver->source_file, driver->name);
+				validity_error(out, "%s: %s has inverted No/Yes dipswitch order\n", driver->source_file, driver->name);
 				error = TRUE;
 			}
 
 			/* check for inverted upright/cocktail dispswitch order */
 			else if (last_strindex == INPUT_STRING_Cocktail && strindex == INPUT_STRING_Upright)
 			{
-				mame_printf_error("%s: %s has inverted Upright/Cocktail dipswitch order\n", driver->source_file, driver->name);
+				validity_error(out, "%s: %s has inverted Upright/Cocktail dipswitch order\n", driver->source_file, driver->name);
 				error = TRUE;
 			}
 
@@ -903,7 +1061,7 @@ static int validate_inputs(int drivnum, const machine_config *drv, input_port_en
 			else if (last_strindex >= INPUT_STRING_9C_1C && last_strindex <= INPUT_STRING_1C_9C && strindex >= INPUT_STRING_9C_1C && strindex <= INPUT_STRING_1C_9C &&
 					 last_strindex >= strindex && !memcmp(&inp[-1].condition, &inp[0].condition, sizeof(inp[-1].condition)))
 			{
-				mame_printf_error("%s: %s has unsorted coinage %s > %s\n", driver->source_file, driver->name, inp[-1].name, inp[0].name);
+				validity_error(out, "%s: %s has unsorted coinage %s > %s\n", driver->source_file, driver->name, inp[-1].name, inp[0].name);
 				error = TRUE;
 				coin_error = TRUE;
 			}
@@ -916,7 +1074,7 @@ static int validate_inputs(int drivnum, const machine_config *drv, input_port_en
 			if (last_dipname_entry->name == cabinet && strindex == INPUT_STRING_Upright &&
 				last_dipname_entry->default_value != inp->default_value)
 			{
-				mame_printf_error("%s: %s Cabinet must default to Upright\n", driver->source_file, driver->name);
+				validity_error(out, "%s: %s Cabinet must default to Upright\n", driver->source_file, driver->name);
 				error = TRUE;
 			}
 
@@ -924,21 +1082,21 @@ static int validate_inputs(int drivnum, const machine_config *drv, input_port_en
 			if (last_dipname_entry->name == demo_sounds && strindex == INPUT_STRING_On &&
 				last_dipname_entry->default_value != inp->default_value)
 			{
-				mame_printf_error("%s: %s Demo Sounds must default to On\n", driver->source_file, driver->name);
+				validity_error(out, "%s: %s Demo Sounds must default to On\n", driver->source_file, driver->name);
 				error = TRUE;
 			}
 
 			/* check for bad flip screen options */
 			if (last_dipname_entry->name == flip_screen && (strindex == INPUT_STRING_Yes || strindex == INPUT_STRING_No))
 			{
-				mame_printf_error("%s: %s has wrong Flip Screen option %s (must be Off/On)\n", driver->source_file, driver->name, inp->name);
+				validity_error(out, "%s: %s has wrong Flip Screen option %s (must be Off/On)\n", driver->source_file, driver->name, inp->name);
 				error = TRUE;
 			}
 
 			/* check for bad demo sounds options */
 			if (last_dipname_entry->name == demo_sounds && (strindex == INPUT_STRING_Yes || strindex == INPUT_STRING_No))
 			{
-				mame_printf_error("%s: %s has wrong Demo Sounds option %s (must be Off/On)\n", driver->source_file, driver->name, inp->name);
+				validity_error(out, "%s: %s has wrong Demo Sounds option %s (must be Off/On)\n", driver->source_file, driver->name, inp->name);
 				error = TRUE;
 			}
 		}
@@ -946,7 +1104,7 @@ static int validate_inputs(int drivnum, const machine_config *drv, input_port_en
 		/* analog ports must have a valid sensitivity */
 		if (port_type_is_analog(inp->type) && inp->analog.sensitivity == 0)
 		{
-			mame_printf_error("%s: %s has an analog port with zero sensitivity\n", driver->source_file, driver->name);
+			validity_error(out, "%s: %s has an analog port with zero sensitivity\n", driver->source_file, driver->name);
 			error = TRUE;
 		}
 
@@ -955,7 +1113,7 @@ static int validate_inputs(int drivnum, const machine_config *drv, input_port_en
 	}
 
 	if ( coin_error )
-		display_valid_coin_order(drivnum, *memory);
+		display_valid_coin_order(out, drivnum, *memory);
 
 	return error;
 }
@@ -968,7 +1126,7 @@ static int validate_inputs(int drivnum, const machine_config *drv, input_port_en
  *
  *************************************/
 
-static int validate_sound(int drivnum, const machine_config *drv)
+static int validate_sound(validity_output *out, int drivnum, const machine_config *drv)
 {
 	const game_driver *driver = drivers[drivnum];
 	int speaknum, sndnum;
@@ -983,7 +1141,7 @@ static int validate_sound(int drivnum, const machine_config *drv)
 		for (check = 0; check < MAX_SPEAKER && drv->speaker[check].tag; check++)
 			if (speaknum != check && drv->speaker[check].tag && !strcmp(drv->speaker[speaknum].tag, drv->speaker[check].tag))
 			{
-				mame_printf_error("%s: %s has multiple speakers tagged as '%s'\n", driver->source_file, driver->name, drv->speaker[speaknum].tag);
+				validity_error(out, "%s: %s has multiple speakers tagged as '%s'\n", driver->source_file, driver->name, drv->speaker[speaknum].tag);
 				error = TRUE;
 			}
 
@@ -991,7 +1149,7 @@ static int validate_sound(int drivnum, const machine_config *drv)
 		for (check = 0; check < MAX_SOUND && drv->sound[check].sound_type != SOUND_DUMMY; check++)
 			if (drv->sound[check].tag && !strcmp(drv->speaker[speaknum].tag, drv->sound[check].tag))
 			{
-				mame_printf_error("%s: %s has both a speaker and a sound chip tagged as '%s'\n", driver->source_file, driver->name, drv->speaker[speaknum].tag);
+				validity_error(out, "%s: %s has both a speaker and a sound chip tagged as '%s'\n", driver->source_file, driver->name, drv->speaker[speaknum].tag);
 				error = TRUE;
 			}
 	}
@@ -1021,7 +1179,7 @@ static int validate_sound(int drivnum, const machine_config *drv)
 				/* if we didn't find one, it's an error */
 				if (check >= MAX_SOUND || drv->sound[check].sound_type == SOUND_DUMMY)
 				{
-					mame_printf_error("%s: %s attempting to route sound to non-existant speaker '%s'\n", driver->source_file, driver->name, drv->sound[sndnum].route[routenum].target);
+					validity_error(out, "%s: %s attempting to route sound to non-existant speaker '%s'\n", driver->source_file, driver->name, drv->sound[sndnum].route[routenum].target);
 					error = TRUE;
 				}
 			}
@@ -1033,6 +1191,77 @@ static int validate_sound(int drivnum, const machine_config *drv)
 
 
 
+/*************************************
+ *
+ *  Validate a chunk of drivers
+ *  on a worker thread
+ *
+ *************************************/
+
+static void *validate_chunk(void *param)
+{
+	validity_chunk *chunk = param;
+	validity_output *out = &chunk->output;
+	input_port_entry *inputports;
+	int index;
+
+	/* each chunk expands input ports into its own buffer */
+	inputports = malloc_or_die(MAX_INPUT_PORTS * MAX_BITS_PER_PORT * sizeof(*inputports));
+
+	for (index = 0; index < chunk->count; index++)
+	{
+		int drivnum = chunk->drivlist[index];
+		const game_driver *driver = drivers[drivnum];
+		UINT32 region_length[REGION_MAX];
+		machine_config drv;
+
+		/* expand the machine driver */
+		chunk->phase_time[PHASE_EXPANSION] -= osd_ticks();
+		expand_machine_driver(driver->drv, &drv);
+		chunk->phase_time[PHASE_EXPANSION] += osd_ticks();
+
+		/* validate the driver entry */
+		chunk->phase_time[PHASE_DRIVER] -= osd_ticks();
+		chunk->error = validate_driver(out, drivnum, &drv) || chunk->error;
+		chunk->phase_time[PHASE_DRIVER] += osd_ticks();
+
+		/* validate the ROM information */
+		chunk->phase_time[PHASE_ROM] -= osd_ticks();
+		chunk->error = validate_roms(out, drivnum, &drv, region_length) || chunk->error;
+		chunk->phase_time[PHASE_ROM] += osd_ticks();
+
+		/* validate the CPU information */
+		chunk->phase_time[PHASE_CPU] -= osd_ticks();
+		chunk->error = validate_cpu(out, drivnum, &drv, region_length) || chunk->error;
+		chunk->phase_time[PHASE_CPU] += osd_ticks();
+
+		/* validate the display */
+		chunk->phase_time[PHASE_DISPLAY] -= osd_ticks();
+		chunk->error = validate_display(out, drivnum, &drv) || chunk->error;
+		chunk->phase_time[PHASE_DISPLAY] += osd_ticks();
+
+		/* validate the graphics decoding */
+		chunk->phase_time[PHASE_GFX] -= osd_ticks();
+		chunk->error = validate_gfx(out, drivnum, &drv, region_length) || chunk->error;
+		chunk->phase_time[PHASE_GFX] += osd_ticks();
+
+		/* validate input ports */
+		chunk->phase_time[PHASE_INPUT] -= osd_ticks();
+		chunk->error = validate_inputs(out, drivnum, &drv, &inputports) || chunk->error;
+		chunk->phase_time[PHASE_INPUT] += osd_ticks();
+
+		/* validate sounds and speakers */
+		chunk->phase_time[PHASE_SOUND] -= osd_ticks();
+		chunk->error = validate_sound(out, drivnum, &drv) || chunk->error;
+		chunk->phase_time[PHASE_SOUND] += osd_ticks();
+	}
+
+	free(inputports);
+	return NULL;
+}
+
+
+
 /*************************************
  *
  *  Master validity checker
@@ -1041,21 +1270,19 @@ static int validate_sound(int drivnum, const machine_config *drv)
 
 int mame_validitychecks(int game)
 {
+	osd_ticks_t phase_time[PHASE_COUNT] = { 0 };
 	osd_ticks_t prep = 0;
-	osd_ticks_t expansion = 0;
-	osd_ticks_t driver_checks = 0;
-	osd_ticks_t rom_checks = 0;
-	osd_ticks_t cpu_checks = 0;
-	osd_ticks_t gfx_checks = 0;
-	osd_ticks_t display_checks = 0;
-	osd_ticks_t input_checks = 0;
-	osd_ticks_t sound_checks = 0;
+	osd_ticks_t checks = 0;
 #ifdef MESS
 	osd_ticks_t mess_checks = 0;
 #endif
+	osd_ticks_t ticks_per_ms = osd_ticks_per_second() / 1000;
 
-	input_port_entry *inputports = NULL;
-	int drivnum;
+	validity_chunk *chunks;
+	osd_work_item **items;
+	osd_work_queue *queue;
+	int *drivlist;
+	int drivnum, chunknum, numchunks, count, phase, index;
 	int error = FALSE;
 	UINT8 a, b;
 
@@ -1079,92 +1306,103 @@ int mame_validitychecks(int game)
 
 	init_resource_tracking();
 	begin_resource_tracking();
-	osd_profiling_ticks();
 
 	/* prepare by pre-scanning all the drivers and adding their info to hash tables */
-	prep -= osd_profiling_ticks();
+	prep -= osd_ticks();
 	build_quarks();
-	prep += osd_profiling_ticks();
 
 	/* count drivers first */
 	for (drivnum = 0; drivers[drivnum]; drivnum++) ;
 	total_drivers = drivnum;
 
-	/* iterate over all drivers */
-	for (drivnum = 0; drivers[drivnum]; drivnum++)
+	/* gather the drivers we are going to check */
+	drivlist = malloc_or_die((total_drivers + 1) * sizeof(*drivlist));
+	for (drivnum = count = 0; drivers[drivnum]; drivnum++)
 	{
-		const game_driver *driver = drivers[drivnum];
-		UINT32 region_length[REGION_MAX];
-		machine_config drv;
-
 /* ASG -- trying this for a while to see if submission failures increase */
 #if 1
 		/* non-debug builds only care about games in the same driver */
-		if (game != -1 && strcmp(drivers[game]->source_file, driver->source_file) != 0)
+		if (game != -1 && strcmp(drivers[game]->source_file, drivers[drivnum]->source_file) != 0)
 			continue;
 #endif
+		drivlist[count++] = drivnum;
+	}
+	assign_input_owners(drivlist, count);
 
-		/* expand the machine driver */
-		expansion -= osd_profiling_ticks();
-		expand_machine_driver(driver->drv, &drv);
-		expansion += osd_profiling_ticks();
+	/* look up the clones here, where nobody else is using the driver LRU */
+	driver_clones = malloc_or_die((total_drivers + 1) * sizeof(*driver_clones));
+	memset(driver_clones, 0, (total_drivers + 1) * sizeof(*driver_clones));
+	for (index = 0; index < count; index++)
+	{
+		validity_clone *clone = &driver_clones[drivlist[index]];
 
-		/* validate the driver entry */
-		driver_checks -= osd_profiling_ticks();
-		error = validate_driver(drivnum, &drv) || error;
-		driver_checks += osd_profiling_ticks();
+		clone->parent = driver_get_clone(drivers[drivlist[index]]);
+		if (clone->parent != NULL)
+			clone->grandparent = driver_get_clone(clone->parent);
+	}
+	prep += osd_ticks();
 
-		/* validate the ROM information */
-		rom_checks -= osd_profiling_ticks();
-		error = validate_roms(drivnum, &drv, region_length) || error;
-		rom_checks += osd_profiling_ticks();
+	/* split the drivers into chunks and hand them to the workers */
+	checks -= osd_ticks();
+	numchunks = (count + DRIVERS_PER_CHUNK - 1) / DRIVERS_PER_CHUNK;
+	chunks = malloc_or_die((numchunks + 1) * sizeof(*chunks));
+	items = malloc_or_die((numchunks + 1) * sizeof(*items));
+	memset(chunks, 0, (numchunks + 1) * sizeof(*chunks));
+	queue = osd_work_queue_alloc(WORK_QUEUE_FLAG_MULTI);
 
-		/* validate the CPU information */
-		cpu_checks -= osd_profiling_ticks();
-		error = validate_cpu(drivnum, &drv, region_length) || error;
-		cpu_checks += osd_profiling_ticks();
+	for (chunknum = 0; chunknum < numchunks; chunknum++)
+	{
+		validity_chunk *chunk = &chunks[chunknum];
 
-		/* validate the display */
-		display_checks -= osd_profiling_ticks();
-		error = validate_display(drivnum, &drv) || error;
-		display_checks += osd_profiling_ticks();
+		chunk->drivlist = &drivlist[chunknum * DRIVERS_PER_CHUNK];
+		chunk->count = MIN(DRIVERS_PER_CHUNK, count - chunknum * DRIVERS_PER_CHUNK);
 
-		/* validate the graphics decoding */
-		gfx_checks -= osd_profiling_ticks();
-		error = validate_gfx(drivnum, &drv, region_length) || error;
-		gfx_checks += osd_profiling_ticks();
+		/* if we can't queue the item, just do the work here */
+		items[chunknum] = (queue != NULL) ? osd_work_item_queue(queue, validate_chunk, chunk) : NULL;
+		if (items[chunknum] == NULL)
+			validate_chunk(chunk);
+	}
 
-		/* validate input ports */
-		input_checks -= osd_profiling_ticks();
-		error = validate_inputs(drivnum, &drv, &inputports) || error;
-		input_checks += osd_profiling_ticks();
+	/* collect the results in driver order */
+	for (chunknum = 0; chunknum < numchunks; chunknum++)
+	{
+		validity_chunk *chunk = &chunks[chunknum];
 
-		/* validate sounds and speakers */
-		sound_checks -= osd_profiling_ticks();
-		error = validate_sound(drivnum, &drv) || error;
-		sound_checks += osd_profiling_ticks();
+		if (items[chunknum] != NULL)
+		{
+			while (!osd_work_item_wait(items[chunknum], osd_ticks_per_second())) ;
+			osd_work_item_release(items[chunknum]);
+		}
+
+		validity_flush(&chunk->output);
+		error = chunk->error || error;
+		for (phase = 0; phase < PHASE_COUNT; phase++)
+			phase_time[phase] += chunk->phase_time[phase];
 	}
 
+	if (queue != NULL)
+		osd_work_queue_free(queue);
+	free(items);
+	free(chunks);
+	free(driver_clones);
+	driver_clones = NULL;
+	free(drivlist);
+	checks += osd_ticks();
+
 #ifdef MESS
-	mess_checks -= osd_profiling_ticks();
+	mess_checks -= osd_ticks();
 	if (mess_validitychecks())
 		error = TRUE;
-	mess_checks += osd_profiling_ticks();
+	mess_checks += osd_ticks();
 #endif /* MESS */
 
-#if (REPORT_TIMES)
-	mame_printf_info("Prep:      %8dm\n", (int)(prep / 1000000));
-	mame_printf_info("Expansion: %8dm\n", (int)(expansion / 1000000));
-	mame_printf_info("Driver:    %8dm\n", (int)(driver_checks / 1000000));
-	mame_printf_info("ROM:       %8dm\n", (int)(rom_checks / 1000000));
-	mame_printf_info("CPU:       %8dm\n", (int)(cpu_checks / 1000000));
-	mame_printf_info("Display:   %8dm\n", (int)(display_checks / 1000000));
-	mame_printf_info("Graphics:  %8dm\n", (int)(gfx_checks / 1000000));
-	mame_printf_info("Input:     %8dm\n", (int)(input_checks / 1000000));
-	mame_printf_info("Sound:     %8dm\n", (int)(sound_checks / 1000000));
+	/* report where the time went; per-check phases are summed across all workers */
+	mame_printf_debug("Prep:      %8dms\n", (int)(prep / ticks_per_ms));
+	for (phase = 0; phase < PHASE_COUNT; phase++)
+		mame_printf_debug("%-10s %8dms\n", phase_name[phase], (int)(phase_time[phase] / ticks_per_ms));
+	mame_printf_debug("Checks:    %8dms (elapsed)\n", (int)(checks / ticks_per_ms));
 #ifdef MESS
-	mame_printf_info("MESS:      %8dm\n", (int)(mess_checks / 1000000));
-#endif
+	mame_printf_debug("MESS:      %8dms\n", (int)(mess_checks / ticks_per_ms));
 #endif
 
 	end_resource_tracking();
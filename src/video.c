@@ -36,12 +36,59 @@
    routines don't clip at boundaries of the bitmap. */
 #define BITMAP_SAFETY				16
 
+/* number of movie frames that can be in flight at once */
+#define MOVIE_JOBS					4
+
+/* movie file formats */
+#define MOVIE_FORMAT_MNG			0
+#define MOVIE_FORMAT_RAW			1
+
+/*
+    Raw movies are meant to be mapped into memory by post-processing tools.
+    Every field is a UINT32 in the byte order of the recording machine, so
+    the magic number doubles as a byte order mark. The file starts with:
+
+        magic ('MRAW'), version, width, height, refresh rate in millihertz,
+        sample rate, channels, reserved
+
+    followed by one record per frame:
+
+        tag ('FRAM'), frame number, first row, row count, bytes per row,
+        sound samples, index of the first sample, payload bytes
+
+    The payload is the changed rows as 32-bit xRGB pixels, followed by the
+    sound generated since the previous frame as interleaved stereo INT16s.
+    Rows outside the changed range are the same as in the previous frame.
+*/
+#define MOVIE_RAW_MAGIC				0x4d524157
+#define MOVIE_RAW_VERSION			1
+#define MOVIE_RAW_FRAME				0x4652414d
+
 
 
 /***************************************************************************
     TYPE DEFINITIONS
 ***************************************************************************/
 
+typedef struct _movie_job movie_job;
+struct _movie_job
+{
+	mame_bitmap *		bitmap;					/* frame to write */
+	int					first;					/* TRUE if this frame starts the movie */
+	int					number;					/* frame number within the movie */
+	int					first_row;				/* first row changed since the previous frame */
+	int					rows;					/* number of changed rows */
+	INT16 *				sound;					/* sound generated since the previous frame */
+	int					samples;				/* number of stereo samples in the sound buffer */
+	int					sound_alloc;			/* number of stereo samples allocated */
+	UINT32				sound_position;			/* index of the first sample in the movie */
+	mng_frame			mng;					/* compressed frame */
+	osd_ticks_t			compress_ticks;			/* time spent compressing */
+	osd_work_item *		compress_item;			/* compression work */
+	osd_work_item *		write_item;				/* write work, which follows the compression */
+};
+
+
 typedef struct _internal_screen_info internal_screen_info;
 struct _internal_screen_info
 {
@@ -68,6 +115,7 @@ int vector_updates = 0;
 
 /* main bitmap to render to */
 static int skipping_this_frame;
+static int fastforward_requested;
 static internal_screen_info scrinfo[MAX_SCREENS];
 
 /* speed computation */
@@ -81,8 +129,29 @@ static performance_info performance;
 static render_target *snap_target;
 static mame_bitmap *snap_bitmap;
 static mame_file *movie_file;
+static int movie_format;
 static int movie_frame;
 
+/* movie frames are compressed on any free processor, then written in order on an I/O thread */
+static osd_work_queue *movie_compress_queue;
+static osd_work_queue *movie_queue;
+static movie_job movie_jobs[MOVIE_JOBS];
+static int movie_curjob;
+
+/* sound generated since the last movie frame */
+static INT16 *movie_sound;
+static int movie_samples;
+static int movie_sound_alloc;
+static UINT32 movie_sound_position;
+
+/* movie pipeline statistics */
+static osd_ticks_t movie_main_ticks;
+static osd_ticks_t movie_wait_ticks;
+static osd_ticks_t movie_compress_ticks;
+static osd_ticks_t movie_write_ticks;
+static UINT64 movie_rows_stored;
+static UINT64 movie_rows_total;
+
 /* crosshair bits */
 static mame_bitmap *crosshair_bitmap[MAX_PLAYERS];
 static render_texture *crosshair_texture[MAX_PLAYERS];
@@ -105,6 +174,8 @@ static void decode_graphics(const gfx_decode *gfxdecodeinfo);
 static void init_buffered_spriteram(void);
 static void recompute_fps(int skipped_it);
 static void movie_record_frame(int scrnum);
+static void movie_wait_job(movie_job *job);
+static void movie_wait(void);
 static void crosshair_init(void);
 static void crosshair_render(void);
 static void crosshair_free(void);
@@ -128,6 +199,7 @@ int video_init(running_machine *machine)
 
 	/* reset globals */
 	memset(scrinfo, 0, sizeof(scrinfo));
+	fastforward_requested = FALSE;
 
 	/* configure all of the screens */
 	for (scrnum = 0; scrnum < MAX_SCREENS; scrnum++)
@@ -189,6 +261,17 @@ int video_init(running_machine *machine)
 		render_target_set_layer_config(snap_target, 0);
 	}
 
+	/* snapshots deflate large images on the PNG code's own workers */
+	png_init(machine);
+
+	/* create queues for compressing and writing movie frames */
+	movie_compress_queue = osd_work_queue_alloc(WORK_QUEUE_FLAG_MULTI);
+	movie_queue = osd_work_queue_alloc(WORK_QUEUE_FLAG_IO);
+	memset(movie_jobs, 0, sizeof(movie_jobs));
+	movie_curjob = 0;
+	movie_sound = NULL;
+	movie_samples = movie_sound_alloc = 0;
+
 	/* create crosshairs */
 	crosshair_init();
 
@@ -210,6 +293,25 @@ static void video_exit(running_machine *machine)
 
 	/* stop recording any movie */
 	video_movie_end_recording();
+	if (movie_queue != NULL)
+		osd_work_queue_free(movie_queue);
+	movie_queue = NULL;
+	if (movie_compress_queue != NULL)
+		osd_work_queue_free(movie_compress_queue);
+	movie_compress_queue = NULL;
+	for (i = 0; i < ARRAY_LENGTH(movie_jobs); i++)
+	{
+		movie_job *job = &movie_jobs[i];
+		if (job->bitmap != NULL)
+			bitmap_free(job->bitmap);
+		if (job->sound != NULL)
+			free(job->sound);
+		mng_free_frame(&job->mng);
+		memset(job, 0, sizeof(*job));
+	}
+	if (movie_sound != NULL)
+		free(movie_sound);
+	movie_sound = NULL;
 
 	/* free all the graphics elements */
 	for (i = 0; i < MAX_GFX_ELEMENTS; i++)
@@ -584,6 +686,7 @@ void video_screen_update_partial(int scrnum, int scanline)
 		LOG_PARTIAL_UPDATES(("updating %d-%d\n", clip.min_y, clip.max_y));
 		flags = (*Machine->drv->video_update)(Machine, scrnum, screen->bitmap[screen->curbitmap], &clip);
 		performance.partial_updates_this_frame++;
+		profiler_partial_update();
 		profiler_mark(PROFILER_END);
 
 		/* if we modified the bitmap, we have to commit */
@@ -752,6 +855,30 @@ int video_skip_this_frame(void)
 }
 
 
+/*-------------------------------------------------
+    video_set_fastforward - request that the
+    machine run unthrottled, skipping all
+    rendering; used by devices such as the
+    cassette to accelerate slow loaders
+-------------------------------------------------*/
+
+void video_set_fastforward(int enable)
+{
+	fastforward_requested = enable;
+}
+
+
+/*-------------------------------------------------
+    video_get_fastforward - return TRUE if the
+    core has requested an unthrottled run
+-------------------------------------------------*/
+
+int video_get_fastforward(void)
+{
+	return fastforward_requested;
+}
+
+
 /*-------------------------------------------------
     video_frame_update - handle frameskipping and
     UI, plus updating the screen during normal
@@ -818,6 +945,10 @@ void video_frame_update(void)
 	/* call the OSD to update */
 	skipping_this_frame = osd_update(mame_timer_get_time());
 
+	/* a core fast forward request overrides the OSD's frameskipping */
+	if (fastforward_requested)
+		skipping_this_frame = TRUE;
+
 	/* empty the containers */
 	for (scrnum = 0; scrnum < MAX_SCREENS; scrnum++)
 		if (Machine->drv->screen[scrnum].tag != NULL)
@@ -861,21 +992,22 @@ const performance_info *mame_get_performance_info(void)
 ***************************************************************************/
 
 /*-------------------------------------------------
-    save_frame_with - save a frame with a
-    given handler for screenshots and movies
+    render_frame_to - render a screen through the
+    snapshot target into a bitmap, (re)allocating
+    it if it isn't the right size
 -------------------------------------------------*/
 
-static void save_frame_with(mame_file *fp, int scrnum, png_error (*write_handler)(mame_file *, mame_bitmap *))
+static mame_bitmap *render_frame_to(int scrnum, mame_bitmap **bitmapptr)
 {
 	const render_primitive_list *primlist;
+	mame_bitmap *bitmap = *bitmapptr;
 	INT32 width, height;
-	int error;
 
 	assert(scrnum >= 0 && scrnum < MAX_SCREENS);
 
 	/* if no screens, do nothing */
 	if (snap_target == NULL)
-		return;
+		return NULL;
 
 	/* select the appropriate view in our dummy target */
 	render_target_set_view(snap_target, scrnum);
@@ -885,22 +1017,35 @@ static void save_frame_with(mame_file *fp, int scrnum, png_error (*write_handler
 	render_target_set_bounds(snap_target, width, height, 0);
 
 	/* if we don't have a bitmap, or if it's not the right size, allocate a new one */
-	if (snap_bitmap == NULL || width != snap_bitmap->width || height != snap_bitmap->height)
+	if (bitmap == NULL || width != bitmap->width || height != bitmap->height)
 	{
-		if (snap_bitmap != NULL)
-			bitmap_free(snap_bitmap);
-		snap_bitmap = bitmap_alloc_format(width, height, BITMAP_FORMAT_RGB32);
-		assert(snap_bitmap != NULL);
+		if (bitmap != NULL)
+			bitmap_free(bitmap);
+		bitmap = *bitmapptr = bitmap_alloc_format(width, height, BITMAP_FORMAT_RGB32);
+		assert(bitmap != NULL);
 	}
 
 	/* render the screen there */
 	primlist = render_target_get_primitives(snap_target);
 	osd_lock_acquire(primlist->lock);
-	rgb888_draw_primitives(primlist->head, snap_bitmap->base, width, height, snap_bitmap->rowpixels);
+	rgb888_draw_primitives(primlist->head, bitmap->base, width, height, bitmap->rowpixels);
 	osd_lock_release(primlist->lock);
+	return bitmap;
+}
+
+
+/*-------------------------------------------------
+    save_frame_with - save a frame with a
+    given handler for screenshots
+-------------------------------------------------*/
+
+static void save_frame_with(mame_file *fp, int scrnum, png_error (*write_handler)(mame_file *, mame_bitmap *))
+{
+	int error;
 
-	/* now do the actual work */
-	error = (*write_handler)(fp, snap_bitmap);
+	/* render the screen, then do the actual work */
+	if (render_frame_to(scrnum, &snap_bitmap) != NULL)
+		error = (*write_handler)(fp, snap_bitmap);
 }
 
 
@@ -911,7 +1056,7 @@ static void save_frame_with(mame_file *fp, int scrnum, png_error (*write_handler
 
 void video_screen_save_snapshot(mame_file *fp, int scrnum)
 {
-	save_frame_with(fp, scrnum, png_write_bitmap);
+	save_frame_with(fp, scrnum, options.snap_uncompressed ? png_write_bitmap_uncompressed : png_write_bitmap);
 }
 
 
@@ -976,7 +1121,7 @@ void video_save_active_screen_snapshots(void)
 
 
 /***************************************************************************
-    MNG MOVIE RECORDING
+    MOVIE RECORDING
 ***************************************************************************/
 
 /*-------------------------------------------------
@@ -993,7 +1138,8 @@ int video_is_movie_active(void)
 
 /*-------------------------------------------------
     video_movie_begin_recording - begin recording
-    of a MNG movie
+    of a movie; names ending in .raw record raw
+    video and sound, everything else is a MNG
 -------------------------------------------------*/
 
 void video_movie_begin_recording(const char *name)
@@ -1001,6 +1147,7 @@ void video_movie_begin_recording(const char *name)
 	mame_file_error filerr;
 
 	/* close any existing movie file */
+	movie_wait();
 	if (movie_file != NULL)
 		mame_fclose(movie_file);
 
@@ -1010,13 +1157,22 @@ void video_movie_begin_recording(const char *name)
 	else
 		filerr = mame_fopen_next(SEARCHPATH_MOVIE, "mng", &movie_file);
 
+	/* pick the format from the extension */
+	movie_format = MOVIE_FORMAT_MNG;
+	if (name != NULL && strlen(name) >= 4 && mame_stricmp(name + strlen(name) - 4, ".raw") == 0)
+		movie_format = MOVIE_FORMAT_RAW;
+
 	movie_frame = 0;
+	movie_samples = 0;
+	movie_sound_position = 0;
+	movie_main_ticks = movie_wait_ticks = movie_compress_ticks = movie_write_ticks = 0;
+	movie_rows_stored = movie_rows_total = 0;
 }
 
 
 /*-------------------------------------------------
     video_movie_end_recording - stop recording of
-    a MNG movie
+    a movie
 -------------------------------------------------*/
 
 void video_movie_end_recording(void)
@@ -1024,7 +1180,21 @@ void video_movie_end_recording(void)
 	/* close the file if it exists */
 	if (movie_file != NULL)
 	{
-		mng_capture_stop(movie_file);
+		osd_ticks_t tps = osd_ticks_per_second();
+
+		movie_wait();
+		if (movie_format == MOVIE_FORMAT_MNG)
+			mng_capture_stop(movie_file);
+
+		/* report how well writing overlapped with emulation */
+		if (movie_frame != 0)
+			mame_printf_info("Movie: %d frames, %.2f ms/frame on the emulation thread (%.2f ms waiting), %.2f ms/frame compressing and %.2f ms/frame writing in the background, %d%% of rows stored\n",
+					movie_frame,
+					(double)movie_main_ticks * 1000.0 / (double)tps / (double)movie_frame,
+					(double)movie_wait_ticks * 1000.0 / (double)tps / (double)movie_frame,
+					(double)movie_compress_ticks * 1000.0 / (double)tps / (double)movie_frame,
+					(double)movie_write_ticks * 1000.0 / (double)tps / (double)movie_frame,
+					(movie_rows_total != 0) ? (int)(movie_rows_stored * 100 / movie_rows_total) : 0);
 		mame_fclose(movie_file);
 		movie_file = NULL;
 		movie_frame = 0;
@@ -1032,6 +1202,218 @@ void video_movie_end_recording(void)
 }
 
 
+/*-------------------------------------------------
+    video_movie_add_sound - add a frame's worth
+    of interleaved stereo sound to the movie
+-------------------------------------------------*/
+
+void video_movie_add_sound(const INT16 *buffer, int samples)
+{
+	/* only raw movies have anywhere to put it */
+	if (movie_file == NULL || movie_format != MOVIE_FORMAT_RAW)
+		return;
+
+	/* expand the buffer if we need to */
+	if (movie_samples + samples > movie_sound_alloc)
+	{
+		INT16 *newsound;
+
+		movie_sound_alloc = (movie_samples + samples) * 2;
+		newsound = malloc_or_die(movie_sound_alloc * 2 * sizeof(*newsound));
+		if (movie_sound != NULL)
+		{
+			memcpy(newsound, movie_sound, movie_samples * 2 * sizeof(*newsound));
+			free(movie_sound);
+		}
+		movie_sound = newsound;
+	}
+
+	/* append the samples */
+	memcpy(movie_sound + movie_samples * 2, buffer, samples * 2 * sizeof(*buffer));
+	movie_samples += samples;
+}
+
+
+/*-------------------------------------------------
+    movie_find_changed_rows - determine the range
+    of rows that differ from the previous frame
+-------------------------------------------------*/
+
+static void movie_find_changed_rows(movie_job *job, const movie_job *prev)
+{
+	mame_bitmap *bitmap = job->bitmap;
+	mame_bitmap *prevbitmap = prev->bitmap;
+	int rowbytes = bitmap->width * sizeof(UINT32);
+	int first, last;
+
+	/* the first frame, or one that changes size, is stored whole */
+	if (job->first || prevbitmap == NULL || prevbitmap->width != bitmap->width || prevbitmap->height != bitmap->height)
+	{
+		job->first_row = 0;
+		job->rows = bitmap->height;
+		return;
+	}
+
+	/* trim unchanged rows from the top and bottom */
+	for (first = 0; first < bitmap->height; first++)
+		if (memcmp(BITMAP_ADDR32(bitmap, first, 0), BITMAP_ADDR32(prevbitmap, first, 0), rowbytes) != 0)
+			break;
+	if (first == bitmap->height)
+	{
+		job->first_row = 0;
+		job->rows = 0;
+		return;
+	}
+	for (last = bitmap->height - 1; last > first; last--)
+		if (memcmp(BITMAP_ADDR32(bitmap, last, 0), BITMAP_ADDR32(prevbitmap, last, 0), rowbytes) != 0)
+			break;
+	job->first_row = first;
+	job->rows = last + 1 - first;
+}
+
+
+/*-------------------------------------------------
+    movie_compress_frame - work item that
+    compresses a MNG movie frame
+-------------------------------------------------*/
+
+static void *movie_compress_frame(void *param)
+{
+	movie_job *job = param;
+	osd_ticks_t start = osd_ticks();
+	int first_row = job->first_row;
+	int rows = job->rows;
+
+	/* MNG needs an image for every frame to keep the timing */
+	if (rows == 0)
+	{
+		first_row = 0;
+		rows = 1;
+	}
+	mng_compress_frame(&job->mng, job->bitmap, first_row, rows, !job->first);
+
+	job->compress_ticks = osd_ticks() - start;
+	return NULL;
+}
+
+
+/*-------------------------------------------------
+    movie_write_raw_frame - write a frame of a
+    raw movie
+-------------------------------------------------*/
+
+static void movie_write_raw_frame(movie_job *job)
+{
+	UINT32 rowbytes = job->bitmap->width * sizeof(UINT32);
+	UINT32 header[8];
+	int y;
+
+	/* the file header precedes the first frame */
+	if (job->first)
+	{
+		header[0] = MOVIE_RAW_MAGIC;
+		header[1] = MOVIE_RAW_VERSION;
+		header[2] = job->bitmap->width;
+		header[3] = job->bitmap->height;
+		header[4] = (UINT32)(Machine->screen[0].refresh * 1000.0);
+		header[5] = Machine->sample_rate;
+		header[6] = 2;
+		header[7] = 0;
+		mame_fwrite(movie_file, header, sizeof(header));
+	}
+
+	/* then the frame record */
+	header[0] = MOVIE_RAW_FRAME;
+	header[1] = job->number;
+	header[2] = job->first_row;
+	header[3] = job->rows;
+	header[4] = rowbytes;
+	header[5] = job->samples;
+	header[6] = job->sound_position;
+	header[7] = job->rows * rowbytes + job->samples * 2 * sizeof(INT16);
+	mame_fwrite(movie_file, header, sizeof(header));
+
+	/* and its payload */
+	for (y = job->first_row; y < job->first_row + job->rows; y++)
+		mame_fwrite(movie_file, BITMAP_ADDR32(job->bitmap, y, 0), rowbytes);
+	if (job->samples > 0)
+		mame_fwrite(movie_file, job->sound, job->samples * 2 * sizeof(INT16));
+}
+
+
+/*-------------------------------------------------
+    movie_write_frame - work item that writes a
+    movie frame once it has been compressed
+-------------------------------------------------*/
+
+static void *movie_write_frame(void *param)
+{
+	movie_job *job = param;
+	osd_ticks_t start;
+
+	/* frames are queued here in order, but may finish compressing out of order */
+	if (job->compress_item != NULL)
+		while (!osd_work_item_wait(job->compress_item, osd_ticks_per_second())) ;
+
+	start = osd_ticks();
+	if (movie_format == MOVIE_FORMAT_MNG)
+	{
+		if (job->first)
+			mng_capture_start(movie_file, job->bitmap);
+		mng_write_frame(movie_file, &job->mng);
+	}
+	else
+		movie_write_raw_frame(job);
+
+	/* only this thread updates the background statistics */
+	movie_write_ticks += osd_ticks() - start;
+	movie_compress_ticks += job->compress_ticks;
+	movie_rows_stored += job->rows;
+	movie_rows_total += job->bitmap->height;
+	return NULL;
+}
+
+
+/*-------------------------------------------------
+    movie_wait_job - wait for a job to finish
+    writing its frame
+-------------------------------------------------*/
+
+static void movie_wait_job(movie_job *job)
+{
+	if (job->write_item != NULL)
+	{
+		osd_ticks_t start = osd_ticks();
+
+		while (!osd_work_item_wait(job->write_item, osd_ticks_per_second())) ;
+		osd_work_item_release(job->write_item);
+		job->write_item = NULL;
+		movie_wait_ticks += osd_ticks() - start;
+	}
+
+	/* writing waited for the compression, so it is done too */
+	if (job->compress_item != NULL)
+	{
+		osd_work_item_release(job->compress_item);
+		job->compress_item = NULL;
+	}
+}
+
+
+/*-------------------------------------------------
+    movie_wait - wait for all frames in flight to
+    be written
+-------------------------------------------------*/
+
+static void movie_wait(void)
+{
+	int i;
+
+	for (i = 0; i < MOVIE_JOBS; i++)
+		movie_wait_job(&movie_jobs[(movie_curjob + i) % MOVIE_JOBS]);
+}
+
+
 /*-------------------------------------------------
     movie_record_frame - record a frame of a
     movie
@@ -1042,13 +1424,49 @@ static void movie_record_frame(int scrnum)
 	/* only record if we have a file */
 	if (movie_file != NULL)
 	{
+		movie_job *job = &movie_jobs[movie_curjob];
+		osd_ticks_t start = osd_ticks();
+
 		profiler_mark(PROFILER_MOVIE_REC);
 
-		/* track frames */
-		if (movie_frame++ == 0)
-			save_frame_with(movie_file, scrnum, mng_capture_start);
-		save_frame_with(movie_file, scrnum, mng_capture_frame);
+		/* this is the oldest job, so it is likely already done */
+		movie_wait_job(job);
+		if (render_frame_to(scrnum, &job->bitmap) != NULL)
+		{
+			INT16 *sound = job->sound;
+			int sound_alloc = job->sound_alloc;
+
+			/* only the rows that changed since the previous frame are stored */
+			job->number = movie_frame;
+			job->first = (movie_frame++ == 0);
+			movie_find_changed_rows(job, &movie_jobs[(movie_curjob + MOVIE_JOBS - 1) % MOVIE_JOBS]);
+
+			/* hand the sound since the previous frame to the job, and take its old buffer */
+			job->sound = movie_sound;
+			job->sound_alloc = movie_sound_alloc;
+			job->samples = movie_samples;
+			job->sound_position = movie_sound_position;
+			movie_sound_position += movie_samples;
+			movie_sound = sound;
+			movie_sound_alloc = sound_alloc;
+			movie_samples = 0;
+
+			/* compress on any free processor; raw frames are written as-is */
+			if (movie_format == MOVIE_FORMAT_MNG)
+			{
+				job->compress_item = (movie_compress_queue != NULL) ? osd_work_item_queue(movie_compress_queue, movie_compress_frame, job) : NULL;
+				if (job->compress_item == NULL)
+					movie_compress_frame(job);
+			}
+
+			/* the I/O queue runs its items in order, so frames are written in order */
+			job->write_item = (movie_queue != NULL) ? osd_work_item_queue(movie_queue, movie_write_frame, job) : NULL;
+			if (job->write_item == NULL)
+				movie_write_frame(job);
+			movie_curjob = (movie_curjob + 1) % MOVIE_JOBS;
+		}
 
+		movie_main_ticks += osd_ticks() - start;
 		profiler_mark(PROFILER_END);
 	}
 }
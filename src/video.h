@@ -94,6 +94,12 @@ void video_reset_partial_updates(void);
 /* are we skipping the current frame? */
 int video_skip_this_frame(void);
 
+/* request (or cancel) unthrottled running with rendering skipped */
+void video_set_fastforward(int enable);
+
+/* is an unthrottled run currently requested by the core? */
+int video_get_fastforward(void);
+
 /* update the screen, handling frame skipping and rendering */
 void video_frame_update(void);
 
@@ -139,6 +145,7 @@ void video_save_active_screen_snapshots(void);
 int video_is_movie_active(void);
 void video_movie_begin_recording(const char *name);
 void video_movie_end_recording(void);
+void video_movie_add_sound(const INT16 *buffer, int samples);
 
 
 /* ----- bitmap allocation ----- */
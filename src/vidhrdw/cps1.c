@@ -1563,26 +1563,44 @@ static void cps2_find_last_sprite(void)    /* Find the offset of last sprite */
 #undef DRAWSPRITE
 }
 
+#define CPS2_SPRITE_BATCH	256
+
 static void cps2_render_sprites(mame_bitmap *bitmap,const rectangle *cliprect,int *primasks)
 {
+	/* sprites are collected and handed to pdrawgfx_list() in batches */
 #define DRAWSPRITE(CODE,COLOR,FLIPX,FLIPY,SX,SY)									\
 {																					\
+	gfx_sprite *sprite = &list[count++];											\
+	sprite->gfx = Machine->gfx[2];													\
+	sprite->code = CODE;															\
+	sprite->color = COLOR;															\
 	if (flip_screen)																\
-		pdrawgfx(bitmap,Machine->gfx[2],											\
-				CODE,																\
-				COLOR,																\
-				!(FLIPX),!(FLIPY),													\
-				511-16-(SX),255-16-(SY),											\
-				cliprect,TRANSPARENCY_PEN,15,primasks[priority]);					\
+	{																				\
+		sprite->flipx = !(FLIPX);													\
+		sprite->flipy = !(FLIPY);													\
+		sprite->sx = 511-16-(SX);													\
+		sprite->sy = 255-16-(SY);													\
+	}																				\
 	else																			\
-		pdrawgfx(bitmap,Machine->gfx[2],											\
-				CODE,																\
-				COLOR,																\
-				FLIPX,FLIPY,														\
-				SX,SY,																\
-				cliprect,TRANSPARENCY_PEN,15,primasks[priority]);					\
+	{																				\
+		sprite->flipx = (FLIPX) ? 1 : 0;											\
+		sprite->flipy = (FLIPY) ? 1 : 0;											\
+		sprite->sx = SX;															\
+		sprite->sy = SY;															\
+	}																				\
+	sprite->scalex = sprite->scaley = 0x10000;										\
+	sprite->transparency = TRANSPARENCY_PEN;										\
+	sprite->transparent_color = 15;													\
+	sprite->priority_mask = primasks[priority];										\
+	if (count == CPS2_SPRITE_BATCH)													\
+	{																				\
+		pdrawgfx_list(bitmap,list,count,cliprect);									\
+		count = 0;																	\
+	}																				\
 }
 
+	static gfx_sprite list[CPS2_SPRITE_BATCH];
+	int count = 0;
 	int i;
 	UINT16 *base=cps2_buffered_obj;
 	int xoffs = 64-cps2_port(CPS2_OBJ_XOFFS);
@@ -1705,6 +1723,9 @@ static void cps2_render_sprites(mame_bitmap *bitmap,const rectangle *cliprect,in
 					(x+xoffs) & 0x3ff,(y+yoffs) & 0x3ff);
 		}
 	}
+
+	pdrawgfx_list(bitmap,list,count,cliprect);
+#undef DRAWSPRITE
 }
 
 
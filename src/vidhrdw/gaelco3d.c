@@ -28,11 +28,25 @@ UINT32 gaelco3d_texmask_size;
 #define IS_POLYEND(x)		(((x) ^ ((x) >> 1)) & 0x4000)
 
 
+typedef struct _poly_extra_data poly_extra_data;
+struct _poly_extra_data
+{
+	float ooz_dx, ooz_dy, ooz_base;
+	float uoz_dx, uoz_dy, uoz_base;
+	float voz_dx, voz_dy, voz_base;
+	float z0;
+	int color;
+	UINT32 tex;
+	int midx, midy;
+};
+
+
 static mame_bitmap *screenbits;
 static mame_bitmap *zbuffer;
 static UINT16 *palette;
 static UINT32 *polydata_buffer;
 static UINT32 polydata_count;
+static poly_manager *poly;
 
 static int polygons;
 static int lastscan;
@@ -45,6 +59,13 @@ static int lastscan;
  *
  *************************************/
 
+static void gaelco3d_exit(running_machine *machine)
+{
+	poly_free(poly);
+	poly = NULL;
+}
+
+
 VIDEO_START( gaelco3d )
 {
 	screenbits = auto_bitmap_alloc(Machine->screen[0].width, Machine->screen[0].height);
@@ -54,6 +75,9 @@ VIDEO_START( gaelco3d )
 	palette = auto_malloc(32768 * sizeof(palette[0]));
 	polydata_buffer = auto_malloc(MAX_POLYDATA * sizeof(polydata_buffer[0]));
 
+	poly = poly_alloc(MAX_POLYGONS, sizeof(poly_extra_data), 0);
+	add_exit_callback(machine, gaelco3d_exit);
+
 	return 0;
 }
 
@@ -96,6 +120,225 @@ static float dsp_to_float(UINT32 val)
 }
 
 
+/*************************************
+ *
+ *  Scanline renderers
+ *
+ *************************************/
+
+static void render_noz_noperspective(void *destbase, INT32 scanline, const struct poly_scanline *extent, const INT64 *dp, const void *extradata, int threadid)
+{
+	const poly_extra_data *extra = extradata;
+	const struct poly_scanline *scan = extent;
+	offs_t endmask = gaelco3d_texture_size - 1;
+	UINT16 *dest = BITMAP_ADDR16((mame_bitmap *)destbase, extra->midy - scanline, extra->midx);
+	UINT16 *zbuf = BITMAP_ADDR16(zbuffer, extra->midy - scanline, 0);
+	int color = extra->color;
+	UINT32 tex = extra->tex;
+	int pixeloffs, zbufval, u, v, x;
+#if (BILINEAR_FILTER)
+	int paldata, r, g, b, f, tf;
+#endif
+	float zbase = 1.0f / extra->ooz_base;
+	float uoz_step = extra->uoz_dx * zbase;
+	float voz_step = extra->voz_dx * zbase;
+	float uoz = (extra->uoz_dy * scanline + scan->sx * extra->uoz_dx + extra->uoz_base) * zbase;
+	float voz = (extra->voz_dy * scanline + scan->sx * extra->voz_dx + extra->voz_base) * zbase;
+
+	zbufval = (int)(-extra->z0 * zbase);
+
+	for (x = scan->sx; x <= scan->ex; x++)
+	{
+#if (!BILINEAR_FILTER)
+		u = (int)(uoz + 0.5); v = (int)(voz + 0.5);
+		pixeloffs = (tex + v * 4096 + u) & endmask;
+		if (pixeloffs >= gaelco3d_texmask_size || !gaelco3d_texmask[pixeloffs])
+		{
+			dest[x] = palette[color | gaelco3d_texture[pixeloffs]];
+			zbuf[x] = zbufval;
+		}
+#else
+		u = (int)(uoz * 256.0); v = (int)(voz * 256.0);
+		pixeloffs = (tex + (v >> 8) * 4096 + (u >> 8)) & endmask;
+		if (pixeloffs >= gaelco3d_texmask_size || !gaelco3d_texmask[pixeloffs])
+		{
+			paldata = palette[color | gaelco3d_texture[pixeloffs]];
+			tf = f = (~u & 0xff) * (~v & 0xff);
+			r = (paldata & 0x7c00) * f; g = (paldata & 0x03e0) * f; b = (paldata & 0x001f) * f;
+
+			paldata = palette[color | gaelco3d_texture[pixeloffs + 1]];
+			tf += f = (u & 0xff) * (~v & 0xff);
+			r += (paldata & 0x7c00) * f; g += (paldata & 0x03e0) * f; b += (paldata & 0x001f) * f;
+
+			paldata = palette[color | gaelco3d_texture[pixeloffs + 4096]];
+			tf += f = (~u & 0xff) * (v & 0xff);
+			r += (paldata & 0x7c00) * f; g += (paldata & 0x03e0) * f; b += (paldata & 0x001f) * f;
+
+			paldata = palette[color | gaelco3d_texture[pixeloffs + 4097]];
+			f = 0x10000 - tf;
+			r += (paldata & 0x7c00) * f; g += (paldata & 0x03e0) * f; b += (paldata & 0x001f) * f;
+
+			dest[x] = ((r >> 16) & 0x7c00) | ((g >> 16) & 0x03e0) | (b >> 16);
+			zbuf[x] = zbufval;
+		}
+#endif
+		/* advance texture params to the next pixel */
+		uoz += uoz_step;
+		voz += voz_step;
+	}
+}
+
+
+static void render_normal(void *destbase, INT32 scanline, const struct poly_scanline *extent, const INT64 *dp, const void *extradata, int threadid)
+{
+	const poly_extra_data *extra = extradata;
+	const struct poly_scanline *scan = extent;
+	offs_t endmask = gaelco3d_texture_size - 1;
+	UINT16 *dest = BITMAP_ADDR16((mame_bitmap *)destbase, extra->midy - scanline, extra->midx);
+	UINT16 *zbuf = BITMAP_ADDR16(zbuffer, extra->midy - scanline, 0);
+	int color = extra->color;
+	UINT32 tex = extra->tex;
+	int pixeloffs, zbufval, u, v, x;
+#if (BILINEAR_FILTER)
+	int paldata, r, g, b, f, tf;
+#endif
+	float ooz_dx = extra->ooz_dx;
+	float uoz_dx = extra->uoz_dx;
+	float voz_dx = extra->voz_dx;
+	float z0 = extra->z0;
+	float ooz = extra->ooz_dy * scanline + scan->sx * ooz_dx + extra->ooz_base;
+	float uoz = extra->uoz_dy * scanline + scan->sx * uoz_dx + extra->uoz_base;
+	float voz = extra->voz_dy * scanline + scan->sx * voz_dx + extra->voz_base;
+
+	for (x = scan->sx; x <= scan->ex; x++)
+	{
+		if (ooz > 0)
+		{
+			/* compute Z and check the Z buffer value first */
+			float z = 1.0f / ooz;
+			zbufval = (int)(z0 * z);
+			if (zbufval < zbuf[x] || zbufval < 0)
+			{
+#if (!BILINEAR_FILTER)
+				u = (int)(uoz * z + 0.5); v = (int)(voz * z + 0.5);
+				pixeloffs = (tex + v * 4096 + u) & endmask;
+				if (pixeloffs >= gaelco3d_texmask_size || !gaelco3d_texmask[pixeloffs])
+				{
+					dest[x] = palette[color | gaelco3d_texture[pixeloffs]];
+					zbuf[x] = (zbufval < 0) ? -zbufval : zbufval;
+				}
+#else
+				u = (int)(uoz * z * 256.0); v = (int)(voz * z * 256.0);
+				pixeloffs = (tex + (v >> 8) * 4096 + (u >> 8)) & endmask;
+				if (pixeloffs >= gaelco3d_texmask_size || !gaelco3d_texmask[pixeloffs])
+				{
+					paldata = palette[color | gaelco3d_texture[pixeloffs]];
+					tf = f = (~u & 0xff) * (~v & 0xff);
+					r = (paldata & 0x7c00) * f; g = (paldata & 0x03e0) * f; b = (paldata & 0x001f) * f;
+
+					paldata = palette[color | gaelco3d_texture[pixeloffs + 1]];
+					tf += f = (u & 0xff) * (~v & 0xff);
+					r += (paldata & 0x7c00) * f; g += (paldata & 0x03e0) * f; b += (paldata & 0x001f) * f;
+
+					paldata = palette[color | gaelco3d_texture[pixeloffs + 4096]];
+					tf += f = (~u & 0xff) * (v & 0xff);
+					r += (paldata & 0x7c00) * f; g += (paldata & 0x03e0) * f; b += (paldata & 0x001f) * f;
+
+					paldata = palette[color | gaelco3d_texture[pixeloffs + 4097]];
+					f = 0x10000 - tf;
+					r += (paldata & 0x7c00) * f; g += (paldata & 0x03e0) * f; b += (paldata & 0x001f) * f;
+
+					dest[x] = ((r >> 16) & 0x7c00) | ((g >> 16) & 0x03e0) | (b >> 16);
+					zbuf[x] = (zbufval < 0) ? -zbufval : zbufval;
+				}
+#endif
+			}
+		}
+
+		/* advance texture params to the next pixel */
+		ooz += ooz_dx;
+		uoz += uoz_dx;
+		voz += voz_dx;
+	}
+}
+
+
+static void render_alphablend(void *destbase, INT32 scanline, const struct poly_scanline *extent, const INT64 *dp, const void *extradata, int threadid)
+{
+	const poly_extra_data *extra = extradata;
+	const struct poly_scanline *scan = extent;
+	offs_t endmask = gaelco3d_texture_size - 1;
+	UINT16 *dest = BITMAP_ADDR16((mame_bitmap *)destbase, extra->midy - scanline, extra->midx);
+	UINT16 *zbuf = BITMAP_ADDR16(zbuffer, extra->midy - scanline, 0);
+	int color = extra->color;
+	UINT32 tex = extra->tex;
+	int pixeloffs, zbufval, u, v, x;
+#if (BILINEAR_FILTER)
+	int paldata, r, g, b, f, tf;
+#endif
+	float ooz_dx = extra->ooz_dx;
+	float uoz_dx = extra->uoz_dx;
+	float voz_dx = extra->voz_dx;
+	float z0 = extra->z0;
+	float ooz = extra->ooz_dy * scanline + scan->sx * ooz_dx + extra->ooz_base;
+	float uoz = extra->uoz_dy * scanline + scan->sx * uoz_dx + extra->uoz_base;
+	float voz = extra->voz_dy * scanline + scan->sx * voz_dx + extra->voz_base;
+
+	for (x = scan->sx; x <= scan->ex; x++)
+	{
+		if (ooz > 0)
+		{
+			/* compute Z and check the Z buffer value first */
+			float z = 1.0f / ooz;
+			zbufval = (int)(z0 * z);
+			if (zbufval < zbuf[x] || zbufval < 0)
+			{
+#if (!BILINEAR_FILTER)
+				u = (int)(uoz * z + 0.5); v = (int)(voz * z + 0.5);
+				pixeloffs = (tex + v * 4096 + u) & endmask;
+				if (pixeloffs >= gaelco3d_texmask_size || !gaelco3d_texmask[pixeloffs])
+				{
+					dest[x] = ((dest[x] >> 1) & 0x3def) + ((palette[color | gaelco3d_texture[pixeloffs]] >> 1) & 0x3def);
+					zbuf[x] = (zbufval < 0) ? -zbufval : zbufval;
+				}
+#else
+				u = (int)(uoz * z * 256.0); v = (int)(voz * z * 256.0);
+				pixeloffs = (tex + (v >> 8) * 4096 + (u >> 8)) & endmask;
+				if (pixeloffs >= gaelco3d_texmask_size || !gaelco3d_texmask[pixeloffs])
+				{
+					paldata = palette[color | gaelco3d_texture[pixeloffs]];
+					tf = f = (~u & 0xff) * (~v & 0xff);
+					r = (paldata & 0x7c00) * f; g = (paldata & 0x03e0) * f; b = (paldata & 0x001f) * f;
+
+					paldata = palette[color | gaelco3d_texture[pixeloffs + 1]];
+					tf += f = (u & 0xff) * (~v & 0xff);
+					r += (paldata & 0x7c00) * f; g += (paldata & 0x03e0) * f; b += (paldata & 0x001f) * f;
+
+					paldata = palette[color | gaelco3d_texture[pixeloffs + 4096]];
+					tf += f = (~u & 0xff) * (v & 0xff);
+					r += (paldata & 0x7c00) * f; g += (paldata & 0x03e0) * f; b += (paldata & 0x001f) * f;
+
+					paldata = palette[color | gaelco3d_texture[pixeloffs + 4097]];
+					f = 0x10000 - tf;
+					r += (paldata & 0x7c00) * f; g += (paldata & 0x03e0) * f; b += (paldata & 0x001f) * f;
+
+					paldata = ((r >> 17) & 0x7c00) | ((g >> 17) & 0x03e0) | (b >> 17);
+					dest[x] = ((dest[x] >> 1) & 0x3def) + (paldata & 0x3def);
+					zbuf[x] = (zbufval < 0) ? -zbufval : zbufval;
+				}
+#endif
+			}
+		}
+
+		/* advance texture params to the next pixel */
+		ooz += ooz_dx;
+		uoz += uoz_dx;
+		voz += voz_dx;
+	}
+}
+
+
+
 /*************************************
  *
  *  Polygon rendering
@@ -130,6 +373,8 @@ static int render_poly(UINT32 *polydata)
 	int midx = Machine->screen[0].width/2;
 	int midy = Machine->screen[0].height/2;
 	struct poly_vertex vert[3];
+	poly_extra_data params;
+	poly_draw_scanline callback;
 	rectangle clip;
 	int i;
 
@@ -161,6 +406,28 @@ static int render_poly(UINT32 *polydata)
 		mame_printf_debug("\n");
 	}
 
+	/* gather everything the scanline renderers need */
+	params.ooz_dx = ooz_dx;		params.ooz_dy = ooz_dy;		params.ooz_base = ooz_base;
+	params.uoz_dx = uoz_dx;		params.uoz_dy = uoz_dy;		params.uoz_base = uoz_base;
+	params.voz_dx = voz_dx;		params.voz_dy = voz_dy;		params.voz_base = voz_base;
+	params.z0 = z0;
+	params.color = color;
+	params.tex = polydata[11];
+	params.midx = midx;
+	params.midy = midy;
+
+	/* special case: no Z buffering and no perspective correction */
+	if (color != 0x7f00 && z0 < 0 && ooz_dx == 0 && ooz_dy == 0)
+		callback = render_noz_noperspective;
+
+	/* general case: non-alpha blended */
+	else if (color != 0x7f00)
+		callback = render_normal;
+
+	/* color 0x7f seems to be hard-coded as a 50% alpha blend */
+	else
+		callback = render_alphablend;
+
 	/* compute the adjusted clip */
 	clip.min_x = Machine->screen[0].visarea.min_x - midx;
 	clip.min_y = Machine->screen[0].visarea.min_y - midy;
@@ -176,215 +443,15 @@ static int render_poly(UINT32 *polydata)
 	/* loop over the remaining verticies */
 	for (i = 17; !IS_POLYEND(polydata[i - 2]) && i < 1000; i += 2)
 	{
-		offs_t endmask = gaelco3d_texture_size - 1;
-		const struct poly_scanline_data *scans;
-		UINT32 tex = polydata[11];
-		int x, y;
+		poly_extra_data *extra = poly_get_extra_data(poly);
 
 		/* extract vertex 2 */
 		vert[2].x = (((INT32)polydata[i] >> 16) + (GAELCO3D_RESOLUTION_DIVIDE/2)) / GAELCO3D_RESOLUTION_DIVIDE;
 		vert[2].y = (((INT32)(polydata[i] << 18) >> 18) + (GAELCO3D_RESOLUTION_DIVIDE/2)) / GAELCO3D_RESOLUTION_DIVIDE;
 
-		/* compute the scanning parameters */
-		scans = setup_triangle_0(&vert[0], &vert[1], &vert[2], &clip);
-		if (scans)
-		{
-			int pixeloffs, zbufval, u, v;
-#if (BILINEAR_FILTER)
-			int paldata, r, g, b, f, tf;
-#endif
-			/* special case: no Z buffering and no perspective correction */
-			if (color != 0x7f00 && z0 < 0 && ooz_dx == 0 && ooz_dy == 0)
-			{
-				float zbase = 1.0f / ooz_base;
-				float uoz_step = uoz_dx * zbase;
-				float voz_step = voz_dx * zbase;
-				zbufval = (int)(-z0 * zbase);
-
-				/* loop over scanlines */
-				for (y = scans->sy; y <= scans->ey; y++)
-				{
-					const struct poly_scanline *scan = &scans->scanline[y - scans->sy];
-					UINT16 *dest = BITMAP_ADDR16(screenbits, midy - y, midx);
-					UINT16 *zbuf = BITMAP_ADDR16(zbuffer, midy - y, 0);
-					float uoz = (uoz_dy * y + scan->sx * uoz_dx + uoz_base) * zbase;
-					float voz = (voz_dy * y + scan->sx * voz_dx + voz_base) * zbase;
-
-					for (x = scan->sx; x <= scan->ex; x++)
-					{
-#if (!BILINEAR_FILTER)
-						u = (int)(uoz + 0.5); v = (int)(voz + 0.5);
-						pixeloffs = (tex + v * 4096 + u) & endmask;
-						if (pixeloffs >= gaelco3d_texmask_size || !gaelco3d_texmask[pixeloffs])
-						{
-							dest[x] = palette[color | gaelco3d_texture[pixeloffs]];
-							zbuf[x] = zbufval;
-						}
-#else
-						u = (int)(uoz * 256.0); v = (int)(voz * 256.0);
-						pixeloffs = (tex + (v >> 8) * 4096 + (u >> 8)) & endmask;
-						if (pixeloffs >= gaelco3d_texmask_size || !gaelco3d_texmask[pixeloffs])
-						{
-							paldata = palette[color | gaelco3d_texture[pixeloffs]];
-							tf = f = (~u & 0xff) * (~v & 0xff);
-							r = (paldata & 0x7c00) * f; g = (paldata & 0x03e0) * f; b = (paldata & 0x001f) * f;
-
-							paldata = palette[color | gaelco3d_texture[pixeloffs + 1]];
-							tf += f = (u & 0xff) * (~v & 0xff);
-							r += (paldata & 0x7c00) * f; g += (paldata & 0x03e0) * f; b += (paldata & 0x001f) * f;
-
-							paldata = palette[color | gaelco3d_texture[pixeloffs + 4096]];
-							tf += f = (~u & 0xff) * (v & 0xff);
-							r += (paldata & 0x7c00) * f; g += (paldata & 0x03e0) * f; b += (paldata & 0x001f) * f;
-
-							paldata = palette[color | gaelco3d_texture[pixeloffs + 4097]];
-							f = 0x10000 - tf;
-							r += (paldata & 0x7c00) * f; g += (paldata & 0x03e0) * f; b += (paldata & 0x001f) * f;
-
-							dest[x] = ((r >> 16) & 0x7c00) | ((g >> 16) & 0x03e0) | (b >> 16);
-							zbuf[x] = zbufval;
-						}
-#endif
-						/* advance texture params to the next pixel */
-						uoz += uoz_step;
-						voz += voz_step;
-					}
-				}
-			}
-
-			/* general case: non-alpha blended */
-			else if (color != 0x7f00)
-			{
-				/* loop over scanlines */
-				for (y = scans->sy; y <= scans->ey; y++)
-				{
-					const struct poly_scanline *scan = &scans->scanline[y - scans->sy];
-					UINT16 *dest = BITMAP_ADDR16(screenbits, midy - y, midx);
-					UINT16 *zbuf = BITMAP_ADDR16(zbuffer, midy - y, 0);
-					float ooz = ooz_dy * y + scan->sx * ooz_dx + ooz_base;
-					float uoz = uoz_dy * y + scan->sx * uoz_dx + uoz_base;
-					float voz = voz_dy * y + scan->sx * voz_dx + voz_base;
-
-					for (x = scan->sx; x <= scan->ex; x++)
-					{
-						if (ooz > 0)
-						{
-							/* compute Z and check the Z buffer value first */
-							float z = 1.0f / ooz;
-							zbufval = (int)(z0 * z);
-							if (zbufval < zbuf[x] || zbufval < 0)
-							{
-#if (!BILINEAR_FILTER)
-								u = (int)(uoz * z + 0.5); v = (int)(voz * z + 0.5);
-								pixeloffs = (tex + v * 4096 + u) & endmask;
-								if (pixeloffs >= gaelco3d_texmask_size || !gaelco3d_texmask[pixeloffs])
-								{
-									dest[x] = palette[color | gaelco3d_texture[pixeloffs]];
-									zbuf[x] = (zbufval < 0) ? -zbufval : zbufval;
-								}
-#else
-								u = (int)(uoz * z * 256.0); v = (int)(voz * z * 256.0);
-								pixeloffs = (tex + (v >> 8) * 4096 + (u >> 8)) & endmask;
-								if (pixeloffs >= gaelco3d_texmask_size || !gaelco3d_texmask[pixeloffs])
-								{
-									paldata = palette[color | gaelco3d_texture[pixeloffs]];
-									tf = f = (~u & 0xff) * (~v & 0xff);
-									r = (paldata & 0x7c00) * f; g = (paldata & 0x03e0) * f; b = (paldata & 0x001f) * f;
-
-									paldata = palette[color | gaelco3d_texture[pixeloffs + 1]];
-									tf += f = (u & 0xff) * (~v & 0xff);
-									r += (paldata & 0x7c00) * f; g += (paldata & 0x03e0) * f; b += (paldata & 0x001f) * f;
-
-									paldata = palette[color | gaelco3d_texture[pixeloffs + 4096]];
-									tf += f = (~u & 0xff) * (v & 0xff);
-									r += (paldata & 0x7c00) * f; g += (paldata & 0x03e0) * f; b += (paldata & 0x001f) * f;
-
-									paldata = palette[color | gaelco3d_texture[pixeloffs + 4097]];
-									f = 0x10000 - tf;
-									r += (paldata & 0x7c00) * f; g += (paldata & 0x03e0) * f; b += (paldata & 0x001f) * f;
-
-									dest[x] = ((r >> 16) & 0x7c00) | ((g >> 16) & 0x03e0) | (b >> 16);
-									zbuf[x] = (zbufval < 0) ? -zbufval : zbufval;
-								}
-#endif
-							}
-						}
-
-						/* advance texture params to the next pixel */
-						ooz += ooz_dx;
-						uoz += uoz_dx;
-						voz += voz_dx;
-					}
-				}
-			}
-
-			/* color 0x7f seems to be hard-coded as a 50% alpha blend */
-			else
-			{
-				/* loop over scanlines */
-				for (y = scans->sy; y <= scans->ey; y++)
-				{
-					const struct poly_scanline *scan = &scans->scanline[y - scans->sy];
-					UINT16 *dest = BITMAP_ADDR16(screenbits, midy - y, midx);
-					UINT16 *zbuf = BITMAP_ADDR16(zbuffer, midy - y, 0);
-					float ooz = ooz_dy * y + scan->sx * ooz_dx + ooz_base;
-					float uoz = uoz_dy * y + scan->sx * uoz_dx + uoz_base;
-					float voz = voz_dy * y + scan->sx * voz_dx + voz_base;
-
-					for (x = scan->sx; x <= scan->ex; x++)
-					{
-						if (ooz > 0)
-						{
-							/* compute Z and check the Z buffer value first */
-							float z = 1.0f / ooz;
-							zbufval = (int)(z0 * z);
-							if (zbufval < zbuf[x] || zbufval < 0)
-							{
-#if (!BILINEAR_FILTER)
-								u = (int)(uoz * z + 0.5); v = (int)(voz * z + 0.5);
-								pixeloffs = (tex + v * 4096 + u) & endmask;
-								if (pixeloffs >= gaelco3d_texmask_size || !gaelco3d_texmask[pixeloffs])
-								{
-									dest[x] = ((dest[x] >> 1) & 0x3def) + ((palette[color | gaelco3d_texture[pixeloffs]] >> 1) & 0x3def);
-									zbuf[x] = (zbufval < 0) ? -zbufval : zbufval;
-								}
-#else
-								u = (int)(uoz * z * 256.0); v = (int)(voz * z * 256.0);
-								pixeloffs = (tex + (v >> 8) * 4096 + (u >> 8)) & endmask;
-								if (pixeloffs >= gaelco3d_texmask_size || !gaelco3d_texmask[pixeloffs])
-								{
-									paldata = palette[color | gaelco3d_texture[pixeloffs]];
-									tf = f = (~u & 0xff) * (~v & 0xff);
-									r = (paldata & 0x7c00) * f; g = (paldata & 0x03e0) * f; b = (paldata & 0x001f) * f;
-
-									paldata = palette[color | gaelco3d_texture[pixeloffs + 1]];
-									tf += f = (u & 0xff) * (~v & 0xff);
-									r += (paldata & 0x7c00) * f; g += (paldata & 0x03e0) * f; b += (paldata & 0x001f) * f;
-
-									paldata = palette[color | gaelco3d_texture[pixeloffs + 4096]];
-									tf += f = (~u & 0xff) * (v & 0xff);
-									r += (paldata & 0x7c00) * f; g += (paldata & 0x03e0) * f; b += (paldata & 0x001f) * f;
-
-									paldata = palette[color | gaelco3d_texture[pixeloffs + 4097]];
-									f = 0x10000 - tf;
-									r += (paldata & 0x7c00) * f; g += (paldata & 0x03e0) * f; b += (paldata & 0x001f) * f;
-
-									paldata = ((r >> 17) & 0x7c00) | ((g >> 17) & 0x03e0) | (b >> 17);
-									dest[x] = ((dest[x] >> 1) & 0x3def) + (paldata & 0x3def);
-									zbuf[x] = (zbufval < 0) ? -zbufval : zbufval;
-								}
-#endif
-							}
-						}
-
-						/* advance texture params to the next pixel */
-						ooz += ooz_dx;
-						uoz += uoz_dx;
-						voz += voz_dx;
-					}
-				}
-			}
-		}
+		/* queue the triangle; every triangle in the fan gets its own copy of the parameters */
+		*extra = params;
+		poly_render_triangle(poly, screenbits, &clip, callback, 0, &vert[0], &vert[1], &vert[2]);
 
 		/* copy vertex 2 to vertex 1 -- this hardware draws in fans */
 		vert[1] = vert[2];
@@ -408,9 +475,14 @@ void gaelco3d_render(void)
 
 	/* if frameskip is engaged, skip it */
 	if (!video_skip_this_frame())
+	{
 		for (i = 0; i < polydata_count; )
 			i += render_poly(&polydata_buffer[i]);
 
+		/* the scene has to be complete before anyone looks at it */
+		poly_wait(poly);
+	}
+
 #if DISPLAY_STATS
 {
 	int scan = cpu_getscanline();
@@ -2,6 +2,7 @@
     Nintendo 64 Video Hardware
 */
 
+#include <stddef.h>
 #include "driver.h"
 #include "includes/n64.h"
 
@@ -43,8 +44,6 @@ typedef struct
 	int z, dz;
 } SPAN;
 
-static SPAN span[1024];
-
 /*****************************************************************************/
 
 #if LSB_FIRST
@@ -162,54 +161,120 @@ typedef struct
 static COMBINE_MODES combine;
 static OTHER_MODES other_modes;
 
+#define PRIMITIVE_TRIANGLE		0
+#define PRIMITIVE_FILL_RECT		1
+#define PRIMITIVE_TEX_RECT		2
+
+#define MAX_PRIMITIVES			1024	// primitives held before the renderers catch up
+#define MAX_SPAN_ROWS			1024	// scanlines a triangle can cover
+#define SPAN_POOL_SIZE			16384	// spans held for the queued triangles
+#define RENDER_BANDS			8		// scanline bands rendered in parallel
+#define RENDER_MIN_BAND_HEIGHT	8		// smallest band worth handing to another thread
+
+// per-thread pixel pipeline state; the combiner and blender inputs are byte offsets into this
+typedef struct
+{
+	COLOR combined_color;
+	COLOR texel0_color;
+	COLOR texel1_color;
+	COLOR shade_color;
+	COLOR pixel_color;
+	COLOR inv_pixel_color;
+	COLOR blended_pixel_color;
+	COLOR memory_color;
+	COLOR blend_color;
+	COLOR prim_color;
+	COLOR env_color;
+	COLOR fog_color;
+	COLOR one_color;
+	COLOR zero_color;
+} RENDER_CONTEXT;
+
+#define INPUT_OFFSET(c)				((UINT8)offsetof(RENDER_CONTEXT, c))
+#define CONTEXT_INPUT(rc, sel)		(((UINT8 *)(rc))[sel])
+
+typedef struct
+{
+	// combiner inputs
+	UINT8 combiner_rgbsub_a_r[2];
+	UINT8 combiner_rgbsub_a_g[2];
+	UINT8 combiner_rgbsub_a_b[2];
+	UINT8 combiner_rgbsub_b_r[2];
+	UINT8 combiner_rgbsub_b_g[2];
+	UINT8 combiner_rgbsub_b_b[2];
+	UINT8 combiner_rgbmul_r[2];
+	UINT8 combiner_rgbmul_g[2];
+	UINT8 combiner_rgbmul_b[2];
+	UINT8 combiner_rgbadd_r[2];
+	UINT8 combiner_rgbadd_g[2];
+	UINT8 combiner_rgbadd_b[2];
+
+	UINT8 combiner_alphasub_a[2];
+	UINT8 combiner_alphasub_b[2];
+	UINT8 combiner_alphamul[2];
+	UINT8 combiner_alphaadd[2];
+
+	// blender input
+	UINT8 blender1a_r[2];
+	UINT8 blender1a_g[2];
+	UINT8 blender1a_b[2];
+	UINT8 blender1b_a[2];
+	UINT8 blender2a_r[2];
+	UINT8 blender2a_g[2];
+	UINT8 blender2a_b[2];
+	UINT8 blender2b_a[2];
+} PIPELINE_INPUTS;
+
+// everything the renderers read that a later command can change, captured with each primitive
+typedef struct
+{
+	OTHER_MODES other_modes;
+	PIPELINE_INPUTS inputs;
+	COLOR blend_color;
+	COLOR prim_color;
+	COLOR env_color;
+	COLOR fog_color;
+	UINT32 fill_color;
+	RECTANGLE clip;
+	TILE tile[8];
+} RENDER_STATE;
+
+typedef struct
+{
+	int type;
+	const RENDER_STATE *state;
+	int starty, endy;			// scanlines touched, inclusive
+
+	// triangles
+	SPAN *spans;				// one span per scanline, starting at starty
+	int tilenum, shade, texture, zbuffer, flip;
+
+	// rectangles
+	RECTANGLE rect;
+	TEX_RECTANGLE texrect;
+} RDP_PRIMITIVE;
+
+typedef struct
+{
+	int starty, stopy;			// scanlines covered, exclusive of stopy
+	RENDER_CONTEXT context;
+} RENDER_BAND;
+
 static COLOR blend_color;
 static COLOR prim_color;
 static COLOR env_color;
 static COLOR fog_color;
-static COLOR combined_color;
-static COLOR texel0_color;
-static COLOR texel1_color;
-static COLOR shade_color;
-
-static COLOR one_color		= { 0xff, 0xff, 0xff, 0xff };
-static COLOR zero_color		= { 0x00, 0x00, 0x00, 0x00 };
-
-// combiner inputs
-static UINT8 *combiner_rgbsub_a_r[2];
-static UINT8 *combiner_rgbsub_a_g[2];
-static UINT8 *combiner_rgbsub_a_b[2];
-static UINT8 *combiner_rgbsub_b_r[2];
-static UINT8 *combiner_rgbsub_b_g[2];
-static UINT8 *combiner_rgbsub_b_b[2];
-static UINT8 *combiner_rgbmul_r[2];
-static UINT8 *combiner_rgbmul_g[2];
-static UINT8 *combiner_rgbmul_b[2];
-static UINT8 *combiner_rgbadd_r[2];
-static UINT8 *combiner_rgbadd_g[2];
-static UINT8 *combiner_rgbadd_b[2];
-
-static UINT8 *combiner_alphasub_a[2];
-static UINT8 *combiner_alphasub_b[2];
-static UINT8 *combiner_alphamul[2];
-static UINT8 *combiner_alphaadd[2];
-
-// blender input
-static UINT8 *blender1a_r[2];
-static UINT8 *blender1a_g[2];
-static UINT8 *blender1a_b[2];
-static UINT8 *blender1b_a[2];
-static UINT8 *blender2a_r[2];
-static UINT8 *blender2a_g[2];
-static UINT8 *blender2a_b[2];
-static UINT8 *blender2b_a[2];
-
-
-static COLOR pixel_color;
-static COLOR inv_pixel_color;
-static COLOR blended_pixel_color;
-static COLOR memory_color;
 
+static PIPELINE_INPUTS inputs;
 
+static RDP_PRIMITIVE *prim_queue;
+static int prim_count;
+static RENDER_STATE *state_pool;
+static int state_count;
+static SPAN *span_pool;
+static int span_count;
+static RENDER_BAND band[RENDER_BANDS];
+static osd_work_queue *render_queue;
 
 static UINT32 fill_color;		// packed 16-bit or 32-bit, depending on framebuffer format
 
@@ -273,6 +338,15 @@ while (0)
 
 
 
+static void n64_video_exit(running_machine *machine)
+{
+	if (render_queue != NULL)
+	{
+		osd_work_queue_free(render_queue);
+		render_queue = NULL;
+	}
+}
+
 VIDEO_START(n64)
 {
 #if LOG_RDP_EXECUTION
@@ -281,32 +355,41 @@ VIDEO_START(n64)
 
 	texture_cache = auto_malloc(0x100000);
 
-	combiner_rgbsub_a_r[0] = combiner_rgbsub_a_r[1] = &one_color.r;
-	combiner_rgbsub_a_g[0] = combiner_rgbsub_a_g[1] = &one_color.g;
-	combiner_rgbsub_a_b[0] = combiner_rgbsub_a_b[1] = &one_color.b;
-	combiner_rgbsub_b_r[0] = combiner_rgbsub_b_r[1] = &one_color.r;
-	combiner_rgbsub_b_g[0] = combiner_rgbsub_b_g[1] = &one_color.g;
-	combiner_rgbsub_b_b[0] = combiner_rgbsub_b_b[1] = &one_color.b;
-	combiner_rgbmul_r[0] = combiner_rgbmul_r[1] = &one_color.r;
-	combiner_rgbmul_g[0] = combiner_rgbmul_g[1] = &one_color.g;
-	combiner_rgbmul_b[0] = combiner_rgbmul_b[1] = &one_color.b;
-	combiner_rgbadd_r[0] = combiner_rgbadd_r[1] = &one_color.r;
-	combiner_rgbadd_g[0] = combiner_rgbadd_g[1] = &one_color.g;
-	combiner_rgbadd_b[0] = combiner_rgbadd_b[1] = &one_color.b;
-
-	combiner_alphasub_a[0] = combiner_alphasub_a[1] = &one_color.a;
-	combiner_alphasub_b[0] = combiner_alphasub_b[1] = &one_color.a;
-	combiner_alphamul[0] = combiner_alphamul[1] = &one_color.a;
-	combiner_alphaadd[0] = combiner_alphaadd[1] = &one_color.a;
-
-	blender1a_r[0] = blender1a_r[1] = &pixel_color.r;
-	blender1a_g[0] = blender1a_g[1] = &pixel_color.r;
-	blender1a_b[0] = blender1a_b[1] = &pixel_color.r;
-	blender1b_a[0] = blender1b_a[1] = &pixel_color.r;
-	blender2a_r[0] = blender2a_r[1] = &pixel_color.r;
-	blender2a_g[0] = blender2a_g[1] = &pixel_color.r;
-	blender2a_b[0] = blender2a_b[1] = &pixel_color.r;
-	blender2b_a[0] = blender2b_a[1] = &pixel_color.r;
+	inputs.combiner_rgbsub_a_r[0] = inputs.combiner_rgbsub_a_r[1] = INPUT_OFFSET(one_color.r);
+	inputs.combiner_rgbsub_a_g[0] = inputs.combiner_rgbsub_a_g[1] = INPUT_OFFSET(one_color.g);
+	inputs.combiner_rgbsub_a_b[0] = inputs.combiner_rgbsub_a_b[1] = INPUT_OFFSET(one_color.b);
+	inputs.combiner_rgbsub_b_r[0] = inputs.combiner_rgbsub_b_r[1] = INPUT_OFFSET(one_color.r);
+	inputs.combiner_rgbsub_b_g[0] = inputs.combiner_rgbsub_b_g[1] = INPUT_OFFSET(one_color.g);
+	inputs.combiner_rgbsub_b_b[0] = inputs.combiner_rgbsub_b_b[1] = INPUT_OFFSET(one_color.b);
+	inputs.combiner_rgbmul_r[0] = inputs.combiner_rgbmul_r[1] = INPUT_OFFSET(one_color.r);
+	inputs.combiner_rgbmul_g[0] = inputs.combiner_rgbmul_g[1] = INPUT_OFFSET(one_color.g);
+	inputs.combiner_rgbmul_b[0] = inputs.combiner_rgbmul_b[1] = INPUT_OFFSET(one_color.b);
+	inputs.combiner_rgbadd_r[0] = inputs.combiner_rgbadd_r[1] = INPUT_OFFSET(one_color.r);
+	inputs.combiner_rgbadd_g[0] = inputs.combiner_rgbadd_g[1] = INPUT_OFFSET(one_color.g);
+	inputs.combiner_rgbadd_b[0] = inputs.combiner_rgbadd_b[1] = INPUT_OFFSET(one_color.b);
+
+	inputs.combiner_alphasub_a[0] = inputs.combiner_alphasub_a[1] = INPUT_OFFSET(one_color.a);
+	inputs.combiner_alphasub_b[0] = inputs.combiner_alphasub_b[1] = INPUT_OFFSET(one_color.a);
+	inputs.combiner_alphamul[0] = inputs.combiner_alphamul[1] = INPUT_OFFSET(one_color.a);
+	inputs.combiner_alphaadd[0] = inputs.combiner_alphaadd[1] = INPUT_OFFSET(one_color.a);
+
+	inputs.blender1a_r[0] = inputs.blender1a_r[1] = INPUT_OFFSET(pixel_color.r);
+	inputs.blender1a_g[0] = inputs.blender1a_g[1] = INPUT_OFFSET(pixel_color.r);
+	inputs.blender1a_b[0] = inputs.blender1a_b[1] = INPUT_OFFSET(pixel_color.r);
+	inputs.blender1b_a[0] = inputs.blender1b_a[1] = INPUT_OFFSET(pixel_color.r);
+	inputs.blender2a_r[0] = inputs.blender2a_r[1] = INPUT_OFFSET(pixel_color.r);
+	inputs.blender2a_g[0] = inputs.blender2a_g[1] = INPUT_OFFSET(pixel_color.r);
+	inputs.blender2a_b[0] = inputs.blender2a_b[1] = INPUT_OFFSET(pixel_color.r);
+	inputs.blender2b_a[0] = inputs.blender2b_a[1] = INPUT_OFFSET(pixel_color.r);
+
+	prim_queue = auto_malloc(sizeof(*prim_queue) * MAX_PRIMITIVES);
+	state_pool = auto_malloc(sizeof(*state_pool) * MAX_PRIMITIVES);
+	span_pool = auto_malloc(sizeof(*span_pool) * SPAN_POOL_SIZE);
+	prim_count = state_count = span_count = 0;
+
+	render_queue = osd_work_queue_alloc(WORK_QUEUE_FLAG_MULTI);
+	add_exit_callback(machine, n64_video_exit);
+
 	return 0;
 }
 
@@ -368,135 +451,135 @@ VIDEO_UPDATE(n64)
 
 /*****************************************************************************/
 
-INLINE void SET_SUBA_RGB_INPUT(UINT8 **input_r, UINT8 **input_g, UINT8 **input_b, int code)
+INLINE void SET_SUBA_RGB_INPUT(UINT8 *input_r, UINT8 *input_g, UINT8 *input_b, int code)
 {
 	switch (code & 0xf)
 	{
-		case 0:		*input_r = &combined_color.r;	*input_g = &combined_color.g;	*input_b = &combined_color.b;	break;
-		case 1:		*input_r = &texel0_color.r;		*input_g = &texel0_color.g;		*input_b = &texel0_color.b;		break;
-		case 2:		*input_r = &texel1_color.r;		*input_g = &texel1_color.g;		*input_b = &texel1_color.b;		break;
-		case 3:		*input_r = &prim_color.r;		*input_g = &prim_color.g;		*input_b = &prim_color.b;		break;
-		case 4:		*input_r = &shade_color.r;		*input_g = &shade_color.g;		*input_b = &shade_color.b;		break;
-		case 5:		*input_r = &env_color.r;		*input_g = &env_color.g;		*input_b = &env_color.b;		break;
-		case 6:		*input_r = &one_color.r;		*input_g = &one_color.g;		*input_b = &one_color.b;		break;
+		case 0:		*input_r = INPUT_OFFSET(combined_color.r);	*input_g = INPUT_OFFSET(combined_color.g);	*input_b = INPUT_OFFSET(combined_color.b);	break;
+		case 1:		*input_r = INPUT_OFFSET(texel0_color.r);		*input_g = INPUT_OFFSET(texel0_color.g);		*input_b = INPUT_OFFSET(texel0_color.b);		break;
+		case 2:		*input_r = INPUT_OFFSET(texel1_color.r);		*input_g = INPUT_OFFSET(texel1_color.g);		*input_b = INPUT_OFFSET(texel1_color.b);		break;
+		case 3:		*input_r = INPUT_OFFSET(prim_color.r);		*input_g = INPUT_OFFSET(prim_color.g);		*input_b = INPUT_OFFSET(prim_color.b);		break;
+		case 4:		*input_r = INPUT_OFFSET(shade_color.r);		*input_g = INPUT_OFFSET(shade_color.g);		*input_b = INPUT_OFFSET(shade_color.b);		break;
+		case 5:		*input_r = INPUT_OFFSET(env_color.r);		*input_g = INPUT_OFFSET(env_color.g);		*input_b = INPUT_OFFSET(env_color.b);		break;
+		case 6:		*input_r = INPUT_OFFSET(one_color.r);		*input_g = INPUT_OFFSET(one_color.g);		*input_b = INPUT_OFFSET(one_color.b);		break;
 		case 7:		break; //TODO fatalerror("SET_SUBA_RGB_INPUT: noise\n"); break;
 		case 8: case 9: case 10: case 11: case 12: case 13: case 14: case 15:
 		{
-			*input_r = &zero_color.r;		*input_g = &zero_color.g;		*input_b = &zero_color.b;		break;
+			*input_r = INPUT_OFFSET(zero_color.r);		*input_g = INPUT_OFFSET(zero_color.g);		*input_b = INPUT_OFFSET(zero_color.b);		break;
 		}
 	}
 }
 
-INLINE void SET_SUBB_RGB_INPUT(UINT8 **input_r, UINT8 **input_g, UINT8 **input_b, int code)
+INLINE void SET_SUBB_RGB_INPUT(UINT8 *input_r, UINT8 *input_g, UINT8 *input_b, int code)
 {
 	switch (code & 0xf)
 	{
-		case 0:		*input_r = &combined_color.r;	*input_g = &combined_color.g;	*input_b = &combined_color.b;	break;
-		case 1:		*input_r = &texel0_color.r;		*input_g = &texel0_color.g;		*input_b = &texel0_color.b;		break;
-		case 2:		*input_r = &texel1_color.r;		*input_g = &texel1_color.g;		*input_b = &texel1_color.b;		break;
-		case 3:		*input_r = &prim_color.r;		*input_g = &prim_color.g;		*input_b = &prim_color.b;		break;
-		case 4:		*input_r = &shade_color.r;		*input_g = &shade_color.g;		*input_b = &shade_color.b;		break;
-		case 5:		*input_r = &env_color.r;		*input_g = &env_color.g;		*input_b = &env_color.b;		break;
+		case 0:		*input_r = INPUT_OFFSET(combined_color.r);	*input_g = INPUT_OFFSET(combined_color.g);	*input_b = INPUT_OFFSET(combined_color.b);	break;
+		case 1:		*input_r = INPUT_OFFSET(texel0_color.r);		*input_g = INPUT_OFFSET(texel0_color.g);		*input_b = INPUT_OFFSET(texel0_color.b);		break;
+		case 2:		*input_r = INPUT_OFFSET(texel1_color.r);		*input_g = INPUT_OFFSET(texel1_color.g);		*input_b = INPUT_OFFSET(texel1_color.b);		break;
+		case 3:		*input_r = INPUT_OFFSET(prim_color.r);		*input_g = INPUT_OFFSET(prim_color.g);		*input_b = INPUT_OFFSET(prim_color.b);		break;
+		case 4:		*input_r = INPUT_OFFSET(shade_color.r);		*input_g = INPUT_OFFSET(shade_color.g);		*input_b = INPUT_OFFSET(shade_color.b);		break;
+		case 5:		*input_r = INPUT_OFFSET(env_color.r);		*input_g = INPUT_OFFSET(env_color.g);		*input_b = INPUT_OFFSET(env_color.b);		break;
 		case 6:		fatalerror("SET_SUBB_RGB_INPUT: key_center\n"); break;
 		case 7:		fatalerror("SET_SUBB_RGB_INPUT: convert_k4\n"); break;
 		case 8: case 9: case 10: case 11: case 12: case 13: case 14: case 15:
 		{
-			*input_r = &zero_color.r;		*input_g = &zero_color.g;		*input_b = &zero_color.b;		break;
+			*input_r = INPUT_OFFSET(zero_color.r);		*input_g = INPUT_OFFSET(zero_color.g);		*input_b = INPUT_OFFSET(zero_color.b);		break;
 		}
 	}
 }
 
-INLINE void SET_MUL_RGB_INPUT(UINT8 **input_r, UINT8 **input_g, UINT8 **input_b, int code)
+INLINE void SET_MUL_RGB_INPUT(UINT8 *input_r, UINT8 *input_g, UINT8 *input_b, int code)
 {
 	switch (code & 0x1f)
 	{
-		case 0:		*input_r = &combined_color.r;	*input_g = &combined_color.g;	*input_b = &combined_color.b;	break;
-		case 1:		*input_r = &texel0_color.r;		*input_g = &texel0_color.g;		*input_b = &texel0_color.b;		break;
-		case 2:		*input_r = &texel1_color.r;		*input_g = &texel1_color.g;		*input_b = &texel1_color.b;		break;
-		case 3:		*input_r = &prim_color.r;		*input_g = &prim_color.g;		*input_b = &prim_color.b;		break;
-		case 4:		*input_r = &shade_color.r;		*input_g = &shade_color.g;		*input_b = &shade_color.b;		break;
-		case 5:		*input_r = &env_color.r;		*input_g = &env_color.g;		*input_b = &env_color.b;		break;
+		case 0:		*input_r = INPUT_OFFSET(combined_color.r);	*input_g = INPUT_OFFSET(combined_color.g);	*input_b = INPUT_OFFSET(combined_color.b);	break;
+		case 1:		*input_r = INPUT_OFFSET(texel0_color.r);		*input_g = INPUT_OFFSET(texel0_color.g);		*input_b = INPUT_OFFSET(texel0_color.b);		break;
+		case 2:		*input_r = INPUT_OFFSET(texel1_color.r);		*input_g = INPUT_OFFSET(texel1_color.g);		*input_b = INPUT_OFFSET(texel1_color.b);		break;
+		case 3:		*input_r = INPUT_OFFSET(prim_color.r);		*input_g = INPUT_OFFSET(prim_color.g);		*input_b = INPUT_OFFSET(prim_color.b);		break;
+		case 4:		*input_r = INPUT_OFFSET(shade_color.r);		*input_g = INPUT_OFFSET(shade_color.g);		*input_b = INPUT_OFFSET(shade_color.b);		break;
+		case 5:		*input_r = INPUT_OFFSET(env_color.r);		*input_g = INPUT_OFFSET(env_color.g);		*input_b = INPUT_OFFSET(env_color.b);		break;
 		case 6:		fatalerror("SET_MUL_RGB_INPUT: key scale\n"); break;
-		case 7:		*input_r = &combined_color.a;	*input_g = &combined_color.a;	*input_b = &combined_color.a;	break;
-		case 8:		*input_r = &texel0_color.a;		*input_g = &texel0_color.a;		*input_b = &texel0_color.a;		break;
-		case 9:		*input_r = &texel1_color.a;		*input_g = &texel1_color.a;		*input_b = &texel1_color.a;		break;
-		case 10:	*input_r = &prim_color.a;		*input_g = &prim_color.a;		*input_b = &prim_color.a;		break;
-		case 11:	*input_r = &shade_color.a;		*input_g = &shade_color.a;		*input_b = &shade_color.a;		break;
-		case 12:	*input_r = &env_color.a;		*input_g = &env_color.a;		*input_b = &env_color.a;		break;
+		case 7:		*input_r = INPUT_OFFSET(combined_color.a);	*input_g = INPUT_OFFSET(combined_color.a);	*input_b = INPUT_OFFSET(combined_color.a);	break;
+		case 8:		*input_r = INPUT_OFFSET(texel0_color.a);		*input_g = INPUT_OFFSET(texel0_color.a);		*input_b = INPUT_OFFSET(texel0_color.a);		break;
+		case 9:		*input_r = INPUT_OFFSET(texel1_color.a);		*input_g = INPUT_OFFSET(texel1_color.a);		*input_b = INPUT_OFFSET(texel1_color.a);		break;
+		case 10:	*input_r = INPUT_OFFSET(prim_color.a);		*input_g = INPUT_OFFSET(prim_color.a);		*input_b = INPUT_OFFSET(prim_color.a);		break;
+		case 11:	*input_r = INPUT_OFFSET(shade_color.a);		*input_g = INPUT_OFFSET(shade_color.a);		*input_b = INPUT_OFFSET(shade_color.a);		break;
+		case 12:	*input_r = INPUT_OFFSET(env_color.a);		*input_g = INPUT_OFFSET(env_color.a);		*input_b = INPUT_OFFSET(env_color.a);		break;
 		case 13:	break;//TODO fatalerror("SET_MUL_RGB_INPUT: lod fraction\n"); break;
 		case 14:	break;//TODO fatalerror("SET_MUL_RGB_INPUT: primitive lod fraction\n"); break;
 		case 15:	break;//TODO fatalerror("SET_MUL_RGB_INPUT: convert k5\n"); break;
 		case 16: case 17: case 18: case 19: case 20: case 21: case 22: case 23:
 		case 24: case 25: case 26: case 27: case 28: case 29: case 30: case 31:
 		{
-			*input_r = &zero_color.r;		*input_g = &zero_color.g;		*input_b = &zero_color.b;		break;
+			*input_r = INPUT_OFFSET(zero_color.r);		*input_g = INPUT_OFFSET(zero_color.g);		*input_b = INPUT_OFFSET(zero_color.b);		break;
 		}
 	}
 }
 
-INLINE void SET_ADD_RGB_INPUT(UINT8 **input_r, UINT8 **input_g, UINT8 **input_b, int code)
+INLINE void SET_ADD_RGB_INPUT(UINT8 *input_r, UINT8 *input_g, UINT8 *input_b, int code)
 {
 	switch (code & 0x7)
 	{
-		case 0:		*input_r = &combined_color.r;	*input_g = &combined_color.g;	*input_b = &combined_color.b;	break;
-		case 1:		*input_r = &texel0_color.r;		*input_g = &texel0_color.g;		*input_b = &texel0_color.b;		break;
-		case 2:		*input_r = &texel1_color.r;		*input_g = &texel1_color.g;		*input_b = &texel1_color.b;		break;
-		case 3:		*input_r = &prim_color.r;		*input_g = &prim_color.g;		*input_b = &prim_color.b;		break;
-		case 4:		*input_r = &shade_color.r;		*input_g = &shade_color.g;		*input_b = &shade_color.b;		break;
-		case 5:		*input_r = &env_color.r;		*input_g = &env_color.g;		*input_b = &env_color.b;		break;
-		case 6:		*input_r = &one_color.r;		*input_g = &one_color.g;		*input_b = &one_color.b;		break;
-		case 7:		*input_r = &zero_color.r;		*input_g = &zero_color.g;		*input_b = &zero_color.b;		break;
+		case 0:		*input_r = INPUT_OFFSET(combined_color.r);	*input_g = INPUT_OFFSET(combined_color.g);	*input_b = INPUT_OFFSET(combined_color.b);	break;
+		case 1:		*input_r = INPUT_OFFSET(texel0_color.r);		*input_g = INPUT_OFFSET(texel0_color.g);		*input_b = INPUT_OFFSET(texel0_color.b);		break;
+		case 2:		*input_r = INPUT_OFFSET(texel1_color.r);		*input_g = INPUT_OFFSET(texel1_color.g);		*input_b = INPUT_OFFSET(texel1_color.b);		break;
+		case 3:		*input_r = INPUT_OFFSET(prim_color.r);		*input_g = INPUT_OFFSET(prim_color.g);		*input_b = INPUT_OFFSET(prim_color.b);		break;
+		case 4:		*input_r = INPUT_OFFSET(shade_color.r);		*input_g = INPUT_OFFSET(shade_color.g);		*input_b = INPUT_OFFSET(shade_color.b);		break;
+		case 5:		*input_r = INPUT_OFFSET(env_color.r);		*input_g = INPUT_OFFSET(env_color.g);		*input_b = INPUT_OFFSET(env_color.b);		break;
+		case 6:		*input_r = INPUT_OFFSET(one_color.r);		*input_g = INPUT_OFFSET(one_color.g);		*input_b = INPUT_OFFSET(one_color.b);		break;
+		case 7:		*input_r = INPUT_OFFSET(zero_color.r);		*input_g = INPUT_OFFSET(zero_color.g);		*input_b = INPUT_OFFSET(zero_color.b);		break;
 	}
 }
 
-INLINE void SET_SUB_ALPHA_INPUT(UINT8 **input, int code)
+INLINE void SET_SUB_ALPHA_INPUT(UINT8 *input, int code)
 {
 	switch (code & 0x7)
 	{
-		case 0:		*input = &combined_color.a; break;
-		case 1:		*input = &texel0_color.a; break;
-		case 2:		*input = &texel1_color.a; break;
-		case 3:		*input = &prim_color.a; break;
-		case 4:		*input = &shade_color.a; break;
-		case 5:		*input = &env_color.a; break;
-		case 6:		*input = &one_color.a; break;
-		case 7:		*input = &zero_color.a; break;
+		case 0:		*input = INPUT_OFFSET(combined_color.a); break;
+		case 1:		*input = INPUT_OFFSET(texel0_color.a); break;
+		case 2:		*input = INPUT_OFFSET(texel1_color.a); break;
+		case 3:		*input = INPUT_OFFSET(prim_color.a); break;
+		case 4:		*input = INPUT_OFFSET(shade_color.a); break;
+		case 5:		*input = INPUT_OFFSET(env_color.a); break;
+		case 6:		*input = INPUT_OFFSET(one_color.a); break;
+		case 7:		*input = INPUT_OFFSET(zero_color.a); break;
 	}
 }
 
-INLINE void SET_MUL_ALPHA_INPUT(UINT8 **input, int code)
+INLINE void SET_MUL_ALPHA_INPUT(UINT8 *input, int code)
 {
 	switch (code & 0x7)
 	{
 		case 0:		break;//TODO fatalerror("SET_MUL_ALPHA_INPUT: lod fraction\n"); break;
-		case 1:		*input = &texel0_color.a; break;
-		case 2:		*input = &texel1_color.a; break;
-		case 3:		*input = &prim_color.a; break;
-		case 4:		*input = &shade_color.a; break;
-		case 5:		*input = &env_color.a; break;
+		case 1:		*input = INPUT_OFFSET(texel0_color.a); break;
+		case 2:		*input = INPUT_OFFSET(texel1_color.a); break;
+		case 3:		*input = INPUT_OFFSET(prim_color.a); break;
+		case 4:		*input = INPUT_OFFSET(shade_color.a); break;
+		case 5:		*input = INPUT_OFFSET(env_color.a); break;
 		case 6:		break;//TODO fatalerror("SET_MUL_ALPHA_INPUT: primitive lod fraction\n"); break;
-		case 7:		*input = &zero_color.a; break;
+		case 7:		*input = INPUT_OFFSET(zero_color.a); break;
 	}
 }
 
 
 
-INLINE COLOR COLOR_COMBINER(int cycle)
+INLINE COLOR COLOR_COMBINER(const RENDER_STATE *st, RENDER_CONTEXT *rc, int cycle)
 {
 	COLOR c;
 	UINT32 r, g, b, a;
 
-	r = (((int)((UINT8)(*combiner_rgbsub_a_r[cycle]) - (UINT8)(*combiner_rgbsub_b_r[cycle])) *
-		*combiner_rgbmul_r[cycle]) >> 8) + *combiner_rgbadd_r[cycle];
+	r = (((int)((UINT8)(CONTEXT_INPUT(rc, st->inputs.combiner_rgbsub_a_r[cycle])) - (UINT8)(CONTEXT_INPUT(rc, st->inputs.combiner_rgbsub_b_r[cycle]))) *
+		CONTEXT_INPUT(rc, st->inputs.combiner_rgbmul_r[cycle])) >> 8) + CONTEXT_INPUT(rc, st->inputs.combiner_rgbadd_r[cycle]);
 
-	g = (((int)((UINT8)(*combiner_rgbsub_a_g[cycle]) - (UINT8)(*combiner_rgbsub_b_g[cycle])) *
-		*combiner_rgbmul_g[cycle]) >> 8) + *combiner_rgbadd_g[cycle];
+	g = (((int)((UINT8)(CONTEXT_INPUT(rc, st->inputs.combiner_rgbsub_a_g[cycle])) - (UINT8)(CONTEXT_INPUT(rc, st->inputs.combiner_rgbsub_b_g[cycle]))) *
+		CONTEXT_INPUT(rc, st->inputs.combiner_rgbmul_g[cycle])) >> 8) + CONTEXT_INPUT(rc, st->inputs.combiner_rgbadd_g[cycle]);
 
-	b = (((int)((UINT8)(*combiner_rgbsub_a_b[cycle]) - (UINT8)(*combiner_rgbsub_b_b[cycle])) *
-		*combiner_rgbmul_b[cycle]) >> 8) + *combiner_rgbadd_b[cycle];
+	b = (((int)((UINT8)(CONTEXT_INPUT(rc, st->inputs.combiner_rgbsub_a_b[cycle])) - (UINT8)(CONTEXT_INPUT(rc, st->inputs.combiner_rgbsub_b_b[cycle]))) *
+		CONTEXT_INPUT(rc, st->inputs.combiner_rgbmul_b[cycle])) >> 8) + CONTEXT_INPUT(rc, st->inputs.combiner_rgbadd_b[cycle]);
 
-	a = (((int)((UINT8)(*combiner_alphasub_a[cycle]) - (UINT8)(*combiner_alphasub_b[cycle])) *
-		*combiner_alphamul[cycle]) >> 8) + *combiner_alphaadd[cycle];
+	a = (((int)((UINT8)(CONTEXT_INPUT(rc, st->inputs.combiner_alphasub_a[cycle])) - (UINT8)(CONTEXT_INPUT(rc, st->inputs.combiner_alphasub_b[cycle]))) *
+		CONTEXT_INPUT(rc, st->inputs.combiner_alphamul[cycle])) >> 8) + CONTEXT_INPUT(rc, st->inputs.combiner_alphaadd[cycle]);
 
 	if (r > 255) r = 255;
 	if (g > 255) g = 255;
@@ -509,7 +592,7 @@ INLINE COLOR COLOR_COMBINER(int cycle)
 
 
 
-INLINE void SET_BLENDER_INPUT(int cycle, int which, UINT8 **input_r, UINT8 **input_g, UINT8 **input_b, UINT8 **input_a, int a, int b)
+INLINE void SET_BLENDER_INPUT(int cycle, int which, UINT8 *input_r, UINT8 *input_g, UINT8 *input_b, UINT8 *input_a, int a, int b)
 {
 	switch (a & 0x3)
 	{
@@ -517,15 +600,15 @@ INLINE void SET_BLENDER_INPUT(int cycle, int which, UINT8 **input_r, UINT8 **inp
 		{
 			if (cycle == 0)
 			{
-				*input_r = &pixel_color.r;
-				*input_g = &pixel_color.g;
-				*input_b = &pixel_color.b;
+				*input_r = INPUT_OFFSET(pixel_color.r);
+				*input_g = INPUT_OFFSET(pixel_color.g);
+				*input_b = INPUT_OFFSET(pixel_color.b);
 			}
 			else
 			{
-				*input_r = &blended_pixel_color.r;
-				*input_g = &blended_pixel_color.g;
-				*input_b = &blended_pixel_color.b;
+				*input_r = INPUT_OFFSET(blended_pixel_color.r);
+				*input_g = INPUT_OFFSET(blended_pixel_color.g);
+				*input_b = INPUT_OFFSET(blended_pixel_color.b);
 			}
 			break;
 		}
@@ -534,21 +617,21 @@ INLINE void SET_BLENDER_INPUT(int cycle, int which, UINT8 **input_r, UINT8 **inp
 		{
 			//fatalerror("SET_BLENDER_INPUT: cycle %d, input A: memory color\n", cycle);
 			// TODO
-			*input_r = &memory_color.r;
-			*input_g = &memory_color.g;
-			*input_b = &memory_color.b;
+			*input_r = INPUT_OFFSET(memory_color.r);
+			*input_g = INPUT_OFFSET(memory_color.g);
+			*input_b = INPUT_OFFSET(memory_color.b);
 			break;
 		}
 
 		case 2:
 		{
-			*input_r = &blend_color.r;		*input_g = &blend_color.g;		*input_b = &blend_color.b;
+			*input_r = INPUT_OFFSET(blend_color.r);		*input_g = INPUT_OFFSET(blend_color.g);		*input_b = INPUT_OFFSET(blend_color.b);
 			break;
 		}
 
 		case 3:
 		{
-			*input_r = &fog_color.r;		*input_g = &fog_color.g;		*input_b = &fog_color.b;
+			*input_r = INPUT_OFFSET(fog_color.r);		*input_g = INPUT_OFFSET(fog_color.g);		*input_b = INPUT_OFFSET(fog_color.b);
 			break;
 		}
 	}
@@ -557,20 +640,20 @@ INLINE void SET_BLENDER_INPUT(int cycle, int which, UINT8 **input_r, UINT8 **inp
 	{
 		switch (b & 0x3)
 		{
-			case 0:		*input_a = &pixel_color.a; break;
-			case 1:		*input_a = &one_color.a; break;
-			case 2:		*input_a = &shade_color.a; break;
-			case 3:		*input_a = &zero_color.a; break;
+			case 0:		*input_a = INPUT_OFFSET(pixel_color.a); break;
+			case 1:		*input_a = INPUT_OFFSET(one_color.a); break;
+			case 2:		*input_a = INPUT_OFFSET(shade_color.a); break;
+			case 3:		*input_a = INPUT_OFFSET(zero_color.a); break;
 		}
 	}
 	else
 	{
 		switch (b & 0x3)
 		{
-			case 0:		*input_a = &inv_pixel_color.a; break;
-			case 1:		*input_a = &memory_color.a; break;
-			case 2:		*input_a = &one_color.a; break;
-			case 3:		*input_a = &zero_color.a; break;
+			case 0:		*input_a = INPUT_OFFSET(inv_pixel_color.a); break;
+			case 1:		*input_a = INPUT_OFFSET(memory_color.a); break;
+			case 2:		*input_a = INPUT_OFFSET(one_color.a); break;
+			case 3:		*input_a = INPUT_OFFSET(zero_color.a); break;
 		}
 	}
 }
@@ -586,34 +669,34 @@ static const UINT8 dither_matrix_4x4[16] =
 #define DITHER_RB(val,dith)	((((val) << 1) - ((val) >> 4) + ((val) >> 7) + (dith)) >> 1)
 #define DITHER_G(val,dith)	((((val) << 2) - ((val) >> 4) + ((val) >> 6) + (dith)) >> 2)
 
-INLINE void BLENDER1_16(UINT16 *fb, COLOR c, int dith)
+INLINE void BLENDER1_16(const RENDER_STATE *st, RENDER_CONTEXT *rc, UINT16 *fb, COLOR c, int dith)
 {
 	int r, g, b;
 
-	pixel_color.r = c.r;	inv_pixel_color.r = 0xff - c.r;
-	pixel_color.g = c.g;	inv_pixel_color.g = 0xff - c.g;
-	pixel_color.b = c.b;	inv_pixel_color.b = 0xff - c.b;
-	pixel_color.a = c.a;	inv_pixel_color.a = 0xff - c.a;
+	rc->pixel_color.r = c.r;	rc->inv_pixel_color.r = 0xff - c.r;
+	rc->pixel_color.g = c.g;	rc->inv_pixel_color.g = 0xff - c.g;
+	rc->pixel_color.b = c.b;	rc->inv_pixel_color.b = 0xff - c.b;
+	rc->pixel_color.a = c.a;	rc->inv_pixel_color.a = 0xff - c.a;
 
 
 
-	if (other_modes.image_read_en)
+	if (st->other_modes.image_read_en)
 	{
 		UINT16 mem = *fb;
-		memory_color.r = ((mem >> 11) & 0x1f) << 3;
-		memory_color.g = ((mem >>  6) & 0x1f) << 3;
-		memory_color.b = ((mem >>  1) & 0x1f) << 3;
-		memory_color.a = 0;
+		rc->memory_color.r = ((mem >> 11) & 0x1f) << 3;
+		rc->memory_color.g = ((mem >>  6) & 0x1f) << 3;
+		rc->memory_color.b = ((mem >>  1) & 0x1f) << 3;
+		rc->memory_color.a = 0;
 	}
 
-	r = (((int)(*blender1a_r[0]) * (int)(*blender1b_a[0])) >> 8) +
-		(((int)(*blender2a_r[0]) * (int)(*blender2b_a[0])) >> 8);
+	r = (((int)(CONTEXT_INPUT(rc, st->inputs.blender1a_r[0])) * (int)(CONTEXT_INPUT(rc, st->inputs.blender1b_a[0]))) >> 8) +
+		(((int)(CONTEXT_INPUT(rc, st->inputs.blender2a_r[0])) * (int)(CONTEXT_INPUT(rc, st->inputs.blender2b_a[0]))) >> 8);
 
-	g = (((int)(*blender1a_g[0]) * (int)(*blender1b_a[0])) >> 8) +
-		(((int)(*blender2a_g[0]) * (int)(*blender2b_a[0])) >> 8);
+	g = (((int)(CONTEXT_INPUT(rc, st->inputs.blender1a_g[0])) * (int)(CONTEXT_INPUT(rc, st->inputs.blender1b_a[0]))) >> 8) +
+		(((int)(CONTEXT_INPUT(rc, st->inputs.blender2a_g[0])) * (int)(CONTEXT_INPUT(rc, st->inputs.blender2b_a[0]))) >> 8);
 
-	b = (((int)(*blender1a_b[0]) * (int)(*blender1b_a[0])) >> 8) +
-		(((int)(*blender2a_b[0]) * (int)(*blender2b_a[0])) >> 8);
+	b = (((int)(CONTEXT_INPUT(rc, st->inputs.blender1a_b[0])) * (int)(CONTEXT_INPUT(rc, st->inputs.blender1b_a[0]))) >> 8) +
+		(((int)(CONTEXT_INPUT(rc, st->inputs.blender2a_b[0])) * (int)(CONTEXT_INPUT(rc, st->inputs.blender2b_a[0]))) >> 8);
 
 	//r = g = b = 0xff;
 
@@ -621,7 +704,7 @@ INLINE void BLENDER1_16(UINT16 *fb, COLOR c, int dith)
 	if (g > 255) g = 255;
 	if (b > 255) b = 255;
 
-	if (other_modes.rgb_dither_sel != 3)
+	if (st->other_modes.rgb_dither_sel != 3)
 	{
 		r = DITHER_RB(r, dith);
 		g = DITHER_G (g, dith);
@@ -634,50 +717,50 @@ INLINE void BLENDER1_16(UINT16 *fb, COLOR c, int dith)
 	}
 }
 
-INLINE void BLENDER2_16(UINT16 *fb, COLOR c1, COLOR c2, int dith)
+INLINE void BLENDER2_16(const RENDER_STATE *st, RENDER_CONTEXT *rc, UINT16 *fb, COLOR c1, COLOR c2, int dith)
 {
 	int r, g, b;
 
-	pixel_color.r = c1.r;	inv_pixel_color.r = 0xff - c1.r;
-	pixel_color.g = c1.g;	inv_pixel_color.g = 0xff - c1.g;
-	pixel_color.b = c1.b;	inv_pixel_color.b = 0xff - c1.b;
-	pixel_color.a = c1.a;	inv_pixel_color.a = 0xff - c1.a;
+	rc->pixel_color.r = c1.r;	rc->inv_pixel_color.r = 0xff - c1.r;
+	rc->pixel_color.g = c1.g;	rc->inv_pixel_color.g = 0xff - c1.g;
+	rc->pixel_color.b = c1.b;	rc->inv_pixel_color.b = 0xff - c1.b;
+	rc->pixel_color.a = c1.a;	rc->inv_pixel_color.a = 0xff - c1.a;
 
-	if (other_modes.image_read_en)
+	if (st->other_modes.image_read_en)
 	{
 		UINT16 mem = *fb;
-		memory_color.r = ((mem >> 11) & 0x1f) << 3;
-		memory_color.g = ((mem >>  6) & 0x1f) << 3;
-		memory_color.b = ((mem >>  1) & 0x1f) << 3;
-		memory_color.a = 0;
+		rc->memory_color.r = ((mem >> 11) & 0x1f) << 3;
+		rc->memory_color.g = ((mem >>  6) & 0x1f) << 3;
+		rc->memory_color.b = ((mem >>  1) & 0x1f) << 3;
+		rc->memory_color.a = 0;
 	}
 
-	r = (((int)(*blender1a_r[0]) * (int)(*blender1b_a[0])) >> 8) +
-		(((int)(*blender2a_r[0]) * (int)(*blender2b_a[0])) >> 8);
+	r = (((int)(CONTEXT_INPUT(rc, st->inputs.blender1a_r[0])) * (int)(CONTEXT_INPUT(rc, st->inputs.blender1b_a[0]))) >> 8) +
+		(((int)(CONTEXT_INPUT(rc, st->inputs.blender2a_r[0])) * (int)(CONTEXT_INPUT(rc, st->inputs.blender2b_a[0]))) >> 8);
 
-	g = (((int)(*blender1a_g[0]) * (int)(*blender1b_a[0])) >> 8) +
-		(((int)(*blender2a_g[0]) * (int)(*blender2b_a[0])) >> 8);
+	g = (((int)(CONTEXT_INPUT(rc, st->inputs.blender1a_g[0])) * (int)(CONTEXT_INPUT(rc, st->inputs.blender1b_a[0]))) >> 8) +
+		(((int)(CONTEXT_INPUT(rc, st->inputs.blender2a_g[0])) * (int)(CONTEXT_INPUT(rc, st->inputs.blender2b_a[0]))) >> 8);
 
-	b = (((int)(*blender1a_b[0]) * (int)(*blender1b_a[0])) >> 8) +
-		(((int)(*blender2a_b[0]) * (int)(*blender2b_a[0])) >> 8);
+	b = (((int)(CONTEXT_INPUT(rc, st->inputs.blender1a_b[0])) * (int)(CONTEXT_INPUT(rc, st->inputs.blender1b_a[0]))) >> 8) +
+		(((int)(CONTEXT_INPUT(rc, st->inputs.blender2a_b[0])) * (int)(CONTEXT_INPUT(rc, st->inputs.blender2b_a[0]))) >> 8);
 
-	blended_pixel_color.r = r;
-	blended_pixel_color.g = g;
-	blended_pixel_color.b = b;
+	rc->blended_pixel_color.r = r;
+	rc->blended_pixel_color.g = g;
+	rc->blended_pixel_color.b = b;
 
-	pixel_color.r = c2.r;	inv_pixel_color.r = 0xff - c2.r;
-	pixel_color.g = c2.g;	inv_pixel_color.g = 0xff - c2.g;
-	pixel_color.b = c2.b;	inv_pixel_color.b = 0xff - c2.b;
-	pixel_color.a = c2.a;	inv_pixel_color.a = 0xff - c2.a;
+	rc->pixel_color.r = c2.r;	rc->inv_pixel_color.r = 0xff - c2.r;
+	rc->pixel_color.g = c2.g;	rc->inv_pixel_color.g = 0xff - c2.g;
+	rc->pixel_color.b = c2.b;	rc->inv_pixel_color.b = 0xff - c2.b;
+	rc->pixel_color.a = c2.a;	rc->inv_pixel_color.a = 0xff - c2.a;
 
-	r = (((int)(*blender1a_r[1]) * (int)(*blender1b_a[1])) >> 8) +
-		(((int)(*blender2a_r[1]) * (int)(*blender2b_a[1])) >> 8);
+	r = (((int)(CONTEXT_INPUT(rc, st->inputs.blender1a_r[1])) * (int)(CONTEXT_INPUT(rc, st->inputs.blender1b_a[1]))) >> 8) +
+		(((int)(CONTEXT_INPUT(rc, st->inputs.blender2a_r[1])) * (int)(CONTEXT_INPUT(rc, st->inputs.blender2b_a[1]))) >> 8);
 
-	g = (((int)(*blender1a_g[1]) * (int)(*blender1b_a[1])) >> 8) +
-		(((int)(*blender2a_g[1]) * (int)(*blender2b_a[1])) >> 8);
+	g = (((int)(CONTEXT_INPUT(rc, st->inputs.blender1a_g[1])) * (int)(CONTEXT_INPUT(rc, st->inputs.blender1b_a[1]))) >> 8) +
+		(((int)(CONTEXT_INPUT(rc, st->inputs.blender2a_g[1])) * (int)(CONTEXT_INPUT(rc, st->inputs.blender2b_a[1]))) >> 8);
 
-	b = (((int)(*blender1a_b[1]) * (int)(*blender1b_a[1])) >> 8) +
-		(((int)(*blender2a_b[1]) * (int)(*blender2b_a[1])) >> 8);
+	b = (((int)(CONTEXT_INPUT(rc, st->inputs.blender1a_b[1])) * (int)(CONTEXT_INPUT(rc, st->inputs.blender1b_a[1]))) >> 8) +
+		(((int)(CONTEXT_INPUT(rc, st->inputs.blender2a_b[1])) * (int)(CONTEXT_INPUT(rc, st->inputs.blender2b_a[1]))) >> 8);
 
 	r = c1.r;
 	g = c1.g;
@@ -687,7 +770,7 @@ INLINE void BLENDER2_16(UINT16 *fb, COLOR c1, COLOR c2, int dith)
 	if (g > 255) g = 255;
 	if (b > 255) b = 255;
 
-	if (other_modes.rgb_dither_sel != 3)
+	if (st->other_modes.rgb_dither_sel != 3)
 	{
 		r = DITHER_RB(r, dith);
 		g = DITHER_G (g, dith);
@@ -701,8 +784,10 @@ INLINE void BLENDER2_16(UINT16 *fb, COLOR c1, COLOR c2, int dith)
 
 /*****************************************************************************/
 
-static void fill_rectangle_16bit(RECTANGLE *rect)
+static void fill_rectangle_16bit(RENDER_CONTEXT *rc, const RDP_PRIMITIVE *prim, int bandmin, int bandmax)
 {
+	const RENDER_STATE *st = prim->state;
+	const RECTANGLE *rect = &prim->rect;
 	UINT16 *fb = (UINT16*)&rdram[(fb_address / 4)];
 	int index, i, j;
 	int x1 = rect->xh / 4;
@@ -712,14 +797,14 @@ static void fill_rectangle_16bit(RECTANGLE *rect)
 	int clipx1, clipx2, clipy1, clipy2;
 
 	UINT16 fill_color1, fill_color2;
-	fill_color1 = (fill_color >> 16) & 0xffff;
-	fill_color2 = (fill_color >>  0) & 0xffff;
+	fill_color1 = (st->fill_color >> 16) & 0xffff;
+	fill_color2 = (st->fill_color >>  0) & 0xffff;
 
 	// TODO: clip
-	clipx1 = clip.xh / 4;
-	clipx2 = clip.xl / 4;
-	clipy1 = clip.yh / 4;
-	clipy2 = clip.yl / 4;
+	clipx1 = st->clip.xh / 4;
+	clipx2 = st->clip.xl / 4;
+	clipy1 = st->clip.yh / 4;
+	clipy2 = st->clip.yl / 4;
 
 	// clip
 	if (x1 < clipx1)
@@ -739,7 +824,17 @@ static void fill_rectangle_16bit(RECTANGLE *rect)
 		y2 = clipy2-1;
 	}
 
-	if (other_modes.cycle_type == CYCLE_TYPE_FILL)
+	// only draw this band's share
+	if (y1 < bandmin)
+	{
+		y1 = bandmin;
+	}
+	if (y2 >= bandmax)
+	{
+		y2 = bandmax-1;
+	}
+
+	if (st->other_modes.cycle_type == CYCLE_TYPE_FILL)
 	{
 		for (j=y1; j <= y2; j++)
 		{
@@ -750,47 +845,47 @@ static void fill_rectangle_16bit(RECTANGLE *rect)
 			}
 		}
 	}
-	else if (other_modes.cycle_type == CYCLE_TYPE_1)
+	else if (st->other_modes.cycle_type == CYCLE_TYPE_1)
 	{
-		shade_color.r = prim_color.r;
-		shade_color.g = prim_color.g;
-		shade_color.b = prim_color.b;
-		shade_color.a = prim_color.a;
+		rc->shade_color.r = rc->prim_color.r;
+		rc->shade_color.g = rc->prim_color.g;
+		rc->shade_color.b = rc->prim_color.b;
+		rc->shade_color.a = rc->prim_color.a;
 
 		for (j=y1; j <= y2; j++)
 		{
 			index = j * fb_width;
 			for (i=x1; i <= x2; i++)
 			{
-				COLOR c = COLOR_COMBINER(0);
+				COLOR c = COLOR_COMBINER(st, rc, 0);
 
 				//BLENDER1_16(&fb[(index + i) ^ 1], c);
 				{
 					int dith = dither_matrix_4x4[(((j) & 3) << 2) + ((i^WORD_ADDR_XOR) & 3)];
-					BLENDER1_16(&fb[(index + i) ^ WORD_ADDR_XOR], c, dith);
+					BLENDER1_16(st, rc, &fb[(index + i) ^ WORD_ADDR_XOR], c, dith);
 				}
 			}
 		}
 	}
-	else if (other_modes.cycle_type == CYCLE_TYPE_2)
+	else if (st->other_modes.cycle_type == CYCLE_TYPE_2)
 	{
-		shade_color.r = prim_color.r;
-		shade_color.g = prim_color.g;
-		shade_color.b = prim_color.b;
-		shade_color.a = prim_color.a;
+		rc->shade_color.r = rc->prim_color.r;
+		rc->shade_color.g = rc->prim_color.g;
+		rc->shade_color.b = rc->prim_color.b;
+		rc->shade_color.a = rc->prim_color.a;
 
 		for (j=y1; j <= y2; j++)
 		{
 			index = j * fb_width;
 			for (i=x1; i <= x2; i++)
 			{
-				COLOR c1 = COLOR_COMBINER(0);
-				COLOR c2 = COLOR_COMBINER(1);
+				COLOR c1 = COLOR_COMBINER(st, rc, 0);
+				COLOR c2 = COLOR_COMBINER(st, rc, 1);
 
 				//BLENDER1_16(&fb[(index + i) ^ 1], c);
 				{
 					int dith = dither_matrix_4x4[(((j) & 3) << 2) + ((i^WORD_ADDR_XOR) & 3)];
-					BLENDER2_16(&fb[(index + i) ^ WORD_ADDR_XOR], c1, c2, dith);
+					BLENDER2_16(st, rc, &fb[(index + i) ^ WORD_ADDR_XOR], c1, c2, dith);
 				}
 			}
 		}
@@ -805,7 +900,7 @@ static void fill_rectangle_16bit(RECTANGLE *rect)
 #define XOR_SWAP_WORD	2
 #define XOR_SWAP_DWORD	1
 
-INLINE void FETCH_TEXEL(COLOR *color, int s, int t, UINT32 twidth, UINT32 tformat, UINT32 tsize, UINT32 tbase)
+INLINE void FETCH_TEXEL(const RENDER_STATE *st, COLOR *color, int s, int t, UINT32 twidth, UINT32 tformat, UINT32 tsize, UINT32 tbase)
 {
 	if (t < 0) t = 0;
 	if (s < 0) s = 0;
@@ -857,7 +952,7 @@ INLINE void FETCH_TEXEL(COLOR *color, int s, int t, UINT32 twidth, UINT32 tforma
 					UINT8 p = ((s) & 1) ? (tc[taddr ^ BYTE_ADDR_XOR] & 0xf) : (tc[taddr ^ BYTE_ADDR_XOR] >> 4);
 					UINT16 c = tlut[p ^ WORD_ADDR_XOR];
 
-					if (other_modes.tlut_type == 0)
+					if (st->other_modes.tlut_type == 0)
 					{
 						color->r = ((c >> 11) & 0x1f) << 3;
 						color->g = ((c >>  6) & 0x1f) << 3;
@@ -878,7 +973,7 @@ INLINE void FETCH_TEXEL(COLOR *color, int s, int t, UINT32 twidth, UINT32 tforma
 					UINT8 p = tc[taddr ^ BYTE_ADDR_XOR];
 					UINT16 c = tlut[p ^ WORD_ADDR_XOR];
 
-					if (other_modes.tlut_type == 0)
+					if (st->other_modes.tlut_type == 0)
 					{
 						color->r = ((c >> 11) & 0x1f) << 3;
 						color->g = ((c >>  6) & 0x1f) << 3;
@@ -989,7 +1084,7 @@ INLINE void FETCH_TEXEL(COLOR *color, int s, int t, UINT32 twidth, UINT32 tforma
 #define TEXTURE_PIPELINE(TEX, SSS, SST, NOBILINEAR)																					\
 do																																	\
 {																																	\
-	if (other_modes.sample_type && !NOBILINEAR)																						\
+	if (st->other_modes.sample_type && !NOBILINEAR)																						\
 	{																																\
 		COLOR t0, t1, t2, t3;																										\
 		int sss1, sst1, sss2, sst2;																									\
@@ -1005,10 +1100,10 @@ do																																	\
 		CLAMP(sss1, sst1);																											\
 		CLAMP(sss2, sst2);																											\
 																																	\
-		FETCH_TEXEL(&t0, sss1, sst1, twidth, tformat, tsize, tbase);																\
-		FETCH_TEXEL(&t1, sss2, sst1, twidth, tformat, tsize, tbase);																\
-		FETCH_TEXEL(&t2, sss1, sst2, twidth, tformat, tsize, tbase);																\
-		FETCH_TEXEL(&t3, sss2, sst2, twidth, tformat, tsize, tbase);																\
+		FETCH_TEXEL(st, &t0, sss1, sst1, twidth, tformat, tsize, tbase);																\
+		FETCH_TEXEL(st, &t1, sss2, sst1, twidth, tformat, tsize, tbase);																\
+		FETCH_TEXEL(st, &t2, sss1, sst2, twidth, tformat, tsize, tbase);																\
+		FETCH_TEXEL(st, &t3, sss2, sst2, twidth, tformat, tsize, tbase);																\
 																																	\
 		TEX.r = (((( (t0.r * (0x3ff - (SSS & 0x3ff))) + (t1.r * ((SSS & 0x3ff))) ) >> 10) * (0x3ff - (SST & 0x3ff))) >> 10) +		\
 						 (((( (t2.r * (0x3ff - (SSS & 0x3ff))) + (t3.r * ((SSS & 0x3ff))) ) >> 10) * ((SST & 0x3ff))) >> 10);		\
@@ -1034,7 +1129,7 @@ do																																	\
 		CLAMP(sss1, sst1);																											\
 																																	\
 		/* point sample */																											\
-		FETCH_TEXEL(&TEX, sss1, sst1, twidth, tformat, tsize, tbase);																\
+		FETCH_TEXEL(st, &TEX, sss1, sst1, twidth, tformat, tsize, tbase);																\
 	}																																\
 }																																	\
 while(0)
@@ -1047,7 +1142,7 @@ while(0)
 #define TEXTURE_PIPELINE(TEX, SSS, SST, NOBILINEAR)																					\
 do																																	\
 {																																	\
-	if (other_modes.sample_type && !NOBILINEAR)																						\
+	if (st->other_modes.sample_type && !NOBILINEAR)																						\
 	{																																\
 		COLOR t0, t1, t2;																											\
 		int sss1, sst1, sss2, sst2;																									\
@@ -1063,9 +1158,9 @@ do																																	\
 		CLAMP(sss1, sst1);																											\
 		CLAMP(sss2, sst2);																											\
 																																	\
-		FETCH_TEXEL(&t0, sss1, sst1, twidth, tformat, tsize, tbase);																\
-		FETCH_TEXEL(&t1, sss2, sst1, twidth, tformat, tsize, tbase);																\
-		FETCH_TEXEL(&t2, sss2, sst2, twidth, tformat, tsize, tbase);																\
+		FETCH_TEXEL(st, &t0, sss1, sst1, twidth, tformat, tsize, tbase);																\
+		FETCH_TEXEL(st, &t1, sss2, sst1, twidth, tformat, tsize, tbase);																\
+		FETCH_TEXEL(st, &t2, sss2, sst2, twidth, tformat, tsize, tbase);																\
 																																	\
 		TEX.r = (((( (t0.r * (0x3ff - (SSS & 0x3ff))) + (t1.r * ((SSS & 0x3ff))) ) >> 10) * (0x3ff - (SST & 0x3ff))) >> 10) +		\
 				(( (t2.r) * ((SST & 0x3ff))) >> 10);																				\
@@ -1091,7 +1186,7 @@ do																																	\
 		CLAMP(sss1, sst1);																											\
 																																	\
 		/* point sample */																											\
-		FETCH_TEXEL(&TEX, sss1, sst1, twidth, tformat, tsize, tbase);																\
+		FETCH_TEXEL(st, &TEX, sss1, sst1, twidth, tformat, tsize, tbase);																\
 	}																																\
 }																																	\
 while(0)
@@ -1100,22 +1195,25 @@ while(0)
 #define TEXTURE_PIPELINE1(SSS, SST, NOBILINEAR)				\
 do															\
 {															\
-	TEXTURE_PIPELINE(texel0_color, SSS, SST, NOBILINEAR);	\
+	TEXTURE_PIPELINE(rc->texel0_color, SSS, SST, NOBILINEAR);	\
 }															\
 while(0)
 
 #define TEXTURE_PIPELINE2(SSS, SST, NOBILINEAR)				\
 do															\
 {															\
-	TEXTURE_PIPELINE(texel0_color, SSS, SST, NOBILINEAR);	\
-	TEXTURE_PIPELINE(texel1_color, SSS, SST, NOBILINEAR);	\
+	TEXTURE_PIPELINE(rc->texel0_color, SSS, SST, NOBILINEAR);	\
+	TEXTURE_PIPELINE(rc->texel1_color, SSS, SST, NOBILINEAR);	\
 }															\
 while(0)
 
 
 
-static void texture_rectangle_16bit(TEX_RECTANGLE *rect)
+static void texture_rectangle_16bit(RENDER_CONTEXT *rc, const RDP_PRIMITIVE *prim, int bandmin, int bandmax)
 {
+	const RENDER_STATE *st = prim->state;
+	TEX_RECTANGLE rectcopy = prim->texrect;
+	TEX_RECTANGLE *rect = &rectcopy;
 	UINT16 *fb = (UINT16*)&rdram[(fb_address / 4)];
 	int i, j;
 	int x1, x2, y1, y2;
@@ -1130,17 +1228,17 @@ static void texture_rectangle_16bit(TEX_RECTANGLE *rect)
 	y1 = (rect->yh / 4);
 	y2 = (rect->yl / 4);
 
-	if (other_modes.cycle_type == CYCLE_TYPE_FILL || other_modes.cycle_type == CYCLE_TYPE_COPY)
+	if (st->other_modes.cycle_type == CYCLE_TYPE_FILL || st->other_modes.cycle_type == CYCLE_TYPE_COPY)
 	{
 		rect->dsdx /= 4;
 		x2 += 1;
 		y2 += 1;
 	}
 
-	clipx1 = clip.xh / 4;
-	clipx2 = clip.xl / 4;
-	clipy1 = clip.yh / 4;
-	clipy2 = clip.yl / 4;
+	clipx1 = st->clip.xh / 4;
+	clipx2 = st->clip.xl / 4;
+	clipy1 = st->clip.yh / 4;
+	clipy2 = st->clip.yl / 4;
 
 	// clip
 	if (x1 < clipx1)
@@ -1160,32 +1258,43 @@ static void texture_rectangle_16bit(TEX_RECTANGLE *rect)
 		y2 = clipy2-1;
 	}
 
-	tsl = tile[rect->tilenum].sl;
-	tsh = tile[rect->tilenum].sh;
-	ttl = tile[rect->tilenum].tl;
-	tth = tile[rect->tilenum].th;
+	tsl = st->tile[rect->tilenum].sl;
+	tsh = st->tile[rect->tilenum].sh;
+	ttl = st->tile[rect->tilenum].tl;
+	tth = st->tile[rect->tilenum].th;
 
-	twidth = tile[rect->tilenum].line;
-	tformat = tile[rect->tilenum].format;
-	tsize = tile[rect->tilenum].size;
-	tbase = tile[rect->tilenum].tmem;
+	twidth = st->tile[rect->tilenum].line;
+	tformat = st->tile[rect->tilenum].format;
+	tsize = st->tile[rect->tilenum].size;
+	tbase = st->tile[rect->tilenum].tmem;
 
 	// FIXME?: clamping breaks at least Rampage World Tour
 	clamp_t = 0; //tile[rect->tilenum].ct;
 	clamp_s = 0; //tile[rect->tilenum].cs;
 
-	mirror_t = tile[rect->tilenum].mt;
-	mirror_s = tile[rect->tilenum].ms;
-	mask_t = tile[rect->tilenum].mask_t;
-	mask_s = tile[rect->tilenum].mask_s;
+	mirror_t = st->tile[rect->tilenum].mt;
+	mirror_s = st->tile[rect->tilenum].ms;
+	mask_t = st->tile[rect->tilenum].mask_t;
+	mask_s = st->tile[rect->tilenum].mask_s;
 
 	t = (int)(rect->t) << 5;
 
-	if (other_modes.cycle_type == CYCLE_TYPE_1 || other_modes.cycle_type == CYCLE_TYPE_2)
+	// only draw this band's share, stepping t down to the first row
+	if (y1 < bandmin)
+	{
+		t += (bandmin - y1) * rect->dtdy;
+		y1 = bandmin;
+	}
+	if (y2 > bandmax)
+	{
+		y2 = bandmax;
+	}
+
+	if (st->other_modes.cycle_type == CYCLE_TYPE_1 || st->other_modes.cycle_type == CYCLE_TYPE_2)
 	{
 	}
 
-	if (other_modes.cycle_type == CYCLE_TYPE_1)
+	if (st->other_modes.cycle_type == CYCLE_TYPE_1)
 	{
 		for (j = y1; j < y2; j++)
 		{
@@ -1207,11 +1316,11 @@ static void texture_rectangle_16bit(TEX_RECTANGLE *rect)
 
 				TEXTURE_PIPELINE1(s, t, (rect->dsdx == (1 << 10)) && (rect->dtdy == (1 << 10)));
 
-				c = COLOR_COMBINER(0);
+				c = COLOR_COMBINER(st, rc, 0);
 
 				{
 					int dith = dither_matrix_4x4[(((j) & 3) << 2) + ((i^WORD_ADDR_XOR) & 3)];
-					BLENDER1_16(&fb[(fb_index + i) ^ WORD_ADDR_XOR], c, dith);
+					BLENDER1_16(st, rc, &fb[(fb_index + i) ^ WORD_ADDR_XOR], c, dith);
 				}
 
 				s += rect->dsdx;
@@ -1220,7 +1329,7 @@ static void texture_rectangle_16bit(TEX_RECTANGLE *rect)
 			t += rect->dtdy;
 		}
 	}
-	else if (other_modes.cycle_type == CYCLE_TYPE_2)
+	else if (st->other_modes.cycle_type == CYCLE_TYPE_2)
 	{
 		for (j = y1; j < y2; j++)
 		{
@@ -1243,13 +1352,13 @@ static void texture_rectangle_16bit(TEX_RECTANGLE *rect)
 
 				TEXTURE_PIPELINE2(s, t, (rect->dsdx == (1 << 10)) && (rect->dtdy == (1 << 10)));
 
-				c1 = COLOR_COMBINER(0);
-				c2 = COLOR_COMBINER(1);
+				c1 = COLOR_COMBINER(st, rc, 0);
+				c2 = COLOR_COMBINER(st, rc, 1);
 
 				//BLENDER2_16(&fb[(fb_index + i) ^ WORD_ADDR_XOR], c1, c2);
 				{
 					int dith = dither_matrix_4x4[(((j) & 3) << 2) + ((i^WORD_ADDR_XOR) & 3)];
-					BLENDER2_16(&fb[(fb_index + i) ^ WORD_ADDR_XOR], c1, c2, dith);
+					BLENDER2_16(st, rc, &fb[(fb_index + i) ^ WORD_ADDR_XOR], c1, c2, dith);
 				}
 
 				s += rect->dsdx;
@@ -1258,7 +1367,7 @@ static void texture_rectangle_16bit(TEX_RECTANGLE *rect)
 			t += rect->dtdy;
 		}
 	}
-	else if (other_modes.cycle_type == CYCLE_TYPE_COPY)
+	else if (st->other_modes.cycle_type == CYCLE_TYPE_COPY)
 	{
 		for (j = y1; j < y2; j++)
 		{
@@ -1300,9 +1409,9 @@ static void texture_rectangle_16bit(TEX_RECTANGLE *rect)
 
 				TEXTURE_PIPELINE1(s, t, (rect->dsdx == (1 << 10)) && (rect->dtdy == (1 << 10)));
 
-				if (texel0_color.a != 0)
+				if (rc->texel0_color.a != 0)
 				{
-					fb[(fb_index + i) ^ WORD_ADDR_XOR] = ((texel0_color.r >> 3) << 11) | ((texel0_color.g >> 3) << 6) | ((texel0_color.b >> 3) << 1);
+					fb[(fb_index + i) ^ WORD_ADDR_XOR] = ((rc->texel0_color.r >> 3) << 11) | ((rc->texel0_color.g >> 3) << 6) | ((rc->texel0_color.b >> 3) << 1);
 				}
 
 				s += rect->dsdx;
@@ -1313,38 +1422,38 @@ static void texture_rectangle_16bit(TEX_RECTANGLE *rect)
 	}
 	else
 	{
-		fatalerror("texture_rectangle_16bit: unknown cycle type %d\n", other_modes.cycle_type);
+		fatalerror("texture_rectangle_16bit: unknown cycle type %d\n", st->other_modes.cycle_type);
 	}
 }
 
 /*****************************************************************************/
 
-INLINE void BLENDER1_32(UINT32 *fb, COLOR c)
+INLINE void BLENDER1_32(const RENDER_STATE *st, RENDER_CONTEXT *rc, UINT32 *fb, COLOR c)
 {
 	int r, g, b;
 
-	pixel_color.r = c.r;	inv_pixel_color.r = 0xff - c.r;
-	pixel_color.g = c.g;	inv_pixel_color.g = 0xff - c.g;
-	pixel_color.b = c.b;	inv_pixel_color.b = 0xff - c.b;
-	pixel_color.a = c.a;	inv_pixel_color.a = 0xff - c.a;
+	rc->pixel_color.r = c.r;	rc->inv_pixel_color.r = 0xff - c.r;
+	rc->pixel_color.g = c.g;	rc->inv_pixel_color.g = 0xff - c.g;
+	rc->pixel_color.b = c.b;	rc->inv_pixel_color.b = 0xff - c.b;
+	rc->pixel_color.a = c.a;	rc->inv_pixel_color.a = 0xff - c.a;
 
-	if (other_modes.image_read_en)
+	if (st->other_modes.image_read_en)
 	{
 		UINT32 mem = *fb;
-		memory_color.r = ((mem >> 16) & 0xff);
-		memory_color.g = ((mem >>  8) & 0xff);
-		memory_color.b = ((mem >>  0) & 0xff);
-		memory_color.a = 0;
+		rc->memory_color.r = ((mem >> 16) & 0xff);
+		rc->memory_color.g = ((mem >>  8) & 0xff);
+		rc->memory_color.b = ((mem >>  0) & 0xff);
+		rc->memory_color.a = 0;
 	}
 
-	r = (((int)(*blender1a_r[0]) * (int)(*blender1b_a[0])) >> 8) +
-		(((int)(*blender2a_r[0]) * (int)(*blender2b_a[0])) >> 8);
+	r = (((int)(CONTEXT_INPUT(rc, st->inputs.blender1a_r[0])) * (int)(CONTEXT_INPUT(rc, st->inputs.blender1b_a[0]))) >> 8) +
+		(((int)(CONTEXT_INPUT(rc, st->inputs.blender2a_r[0])) * (int)(CONTEXT_INPUT(rc, st->inputs.blender2b_a[0]))) >> 8);
 
-	g = (((int)(*blender1a_g[0]) * (int)(*blender1b_a[0])) >> 8) +
-		(((int)(*blender2a_g[0]) * (int)(*blender2b_a[0])) >> 8);
+	g = (((int)(CONTEXT_INPUT(rc, st->inputs.blender1a_g[0])) * (int)(CONTEXT_INPUT(rc, st->inputs.blender1b_a[0]))) >> 8) +
+		(((int)(CONTEXT_INPUT(rc, st->inputs.blender2a_g[0])) * (int)(CONTEXT_INPUT(rc, st->inputs.blender2b_a[0]))) >> 8);
 
-	b = (((int)(*blender1a_b[0]) * (int)(*blender1b_a[0])) >> 8) +
-		(((int)(*blender2a_b[0]) * (int)(*blender2b_a[0])) >> 8);
+	b = (((int)(CONTEXT_INPUT(rc, st->inputs.blender1a_b[0])) * (int)(CONTEXT_INPUT(rc, st->inputs.blender1b_a[0]))) >> 8) +
+		(((int)(CONTEXT_INPUT(rc, st->inputs.blender2a_b[0])) * (int)(CONTEXT_INPUT(rc, st->inputs.blender2b_a[0]))) >> 8);
 
 	//r = g = b = 0xff;
 
@@ -1355,50 +1464,50 @@ INLINE void BLENDER1_32(UINT32 *fb, COLOR c)
 	*fb = (r << 16) | (g << 8) | b;
 }
 
-INLINE void BLENDER2_32(UINT32 *fb, COLOR c1, COLOR c2)
+INLINE void BLENDER2_32(const RENDER_STATE *st, RENDER_CONTEXT *rc, UINT32 *fb, COLOR c1, COLOR c2)
 {
 	int r, g, b;
 
-	pixel_color.r = c1.r;	inv_pixel_color.r = 0xff - c1.r;
-	pixel_color.g = c1.g;	inv_pixel_color.g = 0xff - c1.g;
-	pixel_color.b = c1.b;	inv_pixel_color.b = 0xff - c1.b;
-	pixel_color.a = c1.a;	inv_pixel_color.a = 0xff - c1.a;
+	rc->pixel_color.r = c1.r;	rc->inv_pixel_color.r = 0xff - c1.r;
+	rc->pixel_color.g = c1.g;	rc->inv_pixel_color.g = 0xff - c1.g;
+	rc->pixel_color.b = c1.b;	rc->inv_pixel_color.b = 0xff - c1.b;
+	rc->pixel_color.a = c1.a;	rc->inv_pixel_color.a = 0xff - c1.a;
 
-	if (other_modes.image_read_en)
+	if (st->other_modes.image_read_en)
 	{
 		UINT32 mem = *fb;
-		memory_color.r = ((mem >> 16) & 0xff);
-		memory_color.g = ((mem >>  8) & 0xff);
-		memory_color.b = ((mem >>  0) & 0xff);
-		memory_color.a = 0;
+		rc->memory_color.r = ((mem >> 16) & 0xff);
+		rc->memory_color.g = ((mem >>  8) & 0xff);
+		rc->memory_color.b = ((mem >>  0) & 0xff);
+		rc->memory_color.a = 0;
 	}
 
-	r = (((int)(*blender1a_r[0]) * (int)(*blender1b_a[0])) >> 8) +
-		(((int)(*blender2a_r[0]) * (int)(*blender2b_a[0])) >> 8);
+	r = (((int)(CONTEXT_INPUT(rc, st->inputs.blender1a_r[0])) * (int)(CONTEXT_INPUT(rc, st->inputs.blender1b_a[0]))) >> 8) +
+		(((int)(CONTEXT_INPUT(rc, st->inputs.blender2a_r[0])) * (int)(CONTEXT_INPUT(rc, st->inputs.blender2b_a[0]))) >> 8);
 
-	g = (((int)(*blender1a_g[0]) * (int)(*blender1b_a[0])) >> 8) +
-		(((int)(*blender2a_g[0]) * (int)(*blender2b_a[0])) >> 8);
+	g = (((int)(CONTEXT_INPUT(rc, st->inputs.blender1a_g[0])) * (int)(CONTEXT_INPUT(rc, st->inputs.blender1b_a[0]))) >> 8) +
+		(((int)(CONTEXT_INPUT(rc, st->inputs.blender2a_g[0])) * (int)(CONTEXT_INPUT(rc, st->inputs.blender2b_a[0]))) >> 8);
 
-	b = (((int)(*blender1a_b[0]) * (int)(*blender1b_a[0])) >> 8) +
-		(((int)(*blender2a_b[0]) * (int)(*blender2b_a[0])) >> 8);
+	b = (((int)(CONTEXT_INPUT(rc, st->inputs.blender1a_b[0])) * (int)(CONTEXT_INPUT(rc, st->inputs.blender1b_a[0]))) >> 8) +
+		(((int)(CONTEXT_INPUT(rc, st->inputs.blender2a_b[0])) * (int)(CONTEXT_INPUT(rc, st->inputs.blender2b_a[0]))) >> 8);
 
-	blended_pixel_color.r = r;
-	blended_pixel_color.g = g;
-	blended_pixel_color.b = b;
+	rc->blended_pixel_color.r = r;
+	rc->blended_pixel_color.g = g;
+	rc->blended_pixel_color.b = b;
 
-	pixel_color.r = c2.r;	inv_pixel_color.r = 0xff - c2.r;
-	pixel_color.g = c2.g;	inv_pixel_color.g = 0xff - c2.g;
-	pixel_color.b = c2.b;	inv_pixel_color.b = 0xff - c2.b;
-	pixel_color.a = c2.a;	inv_pixel_color.a = 0xff - c2.a;
+	rc->pixel_color.r = c2.r;	rc->inv_pixel_color.r = 0xff - c2.r;
+	rc->pixel_color.g = c2.g;	rc->inv_pixel_color.g = 0xff - c2.g;
+	rc->pixel_color.b = c2.b;	rc->inv_pixel_color.b = 0xff - c2.b;
+	rc->pixel_color.a = c2.a;	rc->inv_pixel_color.a = 0xff - c2.a;
 
-	r = (((int)(*blender1a_r[1]) * (int)(*blender1b_a[1])) >> 8) +
-		(((int)(*blender2a_r[1]) * (int)(*blender2b_a[1])) >> 8);
+	r = (((int)(CONTEXT_INPUT(rc, st->inputs.blender1a_r[1])) * (int)(CONTEXT_INPUT(rc, st->inputs.blender1b_a[1]))) >> 8) +
+		(((int)(CONTEXT_INPUT(rc, st->inputs.blender2a_r[1])) * (int)(CONTEXT_INPUT(rc, st->inputs.blender2b_a[1]))) >> 8);
 
-	g = (((int)(*blender1a_g[1]) * (int)(*blender1b_a[1])) >> 8) +
-		(((int)(*blender2a_g[1]) * (int)(*blender2b_a[1])) >> 8);
+	g = (((int)(CONTEXT_INPUT(rc, st->inputs.blender1a_g[1])) * (int)(CONTEXT_INPUT(rc, st->inputs.blender1b_a[1]))) >> 8) +
+		(((int)(CONTEXT_INPUT(rc, st->inputs.blender2a_g[1])) * (int)(CONTEXT_INPUT(rc, st->inputs.blender2b_a[1]))) >> 8);
 
-	b = (((int)(*blender1a_b[1]) * (int)(*blender1b_a[1])) >> 8) +
-		(((int)(*blender2a_b[1]) * (int)(*blender2b_a[1])) >> 8);
+	b = (((int)(CONTEXT_INPUT(rc, st->inputs.blender1a_b[1])) * (int)(CONTEXT_INPUT(rc, st->inputs.blender1b_a[1]))) >> 8) +
+		(((int)(CONTEXT_INPUT(rc, st->inputs.blender2a_b[1])) * (int)(CONTEXT_INPUT(rc, st->inputs.blender2b_a[1]))) >> 8);
 
 	if (r > 255) r = 255;
 	if (g > 255) g = 255;
@@ -1407,8 +1516,10 @@ INLINE void BLENDER2_32(UINT32 *fb, COLOR c1, COLOR c2)
 	*fb = (c1.r << 16) | (c1.g << 8) | c1.b;
 }
 
-static void fill_rectangle_32bit(RECTANGLE *rect)
+static void fill_rectangle_32bit(RENDER_CONTEXT *rc, const RDP_PRIMITIVE *prim, int bandmin, int bandmax)
 {
+	const RENDER_STATE *st = prim->state;
+	const RECTANGLE *rect = &prim->rect;
 	UINT32 *fb = (UINT32*)&rdram[(fb_address / 4)];
 	int index, i, j;
 	int x1 = rect->xh / 4;
@@ -1418,10 +1529,10 @@ static void fill_rectangle_32bit(RECTANGLE *rect)
 	int clipx1, clipx2, clipy1, clipy2;
 
 	// TODO: clip
-	clipx1 = clip.xh / 4;
-	clipx2 = clip.xl / 4;
-	clipy1 = clip.yh / 4;
-	clipy2 = clip.yl / 4;
+	clipx1 = st->clip.xh / 4;
+	clipx2 = st->clip.xl / 4;
+	clipy1 = st->clip.yh / 4;
+	clipy2 = st->clip.yl / 4;
 
 	// clip
 	if (x1 < clipx1)
@@ -1441,51 +1552,61 @@ static void fill_rectangle_32bit(RECTANGLE *rect)
 		y2 = clipy2-1;
 	}
 
-	if (other_modes.cycle_type == CYCLE_TYPE_FILL)
+	// only draw this band's share
+	if (y1 < bandmin)
+	{
+		y1 = bandmin;
+	}
+	if (y2 >= bandmax)
+	{
+		y2 = bandmax-1;
+	}
+
+	if (st->other_modes.cycle_type == CYCLE_TYPE_FILL)
 	{
 		for (j=y1; j <= y2; j++)
 		{
 			index = j * fb_width;
 			for (i=x1; i <= x2; i++)
 			{
-				fb[(index + i) ^ 1] = fill_color;
+				fb[(index + i) ^ 1] = st->fill_color;
 			}
 		}
 	}
-	else if (other_modes.cycle_type == CYCLE_TYPE_1)
+	else if (st->other_modes.cycle_type == CYCLE_TYPE_1)
 	{
-		shade_color.r = prim_color.r;
-		shade_color.g = prim_color.g;
-		shade_color.b = prim_color.b;
-		shade_color.a = prim_color.a;
+		rc->shade_color.r = rc->prim_color.r;
+		rc->shade_color.g = rc->prim_color.g;
+		rc->shade_color.b = rc->prim_color.b;
+		rc->shade_color.a = rc->prim_color.a;
 
 		for (j=y1; j <= y2; j++)
 		{
 			index = j * fb_width;
 			for (i=x1; i <= x2; i++)
 			{
-				COLOR c = COLOR_COMBINER(0);
+				COLOR c = COLOR_COMBINER(st, rc, 0);
 
-				BLENDER1_32(&fb[(index + i)], c);
+				BLENDER1_32(st, rc, &fb[(index + i)], c);
 			}
 		}
 	}
-	else if (other_modes.cycle_type == CYCLE_TYPE_2)
+	else if (st->other_modes.cycle_type == CYCLE_TYPE_2)
 	{
-		shade_color.r = prim_color.r;
-		shade_color.g = prim_color.g;
-		shade_color.b = prim_color.b;
-		shade_color.a = prim_color.a;
+		rc->shade_color.r = rc->prim_color.r;
+		rc->shade_color.g = rc->prim_color.g;
+		rc->shade_color.b = rc->prim_color.b;
+		rc->shade_color.a = rc->prim_color.a;
 
 		for (j=y1; j <= y2; j++)
 		{
 			index = j * fb_width;
 			for (i=x1; i <= x2; i++)
 			{
-				COLOR c1 = COLOR_COMBINER(0);
-				COLOR c2 = COLOR_COMBINER(1);
+				COLOR c1 = COLOR_COMBINER(st, rc, 0);
+				COLOR c2 = COLOR_COMBINER(st, rc, 1);
 
-				BLENDER2_32(&fb[(index + i)], c1, c2);
+				BLENDER2_32(st, rc, &fb[(index + i)], c1, c2);
 			}
 		}
 	}
@@ -1495,8 +1616,11 @@ static void fill_rectangle_32bit(RECTANGLE *rect)
 	}
 }
 
-static void texture_rectangle_32bit(TEX_RECTANGLE *rect)
+static void texture_rectangle_32bit(RENDER_CONTEXT *rc, const RDP_PRIMITIVE *prim, int bandmin, int bandmax)
 {
+	const RENDER_STATE *st = prim->state;
+	TEX_RECTANGLE rectcopy = prim->texrect;
+	TEX_RECTANGLE *rect = &rectcopy;
 	UINT32 *fb = (UINT32*)&rdram[(fb_address / 4)];
 	int i, j;
 	int x1, x2, y1, y2;
@@ -1511,17 +1635,17 @@ static void texture_rectangle_32bit(TEX_RECTANGLE *rect)
 	y1 = (rect->yh / 4);
 	y2 = (rect->yl / 4);
 
-	if (other_modes.cycle_type == CYCLE_TYPE_FILL || other_modes.cycle_type == CYCLE_TYPE_COPY)
+	if (st->other_modes.cycle_type == CYCLE_TYPE_FILL || st->other_modes.cycle_type == CYCLE_TYPE_COPY)
 	{
 		rect->dsdx /= 4;
 		x2 += 1;
 		y2 += 1;
 	}
 
-	clipx1 = clip.xh / 4;
-	clipx2 = clip.xl / 4;
-	clipy1 = clip.yh / 4;
-	clipy2 = clip.yl / 4;
+	clipx1 = st->clip.xh / 4;
+	clipx2 = st->clip.xl / 4;
+	clipy1 = st->clip.yh / 4;
+	clipy2 = st->clip.yl / 4;
 
 	// clip
 	if (x1 < clipx1)
@@ -1541,32 +1665,43 @@ static void texture_rectangle_32bit(TEX_RECTANGLE *rect)
 		y2 = clipy2-1;
 	}
 
-	tsl = tile[rect->tilenum].sl;
-	tsh = tile[rect->tilenum].sh;
-	ttl = tile[rect->tilenum].tl;
-	tth = tile[rect->tilenum].th;
+	tsl = st->tile[rect->tilenum].sl;
+	tsh = st->tile[rect->tilenum].sh;
+	ttl = st->tile[rect->tilenum].tl;
+	tth = st->tile[rect->tilenum].th;
 
-	twidth = tile[rect->tilenum].line;
-	tformat = tile[rect->tilenum].format;
-	tsize = tile[rect->tilenum].size;
-	tbase = tile[rect->tilenum].tmem;
+	twidth = st->tile[rect->tilenum].line;
+	tformat = st->tile[rect->tilenum].format;
+	tsize = st->tile[rect->tilenum].size;
+	tbase = st->tile[rect->tilenum].tmem;
 
 	// FIXME?: clamping breaks at least Rampage World Tour
 	clamp_t = 0; //tile[rect->tilenum].ct;
 	clamp_s = 0; //tile[rect->tilenum].cs;
 
-	mirror_t = tile[rect->tilenum].mt;
-	mirror_s = tile[rect->tilenum].ms;
-	mask_t = tile[rect->tilenum].mask_t;
-	mask_s = tile[rect->tilenum].mask_s;
+	mirror_t = st->tile[rect->tilenum].mt;
+	mirror_s = st->tile[rect->tilenum].ms;
+	mask_t = st->tile[rect->tilenum].mask_t;
+	mask_s = st->tile[rect->tilenum].mask_s;
 
 	t = (int)(rect->t) << 5;
 
-	if (other_modes.cycle_type == CYCLE_TYPE_1 || other_modes.cycle_type == CYCLE_TYPE_2)
+	// only draw this band's share, stepping t down to the first row
+	if (y1 < bandmin)
+	{
+		t += (bandmin - y1) * rect->dtdy;
+		y1 = bandmin;
+	}
+	if (y2 > bandmax)
+	{
+		y2 = bandmax;
+	}
+
+	if (st->other_modes.cycle_type == CYCLE_TYPE_1 || st->other_modes.cycle_type == CYCLE_TYPE_2)
 	{
 	}
 
-	if (other_modes.cycle_type == CYCLE_TYPE_1)
+	if (st->other_modes.cycle_type == CYCLE_TYPE_1)
 	{
 		for (j = y1; j < y2; j++)
 		{
@@ -1588,9 +1723,9 @@ static void texture_rectangle_32bit(TEX_RECTANGLE *rect)
 
 				TEXTURE_PIPELINE1(s, t, (rect->dsdx == (1 << 10)) && (rect->dtdy == (1 << 10)));
 
-				c = COLOR_COMBINER(0);
+				c = COLOR_COMBINER(st, rc, 0);
 
-				BLENDER1_32(&fb[(fb_index + i)], c);
+				BLENDER1_32(st, rc, &fb[(fb_index + i)], c);
 
 				s += rect->dsdx;
 			}
@@ -1598,7 +1733,7 @@ static void texture_rectangle_32bit(TEX_RECTANGLE *rect)
 			t += rect->dtdy;
 		}
 	}
-	else if (other_modes.cycle_type == CYCLE_TYPE_2)
+	else if (st->other_modes.cycle_type == CYCLE_TYPE_2)
 	{
 		for (j = y1; j < y2; j++)
 		{
@@ -1621,10 +1756,10 @@ static void texture_rectangle_32bit(TEX_RECTANGLE *rect)
 
 				TEXTURE_PIPELINE2(s, t, (rect->dsdx == (1 << 10)) && (rect->dtdy == (1 << 10)));
 
-				c1 = COLOR_COMBINER(0);
-				c2 = COLOR_COMBINER(1);
+				c1 = COLOR_COMBINER(st, rc, 0);
+				c2 = COLOR_COMBINER(st, rc, 1);
 
-				BLENDER2_32(&fb[(fb_index + i)], c1, c2);
+				BLENDER2_32(st, rc, &fb[(fb_index + i)], c1, c2);
 
 				s += rect->dsdx;
 			}
@@ -1632,7 +1767,7 @@ static void texture_rectangle_32bit(TEX_RECTANGLE *rect)
 			t += rect->dtdy;
 		}
 	}
-	else if (other_modes.cycle_type == CYCLE_TYPE_COPY)
+	else if (st->other_modes.cycle_type == CYCLE_TYPE_COPY)
 	{
 		for (j = y1; j < y2; j++)
 		{
@@ -1674,9 +1809,9 @@ static void texture_rectangle_32bit(TEX_RECTANGLE *rect)
 				//CLAMP(ss, st);
 				//FETCH_TEXEL(&c, ss, st, twidth, tformat, tsize, tbase);
 
-				if (texel0_color.a != 0)
+				if (rc->texel0_color.a != 0)
 				{
-					fb[(fb_index + i) ^ WORD_ADDR_XOR] = (texel0_color.r << 16) | (texel0_color.g << 8) | (texel0_color.b << 0);
+					fb[(fb_index + i) ^ WORD_ADDR_XOR] = (rc->texel0_color.r << 16) | (rc->texel0_color.g << 8) | (rc->texel0_color.b << 0);
 				}
 
 				s += rect->dsdx;
@@ -1687,13 +1822,20 @@ static void texture_rectangle_32bit(TEX_RECTANGLE *rect)
 	}
 	else
 	{
-		fatalerror("texture_rectangle_32bit: unknown cycle type %d\n", other_modes.cycle_type);
+		fatalerror("texture_rectangle_32bit: unknown cycle type %d\n", st->other_modes.cycle_type);
 	}
 }
 
 
-static void render_spans_32(int start, int end, int tilenum, int shade, int texture, int zbuffer, int flip)
+static void render_spans_32(RENDER_CONTEXT *rc, const RDP_PRIMITIVE *prim, int bandmin, int bandmax)
 {
+	const RENDER_STATE *st = prim->state;
+	int start = prim->starty;
+	int end = prim->endy;
+	int tilenum = prim->tilenum;
+	int texture = prim->texture;
+	int zbuffer = prim->zbuffer;
+	int flip = prim->flip;
 	UINT32 *fb = (UINT32*)&rdram[fb_address / 4];
 	UINT16 *zb = (UINT16*)&rdram[zb_address / 4];
 	int i, j;
@@ -1703,27 +1845,27 @@ static void render_spans_32(int start, int end, int tilenum, int shade, int text
 
 	int clipx1, clipx2, clipy1, clipy2;
 
-	clipx1 = clip.xh / 4;
-	clipx2 = clip.xl / 4;
-	clipy1 = clip.yh / 4;
-	clipy2 = clip.yl / 4;
+	clipx1 = st->clip.xh / 4;
+	clipx2 = st->clip.xl / 4;
+	clipy1 = st->clip.yh / 4;
+	clipy2 = st->clip.yl / 4;
 
-	tsl = tile[tilenum].sl;
-	tsh = tile[tilenum].sh;
-	ttl = tile[tilenum].tl;
-	tth = tile[tilenum].th;
+	tsl = st->tile[tilenum].sl;
+	tsh = st->tile[tilenum].sh;
+	ttl = st->tile[tilenum].tl;
+	tth = st->tile[tilenum].th;
 
-	twidth = tile[tilenum].line;
-	tformat = tile[tilenum].format;
-	tsize = tile[tilenum].size;
-	tbase = tile[tilenum].tmem;
+	twidth = st->tile[tilenum].line;
+	tformat = st->tile[tilenum].format;
+	tsize = st->tile[tilenum].size;
+	tbase = st->tile[tilenum].tmem;
 
-	clamp_t = tile[tilenum].ct;
-	clamp_s = tile[tilenum].cs;
-	mirror_t = tile[tilenum].mt;
-	mirror_s = tile[tilenum].ms;
-	mask_t = tile[tilenum].mask_t;
-	mask_s = tile[tilenum].mask_s;
+	clamp_t = st->tile[tilenum].ct;
+	clamp_s = st->tile[tilenum].cs;
+	mirror_t = st->tile[tilenum].mt;
+	mirror_s = st->tile[tilenum].ms;
+	mask_t = st->tile[tilenum].mask_t;
+	mask_s = st->tile[tilenum].mask_s;
 
 	if (start < clipy1)
 	{
@@ -1742,26 +1884,45 @@ static void render_spans_32(int start, int end, int tilenum, int shade, int text
 		end = clipy2-1;
 	}
 
+	// only rows with spans, and only this band's share of them
+	if (start < prim->starty)
+	{
+		start = prim->starty;
+	}
+	if (end > prim->endy)
+	{
+		end = prim->endy;
+	}
+	if (start < bandmin)
+	{
+		start = bandmin;
+	}
+	if (end >= bandmax)
+	{
+		end = bandmax-1;
+	}
+
 	for (i=start; i <= end; i++)
 	{
-		int xstart = span[i].lx;
-		int xend = span[i].rx;
-		int r = span[i].r;
-		int g = span[i].g;
-		int b = span[i].b;
-		int a = span[i].a;
-		int z = span[i].z;
-		int s = span[i].s;
-		int t = span[i].t;
-		int w = span[i].w;
-		int dr = span[i].dr;
-		int dg = span[i].dg;
-		int db = span[i].db;
-		int da = span[i].da;
-		int dz = span[i].dz;
-		int ds = span[i].ds;
-		int dt = span[i].dt;
-		int dw = span[i].dw;
+		const SPAN *sp = &prim->spans[i - prim->starty];
+		int xstart = sp->lx;
+		int xend = sp->rx;
+		int r = sp->r;
+		int g = sp->g;
+		int b = sp->b;
+		int a = sp->a;
+		int z = sp->z;
+		int s = sp->s;
+		int t = sp->t;
+		int w = sp->w;
+		int dr = sp->dr;
+		int dg = sp->dg;
+		int db = sp->db;
+		int da = sp->da;
+		int dz = sp->dz;
+		int ds = sp->ds;
+		int dt = sp->dt;
+		int dw = sp->dw;
 		int drinc, dginc, dbinc, dainc, dzinc, dsinc, dtinc, dwinc;
 
 		int x;
@@ -1791,7 +1952,7 @@ static void render_spans_32(int start, int end, int tilenum, int shade, int text
 			int sb = b >> 16;
 			int sa = a >> 16;
 			int ss = s >> 16;
-			int st = t >> 16;
+			int tt = t >> 16;
 			int sw = w >> 16;
 			UINT16 sz = z >> 16;
 			int oz;
@@ -1806,23 +1967,23 @@ static void render_spans_32(int start, int end, int tilenum, int shade, int text
 				if ((z & 0xffff) >= 0x8000) sz++;
 				if ((w & 0xffff) >= 0x8000) sw++;
 
-				if (other_modes.persp_tex_en)
+				if (st->other_modes.persp_tex_en)
 				{
 					if (sw != 0)
 					{
 						sss = (((INT64)(ss) << 20) / sw);
-						sst = (((INT64)(st) << 20) / sw);
+						sst = (((INT64)(tt) << 20) / sw);
 					}
 				}
 				else
 				{
 					sss = ss;
-					sst = st;
+					sst = tt;
 				}
 
 				if (sr > 0xff) sr = 0xff;	if (sg > 0xff) sg = 0xff;	if (sb > 0xff) sb = 0xff;
 
-				shade_color.r = sr; shade_color.g = sg; shade_color.b = sb; shade_color.a = sa;
+				rc->shade_color.r = sr; rc->shade_color.g = sg; rc->shade_color.b = sb; rc->shade_color.a = sa;
 
 				if (texture)
 				{
@@ -1870,7 +2031,7 @@ static void render_spans_32(int start, int end, int tilenum, int shade, int text
                         FETCH_TEXEL(&texel0_color, sss1, sst1, twidth, tformat, tsize, tbase);
                     }*/
 
-					if (other_modes.cycle_type == CYCLE_TYPE_1)
+					if (st->other_modes.cycle_type == CYCLE_TYPE_1)
 					{
 						TEXTURE_PIPELINE1(sss, sst, 0);
 					}
@@ -1880,14 +2041,14 @@ static void render_spans_32(int start, int end, int tilenum, int shade, int text
 					}
 				}
 
-				if (other_modes.cycle_type == CYCLE_TYPE_1)
+				if (st->other_modes.cycle_type == CYCLE_TYPE_1)
 				{
-					c1 = COLOR_COMBINER(0);
+					c1 = COLOR_COMBINER(st, rc, 0);
 				}
-				else if (other_modes.cycle_type == CYCLE_TYPE_2)
+				else if (st->other_modes.cycle_type == CYCLE_TYPE_2)
 				{
-					c1 = COLOR_COMBINER(0);
-					c2 = COLOR_COMBINER(1);
+					c1 = COLOR_COMBINER(st, rc, 0);
+					c2 = COLOR_COMBINER(st, rc, 1);
 				}
 
 				oz = (UINT16)zb[(fb_index + x) ^ WORD_ADDR_XOR];
@@ -1895,16 +2056,16 @@ static void render_spans_32(int start, int end, int tilenum, int shade, int text
 				{
 					if (sz < oz /*&& c.a != 0*/)
 					{
-						if (other_modes.cycle_type == CYCLE_TYPE_1)
+						if (st->other_modes.cycle_type == CYCLE_TYPE_1)
 						{
-							BLENDER1_32(&fb[(fb_index + x)], c1);
+							BLENDER1_32(st, rc, &fb[(fb_index + x)], c1);
 						}
 						else
 						{
-							BLENDER2_32(&fb[(fb_index + x)], c1, c2);
+							BLENDER2_32(st, rc, &fb[(fb_index + x)], c1, c2);
 						}
 
-						if (other_modes.z_compare_en && other_modes.z_update_en)
+						if (st->other_modes.z_compare_en && st->other_modes.z_update_en)
 						{
 							zb[(fb_index + x) ^ WORD_ADDR_XOR] = sz;
 						}
@@ -1912,13 +2073,13 @@ static void render_spans_32(int start, int end, int tilenum, int shade, int text
 				}
 				else
 				{
-					if (other_modes.cycle_type == CYCLE_TYPE_1)
+					if (st->other_modes.cycle_type == CYCLE_TYPE_1)
 					{
-						BLENDER1_32(&fb[(fb_index + x)], c1);
+						BLENDER1_32(st, rc, &fb[(fb_index + x)], c1);
 					}
 					else
 					{
-						BLENDER2_32(&fb[(fb_index + x)], c1, c2);
+						BLENDER2_32(st, rc, &fb[(fb_index + x)], c1, c2);
 					}
 				}
 			}
@@ -1941,8 +2102,15 @@ static void render_spans_32(int start, int end, int tilenum, int shade, int text
 
 
 
-static void render_spans_16(int start, int end, int tilenum, int shade, int texture, int zbuffer, int flip)
+static void render_spans_16(RENDER_CONTEXT *rc, const RDP_PRIMITIVE *prim, int bandmin, int bandmax)
 {
+	const RENDER_STATE *st = prim->state;
+	int start = prim->starty;
+	int end = prim->endy;
+	int tilenum = prim->tilenum;
+	int texture = prim->texture;
+	int zbuffer = prim->zbuffer;
+	int flip = prim->flip;
 	UINT16 *fb = (UINT16*)&rdram[fb_address / 4];
 	UINT16 *zb = (UINT16*)&rdram[zb_address / 4];
 	int i, j;
@@ -1952,27 +2120,27 @@ static void render_spans_16(int start, int end, int tilenum, int shade, int text
 
 	int clipx1, clipx2, clipy1, clipy2;
 
-	clipx1 = clip.xh / 4;
-	clipx2 = clip.xl / 4;
-	clipy1 = clip.yh / 4;
-	clipy2 = clip.yl / 4;
+	clipx1 = st->clip.xh / 4;
+	clipx2 = st->clip.xl / 4;
+	clipy1 = st->clip.yh / 4;
+	clipy2 = st->clip.yl / 4;
 
-	tsl = tile[tilenum].sl;
-	tsh = tile[tilenum].sh;
-	ttl = tile[tilenum].tl;
-	tth = tile[tilenum].th;
+	tsl = st->tile[tilenum].sl;
+	tsh = st->tile[tilenum].sh;
+	ttl = st->tile[tilenum].tl;
+	tth = st->tile[tilenum].th;
 
-	twidth = tile[tilenum].line;
-	tformat = tile[tilenum].format;
-	tsize = tile[tilenum].size;
-	tbase = tile[tilenum].tmem;
+	twidth = st->tile[tilenum].line;
+	tformat = st->tile[tilenum].format;
+	tsize = st->tile[tilenum].size;
+	tbase = st->tile[tilenum].tmem;
 
-	clamp_t = tile[tilenum].ct;
-	clamp_s = tile[tilenum].cs;
-	mirror_t = tile[tilenum].mt;
-	mirror_s = tile[tilenum].ms;
-	mask_t = tile[tilenum].mask_t;
-	mask_s = tile[tilenum].mask_s;
+	clamp_t = st->tile[tilenum].ct;
+	clamp_s = st->tile[tilenum].cs;
+	mirror_t = st->tile[tilenum].mt;
+	mirror_s = st->tile[tilenum].ms;
+	mask_t = st->tile[tilenum].mask_t;
+	mask_s = st->tile[tilenum].mask_s;
 
 	if (start < clipy1)
 	{
@@ -1991,26 +2159,45 @@ static void render_spans_16(int start, int end, int tilenum, int shade, int text
 		end = clipy2-1;
 	}
 
+	// only rows with spans, and only this band's share of them
+	if (start < prim->starty)
+	{
+		start = prim->starty;
+	}
+	if (end > prim->endy)
+	{
+		end = prim->endy;
+	}
+	if (start < bandmin)
+	{
+		start = bandmin;
+	}
+	if (end >= bandmax)
+	{
+		end = bandmax-1;
+	}
+
 	for (i=start; i <= end; i++)
 	{
-		int xstart = span[i].lx;
-		int xend = span[i].rx;
-		int r = span[i].r;
-		int g = span[i].g;
-		int b = span[i].b;
-		int a = span[i].a;
-		int z = span[i].z;
-		int s = span[i].s;
-		int t = span[i].t;
-		int w = span[i].w;
-		int dr = span[i].dr;
-		int dg = span[i].dg;
-		int db = span[i].db;
-		int da = span[i].da;
-		int dz = span[i].dz;
-		int ds = span[i].ds;
-		int dt = span[i].dt;
-		int dw = span[i].dw;
+		const SPAN *sp = &prim->spans[i - prim->starty];
+		int xstart = sp->lx;
+		int xend = sp->rx;
+		int r = sp->r;
+		int g = sp->g;
+		int b = sp->b;
+		int a = sp->a;
+		int z = sp->z;
+		int s = sp->s;
+		int t = sp->t;
+		int w = sp->w;
+		int dr = sp->dr;
+		int dg = sp->dg;
+		int db = sp->db;
+		int da = sp->da;
+		int dz = sp->dz;
+		int ds = sp->ds;
+		int dt = sp->dt;
+		int dw = sp->dw;
 		int drinc, dginc, dbinc, dainc, dzinc, dsinc, dtinc, dwinc;
 
 		int x;
@@ -2083,7 +2270,7 @@ static void render_spans_16(int start, int end, int tilenum, int shade, int text
 			int sb = b >> 16;
 			int sa = a >> 16;
 			int ss = s >> 16;
-			int st = t >> 16;
+			int tt = t >> 16;
 			int sw = w >> 16;
 			UINT16 sz = z >> 16;
 			int oz;
@@ -2097,23 +2284,23 @@ static void render_spans_16(int start, int end, int tilenum, int shade, int text
 				if ((z & 0xffff) >= 0x8000) sz++;
 				if ((w & 0xffff) >= 0x8000) sw++;
 
-				if (other_modes.persp_tex_en)
+				if (st->other_modes.persp_tex_en)
 				{
 					if (sw != 0)
 					{
 						sss = (((INT64)(ss) << 20) / sw);
-						sst = (((INT64)(st) << 20) / sw);
+						sst = (((INT64)(tt) << 20) / sw);
 					}
 				}
 				else
 				{
 					sss = ss;
-					sst = st;
+					sst = tt;
 				}
 
 				if (sr > 0xff) sr = 0xff;	if (sg > 0xff) sg = 0xff;	if (sb > 0xff) sb = 0xff;
 
-				shade_color.r = sr; shade_color.g = sg; shade_color.b = sb; shade_color.a = sa;
+				rc->shade_color.r = sr; rc->shade_color.g = sg; rc->shade_color.b = sb; rc->shade_color.a = sa;
 
 				if (texture)
 				{
@@ -2161,7 +2348,7 @@ static void render_spans_16(int start, int end, int tilenum, int shade, int text
                         FETCH_TEXEL(&texel0_color, sss1, sst1, twidth, tformat, tsize, tbase);
                     }*/
 
-					if (other_modes.cycle_type == CYCLE_TYPE_1)
+					if (st->other_modes.cycle_type == CYCLE_TYPE_1)
 					{
 						TEXTURE_PIPELINE1(sss, sst, 0);
 					}
@@ -2171,14 +2358,14 @@ static void render_spans_16(int start, int end, int tilenum, int shade, int text
 					}
 				}
 
-				if (other_modes.cycle_type == CYCLE_TYPE_1)
+				if (st->other_modes.cycle_type == CYCLE_TYPE_1)
 				{
-					c1 = COLOR_COMBINER(0);
+					c1 = COLOR_COMBINER(st, rc, 0);
 				}
-				else if (other_modes.cycle_type == CYCLE_TYPE_2)
+				else if (st->other_modes.cycle_type == CYCLE_TYPE_2)
 				{
-					c1 = COLOR_COMBINER(0);
-					c2 = COLOR_COMBINER(1);
+					c1 = COLOR_COMBINER(st, rc, 0);
+					c2 = COLOR_COMBINER(st, rc, 1);
 				}
 
 				oz = (UINT16)zb[(fb_index + x) ^ WORD_ADDR_XOR];
@@ -2189,17 +2376,17 @@ static void render_spans_16(int start, int end, int tilenum, int shade, int text
 						//BLENDER1_16(&fb[(fb_index + x) ^ WORD_ADDR_XOR], c);
 						{
 							int dith = dither_matrix_4x4[(((j) & 3) << 2) + ((i^WORD_ADDR_XOR) & 3)];
-							if (other_modes.cycle_type == CYCLE_TYPE_1)
+							if (st->other_modes.cycle_type == CYCLE_TYPE_1)
 							{
-								BLENDER1_16(&fb[(fb_index + x) ^ WORD_ADDR_XOR], c1, dith);
+								BLENDER1_16(st, rc, &fb[(fb_index + x) ^ WORD_ADDR_XOR], c1, dith);
 							}
 							else
 							{
-								BLENDER2_16(&fb[(fb_index + x) ^ WORD_ADDR_XOR], c1, c2, dith);
+								BLENDER2_16(st, rc, &fb[(fb_index + x) ^ WORD_ADDR_XOR], c1, c2, dith);
 							}
 						}
 
-						if (other_modes.z_compare_en && other_modes.z_update_en)
+						if (st->other_modes.z_compare_en && st->other_modes.z_update_en)
 						{
 							zb[(fb_index + x) ^ WORD_ADDR_XOR] = sz;
 						}
@@ -2211,13 +2398,13 @@ static void render_spans_16(int start, int end, int tilenum, int shade, int text
 
 					{
 						int dith = dither_matrix_4x4[(((j) & 3) << 2) + ((i^WORD_ADDR_XOR) & 3)];
-						if (other_modes.cycle_type == CYCLE_TYPE_1)
+						if (st->other_modes.cycle_type == CYCLE_TYPE_1)
 						{
-							BLENDER1_16(&fb[(fb_index + x) ^ WORD_ADDR_XOR], c1, dith);
+							BLENDER1_16(st, rc, &fb[(fb_index + x) ^ WORD_ADDR_XOR], c1, dith);
 						}
 						else
 						{
-							BLENDER2_16(&fb[(fb_index + x) ^ WORD_ADDR_XOR], c1, c2, dith);
+							BLENDER2_16(st, rc, &fb[(fb_index + x) ^ WORD_ADDR_XOR], c1, c2, dith);
 						}
 					}
 				}
@@ -2237,6 +2424,179 @@ static void render_spans_16(int start, int end, int tilenum, int shade, int text
 	}
 }
 
+/*****************************************************************************/
+
+// Deferred rendering
+//
+// Drawing commands are queued along with a snapshot of the state they use, and are
+// drawn when something needs the results (or the inputs are about to change). The
+// screen is split into horizontal bands which are drawn in parallel; every pixel
+// belongs to exactly one band, so drawing each band in queue order keeps the
+// overdraw order of the original command list.
+
+static const RENDER_STATE *capture_state(void)
+{
+	RENDER_STATE *state = &state_pool[state_count];
+
+	memset(state, 0, sizeof(*state));
+	state->other_modes = other_modes;
+	state->inputs = inputs;
+	state->blend_color = blend_color;
+	state->prim_color = prim_color;
+	state->env_color = env_color;
+	state->fog_color = fog_color;
+	state->fill_color = fill_color;
+	state->clip = clip;
+	memcpy(state->tile, tile, sizeof(tile));
+
+	// most commands in a row share the same state
+	if (state_count > 0 && memcmp(state, &state_pool[state_count - 1], sizeof(*state)) == 0)
+	{
+		return &state_pool[state_count - 1];
+	}
+	return &state_pool[state_count++];
+}
+
+static void *render_band_callback(void *param)
+{
+	RENDER_BAND *bnd = param;
+	RENDER_CONTEXT *rc = &bnd->context;
+	int i;
+
+	memset(rc, 0, sizeof(*rc));
+	rc->one_color.r = rc->one_color.g = rc->one_color.b = rc->one_color.a = 0xff;
+
+	for (i=0; i < prim_count; i++)
+	{
+		const RDP_PRIMITIVE *prim = &prim_queue[i];
+
+		if (prim->starty >= bnd->stopy || prim->endy < bnd->starty)
+		{
+			continue;
+		}
+
+		rc->blend_color = prim->state->blend_color;
+		rc->prim_color = prim->state->prim_color;
+		rc->env_color = prim->state->env_color;
+		rc->fog_color = prim->state->fog_color;
+
+		switch (prim->type)
+		{
+			case PRIMITIVE_TRIANGLE:
+			{
+				switch (fb_size)
+				{
+					case PIXEL_SIZE_16BIT:	render_spans_16(rc, prim, bnd->starty, bnd->stopy); break;
+					case PIXEL_SIZE_32BIT:	render_spans_32(rc, prim, bnd->starty, bnd->stopy); break;
+				}
+				break;
+			}
+
+			case PRIMITIVE_FILL_RECT:
+			{
+				switch (fb_size)
+				{
+					case PIXEL_SIZE_16BIT:	fill_rectangle_16bit(rc, prim, bnd->starty, bnd->stopy); break;
+					case PIXEL_SIZE_32BIT:	fill_rectangle_32bit(rc, prim, bnd->starty, bnd->stopy); break;
+				}
+				break;
+			}
+
+			case PRIMITIVE_TEX_RECT:
+			{
+				switch (fb_size)
+				{
+					case PIXEL_SIZE_16BIT:	texture_rectangle_16bit(rc, prim, bnd->starty, bnd->stopy); break;
+					case PIXEL_SIZE_32BIT:	texture_rectangle_32bit(rc, prim, bnd->starty, bnd->stopy); break;
+				}
+				break;
+			}
+		}
+	}
+	return NULL;
+}
+
+static void flush_primitives(void)
+{
+	osd_work_item *item[RENDER_BANDS];
+	int miny, maxy, height;
+	int bands, i;
+
+	if (prim_count == 0)
+	{
+		return;
+	}
+
+	// find the range of scanlines covered
+	miny = prim_queue[0].starty;
+	maxy = prim_queue[0].endy + 1;
+	for (i=1; i < prim_count; i++)
+	{
+		if (prim_queue[i].starty < miny)
+		{
+			miny = prim_queue[i].starty;
+		}
+		if (prim_queue[i].endy + 1 > maxy)
+		{
+			maxy = prim_queue[i].endy + 1;
+		}
+	}
+
+	bands = (render_queue != NULL) ? (maxy - miny) / RENDER_MIN_BAND_HEIGHT : 1;
+	bands = MAX(1, MIN(bands, RENDER_BANDS));
+	height = (maxy - miny + bands - 1) / bands;
+
+	for (i=0; i < bands; i++)
+	{
+		band[i].starty = miny + i * height;
+		band[i].stopy = MIN(band[i].starty + height, maxy);
+
+		// the first band is ours; if a band can't be queued, draw it here
+		item[i] = NULL;
+		if (i != 0)
+		{
+			item[i] = osd_work_item_queue(render_queue, render_band_callback, &band[i]);
+			if (item[i] == NULL)
+			{
+				render_band_callback(&band[i]);
+			}
+		}
+	}
+	render_band_callback(&band[0]);
+
+	for (i=0; i < bands; i++)
+	{
+		if (item[i] != NULL)
+		{
+			while (!osd_work_item_wait(item[i], osd_ticks_per_second())) ;
+			osd_work_item_release(item[i]);
+		}
+	}
+
+	prim_count = 0;
+	state_count = 0;
+	span_count = 0;
+}
+
+static RDP_PRIMITIVE *alloc_primitive(int type, int spans)
+{
+	RDP_PRIMITIVE *prim;
+
+	if (prim_count >= MAX_PRIMITIVES || span_count + spans > SPAN_POOL_SIZE)
+	{
+		flush_primitives();
+	}
+
+	prim = &prim_queue[prim_count++];
+	prim->type = type;
+	prim->state = capture_state();
+	prim->spans = &span_pool[span_count];
+	span_count += spans;
+	return prim;
+}
+
+/*****************************************************************************/
+
 static void triangle(UINT32 w1, UINT32 w2, int shade, int texture, int zbuffer)
 {
 	int j;
@@ -2249,6 +2609,9 @@ static void triangle(UINT32 w1, UINT32 w2, int shade, int texture, int zbuffer)
 	int drde = 0, dgde = 0, dbde = 0, dade = 0, dzde = 0, dsde = 0, dtde = 0, dwde = 0;
 	int tile;
 	int flip = (w1 & 0x800000) ? 1 : 0;
+	int firsty, lasty;
+	RDP_PRIMITIVE *prim;
+	SPAN *spans;
 
 	INT32 yl, ym, yh;
 	INT32 xl, xm, xh;
@@ -2295,6 +2658,24 @@ static void triangle(UINT32 w1, UINT32 w2, int shade, int texture, int zbuffer)
 
 	tile = (w1 >> 16) & 0x7;
 
+	// only rows on the screen get a span
+	firsty = MAX(yh, 0);
+	lasty = MIN(yl, MAX_SPAN_ROWS - 1);
+	if (firsty > lasty)
+	{
+		return;
+	}
+
+	prim = alloc_primitive(PRIMITIVE_TRIANGLE, lasty - firsty + 1);
+	prim->starty = firsty;
+	prim->endy = lasty;
+	prim->tilenum = tile;
+	prim->shade = shade;
+	prim->texture = texture;
+	prim->zbuffer = zbuffer;
+	prim->flip = flip;
+	spans = prim->spans;
+
 	r = 0xff;	g = 0xff;	b = 0xff;	a = 0xff;	z = 0;	s = 0;	t = 0;	w = 0;
 	dr = 0;		dg = 0;		db = 0;		da = 0;
 
@@ -2350,18 +2731,18 @@ static void triangle(UINT32 w1, UINT32 w2, int shade, int texture, int zbuffer)
 		xstart = xleft >> 16;
 		xend = xright >> 16;
 
-		if (j >= 0)
+		if (j >= firsty && j <= lasty)
 		{
-			span[j].lx = xstart;
-			span[j].rx = xend;
-			span[j].s = s;		span[j].ds = dsdx;
-			span[j].t = t;		span[j].dt = dtdx;
-			span[j].w = w;		span[j].dw = dwdx;
-			span[j].r = r;		span[j].dr = drdx;
-			span[j].g = g;		span[j].dg = dgdx;
-			span[j].b = b;		span[j].db = dbdx;
-			span[j].a = a;		span[j].da = dadx;
-			span[j].z = z;		span[j].dz = dzdx;
+			spans[j - firsty].lx = xstart;
+			spans[j - firsty].rx = xend;
+			spans[j - firsty].s = s;		spans[j - firsty].ds = dsdx;
+			spans[j - firsty].t = t;		spans[j - firsty].dt = dtdx;
+			spans[j - firsty].w = w;		spans[j - firsty].dw = dwdx;
+			spans[j - firsty].r = r;		spans[j - firsty].dr = drdx;
+			spans[j - firsty].g = g;		spans[j - firsty].dg = dgdx;
+			spans[j - firsty].b = b;		spans[j - firsty].db = dbdx;
+			spans[j - firsty].a = a;		spans[j - firsty].da = dadx;
+			spans[j - firsty].z = z;		spans[j - firsty].dz = dzdx;
 		}
 
 		xleft += xleft_inc;
@@ -2385,18 +2766,18 @@ static void triangle(UINT32 w1, UINT32 w2, int shade, int texture, int zbuffer)
 		xstart = xleft >> 16;
 		xend = xright >> 16;
 
-		if (j >= 0)
+		if (j >= firsty && j <= lasty)
 		{
-			span[j].lx = xstart;
-			span[j].rx = xend;
-			span[j].s = s;		span[j].ds = dsdx;
-			span[j].t = t;		span[j].dt = dtdx;
-			span[j].w = w;		span[j].dw = dwdx;
-			span[j].r = r;		span[j].dr = drdx;
-			span[j].g = g;		span[j].dg = dgdx;
-			span[j].b = b;		span[j].db = dbdx;
-			span[j].a = a;		span[j].da = dadx;
-			span[j].z = z;		span[j].dz = dzdx;
+			spans[j - firsty].lx = xstart;
+			spans[j - firsty].rx = xend;
+			spans[j - firsty].s = s;		spans[j - firsty].ds = dsdx;
+			spans[j - firsty].t = t;		spans[j - firsty].dt = dtdx;
+			spans[j - firsty].w = w;		spans[j - firsty].dw = dwdx;
+			spans[j - firsty].r = r;		spans[j - firsty].dr = drdx;
+			spans[j - firsty].g = g;		spans[j - firsty].dg = dgdx;
+			spans[j - firsty].b = b;		spans[j - firsty].db = dbdx;
+			spans[j - firsty].a = a;		spans[j - firsty].da = dadx;
+			spans[j - firsty].z = z;		spans[j - firsty].dz = dzdx;
 		}
 
 		xleft += xleft_inc;
@@ -2410,12 +2791,6 @@ static void triangle(UINT32 w1, UINT32 w2, int shade, int texture, int zbuffer)
 		a += dade;
 		z += dzde;
 	}
-
-	switch (fb_size)
-	{
-		case PIXEL_SIZE_16BIT:	render_spans_16(yh, yl, tile, shade, texture, zbuffer, flip); break;
-		case PIXEL_SIZE_32BIT:	render_spans_32(yh, yl, tile, shade, texture, zbuffer, flip); break;
-	}
 }
 
 /*****************************************************************************/
@@ -2880,6 +3255,15 @@ static void rdp_tri_texshade_z(UINT32 w1, UINT32 w2)
 	triangle(w1, w2, 1, 1, 1);
 }
 
+static void queue_texture_rectangle(const TEX_RECTANGLE *rect)
+{
+	RDP_PRIMITIVE *prim = alloc_primitive(PRIMITIVE_TEX_RECT, 0);
+
+	prim->texrect = *rect;
+	prim->starty = rect->yh / 4;
+	prim->endy = rect->yl / 4;
+}
+
 static void rdp_tex_rect(UINT32 w1, UINT32 w2)
 {
 	UINT32 w3, w4;
@@ -2898,11 +3282,7 @@ static void rdp_tex_rect(UINT32 w1, UINT32 w2)
 	rect.dsdx		= (w4 >> 16) & 0xffff;
 	rect.dtdy		= (w4 >>  0) & 0xffff;
 
-	switch (fb_size)
-	{
-		case PIXEL_SIZE_16BIT:		texture_rectangle_16bit(&rect); break;
-		case PIXEL_SIZE_32BIT:		texture_rectangle_32bit(&rect); break;
-	}
+	queue_texture_rectangle(&rect);
 }
 
 static void rdp_tex_rect_flip(UINT32 w1, UINT32 w2)
@@ -2923,11 +3303,7 @@ static void rdp_tex_rect_flip(UINT32 w1, UINT32 w2)
 	rect.dtdy		= (w4 >> 16) & 0xffff;
 	rect.dsdx		= (w4 >>  0) & 0xffff;
 
-	switch (fb_size)
-	{
-		case PIXEL_SIZE_16BIT:		texture_rectangle_16bit(&rect); break;
-		case PIXEL_SIZE_32BIT:		texture_rectangle_32bit(&rect); break;
-	}
+	queue_texture_rectangle(&rect);
 }
 
 static void rdp_sync_load(UINT32 w1, UINT32 w2)
@@ -2947,6 +3323,7 @@ static void rdp_sync_tile(UINT32 w1, UINT32 w2)
 
 static void rdp_sync_full(UINT32 w1, UINT32 w2)
 {
+	flush_primitives();
 	dp_full_sync();
 }
 
@@ -3020,13 +3397,13 @@ static void rdp_set_other_modes(UINT32 w1, UINT32 w2)
 	other_modes.dither_alpha_en		= (w2 & 0x02) ? 1 : 0;
 	other_modes.alpha_compare_en	= (w2 & 0x01) ? 1 : 0;
 
-	SET_BLENDER_INPUT(0, 0, &blender1a_r[0], &blender1a_g[0], &blender1a_b[0], &blender1b_a[0],
+	SET_BLENDER_INPUT(0, 0, &inputs.blender1a_r[0], &inputs.blender1a_g[0], &inputs.blender1a_b[0], &inputs.blender1b_a[0],
 					  other_modes.blend_m1a_0, other_modes.blend_m1b_0);
-	SET_BLENDER_INPUT(0, 1, &blender2a_r[0], &blender2a_g[0], &blender2a_b[0], &blender2b_a[0],
+	SET_BLENDER_INPUT(0, 1, &inputs.blender2a_r[0], &inputs.blender2a_g[0], &inputs.blender2a_b[0], &inputs.blender2b_a[0],
 					  other_modes.blend_m2a_0, other_modes.blend_m2b_0);
-	SET_BLENDER_INPUT(1, 0, &blender1a_r[1], &blender1a_g[1], &blender1a_b[1], &blender1b_a[1],
+	SET_BLENDER_INPUT(1, 0, &inputs.blender1a_r[1], &inputs.blender1a_g[1], &inputs.blender1a_b[1], &inputs.blender1b_a[1],
 					  other_modes.blend_m1a_1, other_modes.blend_m1b_1);
-	SET_BLENDER_INPUT(1, 1, &blender2a_r[1], &blender2a_g[1], &blender2a_b[1], &blender2b_a[1],
+	SET_BLENDER_INPUT(1, 1, &inputs.blender2a_r[1], &inputs.blender2a_g[1], &inputs.blender2a_b[1], &inputs.blender2b_a[1],
 					  other_modes.blend_m2a_1, other_modes.blend_m2b_1);
 
 //  mame_printf_debug("blend: m1a = %d, m1b = %d, m2a = %d, m2b = %d\n", other_modes.blend_m1a_0, other_modes.blend_m1b_0, other_modes.blend_m2a_0, other_modes.blend_m2b_0);
@@ -3046,6 +3423,9 @@ static void rdp_load_tlut(UINT32 w1, UINT32 w2)
 	UINT16 sl, sh;
 //  int tilenum = (w2 >> 24) & 0x7;
 
+	// queued primitives still sample the old palette
+	flush_primitives();
+
 	sl	= ((w1 >> 12) & 0xfff) / 4;
 	sh	= ((w2 >> 12) & 0xfff) / 4;
 
@@ -3095,6 +3475,9 @@ static void rdp_load_block(UINT32 w1, UINT32 w2)
 	UINT32 *src, *tc;
 	int tb;
 
+	// queued primitives still sample the old texture memory
+	flush_primitives();
+
 	if (ti_format != tile[tilenum].format || ti_size != tile[tilenum].size)
 		fatalerror("RDP: load_block: format conversion required!\n");
 
@@ -3147,6 +3530,8 @@ static void rdp_load_tile(UINT32 w1, UINT32 w2)
 	int width, height;
 	int tilenum = (w2 >> 24) & 0x7;
 
+	flush_primitives();
+
 	if (ti_format != tile[tilenum].format || ti_size != tile[tilenum].size)
 		fatalerror("RDP: load_block: format conversion required!\n");
 
@@ -3257,17 +3642,17 @@ static void rdp_set_tile(UINT32 w1, UINT32 w2)
 
 static void rdp_fill_rect(UINT32 w1, UINT32 w2)
 {
+	RDP_PRIMITIVE *prim;
 	RECTANGLE rect;
 	rect.xl = (w1 >> 12) & 0xfff;
 	rect.yl = (w1 >>  0) & 0xfff;
 	rect.xh = (w2 >> 12) & 0xfff;
 	rect.yh = (w2 >>  0) & 0xfff;
 
-	switch (fb_size)
-	{
-		case PIXEL_SIZE_16BIT:		fill_rectangle_16bit(&rect); break;
-		case PIXEL_SIZE_32BIT:		fill_rectangle_32bit(&rect); break;
-	}
+	prim = alloc_primitive(PRIMITIVE_FILL_RECT, 0);
+	prim->rect = rect;
+	prim->starty = rect.yh / 4;
+	prim->endy = rect.yl / 4;
 }
 
 static void rdp_set_fill_color(UINT32 w1, UINT32 w2)
@@ -3328,23 +3713,23 @@ static void rdp_set_combine(UINT32 w1, UINT32 w2)
 	combine.sub_b_a1	= (w2 >>  3) & 0x7;
 	combine.add_a1		= (w2 >>  0) & 0x7;
 
-	SET_SUBA_RGB_INPUT(&combiner_rgbsub_a_r[0], &combiner_rgbsub_a_g[0], &combiner_rgbsub_a_b[0], combine.sub_a_rgb0);
-	SET_SUBB_RGB_INPUT(&combiner_rgbsub_b_r[0], &combiner_rgbsub_b_g[0], &combiner_rgbsub_b_b[0], combine.sub_b_rgb0);
-	SET_MUL_RGB_INPUT(&combiner_rgbmul_r[0], &combiner_rgbmul_g[0], &combiner_rgbmul_b[0], combine.mul_rgb0);
-	SET_ADD_RGB_INPUT(&combiner_rgbadd_r[0], &combiner_rgbadd_g[0], &combiner_rgbadd_b[0], combine.add_rgb0);
-	SET_SUB_ALPHA_INPUT(&combiner_alphasub_a[0], combine.sub_a_a0);
-	SET_SUB_ALPHA_INPUT(&combiner_alphasub_b[0], combine.sub_b_a0);
-	SET_MUL_ALPHA_INPUT(&combiner_alphamul[0], combine.mul_a0);
-	SET_SUB_ALPHA_INPUT(&combiner_alphaadd[0], combine.add_a0);
-
-	SET_SUBA_RGB_INPUT(&combiner_rgbsub_a_r[1], &combiner_rgbsub_a_g[1], &combiner_rgbsub_a_b[1], combine.sub_a_rgb1);
-	SET_SUBB_RGB_INPUT(&combiner_rgbsub_b_r[1], &combiner_rgbsub_b_g[1], &combiner_rgbsub_b_b[1], combine.sub_b_rgb1);
-	SET_MUL_RGB_INPUT(&combiner_rgbmul_r[1], &combiner_rgbmul_g[1], &combiner_rgbmul_b[1], combine.mul_rgb1);
-	SET_ADD_RGB_INPUT(&combiner_rgbadd_r[1], &combiner_rgbadd_g[1], &combiner_rgbadd_b[1], combine.add_rgb1);
-	SET_SUB_ALPHA_INPUT(&combiner_alphasub_a[1], combine.sub_a_a1);
-	SET_SUB_ALPHA_INPUT(&combiner_alphasub_b[1], combine.sub_b_a1);
-	SET_MUL_ALPHA_INPUT(&combiner_alphamul[1], combine.mul_a1);
-	SET_SUB_ALPHA_INPUT(&combiner_alphaadd[1], combine.add_a1);
+	SET_SUBA_RGB_INPUT(&inputs.combiner_rgbsub_a_r[0], &inputs.combiner_rgbsub_a_g[0], &inputs.combiner_rgbsub_a_b[0], combine.sub_a_rgb0);
+	SET_SUBB_RGB_INPUT(&inputs.combiner_rgbsub_b_r[0], &inputs.combiner_rgbsub_b_g[0], &inputs.combiner_rgbsub_b_b[0], combine.sub_b_rgb0);
+	SET_MUL_RGB_INPUT(&inputs.combiner_rgbmul_r[0], &inputs.combiner_rgbmul_g[0], &inputs.combiner_rgbmul_b[0], combine.mul_rgb0);
+	SET_ADD_RGB_INPUT(&inputs.combiner_rgbadd_r[0], &inputs.combiner_rgbadd_g[0], &inputs.combiner_rgbadd_b[0], combine.add_rgb0);
+	SET_SUB_ALPHA_INPUT(&inputs.combiner_alphasub_a[0], combine.sub_a_a0);
+	SET_SUB_ALPHA_INPUT(&inputs.combiner_alphasub_b[0], combine.sub_b_a0);
+	SET_MUL_ALPHA_INPUT(&inputs.combiner_alphamul[0], combine.mul_a0);
+	SET_SUB_ALPHA_INPUT(&inputs.combiner_alphaadd[0], combine.add_a0);
+
+	SET_SUBA_RGB_INPUT(&inputs.combiner_rgbsub_a_r[1], &inputs.combiner_rgbsub_a_g[1], &inputs.combiner_rgbsub_a_b[1], combine.sub_a_rgb1);
+	SET_SUBB_RGB_INPUT(&inputs.combiner_rgbsub_b_r[1], &inputs.combiner_rgbsub_b_g[1], &inputs.combiner_rgbsub_b_b[1], combine.sub_b_rgb1);
+	SET_MUL_RGB_INPUT(&inputs.combiner_rgbmul_r[1], &inputs.combiner_rgbmul_g[1], &inputs.combiner_rgbmul_b[1], combine.mul_rgb1);
+	SET_ADD_RGB_INPUT(&inputs.combiner_rgbadd_r[1], &inputs.combiner_rgbadd_g[1], &inputs.combiner_rgbadd_b[1], combine.add_rgb1);
+	SET_SUB_ALPHA_INPUT(&inputs.combiner_alphasub_a[1], combine.sub_a_a1);
+	SET_SUB_ALPHA_INPUT(&inputs.combiner_alphasub_b[1], combine.sub_b_a1);
+	SET_MUL_ALPHA_INPUT(&inputs.combiner_alphamul[1], combine.mul_a1);
+	SET_SUB_ALPHA_INPUT(&inputs.combiner_alphaadd[1], combine.add_a1);
 }
 
 static void rdp_set_texture_image(UINT32 w1, UINT32 w2)
@@ -3357,11 +3742,13 @@ static void rdp_set_texture_image(UINT32 w1, UINT32 w2)
 
 static void rdp_set_mask_image(UINT32 w1, UINT32 w2)
 {
+	flush_primitives();
 	zb_address	= w2 & 0x01ffffff;
 }
 
 static void rdp_set_color_image(UINT32 w1, UINT32 w2)
 {
+	flush_primitives();
 	fb_format 	= (w1 >> 21) & 0x7;
 	fb_size		= (w1 >> 19) & 0x3;
 	fb_width	= (w1 & 0x3ff) + 1;
@@ -3435,6 +3822,7 @@ void rdp_process_list(void)
 
 		if (((rdp_cmd_ptr-rdp_cmd_cur) * 4) < rdp_command_length[cmd])
 		{
+			flush_primitives();
 			return;
 			//fatalerror("rdp_process_list: not enough rdp command data: cur = %d, ptr = %d, expected = %d\n", rdp_cmd_cur, rdp_cmd_ptr, rdp_command_length[cmd]);
 		}
@@ -3453,6 +3841,10 @@ void rdp_process_list(void)
 
 		rdp_cmd_cur += rdp_command_length[cmd] / 4;
 	};
+
+	// the CPU reads RDRAM directly, so everything must be drawn before it gets control back
+	flush_primitives();
+
 	rdp_cmd_ptr = 0;
 	rdp_cmd_cur = 0;
 
@@ -9,6 +9,7 @@
 #ifndef RECURSIVE_INCLUDE
 
 #include "poly.h"
+#include "profiler.h"
 
 /***************************************************************************
 
@@ -27,51 +28,371 @@ static struct poly_scanline_data scanlines;
 #define RECURSIVE_INCLUDE
 
 #define FUNC_NAME	setup_triangle_0
+#define SETUP_NAME	setup_triangle_0_into
 #define NUM_PARAMS	0
 #include "poly.c"
 #undef NUM_PARAMS
+#undef SETUP_NAME
 #undef FUNC_NAME
 
 #define FUNC_NAME	setup_triangle_1
+#define SETUP_NAME	setup_triangle_1_into
 #define NUM_PARAMS	1
 #include "poly.c"
 #undef NUM_PARAMS
+#undef SETUP_NAME
 #undef FUNC_NAME
 
 #define FUNC_NAME	setup_triangle_2
+#define SETUP_NAME	setup_triangle_2_into
 #define NUM_PARAMS	2
 #include "poly.c"
 #undef NUM_PARAMS
+#undef SETUP_NAME
 #undef FUNC_NAME
 
 #define FUNC_NAME	setup_triangle_3
+#define SETUP_NAME	setup_triangle_3_into
 #define NUM_PARAMS	3
 #include "poly.c"
 #undef NUM_PARAMS
+#undef SETUP_NAME
 #undef FUNC_NAME
 
 #define FUNC_NAME	setup_triangle_4
+#define SETUP_NAME	setup_triangle_4_into
 #define NUM_PARAMS	4
 #include "poly.c"
 #undef NUM_PARAMS
+#undef SETUP_NAME
 #undef FUNC_NAME
 
 #define FUNC_NAME	setup_triangle_5
+#define SETUP_NAME	setup_triangle_5_into
 #define NUM_PARAMS	5
 #include "poly.c"
 #undef NUM_PARAMS
+#undef SETUP_NAME
 #undef FUNC_NAME
 
 #define FUNC_NAME	setup_triangle_6
+#define SETUP_NAME	setup_triangle_6_into
 #define NUM_PARAMS	6
 #include "poly.c"
 #undef NUM_PARAMS
+#undef SETUP_NAME
 #undef FUNC_NAME
 
 
+/***************************************************************************
+
+    Polygon manager
+
+    Triangles are set up on the calling thread as they are submitted, and
+    queued along with their scanline extents and a copy of the caller's
+    per-polygon data. When the queue fills, or when poly_wait is called,
+    the covered scanlines are split into horizontal bands which are drawn
+    in parallel on the OSD work queue. Each band draws its slice of every
+    polygon in submission order, so overdraw behaves exactly as if the
+    polygons were drawn one at a time.
+
+***************************************************************************/
+
+/* most bands a flush is split into */
+#define POLY_BANDS				8
+
+/* smallest band worth handing to another thread */
+#define POLY_MIN_BAND_HEIGHT	8
+
+/* scanlines held per polygon on average before we flush */
+#define POLY_SCANLINES_PER_POLY	32
+
+typedef struct _poly_polygon poly_polygon;
+struct _poly_polygon
+{
+	void *				dest;					/* destination passed to the callback */
+	poly_draw_scanline	callback;				/* callback to draw each scanline */
+	const void *		extra;					/* caller's per-polygon data */
+	INT32				sy, ey;					/* 16.0 starting and ending Y coordinates */
+	INT64				dp[MAX_VERTEX_PARAMS];	/* 32.16 per-pixel deltas for each parameter */
+	struct poly_scanline *scanline;				/* scanline extents, starting at sy */
+};
+
+typedef struct _poly_band poly_band;
+struct _poly_band
+{
+	poly_manager *		poly;					/* owning manager */
+	INT32				sy, ey;					/* scanlines covered, inclusive */
+	int					threadid;				/* index passed to the callbacks */
+};
+
+struct _poly_manager
+{
+	osd_work_queue *	queue;					/* queue for the bands, or NULL */
+
+	poly_polygon *		polygon;				/* queued polygons */
+	int					polygon_count;
+	int					polygon_max;
+
+	UINT8 *				extra;					/* per-polygon data, one slot per polygon */
+	size_t				extra_size;
+	int					extra_count;			/* slots handed out; may be one ahead of polygon_count */
+
+	struct poly_scanline *scanline;				/* pooled scanline extents */
+	int					scanline_count;
+	int					scanline_max;
+
+	poly_band			band[POLY_BANDS];
+};
+
+
+static int (*const setup_triangle_into[MAX_VERTEX_PARAMS])(const struct poly_vertex *, const struct poly_vertex *, const struct poly_vertex *, const rectangle *, INT32 *, INT32 *, INT64 *, struct poly_scanline *) =
+{
+	setup_triangle_0_into, setup_triangle_1_into, setup_triangle_2_into,
+	setup_triangle_3_into, setup_triangle_4_into, setup_triangle_5_into
+};
+
+
+
+/*------------------------------------------------------------------
+    poly_alloc - allocate a polygon manager
+    that can queue max_polys polygons, each
+    with extra_data_size bytes of data
+------------------------------------------------------------------*/
+
+poly_manager *poly_alloc(int max_polys, size_t extra_data_size, UINT8 flags)
+{
+	poly_manager *poly = malloc_or_die(sizeof(*poly));
+
+	memset(poly, 0, sizeof(*poly));
+
+	/* keep the data slots aligned for whatever the caller puts in them */
+	poly->extra_size = (extra_data_size + 7) & ~7;
+	if (poly->extra_size == 0)
+		poly->extra_size = 8;
+
+	poly->polygon_max = max_polys;
+	poly->polygon = malloc_or_die(max_polys * sizeof(poly->polygon[0]));
+	poly->extra = malloc_or_die(max_polys * poly->extra_size);
+
+	/* always leave room for one full-height polygon */
+	poly->scanline_max = max_polys * POLY_SCANLINES_PER_POLY;
+	if (poly->scanline_max < MAX_POLY_SCANLINES)
+		poly->scanline_max = MAX_POLY_SCANLINES;
+	poly->scanline = malloc_or_die(poly->scanline_max * sizeof(poly->scanline[0]));
+
+	if (!(flags & POLYFLAG_NO_WORK_QUEUE))
+		poly->queue = osd_work_queue_alloc(WORK_QUEUE_FLAG_MULTI);
+	return poly;
+}
+
+
+/*------------------------------------------------------------------
+    poly_free - draw anything pending and
+    release a polygon manager
+------------------------------------------------------------------*/
+
+void poly_free(poly_manager *poly)
+{
+	if (poly == NULL)
+		return;
+
+	poly_wait(poly);
+	if (poly->queue != NULL)
+		osd_work_queue_free(poly->queue);
+	free(poly->scanline);
+	free(poly->extra);
+	free(poly->polygon);
+	free(poly);
+}
+
+
+/*------------------------------------------------------------------
+    poly_band_callback - draw one band's slice
+    of every queued polygon
+------------------------------------------------------------------*/
+
+static void *poly_band_callback(void *param)
+{
+	poly_band *band = param;
+	poly_manager *poly = band->poly;
+	int polynum;
+
+	for (polynum = 0; polynum < poly->polygon_count; polynum++)
+	{
+		const poly_polygon *polygon = &poly->polygon[polynum];
+		INT32 sy = MAX(polygon->sy, band->sy);
+		INT32 ey = MIN(polygon->ey, band->ey);
+		INT32 y;
+
+		for (y = sy; y <= ey; y++)
+		{
+			const struct poly_scanline *scan = &polygon->scanline[y - polygon->sy];
+			if (scan->sx <= scan->ex)
+				(*polygon->callback)(polygon->dest, y, scan, polygon->dp, polygon->extra, band->threadid);
+		}
+	}
+	return NULL;
+}
+
+
+/*------------------------------------------------------------------
+    poly_flush - draw all queued polygons,
+    optionally keeping the data slot that has
+    been handed out for the next one
+------------------------------------------------------------------*/
+
+static void poly_flush(poly_manager *poly)
+{
+	osd_work_item *item[POLY_BANDS];
+	INT32 miny, maxy, height;
+	int bands, bandnum, polynum;
+
+	if (poly->polygon_count > 0)
+	{
+		/* find the range of scanlines covered */
+		miny = poly->polygon[0].sy;
+		maxy = poly->polygon[0].ey;
+		for (polynum = 1; polynum < poly->polygon_count; polynum++)
+		{
+			if (poly->polygon[polynum].sy < miny)
+				miny = poly->polygon[polynum].sy;
+			if (poly->polygon[polynum].ey > maxy)
+				maxy = poly->polygon[polynum].ey;
+		}
+
+		/* split the range into bands */
+		bands = (poly->queue != NULL) ? (maxy - miny + 1) / POLY_MIN_BAND_HEIGHT : 1;
+		bands = MAX(1, MIN(bands, POLY_BANDS));
+		height = (maxy - miny + bands) / bands;
+
+		for (bandnum = 0; bandnum < bands; bandnum++)
+		{
+			poly_band *band = &poly->band[bandnum];
+
+			band->poly = poly;
+			band->threadid = bandnum;
+			band->sy = miny + bandnum * height;
+			band->ey = MIN(band->sy + height - 1, maxy);
+
+			/* the first band is ours; if a band can't be queued, draw it here */
+			item[bandnum] = NULL;
+			if (bandnum != 0)
+			{
+				item[bandnum] = osd_work_item_queue(poly->queue, poly_band_callback, band);
+				if (item[bandnum] == NULL)
+					poly_band_callback(band);
+			}
+		}
+		poly_band_callback(&poly->band[0]);
+
+		for (bandnum = 1; bandnum < bands; bandnum++)
+			if (item[bandnum] != NULL)
+			{
+				while (!osd_work_item_wait(item[bandnum], osd_ticks_per_second())) ;
+				osd_work_item_release(item[bandnum]);
+			}
+	}
+
+	/* a slot handed out for the next polygon moves to the front */
+	if (poly->extra_count > poly->polygon_count)
+	{
+		memmove(poly->extra, poly->extra + poly->polygon_count * poly->extra_size, poly->extra_size);
+		poly->extra_count = 1;
+	}
+	else
+		poly->extra_count = 0;
+
+	poly->polygon_count = 0;
+	poly->scanline_count = 0;
+}
+
+
+/*------------------------------------------------------------------
+    poly_wait - draw everything queued; call
+    this before reading back the destination
+------------------------------------------------------------------*/
+
+void poly_wait(poly_manager *poly)
+{
+	profiler_mark(PROFILER_USER1);
+	poly_flush(poly);
+	profiler_mark(PROFILER_END);
+}
+
+
+/*------------------------------------------------------------------
+    poly_get_extra_data - return the data slot
+    for the next polygon submitted
+------------------------------------------------------------------*/
+
+void *poly_get_extra_data(poly_manager *poly)
+{
+	/* hand out the same slot until a polygon uses it */
+	if (poly->extra_count == poly->polygon_count)
+	{
+		if (poly->extra_count >= poly->polygon_max)
+			poly_flush(poly);
+		poly->extra_count++;
+	}
+	return poly->extra + poly->polygon_count * poly->extra_size;
+}
+
+
+/*------------------------------------------------------------------
+    poly_render_triangle - set up a triangle
+    and queue it for drawing; returns the
+    number of pixels it covers
+------------------------------------------------------------------*/
+
+UINT32 poly_render_triangle(poly_manager *poly, void *dest, const rectangle *cliprect, poly_draw_scanline callback, int paramcount, const struct poly_vertex *v1, const struct poly_vertex *v2, const struct poly_vertex *v3)
+{
+	poly_polygon *polygon;
+	UINT32 pixels = 0;
+	INT32 y;
+
+	/* make sure there's room for the worst case */
+	if (poly->polygon_count >= poly->polygon_max || poly->scanline_count + (cliprect->max_y - cliprect->min_y + 1) > poly->scanline_max)
+		poly_flush(poly);
+
+	/* claim the data slot if the caller didn't */
+	if (poly->extra_count == poly->polygon_count)
+		poly->extra_count++;
+
+	polygon = &poly->polygon[poly->polygon_count];
+	polygon->scanline = &poly->scanline[poly->scanline_count];
+	if (!(*setup_triangle_into[MAX(paramcount, 1) - 1])(v1, v2, v3, cliprect, &polygon->sy, &polygon->ey, polygon->dp, polygon->scanline))
+	{
+		/* leave the slot for the next polygon */
+		poly->extra_count--;
+		return 0;
+	}
+	if (polygon->ey < polygon->sy)
+	{
+		poly->extra_count--;
+		return 0;
+	}
+
+	polygon->dest = dest;
+	polygon->callback = callback;
+	polygon->extra = poly->extra + poly->polygon_count * poly->extra_size;
+
+	for (y = polygon->sy; y <= polygon->ey; y++)
+	{
+		const struct poly_scanline *scan = &polygon->scanline[y - polygon->sy];
+		if (scan->sx <= scan->ex)
+			pixels += scan->ex - scan->sx + 1;
+	}
+
+	poly->scanline_count += polygon->ey - polygon->sy + 1;
+	poly->polygon_count++;
+	return pixels;
+}
+
+
 #else
 
-const struct poly_scanline_data *FUNC_NAME(const struct poly_vertex *v1, const struct poly_vertex *v2, const struct poly_vertex *v3, const rectangle *cliprect)
+static int SETUP_NAME(const struct poly_vertex *v1, const struct poly_vertex *v2, const struct poly_vertex *v3, const rectangle *cliprect, INT32 *psy, INT32 *pey, INT64 *dp, struct poly_scanline *scanbase)
 {
 	INT32 i, y, dy, ey, sx, sdx, ex, edx, temp, longest_scanline;
 	INT64 pstart[MAX_VERTEX_PARAMS], pdelta[MAX_VERTEX_PARAMS];
@@ -89,14 +410,14 @@ const struct poly_scanline_data *FUNC_NAME(const struct poly_vertex *v1, const s
 
 	/* see if we're on-screen */
 	if (v1->y > cliprect->max_y || v3->y < cliprect->min_y)
-		return NULL;
+		return 0;
 	if ((v1->x < cliprect->min_x && v2->x < cliprect->min_x && v3->x < cliprect->min_x) ||
 		(v1->x > cliprect->max_x && v2->x > cliprect->max_x && v3->x > cliprect->max_x))
-		return NULL;
+		return 0;
 
 	/* set the final start/end Y values */
-	scanlines.sy = (v1->y < cliprect->min_y) ? cliprect->min_y : v1->y;
-	scanlines.ey = (v3->y > cliprect->max_y) ? cliprect->max_y : v3->y - 1;
+	*psy = (v1->y < cliprect->min_y) ? cliprect->min_y : v1->y;
+	*pey = (v3->y > cliprect->max_y) ? cliprect->max_y : v3->y - 1;
 
 	/* imagine the triangle divided into two parts vertically, splitting at v2:
 
@@ -110,7 +431,7 @@ const struct poly_scanline_data *FUNC_NAME(const struct poly_vertex *v1, const s
 	/* determine what portion of the triangle lives in the upper part (16.16) */
 	temp = v3->y - v1->y;
 	if (temp <= 0)
-		return NULL;
+		return 0;
 	temp = ((v2->y - v1->y) << 16) / temp;
 
 	/* compute the length of the longest scanline; this is the dx from v1 to v2 */
@@ -120,39 +441,39 @@ const struct poly_scanline_data *FUNC_NAME(const struct poly_vertex *v1, const s
 
 	/* if the longest scanline is 0, early out */
 	if (longest_scanline == 0)
-		return NULL;
+		return 0;
 
 	/* the per-pixel deltas for the parameters will be constant across the entire */
 	/* surface of the triangle, so compute those up front (16.16) */
 	if (NUM_PARAMS >= 0)
 	{
 		INT64 value = ((INT64)(v1->p[0] - v2->p[0]) << 32) + (INT64)temp * ((INT64)(v3->p[0] - v1->p[0]) << 16);
-		scanlines.dp[0] = value / longest_scanline;
+		dp[0] = value / longest_scanline;
 	}
 	if (NUM_PARAMS >= 1)
 	{
 		INT64 value = ((INT64)(v1->p[1] - v2->p[1]) << 32) + (INT64)temp * ((INT64)(v3->p[1] - v1->p[1]) << 16);
-		scanlines.dp[1] = value / longest_scanline;
+		dp[1] = value / longest_scanline;
 	}
 	if (NUM_PARAMS >= 2)
 	{
 		INT64 value = ((INT64)(v1->p[2] - v2->p[2]) << 32) + (INT64)temp * ((INT64)(v3->p[2] - v1->p[2]) << 16);
-		scanlines.dp[2] = value / longest_scanline;
+		dp[2] = value / longest_scanline;
 	}
 	if (NUM_PARAMS >= 3)
 	{
 		INT64 value = ((INT64)(v1->p[3] - v2->p[3]) << 32) + (INT64)temp * ((INT64)(v3->p[3] - v1->p[3]) << 16);
-		scanlines.dp[3] = value / longest_scanline;
+		dp[3] = value / longest_scanline;
 	}
 	if (NUM_PARAMS >= 4)
 	{
 		INT64 value = ((INT64)(v1->p[4] - v2->p[4]) << 32) + (INT64)temp * ((INT64)(v3->p[4] - v1->p[4]) << 16);
-		scanlines.dp[4] = value / longest_scanline;
+		dp[4] = value / longest_scanline;
 	}
 	if (NUM_PARAMS >= 5)
 	{
 		INT64 value = ((INT64)(v1->p[5] - v2->p[5]) << 32) + (INT64)temp * ((INT64)(v3->p[5] - v1->p[5]) << 16);
-		scanlines.dp[5] = value / longest_scanline;
+		dp[5] = value / longest_scanline;
 	}
 
 	/* if the longest scanline was negative, the middle vertex is to the right */
@@ -253,7 +574,7 @@ const struct poly_scanline_data *FUNC_NAME(const struct poly_vertex *v1, const s
 	}
 
 	/* set up everything for the big loop */
-	scan = &scanlines.scanline[0];
+	scan = scanbase;
 	y = v1->y;
 	ey = (v3->y < cliprect->max_y) ? v3->y : cliprect->max_y;
 
@@ -303,13 +624,13 @@ const struct poly_scanline_data *FUNC_NAME(const struct poly_vertex *v1, const s
 					/* in order to get accurate texturing, we need to account for the fractional */
 					/* pixel we just chopped off */
 					temp = ~sx & 0xffff;
-					scan->p[0] = pstart[0] + ((temp * scanlines.dp[0]) >> 16);
+					scan->p[0] = pstart[0] + ((temp * dp[0]) >> 16);
 				}
-				if (NUM_PARAMS >= 1) scan->p[1] = pstart[1] + ((temp * scanlines.dp[1]) >> 16);
-				if (NUM_PARAMS >= 2) scan->p[2] = pstart[2] + ((temp * scanlines.dp[2]) >> 16);
-				if (NUM_PARAMS >= 3) scan->p[3] = pstart[3] + ((temp * scanlines.dp[3]) >> 16);
-				if (NUM_PARAMS >= 4) scan->p[4] = pstart[4] + ((temp * scanlines.dp[4]) >> 16);
-				if (NUM_PARAMS >= 5) scan->p[5] = pstart[5] + ((temp * scanlines.dp[5]) >> 16);
+				if (NUM_PARAMS >= 1) scan->p[1] = pstart[1] + ((temp * dp[1]) >> 16);
+				if (NUM_PARAMS >= 2) scan->p[2] = pstart[2] + ((temp * dp[2]) >> 16);
+				if (NUM_PARAMS >= 3) scan->p[3] = pstart[3] + ((temp * dp[3]) >> 16);
+				if (NUM_PARAMS >= 4) scan->p[4] = pstart[4] + ((temp * dp[4]) >> 16);
+				if (NUM_PARAMS >= 5) scan->p[5] = pstart[5] + ((temp * dp[5]) >> 16);
 			}
 			scan++;
 
@@ -386,19 +707,19 @@ const struct poly_scanline_data *FUNC_NAME(const struct poly_vertex *v1, const s
 	}
 
 	/* apply clipping */
-	while (--scan >= &scanlines.scanline[0])
+	while (--scan >= scanbase)
 	{
 		/* left clip */
 		if (scan->sx < cliprect->min_x)
 		{
 			temp = cliprect->min_x - scan->sx;
 			scan->sx += temp;
-			if (NUM_PARAMS >= 0) scan->p[0] += scanlines.dp[0] * temp;
-			if (NUM_PARAMS >= 1) scan->p[1] += scanlines.dp[1] * temp;
-			if (NUM_PARAMS >= 2) scan->p[2] += scanlines.dp[2] * temp;
-			if (NUM_PARAMS >= 3) scan->p[3] += scanlines.dp[3] * temp;
-			if (NUM_PARAMS >= 4) scan->p[4] += scanlines.dp[4] * temp;
-			if (NUM_PARAMS >= 5) scan->p[5] += scanlines.dp[5] * temp;
+			if (NUM_PARAMS >= 0) scan->p[0] += dp[0] * temp;
+			if (NUM_PARAMS >= 1) scan->p[1] += dp[1] * temp;
+			if (NUM_PARAMS >= 2) scan->p[2] += dp[2] * temp;
+			if (NUM_PARAMS >= 3) scan->p[3] += dp[3] * temp;
+			if (NUM_PARAMS >= 4) scan->p[4] += dp[4] * temp;
+			if (NUM_PARAMS >= 5) scan->p[5] += dp[5] * temp;
 		}
 
 		/* right clip */
@@ -406,6 +727,14 @@ const struct poly_scanline_data *FUNC_NAME(const struct poly_vertex *v1, const s
 			scan->ex = cliprect->max_x;
 	}
 
+	return 1;
+}
+
+
+const struct poly_scanline_data *FUNC_NAME(const struct poly_vertex *v1, const struct poly_vertex *v2, const struct poly_vertex *v3, const rectangle *cliprect)
+{
+	if (!SETUP_NAME(v1, v2, v3, cliprect, &scanlines.sy, &scanlines.ey, scanlines.dp, scanlines.scanline))
+		return NULL;
 	return &scanlines;
 }
 
@@ -33,6 +33,15 @@ struct poly_scanline_data
 	struct poly_scanline scanline[MAX_POLY_SCANLINES];
 };
 
+/* flags for poly_alloc */
+#define POLYFLAG_NO_WORK_QUEUE	0x01	/* draw everything on the calling thread */
+
+typedef struct _poly_manager poly_manager;
+
+/* draws one scanline of a polygon; may be called from any thread, with threadid 0..7 */
+/* identifying which band is being drawn so callbacks can keep per-thread scratch data */
+typedef void (*poly_draw_scanline)(void *dest, INT32 scanline, const struct poly_scanline *extent, const INT64 *dp, const void *extradata, int threadid);
+
 const struct poly_scanline_data *setup_triangle_0(const struct poly_vertex *v1, const struct poly_vertex *v2, const struct poly_vertex *v3, const rectangle *cliprect);
 const struct poly_scanline_data *setup_triangle_1(const struct poly_vertex *v1, const struct poly_vertex *v2, const struct poly_vertex *v3, const rectangle *cliprect);
 const struct poly_scanline_data *setup_triangle_2(const struct poly_vertex *v1, const struct poly_vertex *v2, const struct poly_vertex *v3, const rectangle *cliprect);
@@ -40,3 +49,9 @@ const struct poly_scanline_data *setup_triangle_3(const struct poly_vertex *v1,
 const struct poly_scanline_data *setup_triangle_4(const struct poly_vertex *v1, const struct poly_vertex *v2, const struct poly_vertex *v3, const rectangle *cliprect);
 const struct poly_scanline_data *setup_triangle_5(const struct poly_vertex *v1, const struct poly_vertex *v2, const struct poly_vertex *v3, const rectangle *cliprect);
 const struct poly_scanline_data *setup_triangle_6(const struct poly_vertex *v1, const struct poly_vertex *v2, const struct poly_vertex *v3, const rectangle *cliprect);
+
+poly_manager *poly_alloc(int max_polys, size_t extra_data_size, UINT8 flags);
+void poly_free(poly_manager *poly);
+void poly_wait(poly_manager *poly);
+void *poly_get_extra_data(poly_manager *poly);
+UINT32 poly_render_triangle(poly_manager *poly, void *dest, const rectangle *cliprect, poly_draw_scanline callback, int paramcount, const struct poly_vertex *v1, const struct poly_vertex *v2, const struct poly_vertex *v3);
@@ -69,7 +69,7 @@ struct GOURAUDTEXTUREDVERTEX
 	PAIR n_texture;
 };
 
-static union
+union PSXPACKET
 {
 	UINT32 n_entry[ 16 ];
 
@@ -159,7 +159,9 @@ static union
 		PAIR n_bgr;
 		struct FLATVERTEX vertex;
 	} Dot;
-} m_packet;
+};
+
+static union PSXPACKET m_packet;
 
 struct PSXGPU
 {
@@ -242,11 +244,53 @@ static UINT16 m_p_n_b0[ 0x10000 ];
 static UINT16 m_p_n_r1[ 0x10000 ];
 static UINT16 m_p_n_b1g1[ 0x10000 ];
 
+/* drawing primitives are queued with a copy of the state they were issued with and
+   rendered in horizontal bands when the queue is flushed */
+#define MAX_PRIMITIVES ( 1024 )
+#define MAX_BANDS ( 8 )
+#define MIN_BAND_HEIGHT ( 8 )
+
+struct PSXPRIMITIVE
+{
+	void (*draw)( struct PSXPRIMITIVE *p_prim );
+	int n_points;
+	union PSXPACKET packet;
+	struct PSXGPU gpu;
+	UINT32 n_twy;
+	UINT32 n_twx;
+	UINT32 n_twh;
+	UINT32 n_tww;
+	UINT32 n_drawarea_x1;
+	UINT32 n_drawarea_y1;
+	UINT32 n_drawarea_x2;
+	UINT32 n_drawarea_y2;
+	INT32 n_drawoffset_x;
+	INT32 n_drawoffset_y;
+};
+
+struct PSXBAND
+{
+	UINT32 n_y1;
+	UINT32 n_y2;
+};
+
+static struct PSXPRIMITIVE *m_p_primitive;
+static int m_n_primitives;
+static UINT32 m_n_queue_x1;
+static UINT32 m_n_queue_y1;
+static UINT32 m_n_queue_x2;
+static UINT32 m_n_queue_y2;
+static UINT32 m_n_vram_height;
+static struct PSXBAND m_p_band[ MAX_BANDS ];
+static osd_work_queue *m_p_work_queue;
+
+static void psx_gpu_flush( void );
+
 #define SINT11( x ) ( ( (INT32)( x ) << 21 ) >> 21 )
 
 #define ADJUST_COORD( a ) \
-	a.w.l = COORD_X( a ) + m_n_drawoffset_x; \
-	a.w.h = COORD_Y( a ) + m_n_drawoffset_y;
+	a.w.l = COORD_X( a ) + p_prim->n_drawoffset_x; \
+	a.w.h = COORD_Y( a ) + p_prim->n_drawoffset_y;
 
 #define COORD_X( a ) ( (INT16)a.w.l )
 #define COORD_Y( a ) ( (INT16)a.w.h )
@@ -627,6 +671,15 @@ static void updatevisiblearea( void )
 	video_screen_configure(0, m_n_screenwidth, m_n_screenheight, &visarea, refresh);
 }
 
+static void psx_gpu_exit( running_machine *machine )
+{
+	if( m_p_work_queue != NULL )
+	{
+		osd_work_queue_free( m_p_work_queue );
+		m_p_work_queue = NULL;
+	}
+}
+
 static int psx_gpu_init( void )
 {
 	int n_line;
@@ -646,9 +699,15 @@ static int psx_gpu_init( void )
 	m_n_lightgun_y = 0;
 
 	m_n_vram_size = Machine->screen[0].width * Machine->screen[0].height;
+	m_n_vram_height = Machine->screen[0].height;
 	m_p_vram = auto_malloc( m_n_vram_size * 2 );
 	memset( m_p_vram, 0x00, m_n_vram_size * 2 );
 
+	m_p_primitive = auto_malloc( sizeof( *m_p_primitive ) * MAX_PRIMITIVES );
+	m_n_primitives = 0;
+	m_p_work_queue = osd_work_queue_alloc( WORK_QUEUE_FLAG_MULTI );
+	add_exit_callback( Machine, psx_gpu_exit );
+
 	for( n_line = 0; n_line < 1024; n_line++ )
 	{
 		m_p_p_vram[ n_line ] = &m_p_vram[ ( n_line % Machine->screen[0].height ) * Machine->screen[0].width ];
@@ -780,6 +839,7 @@ static int psx_gpu_init( void )
 	state_save_register_global( psxgpu.n_iy );
 	state_save_register_global( psxgpu.n_ti );
 
+	state_save_register_func_presave( psx_gpu_flush );
 	state_save_register_func_postload( updatevisiblearea );
 
 	return 0;
@@ -811,6 +871,8 @@ VIDEO_UPDATE( psx )
 	int n_overscantop;
 	int n_overscanleft;
 
+	psx_gpu_flush();
+
 #if defined( MAME_DEBUG )
 	if( DebugMeshDisplay( bitmap, cliprect ) )
 	{
@@ -1006,7 +1068,7 @@ INLINE void decode_tpage( struct PSXGPU *p_psxgpu, UINT32 tpage )
 }
 
 #define SPRITESETUP \
-	if( psxgpu.n_iy != 0 ) \
+	if( p_prim->gpu.n_iy != 0 ) \
 	{ \
 		n_dv = -1; \
 	} \
@@ -1014,7 +1076,7 @@ INLINE void decode_tpage( struct PSXGPU *p_psxgpu, UINT32 tpage )
 	{ \
 		n_dv = 1; \
 	} \
-	if( psxgpu.n_ix != 0 ) \
+	if( p_prim->gpu.n_ix != 0 ) \
 	{ \
 		n_u |= 1; \
 		n_du = -1; \
@@ -1036,7 +1098,7 @@ INLINE void decode_tpage( struct PSXGPU *p_psxgpu, UINT32 tpage )
 	switch( n_cmd & 0x02 ) \
 	{ \
 	case 0x02: \
-		switch( psxgpu.n_abr ) \
+		switch( p_prim->gpu.n_abr ) \
 		{ \
 		case 0x00: \
 			p_n_f = m_p_n_f05; \
@@ -1086,22 +1148,22 @@ INLINE void decode_tpage( struct PSXGPU *p_psxgpu, UINT32 tpage )
 	TRANSPARENCYSETUP
 
 #define TEXTURESETUP \
-	n_tx = psxgpu.n_tx; \
-	n_ty = psxgpu.n_ty; \
+	n_tx = p_prim->gpu.n_tx; \
+	n_ty = p_prim->gpu.n_ty; \
 	p_clut = m_p_p_vram[ n_cluty ] + n_clutx; \
-	switch( psxgpu.n_tp ) \
+	switch( p_prim->gpu.n_tp ) \
 	{ \
 	case 0: \
-		n_tx += m_n_twx >> 2; \
-		n_ty += m_n_twy; \
+		n_tx += p_prim->n_twx >> 2; \
+		n_ty += p_prim->n_twy; \
 		break; \
 	case 1: \
-		n_tx += m_n_twx >> 1; \
-		n_ty += m_n_twy; \
+		n_tx += p_prim->n_twx >> 1; \
+		n_ty += p_prim->n_twy; \
 		break; \
 	case 2: \
-		n_tx += m_n_twx >> 0; \
-		n_ty += m_n_twy; \
+		n_tx += p_prim->n_twx >> 0; \
+		n_ty += p_prim->n_twy; \
 		break; \
 	} \
 	TRANSPARENCYSETUP
@@ -1114,9 +1176,9 @@ INLINE void decode_tpage( struct PSXGPU *p_psxgpu, UINT32 tpage )
 	n_b.d += n_db;
 
 #define SOLIDFILL( PIXELUPDATE ) \
-	if( n_distance > ( (INT32)m_n_drawarea_x2 - n_x ) + 1 ) \
+	if( n_distance > ( (INT32)p_prim->n_drawarea_x2 - n_x ) + 1 ) \
 	{ \
-		n_distance = ( m_n_drawarea_x2 - n_x ) + 1; \
+		n_distance = ( p_prim->n_drawarea_x2 - n_x ) + 1; \
 	} \
 	p_vram = m_p_p_vram[ n_y ] + n_x; \
  \
@@ -1179,9 +1241,9 @@ INLINE void decode_tpage( struct PSXGPU *p_psxgpu, UINT32 tpage )
 	{ \
 		n_bgr = *( m_p_p_vram[ n_ty + TXV ] + n_tx + TXU );
 
-#define TEXTUREWINDOW4BIT( TXV, TXU ) TEXTURE4BIT( ( TXV & m_n_twh ), ( TXU & m_n_tww ) )
-#define TEXTUREWINDOW8BIT( TXV, TXU ) TEXTURE8BIT( ( TXV & m_n_twh ), ( TXU & m_n_tww ) )
-#define TEXTUREWINDOW15BIT( TXV, TXU ) TEXTURE15BIT( ( TXV & m_n_twh ), ( TXU & m_n_tww ) )
+#define TEXTUREWINDOW4BIT( TXV, TXU ) TEXTURE4BIT( ( TXV & p_prim->n_twh ), ( TXU & p_prim->n_tww ) )
+#define TEXTUREWINDOW8BIT( TXV, TXU ) TEXTURE8BIT( ( TXV & p_prim->n_twh ), ( TXU & p_prim->n_tww ) )
+#define TEXTUREWINDOW15BIT( TXV, TXU ) TEXTURE15BIT( ( TXV & p_prim->n_twh ), ( TXU & p_prim->n_tww ) )
 
 #define TEXTUREINTERLEAVED4BIT( TXV, TXU ) \
 	while( n_distance > 0 ) \
@@ -1204,9 +1266,9 @@ INLINE void decode_tpage( struct PSXGPU *p_psxgpu, UINT32 tpage )
 		int n_yi = TXV; \
 		n_bgr = *( m_p_p_vram[ n_ty + n_yi ] + n_tx + n_xi );
 
-#define TEXTUREWINDOWINTERLEAVED4BIT( TXV, TXU ) TEXTUREINTERLEAVED4BIT( ( TXV & m_n_twh ), ( TXU & m_n_tww ) )
-#define TEXTUREWINDOWINTERLEAVED8BIT( TXV, TXU ) TEXTUREINTERLEAVED8BIT( ( TXV & m_n_twh ), ( TXU & m_n_tww ) )
-#define TEXTUREWINDOWINTERLEAVED15BIT( TXV, TXU ) TEXTUREINTERLEAVED15BIT( ( TXV & m_n_twh ), ( TXU & m_n_tww ) )
+#define TEXTUREWINDOWINTERLEAVED4BIT( TXV, TXU ) TEXTUREINTERLEAVED4BIT( ( TXV & p_prim->n_twh ), ( TXU & p_prim->n_tww ) )
+#define TEXTUREWINDOWINTERLEAVED8BIT( TXV, TXU ) TEXTUREINTERLEAVED8BIT( ( TXV & p_prim->n_twh ), ( TXU & p_prim->n_tww ) )
+#define TEXTUREWINDOWINTERLEAVED15BIT( TXV, TXU ) TEXTUREINTERLEAVED15BIT( ( TXV & p_prim->n_twh ), ( TXU & p_prim->n_tww ) )
 
 #define SHADEDPIXEL( PIXELUPDATE ) \
 		if( n_bgr != 0 ) \
@@ -1245,26 +1307,26 @@ INLINE void decode_tpage( struct PSXGPU *p_psxgpu, UINT32 tpage )
 	}
 
 #define TEXTUREFILL( PIXELUPDATE, TXU, TXV ) \
-	if( n_distance > ( (INT32)m_n_drawarea_x2 - n_x ) + 1 ) \
+	if( n_distance > ( (INT32)p_prim->n_drawarea_x2 - n_x ) + 1 ) \
 	{ \
-		n_distance = ( m_n_drawarea_x2 - n_x ) + 1; \
+		n_distance = ( p_prim->n_drawarea_x2 - n_x ) + 1; \
 	} \
 	p_vram = m_p_p_vram[ n_y ] + n_x; \
  \
-	if( psxgpu.n_ti != 0 ) \
+	if( p_prim->gpu.n_ti != 0 ) \
 	{ \
 		/* interleaved texture */ \
-		if( m_n_twh != 255 || \
-			m_n_tww != 255 || \
-			m_n_twx != 0 || \
-			m_n_twy != 0 ) \
+		if( p_prim->n_twh != 255 || \
+			p_prim->n_tww != 255 || \
+			p_prim->n_twx != 0 || \
+			p_prim->n_twy != 0 ) \
 		{ \
 			/* texture window */ \
 			switch( n_cmd & 0x02 ) \
 			{ \
 			case 0x00: \
 				/* shading */ \
-				switch( psxgpu.n_tp ) \
+				switch( p_prim->gpu.n_tp ) \
 				{ \
 				case 0: \
 					/* 4 bit clut */ \
@@ -1285,7 +1347,7 @@ INLINE void decode_tpage( struct PSXGPU *p_psxgpu, UINT32 tpage )
 				break; \
 			case 0x02: \
 				/* semi transparency */ \
-				switch( psxgpu.n_tp ) \
+				switch( p_prim->gpu.n_tp ) \
 				{ \
 				case 0: \
 					/* 4 bit clut */ \
@@ -1313,7 +1375,7 @@ INLINE void decode_tpage( struct PSXGPU *p_psxgpu, UINT32 tpage )
 			{ \
 			case 0x00: \
 				/* shading */ \
-				switch( psxgpu.n_tp ) \
+				switch( p_prim->gpu.n_tp ) \
 				{ \
 				case 0: \
 					/* 4 bit clut */ \
@@ -1334,7 +1396,7 @@ INLINE void decode_tpage( struct PSXGPU *p_psxgpu, UINT32 tpage )
 				break; \
 			case 0x02: \
 				/* semi transparency */ \
-				switch( psxgpu.n_tp ) \
+				switch( p_prim->gpu.n_tp ) \
 				{ \
 				case 0: \
 					/* 4 bit clut */ \
@@ -1359,17 +1421,17 @@ INLINE void decode_tpage( struct PSXGPU *p_psxgpu, UINT32 tpage )
 	else \
 	{ \
 		/* standard texture */ \
-		if( m_n_twh != 255 || \
-			m_n_tww != 255 || \
-			m_n_twx != 0 || \
-			m_n_twy != 0 ) \
+		if( p_prim->n_twh != 255 || \
+			p_prim->n_tww != 255 || \
+			p_prim->n_twx != 0 || \
+			p_prim->n_twy != 0 ) \
 		{ \
 			/* texture window */ \
 			switch( n_cmd & 0x02 ) \
 			{ \
 			case 0x00: \
 				/* shading */ \
-				switch( psxgpu.n_tp ) \
+				switch( p_prim->gpu.n_tp ) \
 				{ \
 				case 0: \
 					/* 4 bit clut */ \
@@ -1390,7 +1452,7 @@ INLINE void decode_tpage( struct PSXGPU *p_psxgpu, UINT32 tpage )
 				break; \
 			case 0x02: \
 				/* semi transparency */ \
-				switch( psxgpu.n_tp ) \
+				switch( p_prim->gpu.n_tp ) \
 				{ \
 				case 0: \
 					/* 4 bit clut */ \
@@ -1418,7 +1480,7 @@ INLINE void decode_tpage( struct PSXGPU *p_psxgpu, UINT32 tpage )
 			{ \
 			case 0x00: \
 				/* shading */ \
-				switch( psxgpu.n_tp ) \
+				switch( p_prim->gpu.n_tp ) \
 				{ \
 				case 0: \
 					TEXTURE4BIT( TXV, TXU ) \
@@ -1438,7 +1500,7 @@ INLINE void decode_tpage( struct PSXGPU *p_psxgpu, UINT32 tpage )
 				break; \
 			case 0x02: \
 				/* semi transparency */ \
-				switch( psxgpu.n_tp ) \
+				switch( p_prim->gpu.n_tp ) \
 				{ \
 				case 0: \
 					/* 4 bit clut */ \
@@ -1461,8 +1523,9 @@ INLINE void decode_tpage( struct PSXGPU *p_psxgpu, UINT32 tpage )
 		} \
 	}
 
-static void FlatPolygon( int n_points )
+static void FlatPolygon( struct PSXPRIMITIVE *p_prim )
 {
+	int n_points = p_prim->n_points;
 	INT16 n_y;
 	INT16 n_x;
 
@@ -1501,21 +1564,21 @@ static void FlatPolygon( int n_points )
 	}
 	for( n_point = 0; n_point < n_points; n_point++ )
 	{
-		DebugMesh( COORD_X( m_packet.FlatPolygon.vertex[ n_point ].n_coord ) + m_n_drawoffset_x, COORD_Y( m_packet.FlatPolygon.vertex[ n_point ].n_coord ) + m_n_drawoffset_y );
+		DebugMesh( COORD_X( p_prim->packet.FlatPolygon.vertex[ n_point ].n_coord ) + p_prim->n_drawoffset_x, COORD_Y( p_prim->packet.FlatPolygon.vertex[ n_point ].n_coord ) + p_prim->n_drawoffset_y );
 	}
 	DebugMeshEnd();
 #endif
 
-	n_cmd = BGR_C( m_packet.FlatPolygon.n_bgr );
+	n_cmd = BGR_C( p_prim->packet.FlatPolygon.n_bgr );
 
 	n_cx1.d = 0;
 	n_cx2.d = 0;
 
 	SOLIDSETUP
 
-	n_r.w.h = BGR_R( m_packet.FlatPolygon.n_bgr ); n_r.w.l = 0;
-	n_g.w.h = BGR_G( m_packet.FlatPolygon.n_bgr ); n_g.w.l = 0;
-	n_b.w.h = BGR_B( m_packet.FlatPolygon.n_bgr ); n_b.w.l = 0;
+	n_r.w.h = BGR_R( p_prim->packet.FlatPolygon.n_bgr ); n_r.w.l = 0;
+	n_g.w.h = BGR_G( p_prim->packet.FlatPolygon.n_bgr ); n_g.w.l = 0;
+	n_b.w.h = BGR_B( p_prim->packet.FlatPolygon.n_bgr ); n_b.w.l = 0;
 
 	if( n_points == 4 )
 	{
@@ -1530,15 +1593,15 @@ static void FlatPolygon( int n_points )
 
 	for( n_point = 0; n_point < n_points; n_point++ )
 	{
-		ADJUST_COORD( m_packet.FlatPolygon.vertex[ n_point ].n_coord );
+		ADJUST_COORD( p_prim->packet.FlatPolygon.vertex[ n_point ].n_coord );
 	}
 
 	n_leftpoint = 0;
 	for( n_point = 1; n_point < n_points; n_point++ )
 	{
-		if( COORD_Y( m_packet.FlatPolygon.vertex[ n_point ].n_coord ) < COORD_Y( m_packet.FlatPolygon.vertex[ n_leftpoint ].n_coord ) ||
-			( COORD_Y( m_packet.FlatPolygon.vertex[ n_point ].n_coord ) == COORD_Y( m_packet.FlatPolygon.vertex[ n_leftpoint ].n_coord ) &&
-			COORD_X( m_packet.FlatPolygon.vertex[ n_point ].n_coord ) < COORD_X( m_packet.FlatPolygon.vertex[ n_leftpoint ].n_coord ) ) )
+		if( COORD_Y( p_prim->packet.FlatPolygon.vertex[ n_point ].n_coord ) < COORD_Y( p_prim->packet.FlatPolygon.vertex[ n_leftpoint ].n_coord ) ||
+			( COORD_Y( p_prim->packet.FlatPolygon.vertex[ n_point ].n_coord ) == COORD_Y( p_prim->packet.FlatPolygon.vertex[ n_leftpoint ].n_coord ) &&
+			COORD_X( p_prim->packet.FlatPolygon.vertex[ n_point ].n_coord ) < COORD_X( p_prim->packet.FlatPolygon.vertex[ n_leftpoint ].n_coord ) ) )
 		{
 			n_leftpoint = n_point;
 		}
@@ -1548,13 +1611,13 @@ static void FlatPolygon( int n_points )
 	n_dx1 = 0;
 	n_dx2 = 0;
 
-	n_y = COORD_Y( m_packet.FlatPolygon.vertex[ n_rightpoint ].n_coord );
+	n_y = COORD_Y( p_prim->packet.FlatPolygon.vertex[ n_rightpoint ].n_coord );
 
 	for( ;; )
 	{
-		if( n_y == COORD_Y( m_packet.FlatPolygon.vertex[ n_leftpoint ].n_coord ) )
+		if( n_y == COORD_Y( p_prim->packet.FlatPolygon.vertex[ n_leftpoint ].n_coord ) )
 		{
-			while( n_y == COORD_Y( m_packet.FlatPolygon.vertex[ p_n_leftpointlist[ n_leftpoint ] ].n_coord ) )
+			while( n_y == COORD_Y( p_prim->packet.FlatPolygon.vertex[ p_n_leftpointlist[ n_leftpoint ] ].n_coord ) )
 			{
 				n_leftpoint = p_n_leftpointlist[ n_leftpoint ];
 				if( n_leftpoint == n_rightpoint )
@@ -1562,18 +1625,18 @@ static void FlatPolygon( int n_points )
 					break;
 				}
 			}
-			n_cx1.w.h = COORD_X( m_packet.FlatPolygon.vertex[ n_leftpoint ].n_coord ); n_cx1.w.l = 0;
+			n_cx1.w.h = COORD_X( p_prim->packet.FlatPolygon.vertex[ n_leftpoint ].n_coord ); n_cx1.w.l = 0;
 			n_leftpoint = p_n_leftpointlist[ n_leftpoint ];
-			n_distance = COORD_Y( m_packet.FlatPolygon.vertex[ n_leftpoint ].n_coord ) - n_y;
+			n_distance = COORD_Y( p_prim->packet.FlatPolygon.vertex[ n_leftpoint ].n_coord ) - n_y;
 			if( n_distance < 1 )
 			{
 				break;
 			}
-			n_dx1 = (INT32)( ( COORD_X( m_packet.FlatPolygon.vertex[ n_leftpoint ].n_coord ) << 16 ) - n_cx1.d ) / n_distance;
+			n_dx1 = (INT32)( ( COORD_X( p_prim->packet.FlatPolygon.vertex[ n_leftpoint ].n_coord ) << 16 ) - n_cx1.d ) / n_distance;
 		}
-		if( n_y == COORD_Y( m_packet.FlatPolygon.vertex[ n_rightpoint ].n_coord ) )
+		if( n_y == COORD_Y( p_prim->packet.FlatPolygon.vertex[ n_rightpoint ].n_coord ) )
 		{
-			while( n_y == COORD_Y( m_packet.FlatPolygon.vertex[ p_n_rightpointlist[ n_rightpoint ] ].n_coord ) )
+			while( n_y == COORD_Y( p_prim->packet.FlatPolygon.vertex[ p_n_rightpointlist[ n_rightpoint ] ].n_coord ) )
 			{
 				n_rightpoint = p_n_rightpointlist[ n_rightpoint ];
 				if( n_rightpoint == n_leftpoint )
@@ -1581,16 +1644,16 @@ static void FlatPolygon( int n_points )
 					break;
 				}
 			}
-			n_cx2.w.h = COORD_X( m_packet.FlatPolygon.vertex[ n_rightpoint ].n_coord ); n_cx2.w.l = 0;
+			n_cx2.w.h = COORD_X( p_prim->packet.FlatPolygon.vertex[ n_rightpoint ].n_coord ); n_cx2.w.l = 0;
 			n_rightpoint = p_n_rightpointlist[ n_rightpoint ];
-			n_distance = COORD_Y( m_packet.FlatPolygon.vertex[ n_rightpoint ].n_coord ) - n_y;
+			n_distance = COORD_Y( p_prim->packet.FlatPolygon.vertex[ n_rightpoint ].n_coord ) - n_y;
 			if( n_distance < 1 )
 			{
 				break;
 			}
-			n_dx2 = (INT32)( ( COORD_X( m_packet.FlatPolygon.vertex[ n_rightpoint ].n_coord ) << 16 ) - n_cx2.d ) / n_distance;
+			n_dx2 = (INT32)( ( COORD_X( p_prim->packet.FlatPolygon.vertex[ n_rightpoint ].n_coord ) << 16 ) - n_cx2.d ) / n_distance;
 		}
-		if( (INT16)n_cx1.w.h != (INT16)n_cx2.w.h && n_y >= (INT32)m_n_drawarea_y1 && n_y <= (INT32)m_n_drawarea_y2 )
+		if( (INT16)n_cx1.w.h != (INT16)n_cx2.w.h && n_y >= (INT32)p_prim->n_drawarea_y1 && n_y <= (INT32)p_prim->n_drawarea_y2 )
 		{
 			if( (INT16)n_cx1.w.h < (INT16)n_cx2.w.h )
 			{
@@ -1603,10 +1666,10 @@ static void FlatPolygon( int n_points )
 				n_distance = (INT16)n_cx1.w.h - n_x;
 			}
 
-			if( ( (INT32)m_n_drawarea_x1 - n_x ) > 0 )
+			if( ( (INT32)p_prim->n_drawarea_x1 - n_x ) > 0 )
 			{
-				n_distance -= ( m_n_drawarea_x1 - n_x );
-				n_x = m_n_drawarea_x1;
+				n_distance -= ( p_prim->n_drawarea_x1 - n_x );
+				n_x = p_prim->n_drawarea_x1;
 			}
 			SOLIDFILL( FLATPOLYGONUPDATE )
 		}
@@ -1616,8 +1679,9 @@ static void FlatPolygon( int n_points )
 	}
 }
 
-static void FlatTexturedPolygon( int n_points )
+static void FlatTexturedPolygon( struct PSXPRIMITIVE *p_prim )
 {
+	int n_points = p_prim->n_points;
 	INT16 n_y;
 	INT16 n_x;
 	int n_tx;
@@ -1674,15 +1738,15 @@ static void FlatTexturedPolygon( int n_points )
 	}
 	for( n_point = 0; n_point < n_points; n_point++ )
 	{
-		DebugMesh( COORD_X( m_packet.FlatTexturedPolygon.vertex[ n_point ].n_coord ) + m_n_drawoffset_x, COORD_Y( m_packet.FlatTexturedPolygon.vertex[ n_point ].n_coord ) + m_n_drawoffset_y );
+		DebugMesh( COORD_X( p_prim->packet.FlatTexturedPolygon.vertex[ n_point ].n_coord ) + p_prim->n_drawoffset_x, COORD_Y( p_prim->packet.FlatTexturedPolygon.vertex[ n_point ].n_coord ) + p_prim->n_drawoffset_y );
 	}
 	DebugMeshEnd();
 #endif
 
-	n_cmd = BGR_C( m_packet.FlatTexturedPolygon.n_bgr );
+	n_cmd = BGR_C( p_prim->packet.FlatTexturedPolygon.n_bgr );
 
-	n_clutx = ( m_packet.FlatTexturedPolygon.vertex[ 0 ].n_texture.w.h & 0x3f ) << 4;
-	n_cluty = ( m_packet.FlatTexturedPolygon.vertex[ 0 ].n_texture.w.h >> 6 ) & 0x3ff;
+	n_clutx = ( p_prim->packet.FlatTexturedPolygon.vertex[ 0 ].n_texture.w.h & 0x3f ) << 4;
+	n_cluty = ( p_prim->packet.FlatTexturedPolygon.vertex[ 0 ].n_texture.w.h >> 6 ) & 0x3ff;
 
 	n_r.d = 0;
 	n_g.d = 0;
@@ -1694,15 +1758,14 @@ static void FlatTexturedPolygon( int n_points )
 	n_cu2.d = 0;
 	n_cv2.d = 0;
 
-	decode_tpage( &psxgpu, m_packet.FlatTexturedPolygon.vertex[ 1 ].n_texture.w.h );
 	TEXTURESETUP
 
 	switch( n_cmd & 0x01 )
 	{
 	case 0:
-		n_r.w.h = BGR_R( m_packet.FlatTexturedPolygon.n_bgr ); n_r.w.l = 0;
-		n_g.w.h = BGR_G( m_packet.FlatTexturedPolygon.n_bgr ); n_g.w.l = 0;
-		n_b.w.h = BGR_B( m_packet.FlatTexturedPolygon.n_bgr ); n_b.w.l = 0;
+		n_r.w.h = BGR_R( p_prim->packet.FlatTexturedPolygon.n_bgr ); n_r.w.l = 0;
+		n_g.w.h = BGR_G( p_prim->packet.FlatTexturedPolygon.n_bgr ); n_g.w.l = 0;
+		n_b.w.h = BGR_B( p_prim->packet.FlatTexturedPolygon.n_bgr ); n_b.w.l = 0;
 		break;
 	case 1:
 		n_r.w.h = 0x80; n_r.w.l = 0;
@@ -1724,15 +1787,15 @@ static void FlatTexturedPolygon( int n_points )
 
 	for( n_point = 0; n_point < n_points; n_point++ )
 	{
-		ADJUST_COORD( m_packet.FlatTexturedPolygon.vertex[ n_point ].n_coord );
+		ADJUST_COORD( p_prim->packet.FlatTexturedPolygon.vertex[ n_point ].n_coord );
 	}
 
 	n_leftpoint = 0;
 	for( n_point = 1; n_point < n_points; n_point++ )
 	{
-		if( COORD_Y( m_packet.FlatTexturedPolygon.vertex[ n_point ].n_coord ) < COORD_Y( m_packet.FlatTexturedPolygon.vertex[ n_leftpoint ].n_coord ) ||
-			( COORD_Y( m_packet.FlatTexturedPolygon.vertex[ n_point ].n_coord ) == COORD_Y( m_packet.FlatTexturedPolygon.vertex[ n_leftpoint ].n_coord ) &&
-			COORD_X( m_packet.FlatTexturedPolygon.vertex[ n_point ].n_coord ) < COORD_X( m_packet.FlatTexturedPolygon.vertex[ n_leftpoint ].n_coord ) ) )
+		if( COORD_Y( p_prim->packet.FlatTexturedPolygon.vertex[ n_point ].n_coord ) < COORD_Y( p_prim->packet.FlatTexturedPolygon.vertex[ n_leftpoint ].n_coord ) ||
+			( COORD_Y( p_prim->packet.FlatTexturedPolygon.vertex[ n_point ].n_coord ) == COORD_Y( p_prim->packet.FlatTexturedPolygon.vertex[ n_leftpoint ].n_coord ) &&
+			COORD_X( p_prim->packet.FlatTexturedPolygon.vertex[ n_point ].n_coord ) < COORD_X( p_prim->packet.FlatTexturedPolygon.vertex[ n_leftpoint ].n_coord ) ) )
 		{
 			n_leftpoint = n_point;
 		}
@@ -1746,13 +1809,13 @@ static void FlatTexturedPolygon( int n_points )
 	n_dv1 = 0;
 	n_dv2 = 0;
 
-	n_y = COORD_Y( m_packet.FlatTexturedPolygon.vertex[ n_rightpoint ].n_coord );
+	n_y = COORD_Y( p_prim->packet.FlatTexturedPolygon.vertex[ n_rightpoint ].n_coord );
 
 	for( ;; )
 	{
-		if( n_y == COORD_Y( m_packet.FlatTexturedPolygon.vertex[ n_leftpoint ].n_coord ) )
+		if( n_y == COORD_Y( p_prim->packet.FlatTexturedPolygon.vertex[ n_leftpoint ].n_coord ) )
 		{
-			while( n_y == COORD_Y( m_packet.FlatTexturedPolygon.vertex[ p_n_leftpointlist[ n_leftpoint ] ].n_coord ) )
+			while( n_y == COORD_Y( p_prim->packet.FlatTexturedPolygon.vertex[ p_n_leftpointlist[ n_leftpoint ] ].n_coord ) )
 			{
 				n_leftpoint = p_n_leftpointlist[ n_leftpoint ];
 				if( n_leftpoint == n_rightpoint )
@@ -1760,22 +1823,22 @@ static void FlatTexturedPolygon( int n_points )
 					break;
 				}
 			}
-			n_cx1.w.h = COORD_X( m_packet.FlatTexturedPolygon.vertex[ n_leftpoint ].n_coord ); n_cx1.w.l = 0;
-			n_cu1.w.h = TEXTURE_U( m_packet.FlatTexturedPolygon.vertex[ n_leftpoint ].n_texture ); n_cu1.w.l = 0;
-			n_cv1.w.h = TEXTURE_V( m_packet.FlatTexturedPolygon.vertex[ n_leftpoint ].n_texture ); n_cv1.w.l = 0;
+			n_cx1.w.h = COORD_X( p_prim->packet.FlatTexturedPolygon.vertex[ n_leftpoint ].n_coord ); n_cx1.w.l = 0;
+			n_cu1.w.h = TEXTURE_U( p_prim->packet.FlatTexturedPolygon.vertex[ n_leftpoint ].n_texture ); n_cu1.w.l = 0;
+			n_cv1.w.h = TEXTURE_V( p_prim->packet.FlatTexturedPolygon.vertex[ n_leftpoint ].n_texture ); n_cv1.w.l = 0;
 			n_leftpoint = p_n_leftpointlist[ n_leftpoint ];
-			n_distance = COORD_Y( m_packet.FlatTexturedPolygon.vertex[ n_leftpoint ].n_coord ) - n_y;
+			n_distance = COORD_Y( p_prim->packet.FlatTexturedPolygon.vertex[ n_leftpoint ].n_coord ) - n_y;
 			if( n_distance < 1 )
 			{
 				break;
 			}
-			n_dx1 = (INT32)( ( COORD_X( m_packet.FlatTexturedPolygon.vertex[ n_leftpoint ].n_coord ) << 16 ) - n_cx1.d ) / n_distance;
-			n_du1 = (INT32)( ( TEXTURE_U( m_packet.FlatTexturedPolygon.vertex[ n_leftpoint ].n_texture ) << 16 ) - n_cu1.d ) / n_distance;
-			n_dv1 = (INT32)( ( TEXTURE_V( m_packet.FlatTexturedPolygon.vertex[ n_leftpoint ].n_texture ) << 16 ) - n_cv1.d ) / n_distance;
+			n_dx1 = (INT32)( ( COORD_X( p_prim->packet.FlatTexturedPolygon.vertex[ n_leftpoint ].n_coord ) << 16 ) - n_cx1.d ) / n_distance;
+			n_du1 = (INT32)( ( TEXTURE_U( p_prim->packet.FlatTexturedPolygon.vertex[ n_leftpoint ].n_texture ) << 16 ) - n_cu1.d ) / n_distance;
+			n_dv1 = (INT32)( ( TEXTURE_V( p_prim->packet.FlatTexturedPolygon.vertex[ n_leftpoint ].n_texture ) << 16 ) - n_cv1.d ) / n_distance;
 		}
-		if( n_y == COORD_Y( m_packet.FlatTexturedPolygon.vertex[ n_rightpoint ].n_coord ) )
+		if( n_y == COORD_Y( p_prim->packet.FlatTexturedPolygon.vertex[ n_rightpoint ].n_coord ) )
 		{
-			while( n_y == COORD_Y( m_packet.FlatTexturedPolygon.vertex[ p_n_rightpointlist[ n_rightpoint ] ].n_coord ) )
+			while( n_y == COORD_Y( p_prim->packet.FlatTexturedPolygon.vertex[ p_n_rightpointlist[ n_rightpoint ] ].n_coord ) )
 			{
 				n_rightpoint = p_n_rightpointlist[ n_rightpoint ];
 				if( n_rightpoint == n_leftpoint )
@@ -1783,20 +1846,20 @@ static void FlatTexturedPolygon( int n_points )
 					break;
 				}
 			}
-			n_cx2.w.h = COORD_X( m_packet.FlatTexturedPolygon.vertex[ n_rightpoint ].n_coord ); n_cx2.w.l = 0;
-			n_cu2.w.h = TEXTURE_U( m_packet.FlatTexturedPolygon.vertex[ n_rightpoint ].n_texture ); n_cu2.w.l = 0;
-			n_cv2.w.h = TEXTURE_V( m_packet.FlatTexturedPolygon.vertex[ n_rightpoint ].n_texture ); n_cv2.w.l = 0;
+			n_cx2.w.h = COORD_X( p_prim->packet.FlatTexturedPolygon.vertex[ n_rightpoint ].n_coord ); n_cx2.w.l = 0;
+			n_cu2.w.h = TEXTURE_U( p_prim->packet.FlatTexturedPolygon.vertex[ n_rightpoint ].n_texture ); n_cu2.w.l = 0;
+			n_cv2.w.h = TEXTURE_V( p_prim->packet.FlatTexturedPolygon.vertex[ n_rightpoint ].n_texture ); n_cv2.w.l = 0;
 			n_rightpoint = p_n_rightpointlist[ n_rightpoint ];
-			n_distance = COORD_Y( m_packet.FlatTexturedPolygon.vertex[ n_rightpoint ].n_coord ) - n_y;
+			n_distance = COORD_Y( p_prim->packet.FlatTexturedPolygon.vertex[ n_rightpoint ].n_coord ) - n_y;
 			if( n_distance < 1 )
 			{
 				break;
 			}
-			n_dx2 = (INT32)( ( COORD_X( m_packet.FlatTexturedPolygon.vertex[ n_rightpoint ].n_coord ) << 16 ) - n_cx2.d ) / n_distance;
-			n_du2 = (INT32)( ( TEXTURE_U( m_packet.FlatTexturedPolygon.vertex[ n_rightpoint ].n_texture ) << 16 ) - n_cu2.d ) / n_distance;
-			n_dv2 = (INT32)( ( TEXTURE_V( m_packet.FlatTexturedPolygon.vertex[ n_rightpoint ].n_texture ) << 16 ) - n_cv2.d ) / n_distance;
+			n_dx2 = (INT32)( ( COORD_X( p_prim->packet.FlatTexturedPolygon.vertex[ n_rightpoint ].n_coord ) << 16 ) - n_cx2.d ) / n_distance;
+			n_du2 = (INT32)( ( TEXTURE_U( p_prim->packet.FlatTexturedPolygon.vertex[ n_rightpoint ].n_texture ) << 16 ) - n_cu2.d ) / n_distance;
+			n_dv2 = (INT32)( ( TEXTURE_V( p_prim->packet.FlatTexturedPolygon.vertex[ n_rightpoint ].n_texture ) << 16 ) - n_cv2.d ) / n_distance;
 		}
-		if( (INT16)n_cx1.w.h != (INT16)n_cx2.w.h && n_y >= (INT32)m_n_drawarea_y1 && n_y <= (INT32)m_n_drawarea_y2 )
+		if( (INT16)n_cx1.w.h != (INT16)n_cx2.w.h && n_y >= (INT32)p_prim->n_drawarea_y1 && n_y <= (INT32)p_prim->n_drawarea_y2 )
 		{
 			if( (INT16)n_cx1.w.h < (INT16)n_cx2.w.h )
 			{
@@ -1819,12 +1882,12 @@ static void FlatTexturedPolygon( int n_points )
 				n_dv = (INT32)( n_cv1.d - n_cv2.d ) / n_distance;
 			}
 
-			if( ( (INT32)m_n_drawarea_x1 - n_x ) > 0 )
+			if( ( (INT32)p_prim->n_drawarea_x1 - n_x ) > 0 )
 			{
-				n_u.d += n_du * ( m_n_drawarea_x1 - n_x );
-				n_v.d += n_dv * ( m_n_drawarea_x1 - n_x );
-				n_distance -= ( m_n_drawarea_x1 - n_x );
-				n_x = m_n_drawarea_x1;
+				n_u.d += n_du * ( p_prim->n_drawarea_x1 - n_x );
+				n_v.d += n_dv * ( p_prim->n_drawarea_x1 - n_x );
+				n_distance -= ( p_prim->n_drawarea_x1 - n_x );
+				n_x = p_prim->n_drawarea_x1;
 			}
 			TEXTUREFILL( FLATTEXTUREDPOLYGONUPDATE, n_u.w.h, n_v.w.h );
 		}
@@ -1838,8 +1901,9 @@ static void FlatTexturedPolygon( int n_points )
 	}
 }
 
-static void GouraudPolygon( int n_points )
+static void GouraudPolygon( struct PSXPRIMITIVE *p_prim )
 {
+	int n_points = p_prim->n_points;
 	INT16 n_y;
 	INT16 n_x;
 
@@ -1893,12 +1957,12 @@ static void GouraudPolygon( int n_points )
 	}
 	for( n_point = 0; n_point < n_points; n_point++ )
 	{
-		DebugMesh( COORD_X( m_packet.GouraudPolygon.vertex[ n_point ].n_coord ) + m_n_drawoffset_x, COORD_Y( m_packet.GouraudPolygon.vertex[ n_point ].n_coord ) + m_n_drawoffset_y );
+		DebugMesh( COORD_X( p_prim->packet.GouraudPolygon.vertex[ n_point ].n_coord ) + p_prim->n_drawoffset_x, COORD_Y( p_prim->packet.GouraudPolygon.vertex[ n_point ].n_coord ) + p_prim->n_drawoffset_y );
 	}
 	DebugMeshEnd();
 #endif
 
-	n_cmd = BGR_C( m_packet.GouraudPolygon.vertex[ 0 ].n_bgr );
+	n_cmd = BGR_C( p_prim->packet.GouraudPolygon.vertex[ 0 ].n_bgr );
 
 	n_cx1.d = 0;
 	n_cr1.d = 0;
@@ -1924,15 +1988,15 @@ static void GouraudPolygon( int n_points )
 
 	for( n_point = 0; n_point < n_points; n_point++ )
 	{
-		ADJUST_COORD( m_packet.GouraudPolygon.vertex[ n_point ].n_coord );
+		ADJUST_COORD( p_prim->packet.GouraudPolygon.vertex[ n_point ].n_coord );
 	}
 
 	n_leftpoint = 0;
 	for( n_point = 1; n_point < n_points; n_point++ )
 	{
-		if( COORD_Y( m_packet.GouraudPolygon.vertex[ n_point ].n_coord ) < COORD_Y( m_packet.GouraudPolygon.vertex[ n_leftpoint ].n_coord ) ||
-			( COORD_Y( m_packet.GouraudPolygon.vertex[ n_point ].n_coord ) == COORD_Y( m_packet.GouraudPolygon.vertex[ n_leftpoint ].n_coord ) &&
-			COORD_X( m_packet.GouraudPolygon.vertex[ n_point ].n_coord ) < COORD_X( m_packet.GouraudPolygon.vertex[ n_leftpoint ].n_coord ) ) )
+		if( COORD_Y( p_prim->packet.GouraudPolygon.vertex[ n_point ].n_coord ) < COORD_Y( p_prim->packet.GouraudPolygon.vertex[ n_leftpoint ].n_coord ) ||
+			( COORD_Y( p_prim->packet.GouraudPolygon.vertex[ n_point ].n_coord ) == COORD_Y( p_prim->packet.GouraudPolygon.vertex[ n_leftpoint ].n_coord ) &&
+			COORD_X( p_prim->packet.GouraudPolygon.vertex[ n_point ].n_coord ) < COORD_X( p_prim->packet.GouraudPolygon.vertex[ n_leftpoint ].n_coord ) ) )
 		{
 			n_leftpoint = n_point;
 		}
@@ -1948,13 +2012,13 @@ static void GouraudPolygon( int n_points )
 	n_db1 = 0;
 	n_db2 = 0;
 
-	n_y = COORD_Y( m_packet.GouraudPolygon.vertex[ n_rightpoint ].n_coord );
+	n_y = COORD_Y( p_prim->packet.GouraudPolygon.vertex[ n_rightpoint ].n_coord );
 
 	for( ;; )
 	{
-		if( n_y == COORD_Y( m_packet.GouraudPolygon.vertex[ n_leftpoint ].n_coord ) )
+		if( n_y == COORD_Y( p_prim->packet.GouraudPolygon.vertex[ n_leftpoint ].n_coord ) )
 		{
-			while( n_y == COORD_Y( m_packet.GouraudPolygon.vertex[ p_n_leftpointlist[ n_leftpoint ] ].n_coord ) )
+			while( n_y == COORD_Y( p_prim->packet.GouraudPolygon.vertex[ p_n_leftpointlist[ n_leftpoint ] ].n_coord ) )
 			{
 				n_leftpoint = p_n_leftpointlist[ n_leftpoint ];
 				if( n_leftpoint == n_rightpoint )
@@ -1962,24 +2026,24 @@ static void GouraudPolygon( int n_points )
 					break;
 				}
 			}
-			n_cx1.w.h = COORD_X( m_packet.GouraudPolygon.vertex[ n_leftpoint ].n_coord ); n_cx1.w.l = 0;
-			n_cr1.w.h = BGR_R( m_packet.GouraudPolygon.vertex[ n_leftpoint ].n_bgr ); n_cr1.w.l = 0;
-			n_cg1.w.h = BGR_G( m_packet.GouraudPolygon.vertex[ n_leftpoint ].n_bgr ); n_cg1.w.l = 0;
-			n_cb1.w.h = BGR_B( m_packet.GouraudPolygon.vertex[ n_leftpoint ].n_bgr ); n_cb1.w.l = 0;
+			n_cx1.w.h = COORD_X( p_prim->packet.GouraudPolygon.vertex[ n_leftpoint ].n_coord ); n_cx1.w.l = 0;
+			n_cr1.w.h = BGR_R( p_prim->packet.GouraudPolygon.vertex[ n_leftpoint ].n_bgr ); n_cr1.w.l = 0;
+			n_cg1.w.h = BGR_G( p_prim->packet.GouraudPolygon.vertex[ n_leftpoint ].n_bgr ); n_cg1.w.l = 0;
+			n_cb1.w.h = BGR_B( p_prim->packet.GouraudPolygon.vertex[ n_leftpoint ].n_bgr ); n_cb1.w.l = 0;
 			n_leftpoint = p_n_leftpointlist[ n_leftpoint ];
-			n_distance = COORD_Y( m_packet.GouraudPolygon.vertex[ n_leftpoint ].n_coord ) - n_y;
+			n_distance = COORD_Y( p_prim->packet.GouraudPolygon.vertex[ n_leftpoint ].n_coord ) - n_y;
 			if( n_distance < 1 )
 			{
 				break;
 			}
-			n_dx1 = (INT32)( ( COORD_X( m_packet.GouraudPolygon.vertex[ n_leftpoint ].n_coord ) << 16 ) - n_cx1.d ) / n_distance;
-			n_dr1 = (INT32)( ( BGR_R( m_packet.GouraudPolygon.vertex[ n_leftpoint ].n_bgr ) << 16 ) - n_cr1.d ) / n_distance;
-			n_dg1 = (INT32)( ( BGR_G( m_packet.GouraudPolygon.vertex[ n_leftpoint ].n_bgr ) << 16 ) - n_cg1.d ) / n_distance;
-			n_db1 = (INT32)( ( BGR_B( m_packet.GouraudPolygon.vertex[ n_leftpoint ].n_bgr ) << 16 ) - n_cb1.d ) / n_distance;
+			n_dx1 = (INT32)( ( COORD_X( p_prim->packet.GouraudPolygon.vertex[ n_leftpoint ].n_coord ) << 16 ) - n_cx1.d ) / n_distance;
+			n_dr1 = (INT32)( ( BGR_R( p_prim->packet.GouraudPolygon.vertex[ n_leftpoint ].n_bgr ) << 16 ) - n_cr1.d ) / n_distance;
+			n_dg1 = (INT32)( ( BGR_G( p_prim->packet.GouraudPolygon.vertex[ n_leftpoint ].n_bgr ) << 16 ) - n_cg1.d ) / n_distance;
+			n_db1 = (INT32)( ( BGR_B( p_prim->packet.GouraudPolygon.vertex[ n_leftpoint ].n_bgr ) << 16 ) - n_cb1.d ) / n_distance;
 		}
-		if( n_y == COORD_Y( m_packet.GouraudPolygon.vertex[ n_rightpoint ].n_coord ) )
+		if( n_y == COORD_Y( p_prim->packet.GouraudPolygon.vertex[ n_rightpoint ].n_coord ) )
 		{
-			while( n_y == COORD_Y( m_packet.GouraudPolygon.vertex[ p_n_rightpointlist[ n_rightpoint ] ].n_coord ) )
+			while( n_y == COORD_Y( p_prim->packet.GouraudPolygon.vertex[ p_n_rightpointlist[ n_rightpoint ] ].n_coord ) )
 			{
 				n_rightpoint = p_n_rightpointlist[ n_rightpoint ];
 				if( n_rightpoint == n_leftpoint )
@@ -1987,22 +2051,22 @@ static void GouraudPolygon( int n_points )
 					break;
 				}
 			}
-			n_cx2.w.h = COORD_X( m_packet.GouraudPolygon.vertex[ n_rightpoint ].n_coord ); n_cx2.w.l = 0;
-			n_cr2.w.h = BGR_R( m_packet.GouraudPolygon.vertex[ n_rightpoint ].n_bgr ); n_cr2.w.l = 0;
-			n_cg2.w.h = BGR_G( m_packet.GouraudPolygon.vertex[ n_rightpoint ].n_bgr ); n_cg2.w.l = 0;
-			n_cb2.w.h = BGR_B( m_packet.GouraudPolygon.vertex[ n_rightpoint ].n_bgr ); n_cb2.w.l = 0;
+			n_cx2.w.h = COORD_X( p_prim->packet.GouraudPolygon.vertex[ n_rightpoint ].n_coord ); n_cx2.w.l = 0;
+			n_cr2.w.h = BGR_R( p_prim->packet.GouraudPolygon.vertex[ n_rightpoint ].n_bgr ); n_cr2.w.l = 0;
+			n_cg2.w.h = BGR_G( p_prim->packet.GouraudPolygon.vertex[ n_rightpoint ].n_bgr ); n_cg2.w.l = 0;
+			n_cb2.w.h = BGR_B( p_prim->packet.GouraudPolygon.vertex[ n_rightpoint ].n_bgr ); n_cb2.w.l = 0;
 			n_rightpoint = p_n_rightpointlist[ n_rightpoint ];
-			n_distance = COORD_Y( m_packet.GouraudPolygon.vertex[ n_rightpoint ].n_coord ) - n_y;
+			n_distance = COORD_Y( p_prim->packet.GouraudPolygon.vertex[ n_rightpoint ].n_coord ) - n_y;
 			if( n_distance < 1 )
 			{
 				break;
 			}
-			n_dx2 = (INT32)( ( COORD_X( m_packet.GouraudPolygon.vertex[ n_rightpoint ].n_coord ) << 16 ) - n_cx2.d ) / n_distance;
-			n_dr2 = (INT32)( ( BGR_R( m_packet.GouraudPolygon.vertex[ n_rightpoint ].n_bgr ) << 16 ) - n_cr2.d ) / n_distance;
-			n_dg2 = (INT32)( ( BGR_G( m_packet.GouraudPolygon.vertex[ n_rightpoint ].n_bgr ) << 16 ) - n_cg2.d ) / n_distance;
-			n_db2 = (INT32)( ( BGR_B( m_packet.GouraudPolygon.vertex[ n_rightpoint ].n_bgr ) << 16 ) - n_cb2.d ) / n_distance;
+			n_dx2 = (INT32)( ( COORD_X( p_prim->packet.GouraudPolygon.vertex[ n_rightpoint ].n_coord ) << 16 ) - n_cx2.d ) / n_distance;
+			n_dr2 = (INT32)( ( BGR_R( p_prim->packet.GouraudPolygon.vertex[ n_rightpoint ].n_bgr ) << 16 ) - n_cr2.d ) / n_distance;
+			n_dg2 = (INT32)( ( BGR_G( p_prim->packet.GouraudPolygon.vertex[ n_rightpoint ].n_bgr ) << 16 ) - n_cg2.d ) / n_distance;
+			n_db2 = (INT32)( ( BGR_B( p_prim->packet.GouraudPolygon.vertex[ n_rightpoint ].n_bgr ) << 16 ) - n_cb2.d ) / n_distance;
 		}
-		if( (INT16)n_cx1.w.h != (INT16)n_cx2.w.h && n_y >= (INT32)m_n_drawarea_y1 && n_y <= (INT32)m_n_drawarea_y2 )
+		if( (INT16)n_cx1.w.h != (INT16)n_cx2.w.h && n_y >= (INT32)p_prim->n_drawarea_y1 && n_y <= (INT32)p_prim->n_drawarea_y2 )
 		{
 			if( (INT16)n_cx1.w.h < (INT16)n_cx2.w.h )
 			{
@@ -2029,13 +2093,13 @@ static void GouraudPolygon( int n_points )
 				n_db = (INT32)( n_cb1.d - n_cb2.d ) / n_distance;
 			}
 
-			if( ( (INT32)m_n_drawarea_x1 - n_x ) > 0 )
+			if( ( (INT32)p_prim->n_drawarea_x1 - n_x ) > 0 )
 			{
-				n_r.d += n_dr * ( m_n_drawarea_x1 - n_x );
-				n_g.d += n_dg * ( m_n_drawarea_x1 - n_x );
-				n_b.d += n_db * ( m_n_drawarea_x1 - n_x );
-				n_distance -= ( m_n_drawarea_x1 - n_x );
-				n_x = m_n_drawarea_x1;
+				n_r.d += n_dr * ( p_prim->n_drawarea_x1 - n_x );
+				n_g.d += n_dg * ( p_prim->n_drawarea_x1 - n_x );
+				n_b.d += n_db * ( p_prim->n_drawarea_x1 - n_x );
+				n_distance -= ( p_prim->n_drawarea_x1 - n_x );
+				n_x = p_prim->n_drawarea_x1;
 			}
 			SOLIDFILL( GOURAUDPOLYGONUPDATE )
 		}
@@ -2051,8 +2115,9 @@ static void GouraudPolygon( int n_points )
 	}
 }
 
-static void GouraudTexturedPolygon( int n_points )
+static void GouraudTexturedPolygon( struct PSXPRIMITIVE *p_prim )
 {
+	int n_points = p_prim->n_points;
 	INT16 n_y;
 	INT16 n_x;
 	int n_tx;
@@ -2124,15 +2189,15 @@ static void GouraudTexturedPolygon( int n_points )
 	}
 	for( n_point = 0; n_point < n_points; n_point++ )
 	{
-		DebugMesh( COORD_X( m_packet.GouraudTexturedPolygon.vertex[ n_point ].n_coord ) + m_n_drawoffset_x, COORD_Y( m_packet.GouraudTexturedPolygon.vertex[ n_point ].n_coord ) + m_n_drawoffset_y );
+		DebugMesh( COORD_X( p_prim->packet.GouraudTexturedPolygon.vertex[ n_point ].n_coord ) + p_prim->n_drawoffset_x, COORD_Y( p_prim->packet.GouraudTexturedPolygon.vertex[ n_point ].n_coord ) + p_prim->n_drawoffset_y );
 	}
 	DebugMeshEnd();
 #endif
 
-	n_cmd = BGR_C( m_packet.GouraudTexturedPolygon.vertex[ 0 ].n_bgr );
+	n_cmd = BGR_C( p_prim->packet.GouraudTexturedPolygon.vertex[ 0 ].n_bgr );
 
-	n_clutx = ( m_packet.GouraudTexturedPolygon.vertex[ 0 ].n_texture.w.h & 0x3f ) << 4;
-	n_cluty = ( m_packet.GouraudTexturedPolygon.vertex[ 0 ].n_texture.w.h >> 6 ) & 0x3ff;
+	n_clutx = ( p_prim->packet.GouraudTexturedPolygon.vertex[ 0 ].n_texture.w.h & 0x3f ) << 4;
+	n_cluty = ( p_prim->packet.GouraudTexturedPolygon.vertex[ 0 ].n_texture.w.h >> 6 ) & 0x3ff;
 
 	n_cx1.d = 0;
 	n_cr1.d = 0;
@@ -2147,7 +2212,6 @@ static void GouraudTexturedPolygon( int n_points )
 	n_cu2.d = 0;
 	n_cv2.d = 0;
 
-	decode_tpage( &psxgpu, m_packet.GouraudTexturedPolygon.vertex[ 1 ].n_texture.w.h );
 	TEXTURESETUP
 
 	if( n_points == 4 )
@@ -2163,15 +2227,15 @@ static void GouraudTexturedPolygon( int n_points )
 
 	for( n_point = 0; n_point < n_points; n_point++ )
 	{
-		ADJUST_COORD( m_packet.GouraudTexturedPolygon.vertex[ n_point ].n_coord );
+		ADJUST_COORD( p_prim->packet.GouraudTexturedPolygon.vertex[ n_point ].n_coord );
 	}
 
 	n_leftpoint = 0;
 	for( n_point = 1; n_point < n_points; n_point++ )
 	{
-		if( COORD_Y( m_packet.GouraudTexturedPolygon.vertex[ n_point ].n_coord ) < COORD_Y( m_packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_coord ) ||
-			( COORD_Y( m_packet.GouraudTexturedPolygon.vertex[ n_point ].n_coord ) == COORD_Y( m_packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_coord ) &&
-			COORD_X( m_packet.GouraudTexturedPolygon.vertex[ n_point ].n_coord ) < COORD_X( m_packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_coord ) ) )
+		if( COORD_Y( p_prim->packet.GouraudTexturedPolygon.vertex[ n_point ].n_coord ) < COORD_Y( p_prim->packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_coord ) ||
+			( COORD_Y( p_prim->packet.GouraudTexturedPolygon.vertex[ n_point ].n_coord ) == COORD_Y( p_prim->packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_coord ) &&
+			COORD_X( p_prim->packet.GouraudTexturedPolygon.vertex[ n_point ].n_coord ) < COORD_X( p_prim->packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_coord ) ) )
 		{
 			n_leftpoint = n_point;
 		}
@@ -2191,13 +2255,13 @@ static void GouraudTexturedPolygon( int n_points )
 	n_dv1 = 0;
 	n_dv2 = 0;
 
-	n_y = COORD_Y( m_packet.GouraudTexturedPolygon.vertex[ n_rightpoint ].n_coord );
+	n_y = COORD_Y( p_prim->packet.GouraudTexturedPolygon.vertex[ n_rightpoint ].n_coord );
 
 	for( ;; )
 	{
-		if( n_y == COORD_Y( m_packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_coord ) )
+		if( n_y == COORD_Y( p_prim->packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_coord ) )
 		{
-			while( n_y == COORD_Y( m_packet.GouraudTexturedPolygon.vertex[ p_n_leftpointlist[ n_leftpoint ] ].n_coord ) )
+			while( n_y == COORD_Y( p_prim->packet.GouraudTexturedPolygon.vertex[ p_n_leftpointlist[ n_leftpoint ] ].n_coord ) )
 			{
 				n_leftpoint = p_n_leftpointlist[ n_leftpoint ];
 				if( n_leftpoint == n_rightpoint )
@@ -2205,13 +2269,13 @@ static void GouraudTexturedPolygon( int n_points )
 					break;
 				}
 			}
-			n_cx1.w.h = COORD_X( m_packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_coord ); n_cx1.w.l = 0;
+			n_cx1.w.h = COORD_X( p_prim->packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_coord ); n_cx1.w.l = 0;
 			switch( n_cmd & 0x01 )
 			{
 			case 0x00:
-				n_cr1.w.h = BGR_R( m_packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_bgr ); n_cr1.w.l = 0;
-				n_cg1.w.h = BGR_G( m_packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_bgr ); n_cg1.w.l = 0;
-				n_cb1.w.h = BGR_B( m_packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_bgr ); n_cb1.w.l = 0;
+				n_cr1.w.h = BGR_R( p_prim->packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_bgr ); n_cr1.w.l = 0;
+				n_cg1.w.h = BGR_G( p_prim->packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_bgr ); n_cg1.w.l = 0;
+				n_cb1.w.h = BGR_B( p_prim->packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_bgr ); n_cb1.w.l = 0;
 				break;
 			case 0x01:
 				n_cr1.w.h = 0x80; n_cr1.w.l = 0;
@@ -2219,21 +2283,21 @@ static void GouraudTexturedPolygon( int n_points )
 				n_cb1.w.h = 0x80; n_cb1.w.l = 0;
 				break;
 			}
-			n_cu1.w.h = TEXTURE_U( m_packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_texture ); n_cu1.w.l = 0;
-			n_cv1.w.h = TEXTURE_V( m_packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_texture ); n_cv1.w.l = 0;
+			n_cu1.w.h = TEXTURE_U( p_prim->packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_texture ); n_cu1.w.l = 0;
+			n_cv1.w.h = TEXTURE_V( p_prim->packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_texture ); n_cv1.w.l = 0;
 			n_leftpoint = p_n_leftpointlist[ n_leftpoint ];
-			n_distance = COORD_Y( m_packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_coord ) - n_y;
+			n_distance = COORD_Y( p_prim->packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_coord ) - n_y;
 			if( n_distance < 1 )
 			{
 				break;
 			}
-			n_dx1 = (INT32)( ( COORD_X( m_packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_coord ) << 16 ) - n_cx1.d ) / n_distance;
+			n_dx1 = (INT32)( ( COORD_X( p_prim->packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_coord ) << 16 ) - n_cx1.d ) / n_distance;
 			switch( n_cmd & 0x01 )
 			{
 			case 0x00:
-				n_dr1 = (INT32)( ( BGR_R( m_packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_bgr ) << 16 ) - n_cr1.d ) / n_distance;
-				n_dg1 = (INT32)( ( BGR_G( m_packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_bgr ) << 16 ) - n_cg1.d ) / n_distance;
-				n_db1 = (INT32)( ( BGR_B( m_packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_bgr ) << 16 ) - n_cb1.d ) / n_distance;
+				n_dr1 = (INT32)( ( BGR_R( p_prim->packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_bgr ) << 16 ) - n_cr1.d ) / n_distance;
+				n_dg1 = (INT32)( ( BGR_G( p_prim->packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_bgr ) << 16 ) - n_cg1.d ) / n_distance;
+				n_db1 = (INT32)( ( BGR_B( p_prim->packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_bgr ) << 16 ) - n_cb1.d ) / n_distance;
 				break;
 			case 0x01:
 				n_dr1 = 0;
@@ -2241,12 +2305,12 @@ static void GouraudTexturedPolygon( int n_points )
 				n_db1 = 0;
 				break;
 			}
-			n_du1 = (INT32)( ( TEXTURE_U( m_packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_texture ) << 16 ) - n_cu1.d ) / n_distance;
-			n_dv1 = (INT32)( ( TEXTURE_V( m_packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_texture ) << 16 ) - n_cv1.d ) / n_distance;
+			n_du1 = (INT32)( ( TEXTURE_U( p_prim->packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_texture ) << 16 ) - n_cu1.d ) / n_distance;
+			n_dv1 = (INT32)( ( TEXTURE_V( p_prim->packet.GouraudTexturedPolygon.vertex[ n_leftpoint ].n_texture ) << 16 ) - n_cv1.d ) / n_distance;
 		}
-		if( n_y == COORD_Y( m_packet.GouraudTexturedPolygon.vertex[ n_rightpoint ].n_coord ) )
+		if( n_y == COORD_Y( p_prim->packet.GouraudTexturedPolygon.vertex[ n_rightpoint ].n_coord ) )
 		{
-			while( n_y == COORD_Y( m_packet.GouraudTexturedPolygon.vertex[ p_n_rightpointlist[ n_rightpoint ] ].n_coord ) )
+			while( n_y == COORD_Y( p_prim->packet.GouraudTexturedPolygon.vertex[ p_n_rightpointlist[ n_rightpoint ] ].n_coord ) )
 			{
 				n_rightpoint = p_n_rightpointlist[ n_rightpoint ];
 				if( n_rightpoint == n_leftpoint )
@@ -2254,13 +2318,13 @@ static void GouraudTexturedPolygon( int n_points )
 					break;
 				}
 			}
-			n_cx2.w.h = COORD_X( m_packet.GouraudTexturedPolygon.vertex[ n_rightpoint ].n_coord ); n_cx2.w.l = 0;
+			n_cx2.w.h = COORD_X( p_prim->packet.GouraudTexturedPolygon.vertex[ n_rightpoint ].n_coord ); n_cx2.w.l = 0;
 			switch( n_cmd & 0x01 )
 			{
 			case 0x00:
-				n_cr2.w.h = BGR_R( m_packet.GouraudTexturedPolygon.vertex[ n_rightpoint ].n_bgr ); n_cr2.w.l = 0;
-				n_cg2.w.h = BGR_G( m_packet.GouraudTexturedPolygon.vertex[ n_rightpoint ].n_bgr ); n_cg2.w.l = 0;
-				n_cb2.w.h = BGR_B( m_packet.GouraudTexturedPolygon.vertex[ n_rightpoint ].n_bgr ); n_cb2.w.l = 0;
+				n_cr2.w.h = BGR_R( p_prim->packet.GouraudTexturedPolygon.vertex[ n_rightpoint ].n_bgr ); n_cr2.w.l = 0;
+				n_cg2.w.h = BGR_G( p_prim->packet.GouraudTexturedPolygon.vertex[ n_rightpoint ].n_bgr ); n_cg2.w.l = 0;
+				n_cb2.w.h = BGR_B( p_prim->packet.GouraudTexturedPolygon.vertex[ n_rightpoint ].n_bgr ); n_cb2.w.l = 0;
 				break;
 			case 0x01:
 				n_cr2.w.h = 0x80; n_cr2.w.l = 0;
@@ -2268,21 +2332,21 @@ static void GouraudTexturedPolygon( int n_points )
 				n_cb2.w.h = 0x80; n_cb2.w.l = 0;
 				break;
 			}
-			n_cu2.w.h = TEXTURE_U( m_packet.GouraudTexturedPolygon.vertex[ n_rightpoint ].n_texture ); n_cu2.w.l = 0;
-			n_cv2.w.h = TEXTURE_V( m_packet.GouraudTexturedPolygon.vertex[ n_rightpoint ].n_texture ); n_cv2.w.l = 0;
+			n_cu2.w.h = TEXTURE_U( p_prim->packet.GouraudTexturedPolygon.vertex[ n_rightpoint ].n_texture ); n_cu2.w.l = 0;
+			n_cv2.w.h = TEXTURE_V( p_prim->packet.GouraudTexturedPolygon.vertex[ n_rightpoint ].n_texture ); n_cv2.w.l = 0;
 			n_rightpoint = p_n_rightpointlist[ n_rightpoint ];
-			n_distance = COORD_Y( m_packet.GouraudTexturedPolygon.vertex[ n_rightpoint ].n_coord ) - n_y;
+			n_distance = COORD_Y( p_prim->packet.GouraudTexturedPolygon.vertex[ n_rightpoint ].n_coord ) - n_y;
 			if( n_distance < 1 )
 			{
 				break;
 			}
-			n_dx2 = (INT32)( ( COORD_X( m_packet.GouraudTexturedPolygon.vertex[ n_rightpoint ].n_coord ) << 16 ) - n_cx2.d ) / n_distance;
+			n_dx2 = (INT32)( ( COORD_X( p_prim->packet.GouraudTexturedPolygon.vertex[ n_rightpoint ].n_coord ) << 16 ) - n_cx2.d ) / n_distance;
 			switch( n_cmd & 0x01 )
 			{
 			case 0x00:
-				n_dr2 = (INT32)( ( BGR_R( m_packet.GouraudTexturedPolygon.vertex[ n_rightpoint ].n_bgr ) << 16 ) - n_cr2.d ) / n_distance;
-				n_dg2 = (INT32)( ( BGR_G( m_packet.GouraudTexturedPolygon.vertex[ n_rightpoint ].n_bgr ) << 16 ) - n_cg2.d ) / n_distance;
-				n_db2 = (INT32)( ( BGR_B( m_packet.GouraudTexturedPolygon.vertex[ n_rightpoint ].n_bgr ) << 16 ) - n_cb2.d ) / n_distance;
+				n_dr2 = (INT32)( ( BGR_R( p_prim->packet.GouraudTexturedPolygon.vertex[ n_rightpoint ].n_bgr ) << 16 ) - n_cr2.d ) / n_distance;
+				n_dg2 = (INT32)( ( BGR_G( p_prim->packet.GouraudTexturedPolygon.vertex[ n_rightpoint ].n_bgr ) << 16 ) - n_cg2.d ) / n_distance;
+				n_db2 = (INT32)( ( BGR_B( p_prim->packet.GouraudTexturedPolygon.vertex[ n_rightpoint ].n_bgr ) << 16 ) - n_cb2.d ) / n_distance;
 				break;
 			case 0x01:
 				n_dr2 = 0;
@@ -2290,10 +2354,10 @@ static void GouraudTexturedPolygon( int n_points )
 				n_db2 = 0;
 				break;
 			}
-			n_du2 = (INT32)( ( TEXTURE_U( m_packet.GouraudTexturedPolygon.vertex[ n_rightpoint ].n_texture ) << 16 ) - n_cu2.d ) / n_distance;
-			n_dv2 = (INT32)( ( TEXTURE_V( m_packet.GouraudTexturedPolygon.vertex[ n_rightpoint ].n_texture ) << 16 ) - n_cv2.d ) / n_distance;
+			n_du2 = (INT32)( ( TEXTURE_U( p_prim->packet.GouraudTexturedPolygon.vertex[ n_rightpoint ].n_texture ) << 16 ) - n_cu2.d ) / n_distance;
+			n_dv2 = (INT32)( ( TEXTURE_V( p_prim->packet.GouraudTexturedPolygon.vertex[ n_rightpoint ].n_texture ) << 16 ) - n_cv2.d ) / n_distance;
 		}
-		if( (INT16)n_cx1.w.h != (INT16)n_cx2.w.h && n_y >= (INT32)m_n_drawarea_y1 && n_y <= (INT32)m_n_drawarea_y2 )
+		if( (INT16)n_cx1.w.h != (INT16)n_cx2.w.h && n_y >= (INT32)p_prim->n_drawarea_y1 && n_y <= (INT32)p_prim->n_drawarea_y2 )
 		{
 			if( (INT16)n_cx1.w.h < (INT16)n_cx2.w.h )
 			{
@@ -2328,15 +2392,15 @@ static void GouraudTexturedPolygon( int n_points )
 				n_dv = (INT32)( n_cv1.d - n_cv2.d ) / n_distance;
 			}
 
-			if( ( (INT32)m_n_drawarea_x1 - n_x ) > 0 )
+			if( ( (INT32)p_prim->n_drawarea_x1 - n_x ) > 0 )
 			{
-				n_r.d += n_dr * ( m_n_drawarea_x1 - n_x );
-				n_g.d += n_dg * ( m_n_drawarea_x1 - n_x );
-				n_b.d += n_db * ( m_n_drawarea_x1 - n_x );
-				n_u.d += n_du * ( m_n_drawarea_x1 - n_x );
-				n_v.d += n_dv * ( m_n_drawarea_x1 - n_x );
-				n_distance -= ( m_n_drawarea_x1 - n_x );
-				n_x = m_n_drawarea_x1;
+				n_r.d += n_dr * ( p_prim->n_drawarea_x1 - n_x );
+				n_g.d += n_dg * ( p_prim->n_drawarea_x1 - n_x );
+				n_b.d += n_db * ( p_prim->n_drawarea_x1 - n_x );
+				n_u.d += n_du * ( p_prim->n_drawarea_x1 - n_x );
+				n_v.d += n_dv * ( p_prim->n_drawarea_x1 - n_x );
+				n_distance -= ( p_prim->n_drawarea_x1 - n_x );
+				n_x = p_prim->n_drawarea_x1;
 			}
 			TEXTUREFILL( GOURAUDTEXTUREDPOLYGONUPDATE, n_u.w.h, n_v.w.h );
 		}
@@ -2356,7 +2420,7 @@ static void GouraudTexturedPolygon( int n_points )
 	}
 }
 
-static void MonochromeLine( void )
+static void MonochromeLine( struct PSXPRIMITIVE *p_prim )
 {
 	PAIR n_x;
 	PAIR n_y;
@@ -2382,19 +2446,19 @@ static void MonochromeLine( void )
 	{
 		return;
 	}
-	DebugMesh( COORD_X( m_packet.MonochromeLine.vertex[ 0 ].n_coord ) + m_n_drawoffset_x, COORD_Y( m_packet.MonochromeLine.vertex[ 0 ].n_coord ) + m_n_drawoffset_y );
-	DebugMesh( COORD_X( m_packet.MonochromeLine.vertex[ 1 ].n_coord ) + m_n_drawoffset_x, COORD_Y( m_packet.MonochromeLine.vertex[ 1 ].n_coord ) + m_n_drawoffset_y );
+	DebugMesh( COORD_X( p_prim->packet.MonochromeLine.vertex[ 0 ].n_coord ) + p_prim->n_drawoffset_x, COORD_Y( p_prim->packet.MonochromeLine.vertex[ 0 ].n_coord ) + p_prim->n_drawoffset_y );
+	DebugMesh( COORD_X( p_prim->packet.MonochromeLine.vertex[ 1 ].n_coord ) + p_prim->n_drawoffset_x, COORD_Y( p_prim->packet.MonochromeLine.vertex[ 1 ].n_coord ) + p_prim->n_drawoffset_y );
 	DebugMeshEnd();
 #endif
 
-	n_xstart = COORD_X( m_packet.MonochromeLine.vertex[ 0 ].n_coord ) + m_n_drawoffset_x;
-	n_xend = COORD_X( m_packet.MonochromeLine.vertex[ 1 ].n_coord ) + m_n_drawoffset_x;
-	n_ystart = COORD_Y( m_packet.MonochromeLine.vertex[ 0 ].n_coord ) + m_n_drawoffset_y;
-	n_yend = COORD_Y( m_packet.MonochromeLine.vertex[ 1 ].n_coord ) + m_n_drawoffset_y;
+	n_xstart = COORD_X( p_prim->packet.MonochromeLine.vertex[ 0 ].n_coord ) + p_prim->n_drawoffset_x;
+	n_xend = COORD_X( p_prim->packet.MonochromeLine.vertex[ 1 ].n_coord ) + p_prim->n_drawoffset_x;
+	n_ystart = COORD_Y( p_prim->packet.MonochromeLine.vertex[ 0 ].n_coord ) + p_prim->n_drawoffset_y;
+	n_yend = COORD_Y( p_prim->packet.MonochromeLine.vertex[ 1 ].n_coord ) + p_prim->n_drawoffset_y;
 
-	n_r = BGR_R( m_packet.MonochromeLine.n_bgr );
-	n_g = BGR_G( m_packet.MonochromeLine.n_bgr );
-	n_b = BGR_B( m_packet.MonochromeLine.n_bgr );
+	n_r = BGR_R( p_prim->packet.MonochromeLine.n_bgr );
+	n_g = BGR_G( p_prim->packet.MonochromeLine.n_bgr );
+	n_b = BGR_B( p_prim->packet.MonochromeLine.n_bgr );
 
 	if( n_xend > n_xstart )
 	{
@@ -2439,10 +2503,10 @@ static void MonochromeLine( void )
 
 	while( n_len > 0 )
 	{
-		if( (INT16)n_x.w.h >= (INT32)m_n_drawarea_x1 &&
-			(INT16)n_y.w.h >= (INT32)m_n_drawarea_y1 &&
-			(INT16)n_x.w.h <= (INT32)m_n_drawarea_x2 &&
-			(INT16)n_y.w.h <= (INT32)m_n_drawarea_y2 )
+		if( (INT16)n_x.w.h >= (INT32)p_prim->n_drawarea_x1 &&
+			(INT16)n_y.w.h >= (INT32)p_prim->n_drawarea_y1 &&
+			(INT16)n_x.w.h <= (INT32)p_prim->n_drawarea_x2 &&
+			(INT16)n_y.w.h <= (INT32)p_prim->n_drawarea_y2 )
 		{
 			p_vram = m_p_p_vram[ n_y.w.h ] + n_x.w.h;
 			WRITE_PIXEL(
@@ -2456,7 +2520,7 @@ static void MonochromeLine( void )
 	}
 }
 
-static void GouraudLine( void )
+static void GouraudLine( struct PSXPRIMITIVE *p_prim )
 {
 	PAIR n_x;
 	PAIR n_y;
@@ -2488,22 +2552,22 @@ static void GouraudLine( void )
 	{
 		return;
 	}
-	DebugMesh( COORD_X( m_packet.GouraudLine.vertex[ 0 ].n_coord ) + m_n_drawoffset_x, COORD_Y( m_packet.GouraudLine.vertex[ 0 ].n_coord ) + m_n_drawoffset_y );
-	DebugMesh( COORD_X( m_packet.GouraudLine.vertex[ 1 ].n_coord ) + m_n_drawoffset_x, COORD_Y( m_packet.GouraudLine.vertex[ 1 ].n_coord ) + m_n_drawoffset_y );
+	DebugMesh( COORD_X( p_prim->packet.GouraudLine.vertex[ 0 ].n_coord ) + p_prim->n_drawoffset_x, COORD_Y( p_prim->packet.GouraudLine.vertex[ 0 ].n_coord ) + p_prim->n_drawoffset_y );
+	DebugMesh( COORD_X( p_prim->packet.GouraudLine.vertex[ 1 ].n_coord ) + p_prim->n_drawoffset_x, COORD_Y( p_prim->packet.GouraudLine.vertex[ 1 ].n_coord ) + p_prim->n_drawoffset_y );
 	DebugMeshEnd();
 #endif
 
-	n_xstart = COORD_X( m_packet.GouraudLine.vertex[ 0 ].n_coord ) + m_n_drawoffset_x;
-	n_ystart = COORD_Y( m_packet.GouraudLine.vertex[ 0 ].n_coord ) + m_n_drawoffset_y;
-	n_cr1.w.h = BGR_R( m_packet.GouraudLine.vertex[ 0 ].n_bgr ); n_cr1.w.l = 0;
-	n_cg1.w.h = BGR_G( m_packet.GouraudLine.vertex[ 0 ].n_bgr ); n_cg1.w.l = 0;
-	n_cb1.w.h = BGR_B( m_packet.GouraudLine.vertex[ 0 ].n_bgr ); n_cb1.w.l = 0;
+	n_xstart = COORD_X( p_prim->packet.GouraudLine.vertex[ 0 ].n_coord ) + p_prim->n_drawoffset_x;
+	n_ystart = COORD_Y( p_prim->packet.GouraudLine.vertex[ 0 ].n_coord ) + p_prim->n_drawoffset_y;
+	n_cr1.w.h = BGR_R( p_prim->packet.GouraudLine.vertex[ 0 ].n_bgr ); n_cr1.w.l = 0;
+	n_cg1.w.h = BGR_G( p_prim->packet.GouraudLine.vertex[ 0 ].n_bgr ); n_cg1.w.l = 0;
+	n_cb1.w.h = BGR_B( p_prim->packet.GouraudLine.vertex[ 0 ].n_bgr ); n_cb1.w.l = 0;
 
-	n_xend = COORD_X( m_packet.GouraudLine.vertex[ 1 ].n_coord ) + m_n_drawoffset_x;
-	n_yend = COORD_Y( m_packet.GouraudLine.vertex[ 1 ].n_coord ) + m_n_drawoffset_y;
-	n_cr2.w.h = BGR_R( m_packet.GouraudLine.vertex[ 1 ].n_bgr ); n_cr1.w.l = 0;
-	n_cg2.w.h = BGR_G( m_packet.GouraudLine.vertex[ 1 ].n_bgr ); n_cg1.w.l = 0;
-	n_cb2.w.h = BGR_B( m_packet.GouraudLine.vertex[ 1 ].n_bgr ); n_cb1.w.l = 0;
+	n_xend = COORD_X( p_prim->packet.GouraudLine.vertex[ 1 ].n_coord ) + p_prim->n_drawoffset_x;
+	n_yend = COORD_Y( p_prim->packet.GouraudLine.vertex[ 1 ].n_coord ) + p_prim->n_drawoffset_y;
+	n_cr2.w.h = BGR_R( p_prim->packet.GouraudLine.vertex[ 1 ].n_bgr ); n_cr1.w.l = 0;
+	n_cg2.w.h = BGR_G( p_prim->packet.GouraudLine.vertex[ 1 ].n_bgr ); n_cg1.w.l = 0;
+	n_cb2.w.h = BGR_B( p_prim->packet.GouraudLine.vertex[ 1 ].n_bgr ); n_cb1.w.l = 0;
 
 	n_x.w.h = n_xstart; n_x.w.l = 0;
 	n_y.w.h = n_ystart; n_y.w.l = 0;
@@ -2551,10 +2615,10 @@ static void GouraudLine( void )
 
 	while( n_distance > 0 )
 	{
-		if( (INT16)n_x.w.h >= (INT32)m_n_drawarea_x1 &&
-			(INT16)n_y.w.h >= (INT32)m_n_drawarea_y1 &&
-			(INT16)n_x.w.h <= (INT32)m_n_drawarea_x2 &&
-			(INT16)n_y.w.h <= (INT32)m_n_drawarea_y2 )
+		if( (INT16)n_x.w.h >= (INT32)p_prim->n_drawarea_x1 &&
+			(INT16)n_y.w.h >= (INT32)p_prim->n_drawarea_y1 &&
+			(INT16)n_x.w.h <= (INT32)p_prim->n_drawarea_x2 &&
+			(INT16)n_y.w.h <= (INT32)p_prim->n_drawarea_y2 )
 		{
 			p_vram = m_p_p_vram[ n_y.w.h ] + n_x.w.h;
 			WRITE_PIXEL(
@@ -2621,7 +2685,7 @@ static void FrameBufferRectangleDraw( void )
 	}
 }
 
-static void FlatRectangle( void )
+static void FlatRectangle( struct PSXPRIMITIVE *p_prim )
 {
 	INT16 n_y;
 	INT16 n_x;
@@ -2649,35 +2713,35 @@ static void FlatRectangle( void )
 	{
 		return;
 	}
-	DebugMesh( COORD_X( m_packet.FlatRectangle.n_coord ) + m_n_drawoffset_x, COORD_Y( m_packet.FlatRectangle.n_coord ) + m_n_drawoffset_y );
-	DebugMesh( COORD_X( m_packet.FlatRectangle.n_coord ) + m_n_drawoffset_x + SIZE_W( m_packet.FlatRectangle.n_size ), COORD_Y( m_packet.FlatRectangle.n_coord ) + m_n_drawoffset_y );
-	DebugMesh( COORD_X( m_packet.FlatRectangle.n_coord ) + m_n_drawoffset_x, COORD_Y( m_packet.FlatRectangle.n_coord ) + m_n_drawoffset_y + SIZE_H( m_packet.FlatRectangle.n_size ) );
-	DebugMesh( COORD_X( m_packet.FlatRectangle.n_coord ) + m_n_drawoffset_x + SIZE_W( m_packet.FlatRectangle.n_size ), COORD_Y( m_packet.FlatRectangle.n_coord ) + m_n_drawoffset_y + SIZE_H( m_packet.FlatRectangle.n_size ) );
+	DebugMesh( COORD_X( p_prim->packet.FlatRectangle.n_coord ) + p_prim->n_drawoffset_x, COORD_Y( p_prim->packet.FlatRectangle.n_coord ) + p_prim->n_drawoffset_y );
+	DebugMesh( COORD_X( p_prim->packet.FlatRectangle.n_coord ) + p_prim->n_drawoffset_x + SIZE_W( p_prim->packet.FlatRectangle.n_size ), COORD_Y( p_prim->packet.FlatRectangle.n_coord ) + p_prim->n_drawoffset_y );
+	DebugMesh( COORD_X( p_prim->packet.FlatRectangle.n_coord ) + p_prim->n_drawoffset_x, COORD_Y( p_prim->packet.FlatRectangle.n_coord ) + p_prim->n_drawoffset_y + SIZE_H( p_prim->packet.FlatRectangle.n_size ) );
+	DebugMesh( COORD_X( p_prim->packet.FlatRectangle.n_coord ) + p_prim->n_drawoffset_x + SIZE_W( p_prim->packet.FlatRectangle.n_size ), COORD_Y( p_prim->packet.FlatRectangle.n_coord ) + p_prim->n_drawoffset_y + SIZE_H( p_prim->packet.FlatRectangle.n_size ) );
 	DebugMeshEnd();
 #endif
 
-	n_cmd = BGR_C( m_packet.FlatRectangle.n_bgr );
+	n_cmd = BGR_C( p_prim->packet.FlatRectangle.n_bgr );
 
 	SOLIDSETUP
 
-	n_r.w.h = BGR_R( m_packet.FlatRectangle.n_bgr ); n_r.w.l = 0;
-	n_g.w.h = BGR_G( m_packet.FlatRectangle.n_bgr ); n_g.w.l = 0;
-	n_b.w.h = BGR_B( m_packet.FlatRectangle.n_bgr ); n_b.w.l = 0;
+	n_r.w.h = BGR_R( p_prim->packet.FlatRectangle.n_bgr ); n_r.w.l = 0;
+	n_g.w.h = BGR_G( p_prim->packet.FlatRectangle.n_bgr ); n_g.w.l = 0;
+	n_b.w.h = BGR_B( p_prim->packet.FlatRectangle.n_bgr ); n_b.w.l = 0;
 
-	n_y = COORD_Y( m_packet.FlatRectangle.n_coord ) + m_n_drawoffset_y;
-	n_h = SIZE_H( m_packet.FlatRectangle.n_size );
+	n_y = COORD_Y( p_prim->packet.FlatRectangle.n_coord ) + p_prim->n_drawoffset_y;
+	n_h = SIZE_H( p_prim->packet.FlatRectangle.n_size );
 
 	while( n_h > 0 )
 	{
-		n_x = COORD_X( m_packet.FlatRectangle.n_coord ) + m_n_drawoffset_x;
+		n_x = COORD_X( p_prim->packet.FlatRectangle.n_coord ) + p_prim->n_drawoffset_x;
 
-		n_distance = SIZE_W( m_packet.FlatRectangle.n_size );
-		if( n_distance > 0 && n_y >= (INT32)m_n_drawarea_y1 && n_y <= (INT32)m_n_drawarea_y2 )
+		n_distance = SIZE_W( p_prim->packet.FlatRectangle.n_size );
+		if( n_distance > 0 && n_y >= (INT32)p_prim->n_drawarea_y1 && n_y <= (INT32)p_prim->n_drawarea_y2 )
 		{
-			if( ( (INT32)m_n_drawarea_x1 - n_x ) > 0 )
+			if( ( (INT32)p_prim->n_drawarea_x1 - n_x ) > 0 )
 			{
-				n_distance -= ( m_n_drawarea_x1 - n_x );
-				n_x = m_n_drawarea_x1;
+				n_distance -= ( p_prim->n_drawarea_x1 - n_x );
+				n_x = p_prim->n_drawarea_x1;
 			}
 			SOLIDFILL( FLATRECTANGEUPDATE )
 		}
@@ -2686,7 +2750,7 @@ static void FlatRectangle( void )
 	}
 }
 
-static void FlatRectangle8x8( void )
+static void FlatRectangle8x8( struct PSXPRIMITIVE *p_prim )
 {
 	INT16 n_y;
 	INT16 n_x;
@@ -2714,35 +2778,35 @@ static void FlatRectangle8x8( void )
 	{
 		return;
 	}
-	DebugMesh( COORD_X( m_packet.FlatRectangle8x8.n_coord ) + m_n_drawoffset_x, COORD_Y( m_packet.FlatRectangle8x8.n_coord ) + m_n_drawoffset_y );
-	DebugMesh( COORD_X( m_packet.FlatRectangle8x8.n_coord ) + m_n_drawoffset_x + 8, COORD_Y( m_packet.FlatRectangle8x8.n_coord ) + m_n_drawoffset_y );
-	DebugMesh( COORD_X( m_packet.FlatRectangle8x8.n_coord ) + m_n_drawoffset_x, COORD_Y( m_packet.FlatRectangle8x8.n_coord ) + m_n_drawoffset_y + 8 );
-	DebugMesh( COORD_X( m_packet.FlatRectangle8x8.n_coord ) + m_n_drawoffset_x + 8, COORD_Y( m_packet.FlatRectangle8x8.n_coord ) + m_n_drawoffset_y + 8 );
+	DebugMesh( COORD_X( p_prim->packet.FlatRectangle8x8.n_coord ) + p_prim->n_drawoffset_x, COORD_Y( p_prim->packet.FlatRectangle8x8.n_coord ) + p_prim->n_drawoffset_y );
+	DebugMesh( COORD_X( p_prim->packet.FlatRectangle8x8.n_coord ) + p_prim->n_drawoffset_x + 8, COORD_Y( p_prim->packet.FlatRectangle8x8.n_coord ) + p_prim->n_drawoffset_y );
+	DebugMesh( COORD_X( p_prim->packet.FlatRectangle8x8.n_coord ) + p_prim->n_drawoffset_x, COORD_Y( p_prim->packet.FlatRectangle8x8.n_coord ) + p_prim->n_drawoffset_y + 8 );
+	DebugMesh( COORD_X( p_prim->packet.FlatRectangle8x8.n_coord ) + p_prim->n_drawoffset_x + 8, COORD_Y( p_prim->packet.FlatRectangle8x8.n_coord ) + p_prim->n_drawoffset_y + 8 );
 	DebugMeshEnd();
 #endif
 
-	n_cmd = BGR_C( m_packet.FlatRectangle8x8.n_bgr );
+	n_cmd = BGR_C( p_prim->packet.FlatRectangle8x8.n_bgr );
 
 	SOLIDSETUP
 
-	n_r.w.h = BGR_R( m_packet.FlatRectangle8x8.n_bgr ); n_r.w.l = 0;
-	n_g.w.h = BGR_G( m_packet.FlatRectangle8x8.n_bgr ); n_g.w.l = 0;
-	n_b.w.h = BGR_B( m_packet.FlatRectangle8x8.n_bgr ); n_b.w.l = 0;
+	n_r.w.h = BGR_R( p_prim->packet.FlatRectangle8x8.n_bgr ); n_r.w.l = 0;
+	n_g.w.h = BGR_G( p_prim->packet.FlatRectangle8x8.n_bgr ); n_g.w.l = 0;
+	n_b.w.h = BGR_B( p_prim->packet.FlatRectangle8x8.n_bgr ); n_b.w.l = 0;
 
-	n_y = COORD_Y( m_packet.FlatRectangle8x8.n_coord ) + m_n_drawoffset_y;
+	n_y = COORD_Y( p_prim->packet.FlatRectangle8x8.n_coord ) + p_prim->n_drawoffset_y;
 	n_h = 8;
 
 	while( n_h > 0 )
 	{
-		n_x = COORD_X( m_packet.FlatRectangle8x8.n_coord ) + m_n_drawoffset_x;
+		n_x = COORD_X( p_prim->packet.FlatRectangle8x8.n_coord ) + p_prim->n_drawoffset_x;
 
 		n_distance = 8;
-		if( n_distance > 0 && n_y >= (INT32)m_n_drawarea_y1 && n_y <= (INT32)m_n_drawarea_y2 )
+		if( n_distance > 0 && n_y >= (INT32)p_prim->n_drawarea_y1 && n_y <= (INT32)p_prim->n_drawarea_y2 )
 		{
-			if( ( (INT32)m_n_drawarea_x1 - n_x ) > 0 )
+			if( ( (INT32)p_prim->n_drawarea_x1 - n_x ) > 0 )
 			{
-				n_distance -= ( m_n_drawarea_x1 - n_x );
-				n_x = m_n_drawarea_x1;
+				n_distance -= ( p_prim->n_drawarea_x1 - n_x );
+				n_x = p_prim->n_drawarea_x1;
 			}
 			SOLIDFILL( FLATRECTANGEUPDATE )
 		}
@@ -2751,7 +2815,7 @@ static void FlatRectangle8x8( void )
 	}
 }
 
-static void FlatRectangle16x16( void )
+static void FlatRectangle16x16( struct PSXPRIMITIVE *p_prim )
 {
 	INT16 n_y;
 	INT16 n_x;
@@ -2779,35 +2843,35 @@ static void FlatRectangle16x16( void )
 	{
 		return;
 	}
-	DebugMesh( COORD_X( m_packet.FlatRectangle16x16.n_coord ) + m_n_drawoffset_x, COORD_Y( m_packet.FlatRectangle16x16.n_coord ) + m_n_drawoffset_y );
-	DebugMesh( COORD_X( m_packet.FlatRectangle16x16.n_coord ) + m_n_drawoffset_x + 16, COORD_Y( m_packet.FlatRectangle16x16.n_coord ) + m_n_drawoffset_y );
-	DebugMesh( COORD_X( m_packet.FlatRectangle16x16.n_coord ) + m_n_drawoffset_x, COORD_Y( m_packet.FlatRectangle16x16.n_coord ) + m_n_drawoffset_y + 16 );
-	DebugMesh( COORD_X( m_packet.FlatRectangle16x16.n_coord ) + m_n_drawoffset_x + 16, COORD_Y( m_packet.FlatRectangle16x16.n_coord ) + m_n_drawoffset_y + 16 );
+	DebugMesh( COORD_X( p_prim->packet.FlatRectangle16x16.n_coord ) + p_prim->n_drawoffset_x, COORD_Y( p_prim->packet.FlatRectangle16x16.n_coord ) + p_prim->n_drawoffset_y );
+	DebugMesh( COORD_X( p_prim->packet.FlatRectangle16x16.n_coord ) + p_prim->n_drawoffset_x + 16, COORD_Y( p_prim->packet.FlatRectangle16x16.n_coord ) + p_prim->n_drawoffset_y );
+	DebugMesh( COORD_X( p_prim->packet.FlatRectangle16x16.n_coord ) + p_prim->n_drawoffset_x, COORD_Y( p_prim->packet.FlatRectangle16x16.n_coord ) + p_prim->n_drawoffset_y + 16 );
+	DebugMesh( COORD_X( p_prim->packet.FlatRectangle16x16.n_coord ) + p_prim->n_drawoffset_x + 16, COORD_Y( p_prim->packet.FlatRectangle16x16.n_coord ) + p_prim->n_drawoffset_y + 16 );
 	DebugMeshEnd();
 #endif
 
-	n_cmd = BGR_C( m_packet.FlatRectangle16x16.n_bgr );
+	n_cmd = BGR_C( p_prim->packet.FlatRectangle16x16.n_bgr );
 
 	SOLIDSETUP
 
-	n_r.w.h = BGR_R( m_packet.FlatRectangle16x16.n_bgr ); n_r.w.l = 0;
-	n_g.w.h = BGR_G( m_packet.FlatRectangle16x16.n_bgr ); n_g.w.l = 0;
-	n_b.w.h = BGR_B( m_packet.FlatRectangle16x16.n_bgr ); n_b.w.l = 0;
+	n_r.w.h = BGR_R( p_prim->packet.FlatRectangle16x16.n_bgr ); n_r.w.l = 0;
+	n_g.w.h = BGR_G( p_prim->packet.FlatRectangle16x16.n_bgr ); n_g.w.l = 0;
+	n_b.w.h = BGR_B( p_prim->packet.FlatRectangle16x16.n_bgr ); n_b.w.l = 0;
 
-	n_y = COORD_Y( m_packet.FlatRectangle16x16.n_coord ) + m_n_drawoffset_y;
+	n_y = COORD_Y( p_prim->packet.FlatRectangle16x16.n_coord ) + p_prim->n_drawoffset_y;
 	n_h = 16;
 
 	while( n_h > 0 )
 	{
-		n_x = COORD_X( m_packet.FlatRectangle16x16.n_coord ) + m_n_drawoffset_x;
+		n_x = COORD_X( p_prim->packet.FlatRectangle16x16.n_coord ) + p_prim->n_drawoffset_x;
 
 		n_distance = 16;
-		if( n_distance > 0 && n_y >= (INT32)m_n_drawarea_y1 && n_y <= (INT32)m_n_drawarea_y2 )
+		if( n_distance > 0 && n_y >= (INT32)p_prim->n_drawarea_y1 && n_y <= (INT32)p_prim->n_drawarea_y2 )
 		{
-			if( ( (INT32)m_n_drawarea_x1 - n_x ) > 0 )
+			if( ( (INT32)p_prim->n_drawarea_x1 - n_x ) > 0 )
 			{
-				n_distance -= ( m_n_drawarea_x1 - n_x );
-				n_x = m_n_drawarea_x1;
+				n_distance -= ( p_prim->n_drawarea_x1 - n_x );
+				n_x = p_prim->n_drawarea_x1;
 			}
 			SOLIDFILL( FLATRECTANGEUPDATE )
 		}
@@ -2816,7 +2880,7 @@ static void FlatRectangle16x16( void )
 	}
 }
 
-static void FlatTexturedRectangle( void )
+static void FlatTexturedRectangle( struct PSXPRIMITIVE *p_prim )
 {
 	INT16 n_y;
 	INT16 n_x;
@@ -2855,17 +2919,17 @@ static void FlatTexturedRectangle( void )
 	{
 		return;
 	}
-	DebugMesh( COORD_X( m_packet.FlatTexturedRectangle.n_coord ) + m_n_drawoffset_x, COORD_Y( m_packet.FlatTexturedRectangle.n_coord ) + m_n_drawoffset_y );
-	DebugMesh( COORD_X( m_packet.FlatTexturedRectangle.n_coord ) + m_n_drawoffset_x + SIZE_W( m_packet.FlatTexturedRectangle.n_size ), COORD_Y( m_packet.FlatTexturedRectangle.n_coord ) + m_n_drawoffset_y );
-	DebugMesh( COORD_X( m_packet.FlatTexturedRectangle.n_coord ) + m_n_drawoffset_x, COORD_Y( m_packet.FlatTexturedRectangle.n_coord ) + m_n_drawoffset_y + SIZE_H( m_packet.FlatTexturedRectangle.n_size ) );
-	DebugMesh( COORD_X( m_packet.FlatTexturedRectangle.n_coord ) + m_n_drawoffset_x + SIZE_W( m_packet.FlatTexturedRectangle.n_size ), COORD_Y( m_packet.FlatTexturedRectangle.n_coord ) + m_n_drawoffset_y + SIZE_H( m_packet.FlatTexturedRectangle.n_size ) );
+	DebugMesh( COORD_X( p_prim->packet.FlatTexturedRectangle.n_coord ) + p_prim->n_drawoffset_x, COORD_Y( p_prim->packet.FlatTexturedRectangle.n_coord ) + p_prim->n_drawoffset_y );
+	DebugMesh( COORD_X( p_prim->packet.FlatTexturedRectangle.n_coord ) + p_prim->n_drawoffset_x + SIZE_W( p_prim->packet.FlatTexturedRectangle.n_size ), COORD_Y( p_prim->packet.FlatTexturedRectangle.n_coord ) + p_prim->n_drawoffset_y );
+	DebugMesh( COORD_X( p_prim->packet.FlatTexturedRectangle.n_coord ) + p_prim->n_drawoffset_x, COORD_Y( p_prim->packet.FlatTexturedRectangle.n_coord ) + p_prim->n_drawoffset_y + SIZE_H( p_prim->packet.FlatTexturedRectangle.n_size ) );
+	DebugMesh( COORD_X( p_prim->packet.FlatTexturedRectangle.n_coord ) + p_prim->n_drawoffset_x + SIZE_W( p_prim->packet.FlatTexturedRectangle.n_size ), COORD_Y( p_prim->packet.FlatTexturedRectangle.n_coord ) + p_prim->n_drawoffset_y + SIZE_H( p_prim->packet.FlatTexturedRectangle.n_size ) );
 	DebugMeshEnd();
 #endif
 
-	n_cmd = BGR_C( m_packet.FlatTexturedRectangle.n_bgr );
+	n_cmd = BGR_C( p_prim->packet.FlatTexturedRectangle.n_bgr );
 
-	n_clutx = ( m_packet.FlatTexturedRectangle.n_texture.w.h & 0x3f ) << 4;
-	n_cluty = ( m_packet.FlatTexturedRectangle.n_texture.w.h >> 6 ) & 0x3ff;
+	n_clutx = ( p_prim->packet.FlatTexturedRectangle.n_texture.w.h & 0x3f ) << 4;
+	n_cluty = ( p_prim->packet.FlatTexturedRectangle.n_texture.w.h >> 6 ) & 0x3ff;
 
 	n_r.d = 0;
 	n_g.d = 0;
@@ -2877,9 +2941,9 @@ static void FlatTexturedRectangle( void )
 	switch( n_cmd & 0x01 )
 	{
 	case 0:
-		n_r.w.h = BGR_R( m_packet.FlatTexturedRectangle.n_bgr ); n_r.w.l = 0;
-		n_g.w.h = BGR_G( m_packet.FlatTexturedRectangle.n_bgr ); n_g.w.l = 0;
-		n_b.w.h = BGR_B( m_packet.FlatTexturedRectangle.n_bgr ); n_b.w.l = 0;
+		n_r.w.h = BGR_R( p_prim->packet.FlatTexturedRectangle.n_bgr ); n_r.w.l = 0;
+		n_g.w.h = BGR_G( p_prim->packet.FlatTexturedRectangle.n_bgr ); n_g.w.l = 0;
+		n_b.w.h = BGR_B( p_prim->packet.FlatTexturedRectangle.n_bgr ); n_b.w.l = 0;
 		break;
 	case 1:
 		n_r.w.h = 0x80; n_r.w.l = 0;
@@ -2888,23 +2952,23 @@ static void FlatTexturedRectangle( void )
 		break;
 	}
 
-	n_v = TEXTURE_V( m_packet.FlatTexturedRectangle.n_texture );
-	n_y = COORD_Y( m_packet.FlatTexturedRectangle.n_coord ) + m_n_drawoffset_y;
-	n_h = SIZE_H( m_packet.FlatTexturedRectangle.n_size );
+	n_v = TEXTURE_V( p_prim->packet.FlatTexturedRectangle.n_texture );
+	n_y = COORD_Y( p_prim->packet.FlatTexturedRectangle.n_coord ) + p_prim->n_drawoffset_y;
+	n_h = SIZE_H( p_prim->packet.FlatTexturedRectangle.n_size );
 
 	while( n_h > 0 )
 	{
-		n_x = COORD_X( m_packet.FlatTexturedRectangle.n_coord ) + m_n_drawoffset_x;
-		n_u = TEXTURE_U( m_packet.FlatTexturedRectangle.n_texture );
+		n_x = COORD_X( p_prim->packet.FlatTexturedRectangle.n_coord ) + p_prim->n_drawoffset_x;
+		n_u = TEXTURE_U( p_prim->packet.FlatTexturedRectangle.n_texture );
 
-		n_distance = SIZE_W( m_packet.FlatTexturedRectangle.n_size );
-		if( n_distance > 0 && n_y >= (INT32)m_n_drawarea_y1 && n_y <= (INT32)m_n_drawarea_y2 )
+		n_distance = SIZE_W( p_prim->packet.FlatTexturedRectangle.n_size );
+		if( n_distance > 0 && n_y >= (INT32)p_prim->n_drawarea_y1 && n_y <= (INT32)p_prim->n_drawarea_y2 )
 		{
-			if( ( (INT32)m_n_drawarea_x1 - n_x ) > 0 )
+			if( ( (INT32)p_prim->n_drawarea_x1 - n_x ) > 0 )
 			{
-				n_u += ( m_n_drawarea_x1 - n_x ) * n_du;
-				n_distance -= ( m_n_drawarea_x1 - n_x );
-				n_x = m_n_drawarea_x1;
+				n_u += ( p_prim->n_drawarea_x1 - n_x ) * n_du;
+				n_distance -= ( p_prim->n_drawarea_x1 - n_x );
+				n_x = p_prim->n_drawarea_x1;
 			}
 			TEXTUREFILL( FLATTEXTUREDRECTANGLEUPDATE, n_u, n_v );
 		}
@@ -2914,7 +2978,7 @@ static void FlatTexturedRectangle( void )
 	}
 }
 
-static void Sprite8x8( void )
+static void Sprite8x8( struct PSXPRIMITIVE *p_prim )
 {
 	INT16 n_y;
 	INT16 n_x;
@@ -2953,17 +3017,17 @@ static void Sprite8x8( void )
 	{
 		return;
 	}
-	DebugMesh( COORD_X( m_packet.Sprite8x8.n_coord ) + m_n_drawoffset_x, COORD_Y( m_packet.Sprite8x8.n_coord ) + m_n_drawoffset_y );
-	DebugMesh( COORD_X( m_packet.Sprite8x8.n_coord ) + m_n_drawoffset_x + 7, COORD_Y( m_packet.Sprite8x8.n_coord ) + m_n_drawoffset_y );
-	DebugMesh( COORD_X( m_packet.Sprite8x8.n_coord ) + m_n_drawoffset_x, COORD_Y( m_packet.Sprite8x8.n_coord ) + m_n_drawoffset_y + 7 );
-	DebugMesh( COORD_X( m_packet.Sprite8x8.n_coord ) + m_n_drawoffset_x + 7, COORD_Y( m_packet.Sprite8x8.n_coord ) + m_n_drawoffset_y + 7 );
+	DebugMesh( COORD_X( p_prim->packet.Sprite8x8.n_coord ) + p_prim->n_drawoffset_x, COORD_Y( p_prim->packet.Sprite8x8.n_coord ) + p_prim->n_drawoffset_y );
+	DebugMesh( COORD_X( p_prim->packet.Sprite8x8.n_coord ) + p_prim->n_drawoffset_x + 7, COORD_Y( p_prim->packet.Sprite8x8.n_coord ) + p_prim->n_drawoffset_y );
+	DebugMesh( COORD_X( p_prim->packet.Sprite8x8.n_coord ) + p_prim->n_drawoffset_x, COORD_Y( p_prim->packet.Sprite8x8.n_coord ) + p_prim->n_drawoffset_y + 7 );
+	DebugMesh( COORD_X( p_prim->packet.Sprite8x8.n_coord ) + p_prim->n_drawoffset_x + 7, COORD_Y( p_prim->packet.Sprite8x8.n_coord ) + p_prim->n_drawoffset_y + 7 );
 	DebugMeshEnd();
 #endif
 
-	n_cmd = BGR_C( m_packet.Sprite8x8.n_bgr );
+	n_cmd = BGR_C( p_prim->packet.Sprite8x8.n_bgr );
 
-	n_clutx = ( m_packet.Sprite8x8.n_texture.w.h & 0x3f ) << 4;
-	n_cluty = ( m_packet.Sprite8x8.n_texture.w.h >> 6 ) & 0x3ff;
+	n_clutx = ( p_prim->packet.Sprite8x8.n_texture.w.h & 0x3f ) << 4;
+	n_cluty = ( p_prim->packet.Sprite8x8.n_texture.w.h >> 6 ) & 0x3ff;
 
 	n_r.d = 0;
 	n_g.d = 0;
@@ -2975,9 +3039,9 @@ static void Sprite8x8( void )
 	switch( n_cmd & 0x01 )
 	{
 	case 0:
-		n_r.w.h = BGR_R( m_packet.Sprite8x8.n_bgr ); n_r.w.l = 0;
-		n_g.w.h = BGR_G( m_packet.Sprite8x8.n_bgr ); n_g.w.l = 0;
-		n_b.w.h = BGR_B( m_packet.Sprite8x8.n_bgr ); n_b.w.l = 0;
+		n_r.w.h = BGR_R( p_prim->packet.Sprite8x8.n_bgr ); n_r.w.l = 0;
+		n_g.w.h = BGR_G( p_prim->packet.Sprite8x8.n_bgr ); n_g.w.l = 0;
+		n_b.w.h = BGR_B( p_prim->packet.Sprite8x8.n_bgr ); n_b.w.l = 0;
 		break;
 	case 1:
 		n_r.w.h = 0x80; n_r.w.l = 0;
@@ -2986,23 +3050,23 @@ static void Sprite8x8( void )
 		break;
 	}
 
-	n_v = TEXTURE_V( m_packet.Sprite8x8.n_texture );
-	n_y = COORD_Y( m_packet.Sprite8x8.n_coord ) + m_n_drawoffset_y;
+	n_v = TEXTURE_V( p_prim->packet.Sprite8x8.n_texture );
+	n_y = COORD_Y( p_prim->packet.Sprite8x8.n_coord ) + p_prim->n_drawoffset_y;
 	n_h = 8;
 
 	while( n_h > 0 )
 	{
-		n_x = COORD_X( m_packet.Sprite8x8.n_coord ) + m_n_drawoffset_x;
-		n_u = TEXTURE_U( m_packet.Sprite8x8.n_texture );
+		n_x = COORD_X( p_prim->packet.Sprite8x8.n_coord ) + p_prim->n_drawoffset_x;
+		n_u = TEXTURE_U( p_prim->packet.Sprite8x8.n_texture );
 
 		n_distance = 8;
-		if( n_distance > 0 && n_y >= (INT32)m_n_drawarea_y1 && n_y <= (INT32)m_n_drawarea_y2 )
+		if( n_distance > 0 && n_y >= (INT32)p_prim->n_drawarea_y1 && n_y <= (INT32)p_prim->n_drawarea_y2 )
 		{
-			if( ( (INT32)m_n_drawarea_x1 - n_x ) > 0 )
+			if( ( (INT32)p_prim->n_drawarea_x1 - n_x ) > 0 )
 			{
-				n_u += ( m_n_drawarea_x1 - n_x ) * n_du;
-				n_distance -= ( m_n_drawarea_x1 - n_x );
-				n_x = m_n_drawarea_x1;
+				n_u += ( p_prim->n_drawarea_x1 - n_x ) * n_du;
+				n_distance -= ( p_prim->n_drawarea_x1 - n_x );
+				n_x = p_prim->n_drawarea_x1;
 			}
 			TEXTUREFILL( FLATTEXTUREDRECTANGLEUPDATE, n_u, n_v );
 		}
@@ -3012,7 +3076,7 @@ static void Sprite8x8( void )
 	}
 }
 
-static void Sprite16x16( void )
+static void Sprite16x16( struct PSXPRIMITIVE *p_prim )
 {
 	INT16 n_y;
 	INT16 n_x;
@@ -3051,17 +3115,17 @@ static void Sprite16x16( void )
 	{
 		return;
 	}
-	DebugMesh( COORD_X( m_packet.Sprite16x16.n_coord ) + m_n_drawoffset_x, COORD_Y( m_packet.Sprite16x16.n_coord ) + m_n_drawoffset_y );
-	DebugMesh( COORD_X( m_packet.Sprite16x16.n_coord ) + m_n_drawoffset_x + 7, COORD_Y( m_packet.Sprite16x16.n_coord ) + m_n_drawoffset_y );
-	DebugMesh( COORD_X( m_packet.Sprite16x16.n_coord ) + m_n_drawoffset_x, COORD_Y( m_packet.Sprite16x16.n_coord ) + m_n_drawoffset_y + 7 );
-	DebugMesh( COORD_X( m_packet.Sprite16x16.n_coord ) + m_n_drawoffset_x + 7, COORD_Y( m_packet.Sprite16x16.n_coord ) + m_n_drawoffset_y + 7 );
+	DebugMesh( COORD_X( p_prim->packet.Sprite16x16.n_coord ) + p_prim->n_drawoffset_x, COORD_Y( p_prim->packet.Sprite16x16.n_coord ) + p_prim->n_drawoffset_y );
+	DebugMesh( COORD_X( p_prim->packet.Sprite16x16.n_coord ) + p_prim->n_drawoffset_x + 7, COORD_Y( p_prim->packet.Sprite16x16.n_coord ) + p_prim->n_drawoffset_y );
+	DebugMesh( COORD_X( p_prim->packet.Sprite16x16.n_coord ) + p_prim->n_drawoffset_x, COORD_Y( p_prim->packet.Sprite16x16.n_coord ) + p_prim->n_drawoffset_y + 7 );
+	DebugMesh( COORD_X( p_prim->packet.Sprite16x16.n_coord ) + p_prim->n_drawoffset_x + 7, COORD_Y( p_prim->packet.Sprite16x16.n_coord ) + p_prim->n_drawoffset_y + 7 );
 	DebugMeshEnd();
 #endif
 
-	n_cmd = BGR_C( m_packet.Sprite16x16.n_bgr );
+	n_cmd = BGR_C( p_prim->packet.Sprite16x16.n_bgr );
 
-	n_clutx = ( m_packet.Sprite16x16.n_texture.w.h & 0x3f ) << 4;
-	n_cluty = ( m_packet.Sprite16x16.n_texture.w.h >> 6 ) & 0x3ff;
+	n_clutx = ( p_prim->packet.Sprite16x16.n_texture.w.h & 0x3f ) << 4;
+	n_cluty = ( p_prim->packet.Sprite16x16.n_texture.w.h >> 6 ) & 0x3ff;
 
 	n_r.d = 0;
 	n_g.d = 0;
@@ -3073,9 +3137,9 @@ static void Sprite16x16( void )
 	switch( n_cmd & 0x01 )
 	{
 	case 0:
-		n_r.w.h = BGR_R( m_packet.Sprite16x16.n_bgr ); n_r.w.l = 0;
-		n_g.w.h = BGR_G( m_packet.Sprite16x16.n_bgr ); n_g.w.l = 0;
-		n_b.w.h = BGR_B( m_packet.Sprite16x16.n_bgr ); n_b.w.l = 0;
+		n_r.w.h = BGR_R( p_prim->packet.Sprite16x16.n_bgr ); n_r.w.l = 0;
+		n_g.w.h = BGR_G( p_prim->packet.Sprite16x16.n_bgr ); n_g.w.l = 0;
+		n_b.w.h = BGR_B( p_prim->packet.Sprite16x16.n_bgr ); n_b.w.l = 0;
 		break;
 	case 1:
 		n_r.w.h = 0x80; n_r.w.l = 0;
@@ -3084,23 +3148,23 @@ static void Sprite16x16( void )
 		break;
 	}
 
-	n_v = TEXTURE_V( m_packet.Sprite16x16.n_texture );
-	n_y = COORD_Y( m_packet.Sprite16x16.n_coord ) + m_n_drawoffset_y;
+	n_v = TEXTURE_V( p_prim->packet.Sprite16x16.n_texture );
+	n_y = COORD_Y( p_prim->packet.Sprite16x16.n_coord ) + p_prim->n_drawoffset_y;
 	n_h = 16;
 
 	while( n_h > 0 )
 	{
-		n_x = COORD_X( m_packet.Sprite16x16.n_coord ) + m_n_drawoffset_x;
-		n_u = TEXTURE_U( m_packet.Sprite16x16.n_texture );
+		n_x = COORD_X( p_prim->packet.Sprite16x16.n_coord ) + p_prim->n_drawoffset_x;
+		n_u = TEXTURE_U( p_prim->packet.Sprite16x16.n_texture );
 
 		n_distance = 16;
-		if( n_distance > 0 && n_y >= (INT32)m_n_drawarea_y1 && n_y <= (INT32)m_n_drawarea_y2 )
+		if( n_distance > 0 && n_y >= (INT32)p_prim->n_drawarea_y1 && n_y <= (INT32)p_prim->n_drawarea_y2 )
 		{
-			if( ( (INT32)m_n_drawarea_x1 - n_x ) > 0 )
+			if( ( (INT32)p_prim->n_drawarea_x1 - n_x ) > 0 )
 			{
-				n_u += ( m_n_drawarea_x1 - n_x ) * n_du;
-				n_distance -= ( m_n_drawarea_x1 - n_x );
-				n_x = m_n_drawarea_x1;
+				n_u += ( p_prim->n_drawarea_x1 - n_x ) * n_du;
+				n_distance -= ( p_prim->n_drawarea_x1 - n_x );
+				n_x = p_prim->n_drawarea_x1;
 			}
 			TEXTUREFILL( FLATTEXTUREDRECTANGLEUPDATE, n_u, n_v );
 		}
@@ -3110,7 +3174,7 @@ static void Sprite16x16( void )
 	}
 }
 
-static void Dot( void )
+static void Dot( struct PSXPRIMITIVE *p_prim )
 {
 	INT32 n_x;
 	INT32 n_y;
@@ -3124,20 +3188,20 @@ static void Dot( void )
 	{
 		return;
 	}
-	DebugMesh( COORD_X( m_packet.Dot.vertex.n_coord ) + m_n_drawoffset_x, COORD_Y( m_packet.Dot.vertex.n_coord ) + m_n_drawoffset_y );
+	DebugMesh( COORD_X( p_prim->packet.Dot.vertex.n_coord ) + p_prim->n_drawoffset_x, COORD_Y( p_prim->packet.Dot.vertex.n_coord ) + p_prim->n_drawoffset_y );
 	DebugMeshEnd();
 #endif
 
-	n_r = BGR_R( m_packet.Dot.n_bgr );
-	n_g = BGR_G( m_packet.Dot.n_bgr );
-	n_b = BGR_B( m_packet.Dot.n_bgr );
-	n_x = COORD_X( m_packet.Dot.vertex.n_coord ) + m_n_drawoffset_x;
-	n_y = COORD_Y( m_packet.Dot.vertex.n_coord ) + m_n_drawoffset_y;
+	n_r = BGR_R( p_prim->packet.Dot.n_bgr );
+	n_g = BGR_G( p_prim->packet.Dot.n_bgr );
+	n_b = BGR_B( p_prim->packet.Dot.n_bgr );
+	n_x = COORD_X( p_prim->packet.Dot.vertex.n_coord ) + p_prim->n_drawoffset_x;
+	n_y = COORD_Y( p_prim->packet.Dot.vertex.n_coord ) + p_prim->n_drawoffset_y;
 
-	if( (INT16)n_x >= (INT32)m_n_drawarea_x1 &&
-		(INT16)n_y >= (INT32)m_n_drawarea_y1 &&
-		(INT16)n_x <= (INT32)m_n_drawarea_x2 &&
-		(INT16)n_y <= (INT32)m_n_drawarea_y2 )
+	if( (INT16)n_x >= (INT32)p_prim->n_drawarea_x1 &&
+		(INT16)n_y >= (INT32)p_prim->n_drawarea_y1 &&
+		(INT16)n_x <= (INT32)p_prim->n_drawarea_x2 &&
+		(INT16)n_y <= (INT32)p_prim->n_drawarea_y2 )
 	{
 		p_vram = m_p_p_vram[ n_y ] + n_x;
 		WRITE_PIXEL(
@@ -3192,6 +3256,160 @@ static void MoveImage( void )
 	}
 }
 
+static void *psx_band_callback( void *param )
+{
+	struct PSXBAND *p_band = param;
+	struct PSXPRIMITIVE prim;
+	int n_prim;
+
+	for( n_prim = 0; n_prim < m_n_primitives; n_prim++ )
+	{
+		const struct PSXPRIMITIVE *p_prim = &m_p_primitive[ n_prim ];
+
+		if( p_prim->n_drawarea_y1 > p_band->n_y2 || p_prim->n_drawarea_y2 < p_band->n_y1 )
+		{
+			continue;
+		}
+
+		/* every row is already clipped against the drawing area, so narrow it to the band */
+		prim = *( p_prim );
+		prim.n_drawarea_y1 = MAX( prim.n_drawarea_y1, p_band->n_y1 );
+		prim.n_drawarea_y2 = MIN( prim.n_drawarea_y2, p_band->n_y2 );
+		prim.draw( &prim );
+	}
+	return NULL;
+}
+
+static void psx_gpu_flush( void )
+{
+	osd_work_item *p_item[ MAX_BANDS ];
+	UINT32 n_height;
+	int n_bands;
+	int n_band;
+
+	if( m_n_primitives == 0 )
+	{
+		return;
+	}
+
+	/* rows past the end of vram wrap around, only split the queue when they can't */
+	n_bands = 1;
+	if( m_p_work_queue != NULL && m_n_queue_y2 < m_n_vram_height )
+	{
+		n_bands = ( m_n_queue_y2 - m_n_queue_y1 + 1 ) / MIN_BAND_HEIGHT;
+		n_bands = MAX( 1, MIN( n_bands, MAX_BANDS ) );
+	}
+#if defined( MAME_DEBUG )
+	/* the mesh viewer isn't thread safe */
+	n_bands = 1;
+#endif
+	n_height = ( m_n_queue_y2 - m_n_queue_y1 + n_bands ) / n_bands;
+
+	for( n_band = 0; n_band < n_bands; n_band++ )
+	{
+		m_p_band[ n_band ].n_y1 = m_n_queue_y1 + ( n_band * n_height );
+		m_p_band[ n_band ].n_y2 = MIN( m_p_band[ n_band ].n_y1 + n_height - 1, m_n_queue_y2 );
+
+		/* the first band is drawn here, as is any band that can't be queued */
+		p_item[ n_band ] = NULL;
+		if( n_band != 0 )
+		{
+			p_item[ n_band ] = osd_work_item_queue( m_p_work_queue, psx_band_callback, &m_p_band[ n_band ] );
+			if( p_item[ n_band ] == NULL )
+			{
+				psx_band_callback( &m_p_band[ n_band ] );
+			}
+		}
+	}
+	psx_band_callback( &m_p_band[ 0 ] );
+
+	for( n_band = 0; n_band < n_bands; n_band++ )
+	{
+		if( p_item[ n_band ] != NULL )
+		{
+			while( !osd_work_item_wait( p_item[ n_band ], osd_ticks_per_second() ) ) ;
+			osd_work_item_release( p_item[ n_band ] );
+		}
+	}
+
+	m_n_primitives = 0;
+}
+
+static void psx_gpu_queue( void (*draw)( struct PSXPRIMITIVE *p_prim ), int n_points )
+{
+	struct PSXPRIMITIVE *p_prim;
+
+	if( m_n_primitives == MAX_PRIMITIVES )
+	{
+		psx_gpu_flush();
+	}
+
+	if( m_n_primitives == 0 )
+	{
+		m_n_queue_x1 = m_n_drawarea_x1;
+		m_n_queue_y1 = m_n_drawarea_y1;
+		m_n_queue_x2 = m_n_drawarea_x2;
+		m_n_queue_y2 = m_n_drawarea_y2;
+	}
+	else
+	{
+		m_n_queue_x1 = MIN( m_n_queue_x1, m_n_drawarea_x1 );
+		m_n_queue_y1 = MIN( m_n_queue_y1, m_n_drawarea_y1 );
+		m_n_queue_x2 = MAX( m_n_queue_x2, m_n_drawarea_x2 );
+		m_n_queue_y2 = MAX( m_n_queue_y2, m_n_drawarea_y2 );
+	}
+
+	p_prim = &m_p_primitive[ m_n_primitives++ ];
+	p_prim->draw = draw;
+	p_prim->n_points = n_points;
+	p_prim->packet = m_packet;
+	p_prim->gpu = psxgpu;
+	p_prim->n_twy = m_n_twy;
+	p_prim->n_twx = m_n_twx;
+	p_prim->n_twh = m_n_twh;
+	p_prim->n_tww = m_n_tww;
+	p_prim->n_drawarea_x1 = m_n_drawarea_x1;
+	p_prim->n_drawarea_y1 = m_n_drawarea_y1;
+	p_prim->n_drawarea_x2 = m_n_drawarea_x2;
+	p_prim->n_drawarea_y2 = m_n_drawarea_y2;
+	p_prim->n_drawoffset_x = m_n_drawoffset_x;
+	p_prim->n_drawoffset_y = m_n_drawoffset_y;
+}
+
+static int psx_gpu_queue_overlaps( UINT32 n_x1, UINT32 n_y1, UINT32 n_x2, UINT32 n_y2 )
+{
+	if( n_x1 > m_n_queue_x2 || n_x2 < m_n_queue_x1 )
+	{
+		return 0;
+	}
+	if( n_y2 >= m_n_vram_height || m_n_queue_y2 >= m_n_vram_height )
+	{
+		/* either side wraps around */
+		return 1;
+	}
+	return n_y1 <= m_n_queue_y2 && n_y2 >= m_n_queue_y1;
+}
+
+static void psx_gpu_queue_textured( void (*draw)( struct PSXPRIMITIVE *p_prim ), int n_points, UINT32 n_texture )
+{
+	UINT32 n_clutx;
+	UINT32 n_cluty;
+
+	/* textures and palettes have to be read after anything queued has been drawn over them */
+	if( m_n_primitives != 0 )
+	{
+		n_clutx = ( n_texture & 0x3f ) << 4;
+		n_cluty = ( n_texture >> 6 ) & 0x3ff;
+
+		if( psx_gpu_queue_overlaps( psxgpu.n_tx, psxgpu.n_ty, psxgpu.n_tx + m_n_twx + 255, psxgpu.n_ty + m_n_twy + 255 ) ||
+			psx_gpu_queue_overlaps( n_clutx, n_cluty, n_clutx + 255, n_cluty ) )
+		{
+			psx_gpu_flush();
+		}
+	}
+	psx_gpu_queue( draw, n_points );
+}
+
 void psx_gpu_write( UINT32 *p_ram, INT32 n_size )
 {
 	while( n_size > 0 )
@@ -3217,6 +3435,7 @@ void psx_gpu_write( UINT32 *p_ram, INT32 n_size )
 			{
 				verboselog( 1, "%02x: frame buffer rectangle %u,%u %u,%u\n", m_packet.n_entry[ 0 ] >> 24,
 					m_packet.n_entry[ 1 ] & 0xffff, m_packet.n_entry[ 1 ] >> 16, m_packet.n_entry[ 2 ] & 0xffff, m_packet.n_entry[ 2 ] >> 16 );
+				psx_gpu_flush();
 				FrameBufferRectangleDraw();
 				m_n_gpu_buffer_offset = 0;
 			}
@@ -3232,7 +3451,7 @@ void psx_gpu_write( UINT32 *p_ram, INT32 n_size )
 			else
 			{
 				verboselog( 1, "%02x: monochrome 3 point polygon\n", m_packet.n_entry[ 0 ] >> 24 );
-				FlatPolygon( 3 );
+				psx_gpu_queue( FlatPolygon, 3 );
 				m_n_gpu_buffer_offset = 0;
 			}
 			break;
@@ -3247,7 +3466,8 @@ void psx_gpu_write( UINT32 *p_ram, INT32 n_size )
 			else
 			{
 				verboselog( 1, "%02x: textured 3 point polygon\n", m_packet.n_entry[ 0 ] >> 24 );
-				FlatTexturedPolygon( 3 );
+				decode_tpage( &psxgpu, m_packet.FlatTexturedPolygon.vertex[ 1 ].n_texture.w.h );
+				psx_gpu_queue_textured( FlatTexturedPolygon, 3, m_packet.FlatTexturedPolygon.vertex[ 0 ].n_texture.w.h );
 				m_n_gpu_buffer_offset = 0;
 			}
 			break;
@@ -3262,7 +3482,7 @@ void psx_gpu_write( UINT32 *p_ram, INT32 n_size )
 			else
 			{
 				verboselog( 1, "%02x: monochrome 4 point polygon\n", m_packet.n_entry[ 0 ] >> 24 );
-				FlatPolygon( 4 );
+				psx_gpu_queue( FlatPolygon, 4 );
 				m_n_gpu_buffer_offset = 0;
 			}
 			break;
@@ -3277,7 +3497,8 @@ void psx_gpu_write( UINT32 *p_ram, INT32 n_size )
 			else
 			{
 				verboselog( 1, "%02x: textured 4 point polygon\n", m_packet.n_entry[ 0 ] >> 24 );
-				FlatTexturedPolygon( 4 );
+				decode_tpage( &psxgpu, m_packet.FlatTexturedPolygon.vertex[ 1 ].n_texture.w.h );
+				psx_gpu_queue_textured( FlatTexturedPolygon, 4, m_packet.FlatTexturedPolygon.vertex[ 0 ].n_texture.w.h );
 				m_n_gpu_buffer_offset = 0;
 			}
 			break;
@@ -3292,7 +3513,7 @@ void psx_gpu_write( UINT32 *p_ram, INT32 n_size )
 			else
 			{
 				verboselog( 1, "%02x: gouraud 3 point polygon\n", m_packet.n_entry[ 0 ] >> 24 );
-				GouraudPolygon( 3 );
+				psx_gpu_queue( GouraudPolygon, 3 );
 				m_n_gpu_buffer_offset = 0;
 			}
 			break;
@@ -3307,7 +3528,8 @@ void psx_gpu_write( UINT32 *p_ram, INT32 n_size )
 			else
 			{
 				verboselog( 1, "%02x: gouraud textured 3 point polygon\n", m_packet.n_entry[ 0 ] >> 24 );
-				GouraudTexturedPolygon( 3 );
+				decode_tpage( &psxgpu, m_packet.GouraudTexturedPolygon.vertex[ 1 ].n_texture.w.h );
+				psx_gpu_queue_textured( GouraudTexturedPolygon, 3, m_packet.GouraudTexturedPolygon.vertex[ 0 ].n_texture.w.h );
 				m_n_gpu_buffer_offset = 0;
 			}
 			break;
@@ -3322,7 +3544,7 @@ void psx_gpu_write( UINT32 *p_ram, INT32 n_size )
 			else
 			{
 				verboselog( 1, "%02x: gouraud 4 point polygon\n", m_packet.n_entry[ 0 ] >> 24 );
-				GouraudPolygon( 4 );
+				psx_gpu_queue( GouraudPolygon, 4 );
 				m_n_gpu_buffer_offset = 0;
 			}
 			break;
@@ -3337,7 +3559,8 @@ void psx_gpu_write( UINT32 *p_ram, INT32 n_size )
 			else
 			{
 				verboselog( 1, "%02x: gouraud textured 4 point polygon\n", m_packet.n_entry[ 0 ] >> 24 );
-				GouraudTexturedPolygon( 4 );
+				decode_tpage( &psxgpu, m_packet.GouraudTexturedPolygon.vertex[ 1 ].n_texture.w.h );
+				psx_gpu_queue_textured( GouraudTexturedPolygon, 4, m_packet.GouraudTexturedPolygon.vertex[ 0 ].n_texture.w.h );
 				m_n_gpu_buffer_offset = 0;
 			}
 			break;
@@ -3351,7 +3574,7 @@ void psx_gpu_write( UINT32 *p_ram, INT32 n_size )
 			else
 			{
 				verboselog( 1, "%02x: monochrome line\n", m_packet.n_entry[ 0 ] >> 24 );
-				MonochromeLine();
+				psx_gpu_queue( MonochromeLine, 0 );
 				m_n_gpu_buffer_offset = 0;
 			}
 			break;
@@ -3365,7 +3588,7 @@ void psx_gpu_write( UINT32 *p_ram, INT32 n_size )
 			else
 			{
 				verboselog( 1, "%02x: monochrome polyline\n", m_packet.n_entry[ 0 ] >> 24 );
-				MonochromeLine();
+				psx_gpu_queue( MonochromeLine, 0 );
 				if( ( m_packet.n_entry[ 3 ] & 0xf000f000 ) != 0x50005000 )
 				{
 					m_packet.n_entry[ 1 ] = m_packet.n_entry[ 2 ];
@@ -3387,7 +3610,7 @@ void psx_gpu_write( UINT32 *p_ram, INT32 n_size )
 			else
 			{
 				verboselog( 1, "%02x: gouraud line\n", m_packet.n_entry[ 0 ] >> 24 );
-				GouraudLine();
+				psx_gpu_queue( GouraudLine, 0 );
 				m_n_gpu_buffer_offset = 0;
 			}
 			break;
@@ -3402,7 +3625,7 @@ void psx_gpu_write( UINT32 *p_ram, INT32 n_size )
 			else
 			{
 				verboselog( 1, "%02x: gouraud polyline\n", m_packet.n_entry[ 0 ] >> 24 );
-				GouraudLine();
+				psx_gpu_queue( GouraudLine, 0 );
 				if( ( m_packet.n_entry[ 4 ] & 0xf000f000 ) != 0x50005000 )
 				{
 					m_packet.n_entry[ 0 ] = ( m_packet.n_entry[ 0 ] & 0xff000000 ) | ( m_packet.n_entry[ 2 ] & 0x00ffffff );
@@ -3431,7 +3654,7 @@ void psx_gpu_write( UINT32 *p_ram, INT32 n_size )
 					m_packet.n_entry[ 0 ] >> 24,
 					(INT16)( m_packet.n_entry[ 1 ] & 0xffff ), (INT16)( m_packet.n_entry[ 1 ] >> 16 ),
 					(INT16)( m_packet.n_entry[ 2 ] & 0xffff ), (INT16)( m_packet.n_entry[ 2 ] >> 16 ) );
-				FlatRectangle();
+				psx_gpu_queue( FlatRectangle, 0 );
 				m_n_gpu_buffer_offset = 0;
 			}
 			break;
@@ -3450,7 +3673,7 @@ void psx_gpu_write( UINT32 *p_ram, INT32 n_size )
 					(INT16)( m_packet.n_entry[ 1 ] & 0xffff ), (INT16)( m_packet.n_entry[ 1 ] >> 16 ),
 					m_packet.n_entry[ 3 ] & 0xffff, m_packet.n_entry[ 3 ] >> 16,
 					m_packet.n_entry[ 0 ], m_packet.n_entry[ 2 ] );
-				FlatTexturedRectangle();
+				psx_gpu_queue_textured( FlatTexturedRectangle, 0, m_packet.FlatTexturedRectangle.n_texture.w.h );
 				m_n_gpu_buffer_offset = 0;
 			}
 			break;
@@ -3466,7 +3689,7 @@ void psx_gpu_write( UINT32 *p_ram, INT32 n_size )
 					m_packet.n_entry[ 0 ] >> 24,
 					(INT16)( m_packet.n_entry[ 1 ] & 0xffff ), (INT16)( m_packet.n_entry[ 1 ] >> 16 ),
 					m_packet.n_entry[ 0 ] & 0xffffff );
-				Dot();
+				psx_gpu_queue( Dot, 0 );
 				m_n_gpu_buffer_offset = 0;
 			}
 			break;
@@ -3481,7 +3704,7 @@ void psx_gpu_write( UINT32 *p_ram, INT32 n_size )
 			{
 				verboselog( 1, "%02x: 16x16 rectangle %08x %08x\n", m_packet.n_entry[ 0 ] >> 24,
 					m_packet.n_entry[ 0 ], m_packet.n_entry[ 1 ] );
-				FlatRectangle8x8();
+				psx_gpu_queue( FlatRectangle8x8, 0 );
 				m_n_gpu_buffer_offset = 0;
 			}
 			break;
@@ -3497,7 +3720,7 @@ void psx_gpu_write( UINT32 *p_ram, INT32 n_size )
 			{
 				verboselog( 1, "%02x: 8x8 sprite %08x %08x %08x\n", m_packet.n_entry[ 0 ] >> 24,
 					m_packet.n_entry[ 0 ], m_packet.n_entry[ 1 ], m_packet.n_entry[ 2 ] );
-				Sprite8x8();
+				psx_gpu_queue_textured( Sprite8x8, 0, m_packet.Sprite8x8.n_texture.w.h );
 				m_n_gpu_buffer_offset = 0;
 			}
 			break;
@@ -3512,7 +3735,7 @@ void psx_gpu_write( UINT32 *p_ram, INT32 n_size )
 			{
 				verboselog( 1, "%02x: 16x16 rectangle %08x %08x\n", m_packet.n_entry[ 0 ] >> 24,
 					m_packet.n_entry[ 0 ], m_packet.n_entry[ 1 ] );
-				FlatRectangle16x16();
+				psx_gpu_queue( FlatRectangle16x16, 0 );
 				m_n_gpu_buffer_offset = 0;
 			}
 			break;
@@ -3528,7 +3751,7 @@ void psx_gpu_write( UINT32 *p_ram, INT32 n_size )
 			{
 				verboselog( 1, "%02x: 16x16 sprite %08x %08x %08x\n", m_packet.n_entry[ 0 ] >> 24,
 					m_packet.n_entry[ 0 ], m_packet.n_entry[ 1 ], m_packet.n_entry[ 2 ] );
-				Sprite16x16();
+				psx_gpu_queue_textured( Sprite16x16, 0, m_packet.Sprite16x16.n_texture.w.h );
 				m_n_gpu_buffer_offset = 0;
 			}
 			break;
@@ -3540,6 +3763,7 @@ void psx_gpu_write( UINT32 *p_ram, INT32 n_size )
 			else
 			{
 				verboselog( 1, "move image in frame buffer %08x %08x %08x %08x\n", m_packet.n_entry[ 0 ], m_packet.n_entry[ 1 ], m_packet.n_entry[ 2 ], m_packet.n_entry[ 3 ] );
+				psx_gpu_flush();
 				MoveImage();
 				m_n_gpu_buffer_offset = 0;
 			}
@@ -3552,6 +3776,7 @@ void psx_gpu_write( UINT32 *p_ram, INT32 n_size )
 			else
 			{
 				UINT32 n_pixel;
+				psx_gpu_flush();
 				for( n_pixel = 0; n_pixel < 2; n_pixel++ )
 				{
 					UINT16 *p_vram;
@@ -3591,6 +3816,7 @@ void psx_gpu_write( UINT32 *p_ram, INT32 n_size )
 			else
 			{
 				verboselog( 1, "%02x: copy image from frame buffer\n", m_packet.n_entry[ 0 ] >> 24 );
+				psx_gpu_flush();
 				m_n_gpustatus |= ( 1L << 0x1b );
 			}
 			break;
@@ -3685,6 +3911,7 @@ WRITE32_HANDLER( psx_gpu_w )
 		{
 		case 0x00:
 			verboselog( 1, "reset gpu\n" );
+			psx_gpu_flush();
 			m_n_gpu_buffer_offset = 0;
 			m_n_gpustatus = 0x14802000;
 			m_n_drawarea_x1 = 0;
@@ -3839,6 +4066,8 @@ WRITE32_HANDLER( psx_gpu_w )
 
 void psx_gpu_read( UINT32 *p_ram, INT32 n_size )
 {
+	psx_gpu_flush();
+
 	while( n_size > 0 )
 	{
 		if( ( m_n_gpustatus & ( 1L << 0x1b ) ) != 0 )
@@ -36,6 +36,16 @@ enum
 /* size of the rasterizer hash table */
 #define RASTER_HASH_SIZE		97
 
+/* extension of the per-game rasterizer profile saved in the cfg directory */
+#define RASTER_PROFILE_EXTENSION	".vrp"
+
+/* maximum number of triangles held in the deferred rendering queue */
+#define MAX_PENDING_TRIANGLES	1024
+
+/* maximum number of scanline bands rasterized in parallel, and their minimum height */
+#define RASTER_BANDS			8
+#define RASTER_MIN_BAND_HEIGHT	16
+
 /* flags for LFB writes */
 #define LFB_RGB_PRESENT			1
 #define LFB_ALPHA_PRESENT		2
@@ -1560,10 +1570,27 @@ struct _voodoo_stats
 typedef struct _voodoo_stats voodoo_stats;
 
 
+struct _stats_block
+{
+	INT32		pixels_in;				/* pixels in statistic */
+	INT32		pixels_out;				/* pixels out statistic */
+	INT32		chroma_fail;			/* chroma test fail statistic */
+	INT32		zfunc_fail;				/* z function test fail statistic */
+	INT32		afunc_fail;				/* alpha function test fail statistic */
+	INT32		clipped;				/* clipped pixels */
+	INT32		stippled;				/* stippled pixels */
+	INT32		stipple_count;			/* number of rotations of the stipple pattern */
+};
+typedef struct _stats_block stats_block;
+
+
+typedef struct _tri_work tri_work;
+
+
 struct _raster_info
 {
 	struct _raster_info *next;			/* pointer to next entry with the same hash */
-	void		(*callback)(voodoo_state *, UINT16 *); /* callback pointer */
+	void		(*callback)(voodoo_state *, const tri_work *, INT32, INT32, stats_block *); /* callback pointer */
 	UINT8		is_generic;				/* TRUE if this is one of the generic rasterizers */
 	UINT32		hits;					/* how many hits (pixels) we've used this for */
 	UINT32		polys;					/* how many polys we've used this for */
@@ -1573,10 +1600,72 @@ struct _raster_info
 	UINT32		eff_fbz_mode;			/* effective fbzMode value */
 	UINT32		eff_tex_mode_0;			/* effective textureMode value for TMU #0 */
 	UINT32		eff_tex_mode_1;			/* effective textureMode value for TMU #1 */
+	INT64		total_hits;				/* hits accumulated across stats dumps */
+	INT64		total_polys;			/* polys accumulated across stats dumps */
 };
 typedef struct _raster_info raster_info;
 
 
+/* one entry in a saved rasterizer profile */
+struct _raster_profile
+{
+	INT64		polys;					/* total polys drawn with this mode */
+	INT64		hits;					/* total pixels drawn with this mode */
+	UINT32		eff_color_path;			/* effective fbzColorPath value */
+	UINT32		eff_alpha_mode;			/* effective alphaMode value */
+	UINT32		eff_fog_mode;			/* effective fogMode value */
+	UINT32		eff_fbz_mode;			/* effective fbzMode value */
+	UINT32		eff_tex_mode_0;			/* effective textureMode value for TMU #0 */
+	UINT32		eff_tex_mode_1;			/* effective textureMode value for TMU #1 */
+};
+typedef struct _raster_profile raster_profile;
+
+
+struct _tri_tmu
+{
+	INT64		starts, startt;			/* starting S,T (14.18) */
+	INT64		startw;					/* starting W (2.30) */
+	INT64		dsdx, dtdx;				/* delta S,T per X */
+	INT64		dwdx;					/* delta W per X */
+	INT64		dsdy, dtdy;				/* delta S,T per Y */
+	INT64		dwdy;					/* delta W per Y */
+	INT32		lodbase;				/* base LOD computed at setup */
+};
+typedef struct _tri_tmu tri_tmu;
+
+
+/* a triangle waiting in the deferred rendering queue; holds everything */
+/* the rasterizer needs that can change without forcing a flush */
+struct _tri_work
+{
+	raster_info *info;					/* rasterizer to use */
+	UINT16 *	drawbuf;				/* buffer to draw into */
+	INT32		starty, stopy;			/* scanlines covered */
+	INT16		ax, ay;					/* vertex A x,y (12.4) */
+	INT16		bx, by;					/* vertex B x,y (12.4) */
+	INT16		cx, cy;					/* vertex C x,y (12.4) */
+	INT32		startr, startg, startb, starta; /* starting R,G,B,A (12.12) */
+	INT32		startz;					/* starting Z (20.12) */
+	INT64		startw;					/* starting W (16.32) */
+	INT32		drdx, dgdx, dbdx, dadx;	/* delta R,G,B,A per X */
+	INT32		dzdx;					/* delta Z per X */
+	INT64		dwdx;					/* delta W per X */
+	INT32		drdy, dgdy, dbdy, dady;	/* delta R,G,B,A per Y */
+	INT32		dzdy;					/* delta Z per Y */
+	INT64		dwdy;					/* delta W per Y */
+	tri_tmu		tmu[MAX_TMU];			/* per-TMU parameters */
+};
+
+
+struct _raster_band
+{
+	voodoo_state *v;					/* owning chip */
+	INT32		starty, stopy;			/* scanlines covered by this band */
+	stats_block	stats;					/* statistics gathered while drawing */
+};
+typedef struct _raster_band raster_band;
+
+
 struct _banshee_info
 {
 	UINT32		io[0x40];				/* I/O registers */
@@ -1622,6 +1711,11 @@ struct _voodoo_state
 	int			next_rasterizer;		/* next rasterizer index */
 	raster_info	rasterizer[MAX_RASTERIZERS]; /* array of rasterizers */
 	raster_info *raster_hash[RASTER_HASH_SIZE]; /* hash table of rasterizers */
+
+	osd_work_queue *work_queue;			/* queue for rasterizing bands in parallel */
+	tri_work *	tri_queue;				/* deferred triangles */
+	int			tri_count;				/* number of deferred triangles */
+	raster_band	band[RASTER_BANDS];		/* scanline bands */
 };
 /* typedef struct _voodoo_state voodoo_state; -- declared above */
 
@@ -2104,7 +2198,7 @@ do 																				\
 		{																		\
 			if ((((COLOR) ^ (VV)->reg[chromaKey].u) & 0xffffff) == 0)			\
 			{																	\
-				(VV)->reg[fbiChromaFail].u++;									\
+				stats->chroma_fail++;											\
 				goto skipdrawdepth;												\
 			}																	\
 		}																		\
@@ -2144,7 +2238,7 @@ do 																				\
 			{																	\
 				if (results != 0)												\
 				{																\
-					(VV)->reg[fbiChromaFail].u++;								\
+					stats->chroma_fail++;										\
 					goto skipdrawdepth;											\
 				}																\
 			}																	\
@@ -2152,7 +2246,7 @@ do 																				\
 			{																	\
 				if (results == 7)												\
 				{																\
-					(VV)->reg[fbiChromaFail].u++;								\
+					stats->chroma_fail++;										\
 					goto skipdrawdepth;											\
 				}																\
 			}																	\
@@ -2176,7 +2270,7 @@ do 																				\
 	{																			\
 		if (((AA) & 1) == 0)													\
 		{																		\
-			(VV)->reg[fbiAfuncFail].u++;										\
+			stats->afunc_fail++;												\
 			goto skipdrawdepth;													\
 		}																		\
 	}																			\
@@ -2199,13 +2293,13 @@ do 																				\
 		switch (ALPHAMODE_ALPHAFUNCTION(ALPHAMODE))								\
 		{																		\
 			case 0:		/* alphaOP = never */									\
-				(VV)->reg[fbiAfuncFail].u++;									\
+				stats->afunc_fail++;											\
 				goto skipdrawdepth;												\
 																				\
 			case 1:		/* alphaOP = less than */								\
 				if ((AA) >= ALPHAMODE_ALPHAREF(ALPHAMODE))						\
 				{																\
-					(VV)->reg[fbiAfuncFail].u++;								\
+					stats->afunc_fail++;										\
 					goto skipdrawdepth;											\
 				}																\
 				break;															\
@@ -2213,7 +2307,7 @@ do 																				\
 			case 2:		/* alphaOP = equal */									\
 				if ((AA) != ALPHAMODE_ALPHAREF(ALPHAMODE))						\
 				{																\
-					(VV)->reg[fbiAfuncFail].u++;								\
+					stats->afunc_fail++;										\
 					goto skipdrawdepth;											\
 				}																\
 				break;															\
@@ -2221,7 +2315,7 @@ do 																				\
 			case 3:		/* alphaOP = less than or equal */						\
 				if ((AA) > ALPHAMODE_ALPHAREF(ALPHAMODE))						\
 				{																\
-					(VV)->reg[fbiAfuncFail].u++;								\
+					stats->afunc_fail++;										\
 					goto skipdrawdepth;											\
 				}																\
 				break;															\
@@ -2229,7 +2323,7 @@ do 																				\
 			case 4:		/* alphaOP = greater than */							\
 				if ((AA) <= ALPHAMODE_ALPHAREF(ALPHAMODE))						\
 				{																\
-					(VV)->reg[fbiAfuncFail].u++;								\
+					stats->afunc_fail++;										\
 					goto skipdrawdepth;											\
 				}																\
 				break;															\
@@ -2237,7 +2331,7 @@ do 																				\
 			case 5:		/* alphaOP = not equal */								\
 				if ((AA) == ALPHAMODE_ALPHAREF(ALPHAMODE))						\
 				{																\
-					(VV)->reg[fbiAfuncFail].u++;								\
+					stats->afunc_fail++;										\
 					goto skipdrawdepth;											\
 				}																\
 				break;															\
@@ -2245,7 +2339,7 @@ do 																				\
 			case 6:		/* alphaOP = greater than or equal */					\
 				if ((AA) < ALPHAMODE_ALPHAREF(ALPHAMODE))						\
 				{																\
-					(VV)->reg[fbiAfuncFail].u++;								\
+					stats->afunc_fail++;										\
 					goto skipdrawdepth;											\
 				}																\
 				break;															\
@@ -2921,7 +3015,7 @@ do 																				\
 	INT32 prefogr, prefogg, prefogb;											\
 	INT32 r, g, b, a;															\
 																				\
-	(VV)->reg[fbiPixelsIn].u++;													\
+	stats->pixels_in++;															\
 																				\
 	/* apply clipping */														\
 	if (FBZMODE_ENABLE_CLIPPING(FBZMODE))										\
@@ -2931,14 +3025,20 @@ do 																				\
 			(SCRY) < (((VV)->reg[clipLowYHighY].u >> 16) & 0x3ff) ||			\
 			(SCRY) >= ((VV)->reg[clipLowYHighY].u & 0x3ff))						\
 		{																		\
-			v->stats.total_clipped++;											\
+			stats->clipped++;													\
 			goto skipdrawdepth;													\
 		}																		\
 	}																			\
 																				\
-	/* rotate stipple pattern */												\
+	/* rotate stipple pattern; when stippling is off we only count the */		\
+	/* rotations, so that bands drawn in parallel don't fight over it */		\
 	if (FBZMODE_STIPPLE_PATTERN(FBZMODE) == 0)									\
-		(VV)->reg[stipple].u = ((VV)->reg[stipple].u << 1) | ((VV)->reg[stipple].u >> 31);\
+	{																			\
+		if (FBZMODE_ENABLE_STIPPLE(FBZMODE))									\
+			(VV)->reg[stipple].u = ((VV)->reg[stipple].u << 1) | ((VV)->reg[stipple].u >> 31);\
+		else																	\
+			stats->stipple_count++;												\
+	}																			\
 																				\
 	/* handle stippling */														\
 	if (FBZMODE_ENABLE_STIPPLE(FBZMODE))										\
@@ -2948,7 +3048,7 @@ do 																				\
 		{																		\
 			if (((VV)->reg[stipple].u & 0x80000000) == 0)						\
 			{																	\
-				v->stats.total_stippled++;										\
+				stats->stippled++;												\
 				goto skipdrawdepth;												\
 			}																	\
 		}																		\
@@ -2959,7 +3059,7 @@ do 																				\
 			int stipple_index = (((YY) & 3) << 3) | (~(XX) & 7);				\
 			if ((((VV)->reg[stipple].u >> stipple_index) & 1) == 0)				\
 			{																	\
-				v->stats.total_stippled++;										\
+				stats->stippled++;												\
 				goto skipdrawdepth;												\
 			}																	\
 		}																		\
@@ -3025,13 +3125,13 @@ do 																				\
 		switch (FBZMODE_DEPTH_FUNCTION(FBZMODE))								\
 		{																		\
 			case 0:		/* depthOP = never */									\
-				(VV)->reg[fbiZfuncFail].u++;									\
+				stats->zfunc_fail++;											\
 				goto skipdrawdepth;												\
 																				\
 			case 1:		/* depthOP = less than */								\
 				if (depthsource >= depth[XX])									\
 				{																\
-					(VV)->reg[fbiZfuncFail].u++;								\
+					stats->zfunc_fail++;										\
 					goto skipdrawdepth;											\
 				}																\
 				break;															\
@@ -3039,7 +3139,7 @@ do 																				\
 			case 2:		/* depthOP = equal */									\
 				if (depthsource != depth[XX])									\
 				{																\
-					(VV)->reg[fbiZfuncFail].u++;								\
+					stats->zfunc_fail++;										\
 					goto skipdrawdepth;											\
 				}																\
 				break;															\
@@ -3047,7 +3147,7 @@ do 																				\
 			case 3:		/* depthOP = less than or equal */						\
 				if (depthsource > depth[XX])									\
 				{																\
-					(VV)->reg[fbiZfuncFail].u++;								\
+					stats->zfunc_fail++;										\
 					goto skipdrawdepth;											\
 				}																\
 				break;															\
@@ -3055,7 +3155,7 @@ do 																				\
 			case 4:		/* depthOP = greater than */							\
 				if (depthsource <= depth[XX])									\
 				{																\
-					(VV)->reg[fbiZfuncFail].u++;								\
+					stats->zfunc_fail++;										\
 					goto skipdrawdepth;											\
 				}																\
 				break;															\
@@ -3063,7 +3163,7 @@ do 																				\
 			case 5:		/* depthOP = not equal */								\
 				if (depthsource == depth[XX])									\
 				{																\
-					(VV)->reg[fbiZfuncFail].u++;								\
+					stats->zfunc_fail++;										\
 					goto skipdrawdepth;											\
 				}																\
 				break;															\
@@ -3071,7 +3171,7 @@ do 																				\
 			case 6:		/* depthOP = greater than or equal */					\
 				if (depthsource < depth[XX])									\
 				{																\
-					(VV)->reg[fbiZfuncFail].u++;								\
+					stats->zfunc_fail++;										\
 					goto skipdrawdepth;											\
 				}																\
 				break;															\
@@ -3115,7 +3215,7 @@ do 																				\
 	}																			\
 																				\
 	/* track pixel writes to the frame buffer regardless of mask */				\
-	(VV)->reg[fbiPixelsOut].u++;												\
+	stats->pixels_out++;														\
 																				\
 skipdrawdepth:																	\
 	;																			\
@@ -3420,7 +3520,7 @@ while (0)
 
 #define RASTERIZER(name, TMUS, FBZCOLORPATH, FBZMODE, ALPHAMODE, FOGMODE, TEXMODE0, TEXMODE1) \
 																				\
-static void raster_##name(voodoo_state *v, UINT16 *drawbuf)						\
+static void raster_##name(voodoo_state *v, const tri_work *extra, INT32 bandmin, INT32 bandmax, stats_block *stats)\
 {																				\
 	INT32 dxdy_minmid, dxdy_minmax, dxdy_midmax;								\
 	INT32 minx, miny, midx, midy, maxx, maxy;									\
@@ -3428,46 +3528,46 @@ static void raster_##name(voodoo_state *v, UINT16 *drawbuf)						\
 	INT32 x, y;																	\
 																				\
 	/* sort the vertices */														\
-	if (v->fbi.ay <= v->fbi.by)													\
+	if (extra->ay <= extra->by)													\
 	{																			\
-		if (v->fbi.by <= v->fbi.cy)												\
+		if (extra->by <= extra->cy)												\
 		{																		\
-			minx = v->fbi.ax;	miny = v->fbi.ay;								\
-			midx = v->fbi.bx;	midy = v->fbi.by;								\
-			maxx = v->fbi.cx;	maxy = v->fbi.cy;								\
+			minx = extra->ax;	miny = extra->ay;								\
+			midx = extra->bx;	midy = extra->by;								\
+			maxx = extra->cx;	maxy = extra->cy;								\
 		}																		\
-		else if (v->fbi.ay <= v->fbi.cy)										\
+		else if (extra->ay <= extra->cy)										\
 		{																		\
-			minx = v->fbi.ax;	miny = v->fbi.ay;								\
-			midx = v->fbi.cx;	midy = v->fbi.cy;								\
-			maxx = v->fbi.bx;	maxy = v->fbi.by;								\
+			minx = extra->ax;	miny = extra->ay;								\
+			midx = extra->cx;	midy = extra->cy;								\
+			maxx = extra->bx;	maxy = extra->by;								\
 		}																		\
 		else																	\
 		{																		\
-			minx = v->fbi.cx;	miny = v->fbi.cy;								\
-			midx = v->fbi.ax;	midy = v->fbi.ay;								\
-			maxx = v->fbi.bx;	maxy = v->fbi.by;								\
+			minx = extra->cx;	miny = extra->cy;								\
+			midx = extra->ax;	midy = extra->ay;								\
+			maxx = extra->bx;	maxy = extra->by;								\
 		}																		\
 	}																			\
 	else																		\
 	{																			\
-		if (v->fbi.ay <= v->fbi.cy)												\
+		if (extra->ay <= extra->cy)												\
 		{																		\
-			minx = v->fbi.bx;	miny = v->fbi.by;								\
-			midx = v->fbi.ax;	midy = v->fbi.ay;								\
-			maxx = v->fbi.cx;	maxy = v->fbi.cy;								\
+			minx = extra->bx;	miny = extra->by;								\
+			midx = extra->ax;	midy = extra->ay;								\
+			maxx = extra->cx;	maxy = extra->cy;								\
 		}																		\
-		else if (v->fbi.by <= v->fbi.cy)										\
+		else if (extra->by <= extra->cy)										\
 		{																		\
-			minx = v->fbi.bx;	miny = v->fbi.by;								\
-			midx = v->fbi.cx;	midy = v->fbi.cy;								\
-			maxx = v->fbi.ax;	maxy = v->fbi.ay;								\
+			minx = extra->bx;	miny = extra->by;								\
+			midx = extra->cx;	midy = extra->cy;								\
+			maxx = extra->ax;	maxy = extra->ay;								\
 		}																		\
 		else																	\
 		{																		\
-			minx = v->fbi.cx;	miny = v->fbi.cy;								\
-			midx = v->fbi.bx;	midy = v->fbi.by;								\
-			maxx = v->fbi.ax;	maxy = v->fbi.ay;								\
+			minx = extra->cx;	miny = extra->cy;								\
+			midx = extra->bx;	midy = extra->by;								\
+			maxx = extra->ax;	maxy = extra->ay;								\
 		}																		\
 	}																			\
 																				\
@@ -3480,6 +3580,12 @@ static void raster_##name(voodoo_state *v, UINT16 *drawbuf)						\
 	starty = (miny + 7) >> 4;													\
 	stopy = (maxy + 7) >> 4;													\
 																				\
+	/* clip to our band */														\
+	if (starty < bandmin)														\
+		starty = bandmin;														\
+	if (stopy > bandmax)														\
+		stopy = bandmax;														\
+																				\
 	/* loop in Y */																\
 	for (y = starty; y < stopy; y++)											\
 	{																			\
@@ -3521,35 +3627,35 @@ static void raster_##name(voodoo_state *v, UINT16 *drawbuf)						\
 			scry = (v->fbi.yorigin - y) & 0x3ff;								\
 																				\
 		/* get pointers to the target buffer and depth buffer */				\
-		dest = drawbuf + scry * v->fbi.rowpixels;								\
+		dest = extra->drawbuf + scry * v->fbi.rowpixels;						\
 		depth = v->fbi.aux ? (v->fbi.aux + scry * v->fbi.rowpixels) : NULL;		\
 																				\
 		/* compute the starting parameters */									\
-		dx = startx - (v->fbi.ax >> 4);											\
-		dy = y - (v->fbi.ay >> 4);												\
-		iterr = v->fbi.startr + dy * v->fbi.drdy + dx * v->fbi.drdx;			\
-		iterg = v->fbi.startg + dy * v->fbi.dgdy + dx * v->fbi.dgdx;			\
-		iterb = v->fbi.startb + dy * v->fbi.dbdy + dx * v->fbi.dbdx;			\
-		itera = v->fbi.starta + dy * v->fbi.dady + dx * v->fbi.dadx;			\
-		iterz = v->fbi.startz + dy * v->fbi.dzdy + dx * v->fbi.dzdx;			\
-		iterw = v->fbi.startw + dy * v->fbi.dwdy + dx * v->fbi.dwdx;			\
+		dx = startx - (extra->ax >> 4);											\
+		dy = y - (extra->ay >> 4);												\
+		iterr = extra->startr + dy * extra->drdy + dx * extra->drdx;			\
+		iterg = extra->startg + dy * extra->dgdy + dx * extra->dgdx;			\
+		iterb = extra->startb + dy * extra->dbdy + dx * extra->dbdx;			\
+		itera = extra->starta + dy * extra->dady + dx * extra->dadx;			\
+		iterz = extra->startz + dy * extra->dzdy + dx * extra->dzdx;			\
+		iterw = extra->startw + dy * extra->dwdy + dx * extra->dwdx;			\
 		if (TMUS >= 1)															\
 		{																		\
-			iterw0 = v->tmu[0].startw + dy * v->tmu[0].dwdy +					\
-										dx * v->tmu[0].dwdx;					\
-			iters0 = v->tmu[0].starts + dy * v->tmu[0].dsdy + 					\
-										dx * v->tmu[0].dsdx;					\
-			itert0 = v->tmu[0].startt + dy * v->tmu[0].dtdy + 					\
-										dx * v->tmu[0].dtdx;					\
+			iterw0 = extra->tmu[0].startw + dy * extra->tmu[0].dwdy +			\
+										dx * extra->tmu[0].dwdx;				\
+			iters0 = extra->tmu[0].starts + dy * extra->tmu[0].dsdy +			\
+										dx * extra->tmu[0].dsdx;				\
+			itert0 = extra->tmu[0].startt + dy * extra->tmu[0].dtdy +			\
+										dx * extra->tmu[0].dtdx;				\
 		}																		\
 		if (TMUS >= 2)															\
 		{																		\
-			iterw1 = v->tmu[1].startw + dy * v->tmu[1].dwdy + 					\
-										dx * v->tmu[1].dwdx;					\
-			iters1 = v->tmu[1].starts + dy * v->tmu[1].dsdy + 					\
-										dx * v->tmu[1].dsdx;					\
-			itert1 = v->tmu[1].startt + dy * v->tmu[1].dtdy + 					\
-										dx * v->tmu[1].dtdx;					\
+			iterw1 = extra->tmu[1].startw + dy * extra->tmu[1].dwdy +			\
+										dx * extra->tmu[1].dwdx;				\
+			iters1 = extra->tmu[1].starts + dy * extra->tmu[1].dsdy +			\
+										dx * extra->tmu[1].dsdx;				\
+			itert1 = extra->tmu[1].startt + dy * extra->tmu[1].dtdy +			\
+										dx * extra->tmu[1].dtdx;				\
 		}																		\
 																				\
 		/* loop in X */															\
@@ -3566,7 +3672,7 @@ static void raster_##name(voodoo_state *v, UINT16 *drawbuf)						\
 			/* note that they set LOD min to 8 to "disable" a TMU */			\
 			if (TMUS >= 2 && v->tmu[1].lodmin < (8 << 8))						\
 				TEXTURE_PIPELINE(&v->tmu[1], x, y, TEXMODE1, texel,				\
-									v->tmu[1].lookup, v->tmu[1].lodbase,		\
+									v->tmu[1].lookup, extra->tmu[1].lodbase,	\
 									iters1, itert1, iterw1, texel);				\
 																				\
 			/* run the texture pipeline on TMU0 to produce a final */			\
@@ -3574,7 +3680,7 @@ static void raster_##name(voodoo_state *v, UINT16 *drawbuf)						\
 			/* note that they set LOD min to 8 to "disable" a TMU */			\
 			if (TMUS >= 1 && v->tmu[0].lodmin < (8 << 8))						\
 				TEXTURE_PIPELINE(&v->tmu[0], x, y, TEXMODE0, texel, 			\
-									v->tmu[0].lookup, v->tmu[0].lodbase,		\
+									v->tmu[0].lookup, extra->tmu[0].lodbase,	\
 									iters0, itert0, iterw0, texel);				\
 																				\
 			/* colorpath pipeline selects source colors and does blending */	\
@@ -3587,23 +3693,23 @@ static void raster_##name(voodoo_state *v, UINT16 *drawbuf)						\
 									ALPHAMODE, FOGMODE, iterz, iterw, iterargb);\
 																				\
 			/* update the iterated parameters */								\
-			iterr += v->fbi.drdx;												\
-			iterg += v->fbi.dgdx;												\
-			iterb += v->fbi.dbdx;												\
-			itera += v->fbi.dadx;												\
-			iterz += v->fbi.dzdx;												\
-			iterw += v->fbi.dwdx;												\
+			iterr += extra->drdx;												\
+			iterg += extra->dgdx;												\
+			iterb += extra->dbdx;												\
+			itera += extra->dadx;												\
+			iterz += extra->dzdx;												\
+			iterw += extra->dwdx;												\
 			if (TMUS >= 1)														\
 			{																	\
-				iterw0 += v->tmu[0].dwdx;										\
-				iters0 += v->tmu[0].dsdx;										\
-				itert0 += v->tmu[0].dtdx;										\
+				iterw0 += extra->tmu[0].dwdx;									\
+				iters0 += extra->tmu[0].dsdx;									\
+				itert0 += extra->tmu[0].dtdx;									\
 			}																	\
 			if (TMUS >= 2)														\
 			{																	\
-				iterw1 += v->tmu[1].dwdx;										\
-				iters1 += v->tmu[1].dsdx;										\
-				itert1 += v->tmu[1].dtdx;										\
+				iterw1 += extra->tmu[1].dwdx;									\
+				iters1 += extra->tmu[1].dsdx;									\
+				itert1 += extra->tmu[1].dtdx;									\
 			}																	\
 		}																		\
 	}																			\
@@ -215,10 +215,17 @@ static INT32 setup_and_draw_triangle(voodoo_state *v);
 static raster_info *add_rasterizer(voodoo_state *v, const raster_info *cinfo);
 static raster_info *find_rasterizer(voodoo_state *v, int texcount);
 static void dump_rasterizer_stats(voodoo_state *v);
+#ifdef VOODOO_PROFILE
+static void save_rasterizer_profile(void);
+#endif
+static INT32 compute_triangle_extent(tri_work *extra);
+static void sum_statistics(voodoo_state *v, const stats_block *stats);
+static void flush_triangles(voodoo_state *v);
+static void voodoo_exit(running_machine *machine);
 
-static void raster_generic_0tmu(voodoo_state *v, UINT16 *drawbuf);
-static void raster_generic_1tmu(voodoo_state *v, UINT16 *drawbuf);
-static void raster_generic_2tmu(voodoo_state *v, UINT16 *drawbuf);
+static void raster_generic_0tmu(voodoo_state *v, const tri_work *extra, INT32 bandmin, INT32 bandmax, stats_block *stats);
+static void raster_generic_1tmu(voodoo_state *v, const tri_work *extra, INT32 bandmin, INT32 bandmax, stats_block *stats);
+static void raster_generic_2tmu(voodoo_state *v, const tri_work *extra, INT32 bandmin, INT32 bandmax, stats_block *stats);
 
 
 
@@ -338,6 +345,13 @@ int voodoo_start(int which, int type, int fbmem_in_mb, int tmem0_in_mb, int tmem
 }
 #endif
 
+	/* set up the deferred rendering queue */
+	v->tri_queue = auto_malloc(sizeof(v->tri_queue[0]) * MAX_PENDING_TRIANGLES);
+	v->tri_count = 0;
+	v->work_queue = osd_work_queue_alloc(WORK_QUEUE_FLAG_MULTI);
+	if (which == 0)
+		add_exit_callback(Machine, voodoo_exit);
+
 	/* set up the PCI FIFO */
 	v->pci.fifo.base = v->pci.fifo_mem;
 	v->pci.fifo.size = 64*2;
@@ -412,6 +426,9 @@ void voodoo_update(int which, mame_bitmap *bitmap, const rectangle *cliprect)
 	int statskey;
 	int x, y;
 
+	/* finish any pending rendering */
+	flush_triangles(v);
+
 	/* if we are blank, just fill with black */
 	if (v->type <= VOODOO_2 && FBIINIT1_SOFTWARE_BLANK(v->reg[fbiInit1].u))
 	{
@@ -1045,6 +1062,7 @@ static void reset_counters(voodoo_state *v)
 
 static void soft_reset(voodoo_state *v)
 {
+	flush_triangles(v);
 	reset_counters(v);
 	v->reg[fbiTrianglesOut].u = 0;
 	fifo_reset(&v->fbi.fifo);
@@ -2134,6 +2152,13 @@ static INT32 register_w(voodoo_state *v, offs_t offset, UINT32 data)
 		return 0;
 	}
 
+	/* triangle parameters are captured when a triangle is queued; anything */
+	/* else may be used by the rasterizers, so finish pending work first */
+	if (!(regnum >= vertexAx && regnum <= triangleCMD) &&
+		!(regnum >= fvertexAx && regnum <= ftriangleCMD) &&
+		!(regnum >= sSetupMode && regnum <= sBeginTriCMD))
+		flush_triangles(v);
+
 	/* switch off the register */
 	switch (regnum)
 	{
@@ -2763,9 +2788,15 @@ static INT32 lfb_w(voodoo_state *v, offs_t offset, UINT32 data, UINT32 mem_mask,
 	int sr[2], sg[2], sb[2], sa[2], sw[2];
 	int x, y, scry, mask;
 	int pixel, destbuf;
+	stats_block lfb_stats;
+	stats_block *stats = &lfb_stats;
 
 	/* statistics */
 	v->stats.lfb_writes++;
+	memset(&lfb_stats, 0, sizeof(lfb_stats));
+
+	/* finish any pending rendering */
+	flush_triangles(v);
 
 	/* byte swizzling */
 	if (LFBMODE_BYTE_SWIZZLE_WRITES(v->reg[lfbMode].u))
@@ -3086,6 +3117,7 @@ static INT32 lfb_w(voodoo_state *v, offs_t offset, UINT32 data, UINT32 mem_mask,
 		}
 	}
 
+	sum_statistics(v, &lfb_stats);
 	return 0;
 }
 
@@ -3105,6 +3137,9 @@ static INT32 texture_w(voodoo_state *v, offs_t offset, UINT32 data)
 	/* statistics */
 	v->stats.tex_writes++;
 
+	/* finish any pending rendering */
+	flush_triangles(v);
+
 	/* point to the right TMU */
 	if (!(v->chipmask & (2 << tmunum)))
 		return 0;
@@ -3538,6 +3573,10 @@ static UINT32 register_r(voodoo_state *v, offs_t offset)
 		return 0xffffffff;
 	}
 
+	/* the pixel counters and stipple are updated by the rasterizers */
+	if (regnum >= stipple && regnum <= fbiPixelsOut)
+		flush_triangles(v);
+
 	/* default result is the FBI register value */
 	result = v->reg[regnum].u;
 
@@ -3711,6 +3750,9 @@ static UINT32 lfb_r(voodoo_state *v, offs_t offset, int forcefront)
 	/* statistics */
 	v->stats.lfb_reads++;
 
+	/* finish any pending rendering */
+	flush_triangles(v);
+
 	/* compute X,Y */
 	x = (offset << 1) & 0x3fe;
 	y = (offset >> 9) & 0x3ff;
@@ -3902,6 +3944,7 @@ static UINT32 banshee_fb_r(voodoo_state *v, offs_t offset, UINT32 mem_mask)
 	if (offset < v->fbi.lfb_base)
 	{
 		logerror("%08X:banshee_fb_r(%X)\n", activecpu_get_pc(), offset*4);
+		flush_triangles(v);
 		if (offset*4 <= v->fbi.mask)
 			result = ((UINT32 *)v->fbi.ram)[offset];
 	}
@@ -4195,6 +4238,7 @@ static void banshee_fb_w(voodoo_state *v, offs_t offset, UINT32 data, UINT32 mem
 			cmdfifo_w(v, &v->fbi.cmdfifo[1], (addr - v->fbi.cmdfifo[1].base) / 4, data);
 		else
 		{
+			flush_triangles(v);
 			if (offset*4 <= v->fbi.mask)
 				COMBINE_DATA(&((UINT32 *)v->fbi.ram)[offset]);
 			logerror("%08X:banshee_fb_w(%X) = %08X & %08X\n", activecpu_get_pc(), offset*4, data, ~mem_mask);
@@ -4470,15 +4514,13 @@ static INT32 swapbuffer(voodoo_state *v, UINT32 data)
 
 static INT32 triangle(voodoo_state *v)
 {
-	INT32 start_pixels_in = v->reg[fbiPixelsIn].u;
-	INT32 start_pixels_out = v->reg[fbiPixelsOut].u;
-	INT32 start_chroma_fail = v->reg[fbiChromaFail].u;
-	INT32 start_zfunc_fail = v->reg[fbiZfuncFail].u;
-	INT32 start_afunc_fail = v->reg[fbiAfuncFail].u;
 	raster_info *info;
+	tri_work *extra;
 	int texcount = 0;
 	UINT16 *drawbuf;
+	INT32 pixels;
 	int destbuf;
+	int tmunum;
 
 	profiler_mark(PROFILER_USER2);
 
@@ -4542,27 +4584,65 @@ static INT32 triangle(voodoo_state *v)
 
 	/* find a rasterizer that matches our current state */
 	info = find_rasterizer(v, texcount);
-	(*info->callback)(v, drawbuf);
+
+	/* make room in the queue */
+	if (v->tri_count >= MAX_PENDING_TRIANGLES)
+		flush_triangles(v);
+
+	/* capture the parameters; the registers may be rewritten before we draw */
+	extra = &v->tri_queue[v->tri_count];
+	extra->info = info;
+	extra->drawbuf = drawbuf;
+	extra->ax = v->fbi.ax;			extra->ay = v->fbi.ay;
+	extra->bx = v->fbi.bx;			extra->by = v->fbi.by;
+	extra->cx = v->fbi.cx;			extra->cy = v->fbi.cy;
+	extra->startr = v->fbi.startr;	extra->drdx = v->fbi.drdx;	extra->drdy = v->fbi.drdy;
+	extra->startg = v->fbi.startg;	extra->dgdx = v->fbi.dgdx;	extra->dgdy = v->fbi.dgdy;
+	extra->startb = v->fbi.startb;	extra->dbdx = v->fbi.dbdx;	extra->dbdy = v->fbi.dbdy;
+	extra->starta = v->fbi.starta;	extra->dadx = v->fbi.dadx;	extra->dady = v->fbi.dady;
+	extra->startz = v->fbi.startz;	extra->dzdx = v->fbi.dzdx;	extra->dzdy = v->fbi.dzdy;
+	extra->startw = v->fbi.startw;	extra->dwdx = v->fbi.dwdx;	extra->dwdy = v->fbi.dwdy;
+	for (tmunum = 0; tmunum < texcount; tmunum++)
+	{
+		tmu_state *t = &v->tmu[tmunum];
+		tri_tmu *tt = &extra->tmu[tmunum];
+
+		tt->starts = t->starts;		tt->dsdx = t->dsdx;		tt->dsdy = t->dsdy;
+		tt->startt = t->startt;		tt->dtdx = t->dtdx;		tt->dtdy = t->dtdy;
+		tt->startw = t->startw;		tt->dwdx = t->dwdx;		tt->dwdy = t->dwdy;
+		tt->lodbase = t->lodbase;
+	}
+
+	/* count the pixels up front, since the timing depends on them */
+	pixels = compute_triangle_extent(extra);
 	info->polys++;
-	info->hits += v->reg[fbiPixelsIn].u - start_pixels_in;
+	info->hits += pixels;
 
-	/* update stats */
-	v->reg[fbiTrianglesOut].u++;
+	/* a rotating stipple pattern depends on the exact pixel order, so draw those right away */
+	if (FBZMODE_ENABLE_STIPPLE(v->reg[fbzMode].u) && FBZMODE_STIPPLE_PATTERN(v->reg[fbzMode].u) == 0)
+	{
+		stats_block stats;
+
+		flush_triangles(v);
+		memset(&stats, 0, sizeof(stats));
+		(*info->callback)(v, extra, extra->starty, extra->stopy, &stats);
+		sum_statistics(v, &stats);
+	}
 
-	if (LOG_REGISTERS) logerror("cycles = %d\n", TRIANGLE_SETUP_CLOCKS + v->reg[fbiPixelsIn].u - start_pixels_in);
+	/* otherwise, leave it in the queue */
+	else if (pixels > 0)
+		v->tri_count++;
 
 	/* update stats */
+	v->reg[fbiTrianglesOut].u++;
 	v->stats.total_triangles++;
-	v->stats.total_pixels_in += v->reg[fbiPixelsIn].u - start_pixels_in;
-	v->stats.total_pixels_out += v->reg[fbiPixelsOut].u - start_pixels_out;
-	v->stats.total_chroma_fail += v->reg[fbiChromaFail].u - start_chroma_fail;
-	v->stats.total_zfunc_fail += v->reg[fbiZfuncFail].u - start_zfunc_fail;
-	v->stats.total_afunc_fail += v->reg[fbiAfuncFail].u - start_afunc_fail;
+
+	if (LOG_REGISTERS) logerror("cycles = %d\n", TRIANGLE_SETUP_CLOCKS + pixels);
 
 	profiler_mark(PROFILER_END);
 
 	/* 1 pixel per clock, plus some setup time */
-	return TRIANGLE_SETUP_CLOCKS + v->reg[fbiPixelsIn].u - start_pixels_in;
+	return TRIANGLE_SETUP_CLOCKS + pixels;
 }
 
 
@@ -4758,6 +4838,216 @@ static INT32 setup_and_draw_triangle(voodoo_state *v)
 
 
 
+/*************************************
+ *
+ *  Deferred rendering
+ *
+ *************************************/
+
+static INT32 compute_triangle_extent(tri_work *extra)
+{
+	INT32 dxdy_minmid, dxdy_minmax, dxdy_midmax;
+	INT32 minx, miny, midx, midy, maxx, maxy;
+	INT32 pixels = 0;
+	INT32 y;
+
+	/* sort the vertices the same way the rasterizers do */
+	if (extra->ay <= extra->by)
+	{
+		if (extra->by <= extra->cy)
+		{
+			minx = extra->ax;	miny = extra->ay;
+			midx = extra->bx;	midy = extra->by;
+			maxx = extra->cx;	maxy = extra->cy;
+		}
+		else if (extra->ay <= extra->cy)
+		{
+			minx = extra->ax;	miny = extra->ay;
+			midx = extra->cx;	midy = extra->cy;
+			maxx = extra->bx;	maxy = extra->by;
+		}
+		else
+		{
+			minx = extra->cx;	miny = extra->cy;
+			midx = extra->ax;	midy = extra->ay;
+			maxx = extra->bx;	maxy = extra->by;
+		}
+	}
+	else
+	{
+		if (extra->ay <= extra->cy)
+		{
+			minx = extra->bx;	miny = extra->by;
+			midx = extra->ax;	midy = extra->ay;
+			maxx = extra->cx;	maxy = extra->cy;
+		}
+		else if (extra->by <= extra->cy)
+		{
+			minx = extra->bx;	miny = extra->by;
+			midx = extra->cx;	midy = extra->cy;
+			maxx = extra->ax;	maxy = extra->ay;
+		}
+		else
+		{
+			minx = extra->cx;	miny = extra->cy;
+			midx = extra->bx;	midy = extra->by;
+			maxx = extra->ax;	maxy = extra->ay;
+		}
+	}
+
+	/* compute the slopes as 16.16 numbers */
+	dxdy_minmid = (miny == midy) ? 0 : ((midx - minx) << 16) / (midy - miny);
+	dxdy_minmax = (miny == maxy) ? 0 : ((maxx - minx) << 16) / (maxy - miny);
+	dxdy_midmax = (midy == maxy) ? 0 : ((maxx - midx) << 16) / (maxy - midy);
+
+	/* clamp to full pixels */
+	extra->starty = (miny + 7) >> 4;
+	extra->stopy = (maxy + 7) >> 4;
+
+	/* every pixel of every span enters the pipeline, so sum up the widths */
+	for (y = extra->starty; y < extra->stopy; y++)
+	{
+		INT32 fully = (y << 4) + 8;
+		INT32 startx = minx + (((fully - miny) * dxdy_minmax) >> 16);
+		INT32 stopx;
+
+		if (fully < midy)
+			stopx = minx + (((fully - miny) * dxdy_minmid) >> 16);
+		else
+			stopx = midx + (((fully - midy) * dxdy_midmax) >> 16);
+
+		startx = (startx + 7) >> 4;
+		stopx = (stopx + 7) >> 4;
+		pixels += (startx < stopx) ? (stopx - startx) : (startx - stopx);
+	}
+	return pixels;
+}
+
+
+static void sum_statistics(voodoo_state *v, const stats_block *stats)
+{
+	int rotate = stats->stipple_count & 31;
+
+	v->reg[fbiPixelsIn].u += stats->pixels_in;
+	v->reg[fbiPixelsOut].u += stats->pixels_out;
+	v->reg[fbiChromaFail].u += stats->chroma_fail;
+	v->reg[fbiZfuncFail].u += stats->zfunc_fail;
+	v->reg[fbiAfuncFail].u += stats->afunc_fail;
+
+	/* the stipple register rotates once per pixel regardless of order */
+	if (rotate != 0)
+		v->reg[stipple].u = (v->reg[stipple].u << rotate) | (v->reg[stipple].u >> (32 - rotate));
+
+	v->stats.total_pixels_in += stats->pixels_in;
+	v->stats.total_pixels_out += stats->pixels_out;
+	v->stats.total_chroma_fail += stats->chroma_fail;
+	v->stats.total_zfunc_fail += stats->zfunc_fail;
+	v->stats.total_afunc_fail += stats->afunc_fail;
+	v->stats.total_clipped += stats->clipped;
+	v->stats.total_stippled += stats->stippled;
+}
+
+
+static void *raster_band_callback(void *param)
+{
+	raster_band *band = param;
+	voodoo_state *v = band->v;
+	int trinum;
+
+	/* draw our slice of each triangle, in the order they were queued */
+	for (trinum = 0; trinum < v->tri_count; trinum++)
+	{
+		const tri_work *extra = &v->tri_queue[trinum];
+		if (extra->starty < band->stopy && extra->stopy > band->starty)
+			(*extra->info->callback)(v, extra, band->starty, band->stopy, &band->stats);
+	}
+	return NULL;
+}
+
+
+static void flush_triangles(voodoo_state *v)
+{
+	osd_work_item *item[RASTER_BANDS];
+	INT32 miny, maxy, height;
+	int bands, bandnum, trinum;
+
+	if (v->tri_count == 0)
+		return;
+
+	profiler_mark(PROFILER_USER2);
+
+	/* find the range of scanlines covered */
+	miny = v->tri_queue[0].starty;
+	maxy = v->tri_queue[0].stopy;
+	for (trinum = 1; trinum < v->tri_count; trinum++)
+	{
+		if (v->tri_queue[trinum].starty < miny)
+			miny = v->tri_queue[trinum].starty;
+		if (v->tri_queue[trinum].stopy > maxy)
+			maxy = v->tri_queue[trinum].stopy;
+	}
+
+	/* split the range into bands; each pixel belongs to exactly one band, */
+	/* so drawing every band in queue order preserves the overdraw order */
+	bands = (v->work_queue != NULL) ? (maxy - miny) / RASTER_MIN_BAND_HEIGHT : 1;
+	bands = MAX(1, MIN(bands, RASTER_BANDS));
+	height = (maxy - miny + bands - 1) / bands;
+
+	for (bandnum = 0; bandnum < bands; bandnum++)
+	{
+		raster_band *band = &v->band[bandnum];
+
+		band->v = v;
+		band->starty = miny + bandnum * height;
+		band->stopy = MIN(band->starty + height, maxy);
+		memset(&band->stats, 0, sizeof(band->stats));
+
+		/* the first band is ours; if a band can't be queued, draw it here */
+		item[bandnum] = NULL;
+		if (bandnum != 0)
+		{
+			item[bandnum] = osd_work_item_queue(v->work_queue, raster_band_callback, band);
+			if (item[bandnum] == NULL)
+				raster_band_callback(band);
+		}
+	}
+	raster_band_callback(&v->band[0]);
+
+	/* wait for the rest and gather their statistics */
+	for (bandnum = 0; bandnum < bands; bandnum++)
+	{
+		if (item[bandnum] != NULL)
+		{
+			while (!osd_work_item_wait(item[bandnum], osd_ticks_per_second())) ;
+			osd_work_item_release(item[bandnum]);
+		}
+		sum_statistics(v, &v->band[bandnum].stats);
+	}
+
+	v->tri_count = 0;
+	profiler_mark(PROFILER_END);
+}
+
+
+static void voodoo_exit(running_machine *machine)
+{
+	int which;
+
+#ifdef VOODOO_PROFILE
+	/* record which modes this game used */
+	save_rasterizer_profile();
+#endif
+
+	for (which = 0; which < MAX_VOODOO; which++)
+		if (voodoo[which] != NULL && voodoo[which]->work_queue != NULL)
+		{
+			osd_work_queue_free(voodoo[which]->work_queue);
+			voodoo[which]->work_queue = NULL;
+		}
+}
+
+
+
 /*************************************
  *
  *  Rasterizer management
@@ -4777,6 +5067,8 @@ static raster_info *add_rasterizer(voodoo_state *v, const raster_info *cinfo)
 	/* fill in the data */
 	info->hits = 0;
 	info->polys = 0;
+	info->total_hits = 0;
+	info->total_polys = 0;
 
 	/* hook us into the hash table */
 	info->next = v->raster_hash[hash];
@@ -4879,12 +5171,135 @@ static void dump_rasterizer_stats(voodoo_state *v)
 			best->eff_tex_mode_0,
 			best->eff_tex_mode_1);
 
-		/* reset */
+		/* fold into the totals and reset */
+		best->total_hits += best->hits;
+		best->total_polys += best->polys;
 		best->hits = best->polys = 0;
 	}
 }
 
 
+/*************************************
+ *
+ *  Rasterizer profiles
+ *
+ *************************************/
+
+#ifdef VOODOO_PROFILE
+
+static int parse_profile_line(const char *line, raster_profile *entry)
+{
+	double polys, hits;
+
+	/* each line is a table entry followed by the counts in a comment; */
+	/* the counts go through doubles since not every C library knows %lld */
+	if (sscanf(line, " RASTERIZER_ENTRY ( 0x%X , 0x%X , 0x%X , 0x%X , 0x%X , 0x%X ) /* %lf polys %lf pixels */",
+			&entry->eff_color_path, &entry->eff_alpha_mode, &entry->eff_fog_mode, &entry->eff_fbz_mode,
+			&entry->eff_tex_mode_0, &entry->eff_tex_mode_1, &polys, &hits) != 8)
+		return FALSE;
+	entry->polys = (INT64)polys;
+	entry->hits = (INT64)hits;
+	return TRUE;
+}
+
+
+static int CLIB_DECL compare_profile_entries(const void *e1, const void *e2)
+{
+	const raster_profile *p1 = e1;
+	const raster_profile *p2 = e2;
+	return (p1->hits < p2->hits) ? 1 : (p1->hits > p2->hits) ? -1 : 0;
+}
+
+
+static void save_rasterizer_profile(void)
+{
+	raster_profile *profile;
+	mame_file_error filerr;
+	int entries = 0, maxentries;
+	int which, rastnum, entry;
+	mame_file *file;
+	char line[256];
+	char *fname;
+
+	/* make room for a full profile plus everything we know about */
+	maxentries = MAX_RASTERIZERS;
+	for (which = 0; which < MAX_VOODOO; which++)
+		if (voodoo[which] != NULL)
+			maxentries += voodoo[which]->next_rasterizer;
+	profile = malloc_or_die(sizeof(*profile) * maxentries);
+
+	/* start with whatever earlier sessions recorded */
+	fname = assemble_2_strings(Machine->gamedrv->name, RASTER_PROFILE_EXTENSION);
+	filerr = mame_fopen(SEARCHPATH_CONFIG, fname, OPEN_FLAG_READ, &file);
+	if (filerr == FILERR_NONE)
+	{
+		while (entries < MAX_RASTERIZERS && mame_fgets(line, sizeof(line), file) != NULL)
+			if (parse_profile_line(line, &profile[entries]))
+				entries++;
+		mame_fclose(file);
+	}
+
+	/* merge in the counts from this session */
+	for (which = 0; which < MAX_VOODOO; which++)
+		if (voodoo[which] != NULL)
+			for (rastnum = 0; rastnum < voodoo[which]->next_rasterizer; rastnum++)
+			{
+				const raster_info *info = &voodoo[which]->rasterizer[rastnum];
+				INT64 polys = info->total_polys + info->polys;
+				INT64 hits = info->total_hits + info->hits;
+
+				if (polys == 0)
+					continue;
+
+				for (entry = 0; entry < entries; entry++)
+					if (profile[entry].eff_color_path == info->eff_color_path &&
+						profile[entry].eff_alpha_mode == info->eff_alpha_mode &&
+						profile[entry].eff_fog_mode == info->eff_fog_mode &&
+						profile[entry].eff_fbz_mode == info->eff_fbz_mode &&
+						profile[entry].eff_tex_mode_0 == info->eff_tex_mode_0 &&
+						profile[entry].eff_tex_mode_1 == info->eff_tex_mode_1)
+						break;
+
+				/* add a new entry if this is a mode we haven't seen before */
+				if (entry == entries)
+				{
+					memset(&profile[entry], 0, sizeof(profile[entry]));
+					profile[entry].eff_color_path = info->eff_color_path;
+					profile[entry].eff_alpha_mode = info->eff_alpha_mode;
+					profile[entry].eff_fog_mode = info->eff_fog_mode;
+					profile[entry].eff_fbz_mode = info->eff_fbz_mode;
+					profile[entry].eff_tex_mode_0 = info->eff_tex_mode_0;
+					profile[entry].eff_tex_mode_1 = info->eff_tex_mode_1;
+					entries++;
+				}
+				profile[entry].polys += polys;
+				profile[entry].hits += hits;
+			}
+
+	/* write the busiest modes back out, in a form the rasterizer table can include */
+	if (entries > 0)
+	{
+		qsort(profile, entries, sizeof(profile[0]), compare_profile_entries);
+		filerr = mame_fopen(SEARCHPATH_CONFIG, fname, OPEN_FLAG_WRITE | OPEN_FLAG_CREATE | OPEN_FLAG_CREATE_PATHS, &file);
+		if (filerr == FILERR_NONE)
+		{
+			mame_fprintf(file, "/* %-11s fbzColorPath alphaMode   fogMode,    fbzMode,    texMode0,   texMode1  */\n", Machine->gamedrv->name);
+			for (entry = 0; entry < entries && entry < MAX_RASTERIZERS; entry++)
+				mame_fprintf(file, "RASTERIZER_ENTRY( 0x%08X,  0x%08X, 0x%08X, 0x%08X, 0x%08X, 0x%08X )\t/* %.0f polys %.0f pixels */\n",
+						profile[entry].eff_color_path, profile[entry].eff_alpha_mode, profile[entry].eff_fog_mode,
+						profile[entry].eff_fbz_mode, profile[entry].eff_tex_mode_0, profile[entry].eff_tex_mode_1,
+						(double)profile[entry].polys, (double)profile[entry].hits);
+			mame_fclose(file);
+		}
+	}
+
+	free(fname);
+	free(profile);
+}
+
+#endif	/* VOODOO_PROFILE */
+
+
 
 /*************************************
  *
@@ -4963,4 +5378,9 @@ RASTERIZER_ENTRY( 0x00002809,  0x00004110, 0x00000001, 0x00030FFB, 0x08241AC7, 0
 RASTERIZER_ENTRY( 0x00424219,  0x00000000, 0x00000001, 0x00030F7B, 0x08241AC7, 0xFFFFFFFF )	/* in-game */
 RASTERIZER_ENTRY( 0x0200421A,  0x00001510, 0x00000001, 0x00030F7B, 0x08241AC7, 0xFFFFFFFF )	/* in-game */
 
+/* modes recorded in the per-game profiles, minus the ones above; see src/tools/voodprof.c */
+#ifdef VOODOO_PROFILE
+#include "voodprof.h"
+#endif
+
 #endif
@@ -26,6 +26,7 @@
 #include "render.h"
 #include "rendutil.h"
 #include "inptport.h"
+#include "inplog.h"
 #include "debug/debugcpu.h"
 #include "debug/debugcon.h"
 
@@ -137,7 +138,10 @@ static const options_entry windows_opts[] =
 	{ "autosave",                 "0",        OPTION_BOOLEAN,    "enable automatic restore at startup, and automatic save at exit time" },
 	{ "playback;pb",              NULL,       0,                 "playback an input file" },
 	{ "record;rec",               NULL,       0,                 "record an input file" },
-	{ "mngwrite",                 NULL,       0,                 "optional filename to write a MNG movie of the current session" },
+	{ "record_checkpoint",        "0",        0,                 "seconds between save state checkpoints in the recorded input file; 0 writes the old format" },
+	{ "playback_seek",            "0",        0,                 "start playing back from the last checkpoint before this many seconds" },
+	{ "snapuncompressed",         "0",        OPTION_BOOLEAN,    "write snapshots without compression; faster, but much larger" },
+	{ "mngwrite",                 NULL,       0,                 "optional filename to write a MNG movie of the current session, or raw video and sound if it ends in .raw" },
 	{ "wavwrite",                 NULL,       0,                 "optional filename to write a WAV file of the current session" },
 
 	// debugging options
@@ -428,11 +432,17 @@ void cli_frontend_exit(void)
 	options.logfile = NULL;
 
 	if (options.playback != NULL)
+	{
+		inplog_close_playback(options.playback);
 		mame_fclose(options.playback);
+	}
 	options.playback = NULL;
 
 	if (options.record != NULL)
+	{
+		inplog_close_record(options.record);
 		mame_fclose(options.record);
+	}
 	options.record = NULL;
 
 	if (options.language_file != NULL)
@@ -658,6 +668,7 @@ static void extract_options(const game_driver *driver, machine_config *drv)
 	// misc options
 	options.bios = (char *)options_get_string("bios");
 	options.cheat = options_get_bool("cheat");
+	options.snap_uncompressed = options_get_bool("snapuncompressed");
 	options.skip_gameinfo = options_get_bool("skip_gameinfo");
 
 #ifdef MESS
@@ -665,6 +676,8 @@ static void extract_options(const game_driver *driver, machine_config *drv)
 #endif /* MESS */
 
 	// save states and input recording
+	options.record_checkpoint = options_get_int_range("record_checkpoint", 0, 24*60*60);
+	options.playback_seek = options_get_int_range("playback_seek", 0, 0x7fffffff);
 	stemp = options_get_string("playback");
 	if (stemp != NULL)
 		setup_playback(stemp, driver);
@@ -725,7 +738,10 @@ static void setup_playback(const char *filename, const game_driver *driver)
 
 	// otherwise, print a message indicating what's happening
 	else
+	{
 		mame_printf_info("Playing back previously recorded " GAMENOUN " %s\n", driver->name);
+		options.playback_checkpoints = (memcmp(inp_header.reserved, INP_CHECKPOINT_MAGIC, sizeof(INP_CHECKPOINT_MAGIC)) == 0);
+	}
 }
 
 
@@ -746,6 +762,8 @@ static void setup_record(const char *filename, const game_driver *driver)
 	// create a header
 	memset(&inp_header, '\0', sizeof(inp_header));
 	strcpy(inp_header.name, driver->name);
+	if (options.record_checkpoint > 0)
+		strcpy(inp_header.reserved, INP_CHECKPOINT_MAGIC);
 	mame_fwrite(options.record, &inp_header, sizeof(inp_header));
 }
 
@@ -594,90 +594,103 @@ void CLIB_DECL verify_printf(const char *fmt, ...)
 
 
 
-int frontend_verifyroms(FILE *output)
+typedef struct _verify_state verify_state;
+struct _verify_state
 {
-	const char *gamename = options_get_string(OPTION_GAMENAME);
-	int correct = 0;
-	int incorrect = 0;
-	int checked = 0;
-	int notfound = 0;
-	int total;
-	int drvindex;
+	FILE *	output;
+	int		correct;
+	int		incorrect;
+	int		notfound;
+	int		checked;
+	int		total;
+};
 
-	/* a NULL gamename == '*' */
-	if (gamename == NULL)
-		gamename = "*";
 
-	/* first count up how many drivers match the string */
-	total = 0;
-	for (drvindex = 0; drivers[drvindex]; drvindex++)
-		if (!mame_strwildcmp(gamename, drivers[drvindex]->name))
-			total++;
 
-	/* gross: stash the output handle in a global */
-	verify_file = output;
+static void verifyroms_report(int drvindex, int audit_records, audit_record *audit, void *param)
+{
+	verify_state *state = param;
+	FILE *output = state->output;
+	int res;
 
-	/* now iterate over drivers */
-	for (drvindex = 0; drivers[drvindex]; drvindex++)
-	{
-		audit_record *audit;
-		int audit_records;
-		int res;
+	/* summarize the ROMs in this set */
+	res = audit_summary(drvindex, audit_records, audit, TRUE);
+	if (audit_records > 0)
+		free(audit);
 
-		/* skip if we don't match */
-		if (mame_strwildcmp(gamename, drivers[drvindex]->name))
-			continue;
+	/* if not found, count that and leave it at that */
+	if (res == NOTFOUND)
+		state->notfound++;
 
-		/* audit the ROMs in this set */
-		audit_records = audit_images(drvindex, AUDIT_VALIDATE_FAST, &audit);
-		res = audit_summary(drvindex, audit_records, audit, TRUE);
-		if (audit_records > 0)
-			free(audit);
+	/* else display information about what we discovered */
+	else
+	{
+		const game_driver *clone_of;
 
-		/* if not found, count that and leave it at that */
-		if (res == NOTFOUND)
-			notfound++;
+		/* output the name of the driver and its clone */
+		fprintf(output, "romset %s ", drivers[drvindex]->name);
+		clone_of = driver_get_clone(drivers[drvindex]);
+		if (clone_of != NULL)
+			fprintf(output, "[%s] ", clone_of->name);
 
-		/* else display information about what we discovered */
-		else
+		/* switch off of the result */
+		switch (res)
 		{
-			const game_driver *clone_of;
+			case INCORRECT:
+				fprintf(output, "is bad\n");
+				state->incorrect++;
+				break;
+
+			case CORRECT:
+				fprintf(output, "is good\n");
+				state->correct++;
+				break;
+
+			case BEST_AVAILABLE:
+				fprintf(output, "is best available\n");
+				state->correct++;
+				break;
+		}
+	}
 
-			/* output the name of the driver and its clone */
-			fprintf(output, "romset %s ", drivers[drvindex]->name);
-			clone_of = driver_get_clone(drivers[drvindex]);
-			if (clone_of != NULL)
-				fprintf(output, "[%s] ", clone_of->name);
+	/* update progress information on stderr */
+	state->checked++;
+	fprintf(stderr, "%d%%\r", 100 * state->checked / state->total);
+}
 
-			/* switch off of the result */
-			switch (res)
-			{
-				case INCORRECT:
-					fprintf(output, "is bad\n");
-					incorrect++;
-					break;
 
-				case CORRECT:
-					fprintf(output, "is good\n");
-					correct++;
-					break;
 
-				case BEST_AVAILABLE:
-					fprintf(output, "is best available\n");
-					correct++;
-					break;
-			}
-		}
+int frontend_verifyroms(FILE *output)
+{
+	const char *gamename = options_get_string(OPTION_GAMENAME);
+	verify_state state;
+	int *games;
+	int drvindex;
 
-		/* update progress information on stderr */
-		checked++;
-		fprintf(stderr, "%d%%\r", 100 * checked / total);
-	}
+	/* a NULL gamename == '*' */
+	if (gamename == NULL)
+		gamename = "*";
+
+	/* first collect the drivers that match the string */
+	memset(&state, 0, sizeof(state));
+	state.output = output;
+	for (drvindex = 0; drivers[drvindex]; drvindex++) ;
+	games = malloc_or_die(sizeof(*games) * (drvindex + 1));
+	for (drvindex = 0; drivers[drvindex]; drvindex++)
+		if (!mame_strwildcmp(gamename, drivers[drvindex]->name))
+			games[state.total++] = drvindex;
+
+	/* gross: stash the output handle in a global */
+	verify_file = output;
+
+	/* now audit them in parallel; results come back in order */
+	audit_images_batch(games, state.total, AUDIT_VALIDATE_FAST, verifyroms_report, &state);
+	free(games);
 
 	/* if we didn't get anything at all, display a generic end message */
-	if (correct + incorrect == 0)
+	if (state.correct + state.incorrect == 0)
 	{
-		if (notfound > 0)
+		if (state.notfound > 0)
 			fprintf(output, "romset \"%8s\" not found!\n", gamename);
 		else
 			fprintf(output, "romset \"%8s\" not supported!\n", gamename);
@@ -687,8 +700,8 @@ int frontend_verifyroms(FILE *output)
 	/* otherwise, print a summary */
 	else
 	{
-		fprintf(output, "%d romsets found, %d were OK.\n", correct + incorrect, correct);
-		return (incorrect > 0) ? 2 : 0;
+		fprintf(output, "%d romsets found, %d were OK.\n", state.correct + state.incorrect, state.correct);
+		return (state.incorrect > 0) ? 2 : 0;
 	}
 }
 
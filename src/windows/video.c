@@ -157,19 +157,19 @@ static void get_resolution(const char *name, win_window_config *config, int repo
 
 INLINE int effective_autoframeskip(void)
 {
-	return video_config.autoframeskip && !video_config.fastforward;
+	return video_config.autoframeskip && !video_config.fastforward && !video_get_fastforward();
 }
 
 
 INLINE int effective_frameskip(void)
 {
-	return video_config.fastforward ? (FRAMESKIP_LEVELS - 1) : video_config.frameskip;
+	return (video_config.fastforward || video_get_fastforward()) ? (FRAMESKIP_LEVELS - 1) : video_config.frameskip;
 }
 
 
 INLINE int effective_throttle(void)
 {
-	return !video_config.fastforward && (video_config.throttle || mame_is_paused(Machine) || ui_is_menu_active() || ui_is_slider_active());
+	return !video_config.fastforward && !video_get_fastforward() && (video_config.throttle || mame_is_paused(Machine) || ui_is_menu_active() || ui_is_slider_active());
 }
 
 
@@ -206,6 +206,21 @@ mame_file_error osd_close(osd_file *file)
 }
 
 
+//============================================================
+//  osd_get_modified_time
+//============================================================
+
+mame_file_error osd_get_modified_time(osd_file *file, UINT64 *modtime)
+{
+	FILETIME lastwrite;
+
+	if (!GetFileTime(file->handle, NULL, NULL, &lastwrite))
+		return win_error_to_mame_file_error(GetLastError());
+	*modtime = ((UINT64)lastwrite.dwHighDateTime << 32) | lastwrite.dwLowDateTime;
+	return FILERR_NONE;
+}
+
+
 //============================================================
 //  osd_rmfile
 //============================================================